@@ -0,0 +1,63 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFCapturedFrame.h"
+#include "RMFMemoryBuffer.h"
+
+namespace RMF
+{
+
+/*
+	BufferCapturedFrame
+
+	A CapturedFrame which pixels live in a MemoryBuffer it owns, with the rows 
+	contiguous in memory. It is used by the backends that generate or read their 
+	images themselves, and by the DeviceBackend default implementation of 
+	acquireCapturedFrame(), which copies the image into a new frame.
+
+	The backend fills the buffer while it is the only one referencing the frame, 
+	before handing the frame over. As it's always entirely overwritten, the buffer 
+	is taken from the default MemoryBufferPool and not zero-filled. Large frames 
+	are backed by transparent huge pages where available.
+*/
+class BufferCapturedFrame : public CapturedFrame
+{
+public:
+	BufferCapturedFrame( const ImageFormat& imageFormat, bool isBottomUp=false );
+	
+	MemoryBuffer&			getBuffer()				{ return mBuffer; }
+	const MemoryBuffer&		getBuffer() const		{ return mBuffer; }
+
+	using CapturedFrame::setSequenceNumber;
+	using CapturedFrame::setTimestamp;
+
+protected:
+	virtual ~BufferCapturedFrame();
+
+private:
+	MemoryBuffer			mBuffer;
+};
+
+}
\ No newline at end of file
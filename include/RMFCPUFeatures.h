@@ -0,0 +1,68 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define RMF_X86
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define RMF_NEON
+#endif
+
+namespace RMF
+{
+
+/*
+	CPUFeatures
+
+	Tells which SIMD instruction sets the processor running the program supports, 
+	so the image processing code can pick the fastest kernels at runtime.
+
+	The detection happens once, on first use. On x86, AVX2 is only reported when 
+	the operating system also saves the AVX registers on context switches.
+	On ARM, NEON is reported when the library was built for a NEON-capable target 
+	(it is always the case on 64-bit ARM).
+*/
+class CPUFeatures
+{
+public:
+	static bool				hasSSE2()		{ return getFeatures().mHasSSE2; }
+	static bool				hasSSSE3()		{ return getFeatures().mHasSSSE3; }
+	static bool				hasAVX2()		{ return getFeatures().mHasAVX2; }
+	static bool				hasNEON()		{ return getFeatures().mHasNEON; }
+
+	static std::string		toString();
+
+private:
+	CPUFeatures();
+	static const CPUFeatures& getFeatures();
+
+	bool					mHasSSE2;
+	bool					mHasSSSE3;
+	bool					mHasAVX2;
+	bool					mHasNEON;
+};
+
+}
\ No newline at end of file
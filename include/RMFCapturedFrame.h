@@ -0,0 +1,100 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include "RMFImage.h"
+
+namespace RMF
+{
+
+/*
+	CapturedFrame
+
+	A captured image as it was produced by a DeviceBackend, shared with its consumers 
+	instead of being copied. Depending on the backend, the pixels live in a buffer 
+	owned by the frame or directly in the capture API buffer (the locked Media 
+	Foundation sample buffer for example), which is given back when the frame is 
+	destroyed.
+
+	A frame is reference-counted. Whoever wants to keep a frame calls addReference() 
+	and later release(), the frame being deleted when the last reference goes away. 
+	The counting is thread-safe, so a frame can be handed over to another thread.
+	Keep in mind that holding on to frames can starve the capture API of buffers: 
+	release them as soon as possible.
+
+	The rows are addressed through getRow(), from the top of the image to the bottom. 
+	The stride is the signed distance in bytes from one row to the next: it's negative 
+	when the image is stored bottom-up in memory, and can be larger than the size of 
+	a row when they are padded. The planes of the planar encodings are addressed 
+	through getPlaneRow(). getView() gives a ConstImageView over the pixels, to 
+	convert them without copying them first.
+
+	The pixels of a frame must not be modified: the same frame can be shared by 
+	several consumers.
+*/
+class CapturedFrame
+{
+public:
+	const ImageFormat&		getImageFormat() const				{ return mImageFormat; }
+	int						getStride() const					{ return mView.getStride(); }
+	bool					isBottomUp() const					{ return mView.isBottomUp(); }
+	const unsigned char*	getRow( unsigned int y ) const		{ return mView.getRow(y); }
+	const unsigned char*	getPlaneRow( unsigned int plane, unsigned int y ) const		{ return mView.getPlaneRow( plane, y ); }
+	const ConstImageView&	getView() const						{ return mView; }
+
+	unsigned int			getSequenceNumber() const			{ return mSequenceNumber; }
+	long long				getTimestamp() const				{ return mTimestamp; }		// In 100-nanosecond units
+	float					getTimestampInSec() const			{ return static_cast<float>(mTimestamp) / 1e7f; }
+
+	// Copy the pixels into an image or a view of the same format, whatever its stride, 
+	// or into a buffer of the same size, top row first
+	bool					copyTo( const ImageView& image ) const;
+	bool					copyTo( MemoryBuffer& buffer ) const;
+
+	void					addReference();
+	void					release();
+	unsigned int			getReferenceCount() const			{ return mReferenceCount; }
+
+protected:
+	CapturedFrame( const ImageFormat& imageFormat );			// The frame starts with one reference
+	virtual ~CapturedFrame();
+
+	void					setRows( const unsigned char* topRow, int stride );		// The planes follow each other, like in an Image
+	void					setSequenceNumber( unsigned int sequenceNumber )	{ mSequenceNumber = sequenceNumber; }
+	void					setTimestamp( long long timestamp )					{ mTimestamp = timestamp; }
+
+private:
+	CapturedFrame( const CapturedFrame& other );				// Not implemented on purpose
+	CapturedFrame& operator=( const CapturedFrame& other );		// Not implemented on purpose
+
+	ImageFormat						mImageFormat;
+	ConstImageView					mView;
+	unsigned int					mSequenceNumber;
+	long long						mTimestamp;
+	std::atomic<unsigned int>		mReferenceCount;
+};
+
+}
\ No newline at end of file
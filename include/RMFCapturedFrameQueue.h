@@ -0,0 +1,85 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include "RMFCapturedFrame.h"
+
+namespace RMF
+{
+
+/*
+	CapturedFrameQueue
+
+	A fixed-depth queue of CapturedFrames between exactly one producer, the capture 
+	thread of a backend, and one consumer, typically the thread updating the Device. 
+	The slots are allocated once and the queue is lock-free: push() and pop() only 
+	synchronize through atomic indices, so neither side ever waits for the other.
+
+	The producer is never blocked by a late consumer: when the queue is full, push() 
+	drops the oldest frame to make room for the new one, and counts it as dropped. 
+	The consumer always gets the frames in the order they were pushed.
+
+	The queue holds a reference on each frame it contains: push() takes over the 
+	reference of the caller, pop() hands it over to the caller, who must release it.
+
+	setDepth(), releaseFrames() and clear() must only be called when nobody is pushing or popping.
+*/
+class CapturedFrameQueue
+{
+public:
+	CapturedFrameQueue( std::size_t depth=0 );
+	~CapturedFrameQueue();
+
+	std::size_t							getDepth() const				{ return mSlots.size(); }
+	bool								setDepth( std::size_t depth );		// Fails if the queue isn't empty
+
+	// Producer side. Return false when the oldest frame had to be dropped, or when the depth is zero 
+	// in which case the frame itself is released
+	bool								push( CapturedFrame* frame );
+	
+	// Consumer side. Return NULL when the queue is empty
+	CapturedFrame*						pop();
+	
+	bool								isEmpty() const;
+	void								releaseFrames();				// Empty the queue, keeping the counters
+	void								clear();						// Empty the queue and reset the counters
+
+	unsigned int						getNumPushedFrames() const		{ return mNumPushedFrames; }
+	unsigned int						getNumDroppedFrames() const		{ return mNumDroppedFrames; }
+
+private:
+	CapturedFrameQueue( const CapturedFrameQueue& other );				// Not implemented on purpose
+	CapturedFrameQueue& operator=( const CapturedFrameQueue& other );	// Not implemented on purpose
+
+	std::vector< std::atomic<CapturedFrame*> >	mSlots;
+	std::atomic<std::size_t>			mHead;							// Incremented by the producer after it fills a slot
+	std::atomic<std::size_t>			mTail;							// Incremented by whoever takes a frame out: the consumer, or the producer when dropping
+	std::atomic<unsigned int>			mNumPushedFrames;
+	std::atomic<unsigned int>			mNumDroppedFrames;
+};
+
+}
\ No newline at end of file
@@ -32,6 +32,7 @@ class CapturedImage
 {
 public:
 	CapturedImage( ImageFormat imageFormat );
+	CapturedImage( ImageFormat imageFormat, const MemoryBuffer::Options& bufferOptions );
 
 	const Image&	getImage() const			{ return mImage; }
 	unsigned int	getSequenceNumber() const	{ return mSequenceNumber; }
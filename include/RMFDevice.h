@@ -28,11 +28,12 @@
 #include "RMFImage.h"
 #include "RMFCaptureSettings.h"
 #include "RMFCapturedImage.h"
+#include "RMFCapturedFrame.h"
 
 namespace RMF
 {
 
-class DeviceInternals;	
+class DeviceBackend;
 
 class Device
 {
@@ -49,6 +50,22 @@ public:
 	const CapturedImage*			getCapturedImage() const				{ return mCapturedImage; }
 	void							stopCapture();
 
+	// Zero-copy mode. Instead of being copied into the CapturedImage, the images are handed 
+	// over to the listeners as the CapturedFrame the backend produced (see onDeviceCapturedFrame). 
+	// getCapturedImage() then returns NULL and getCapturedFrame() the latest frame, which 
+	// stays valid until the next update. It can only be changed while not capturing
+	bool							setZeroCopyEnabled( bool enabled );
+	bool							isZeroCopyEnabled() const				{ return mZeroCopyEnabled; }
+	const CapturedFrame*			getCapturedFrame() const				{ return mCapturedFrame; }
+
+	// Frame queue mode. With a depth other than zero, the backend queues the images it captures 
+	// (see DeviceBackend::setFrameQueueDepth) and update() delivers all those captured since 
+	// the previous update, oldest first, instead of only the latest one. When the backend doesn't 
+	// support it, setFrameQueueDepth() fails. It can only be changed while not capturing
+	bool							setFrameQueueDepth( std::size_t depth );
+	std::size_t						getFrameQueueDepth() const;
+	unsigned int					getNumDroppedFrames() const;			// Since the capture started
+
 	void							update();
 
 	class Listener
@@ -57,6 +74,11 @@ public:
 		virtual ~Listener() {}
 		virtual void onDeviceStarted( Device* /*device*/ ) {}
 		virtual void onDeviceCapturedImage( Device* /*device*/ ) {}
+
+		// Zero-copy mode only. The frame stays valid for the duration of the call. To keep 
+		// it longer, for example to process it on another thread, call addReference() on it, 
+		// and release() when done
+		virtual void onDeviceCapturedFrame( Device* /*device*/, CapturedFrame* /*frame*/ ) {}
 		virtual void onDeviceStopping( Device* /*device*/ ) {}
 	};
 
@@ -65,24 +87,26 @@ public:
 
 protected:
 	friend class DeviceManager;
-	Device( void* activateSharedPtrAsVoidPtr, const std::string& name, const std::string& symbolicLink );
+	Device( DeviceBackend* backend, const std::string& name, const std::string& symbolicLink );		// Takes ownership of the backend
 	virtual ~Device();
 
-	// Note: this should go in a proper transform class or something
-	static bool						flipImageVertically( const Image& sourceImage, Image& destinationImage );
+	void							updateCapturedImage();
+	void							updateCapturedFrame();
+	void							updateFromFrameQueue();
+	void							deliverCapturedFrame( CapturedFrame* frame );
 
 private:
 	std::string						mName;
 	std::string						mSymbolicLink;
 
 	CaptureSettingsList				mSupportedCaptureSettingsList;
-	std::vector<std::size_t>		mMediaTypeIndices;				// For each CaptureSettings, contains the index of the corresponding MediaType
 
-	DeviceInternals*				mInternals;
+	DeviceBackend*					mBackend;
 	
 	unsigned int					mStartedCaptureSettingsIndex;
 	CapturedImage*					mCapturedImage;
-	Image*							mTempImage;						// Used as intermediate step for vertical flip
+	bool							mZeroCopyEnabled;
+	CapturedFrame*					mCapturedFrame;					// Zero-copy mode only
 	
 	typedef	std::vector<Listener*> Listeners; 
 	Listeners						mListeners;
@@ -0,0 +1,102 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include "RMFCaptureSettings.h"
+#include "RMFMemoryBuffer.h"
+#include "RMFCapturedFrame.h"
+#include "RMFImageView.h"
+
+namespace RMF
+{
+
+/*
+	DeviceBackend
+
+	The interface between a Device and whatever actually produces its images: 
+	a Media Foundation source, a synthetic pattern generator, etc...
+	A Device owns its DeviceBackend.
+
+	Like the DeviceInternals it was extracted from, a backend is kept dumb on purpose:
+	it fills a blob (a MemoryBuffer) with the latest captured image along with
+	a sequence number and a timestamp. It doesn't know about the Image class.
+
+	For zero-copy delivery, a backend can also hand its latest image over as a 
+	CapturedFrame. By default the image is copied into a new frame, the backends 
+	that own their image memory override this to share it instead.
+
+	The backends that capture on their own thread can also queue their images as 
+	CapturedFrames (see setFrameQueueDepth()), so a consumer that is late now and 
+	then gets every image instead of only the latest one.
+*/
+class DeviceBackend
+{
+public:
+	virtual ~DeviceBackend() {}
+
+	virtual const CaptureSettingsList&	getSupportedCaptureSettingsList() const = 0;
+	
+	// Whether the images captured with these settings are stored bottom-up (and need to be flipped vertically). 
+	// getCapturedImage() copies them as they are stored. The Device passes the view version a view of its 
+	// image starting from the bottom row, so they land upright in a single pass
+	virtual bool						isBottomUp( std::size_t /*captureSettingsIndex*/ ) const	{ return false; }
+
+	virtual bool						startCapture( std::size_t captureSettingsIndex ) = 0;
+	virtual void						stopCapture() = 0;
+	virtual bool						isCapturing() const = 0;
+
+	// The sequence number of the latest captured image, zero if none has been captured yet
+	virtual unsigned int				getCapturedImageSequenceNumber() const = 0;
+
+	// Copy the latest captured image into the buffer. The timestamp is expressed in 100-nanosecond units.
+	// It's legal for this to fail while capturing, typically when the first image hasn't been captured yet
+	virtual bool						getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const = 0;
+
+	// Same into a view of the same format, which rows receive the stored ones in order. The backends storing 
+	// their images bottom-up must implement it, by default it fails
+	virtual bool						getCapturedImage( const ImageView& /*image*/, unsigned int& /*sequenceNumber*/, long long& /*timestamp*/ ) const	{ return false; }
+
+	// Return the latest captured image with a reference the caller must release, NULL if there is none.
+	// The captureSettingsIndex is the one the capture was started with
+	virtual CapturedFrame*				acquireCapturedFrame( std::size_t captureSettingsIndex ) const;
+
+	// Whether the consumer takes the latest image through acquireCapturedFrame() rather than getCapturedImage().
+	// The backends that lend their capture buffers in their frames only do so then: otherwise they copy the 
+	// images out and give the buffers back right away. It can only be changed while not capturing
+	virtual bool						setZeroCopyEnabled( bool /*enabled*/ )		{ return true; }
+
+	// The depth of the frame queue, zero (the default) to disable it. The capture never waits for the consumer: 
+	// when the queue is full, its oldest frame is dropped. The depth can only be changed while not capturing
+	virtual bool						setFrameQueueDepth( std::size_t depth )		{ return depth==0; }
+	virtual std::size_t					getFrameQueueDepth() const					{ return 0; }
+
+	// Take the oldest queued image out, with a reference the caller must release. NULL if the queue is empty
+	virtual CapturedFrame*				popCapturedFrame()							{ return NULL; }
+	
+	// The number of images dropped from the frame queue since the capture started
+	virtual unsigned int				getNumDroppedFrames() const					{ return 0; }
+};
+
+}
\ No newline at end of file
@@ -31,7 +31,12 @@
 #include <mfreadwrite.h>
 #include <shlwapi.h>
 #include "RMFCOMObjectSharedPtr.h"
+#include "RMFCriticalSection.h"
 #include "RMFMemoryBuffer.h"
+#include "RMFImageFormat.h"
+#include "RMFMediaFoundationCapturedFrame.h"
+#include "RMFBufferCapturedFrame.h"
+#include "RMFCapturedFrameQueue.h"
 
 namespace RMF
 {
@@ -51,6 +56,8 @@ public:
 		INT32				stride;
 		UINT32				frameRate;
 		GUID				subType;
+		UINT32				yuvMatrix;			// A MFVideoTransferMatrix, or 0 (unknown) when the attribute is missing
+		UINT32				nominalRange;		// A MFNominalRange, or 0 (unknown) when the attribute is missing
 				
 		std::string			getSubTypeName() const		{ return getSubTypeName(subType); }
 		static std::string	getSubTypeName( const GUID& mediaType );
@@ -64,11 +71,20 @@ public:
 	const VideoMediaTypes&		getSupportedVideoMediaTypes() const { return mSupportedVideoMediaTypes; }
 
 	//bool						startCapture( const VideoMediaType& videoMediaType );
-	bool						startCapture( DWORD videoMediaTypeIndex );
+	bool						startCapture( DWORD videoMediaTypeIndex, const ImageFormat& imageFormat );
 	void						stopCapture();
 	bool						isCapturing() const	{ return mIsCapturing; }
-	//unsigned int				getCapturedImageSequenceNumber() const;
+	unsigned int				getCapturedImageSequenceNumber() const;
 	bool						getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, LONGLONG& timestamp ) const;
+	CapturedFrame*				acquireCapturedFrame() const;
+
+	bool						setZeroCopyEnabled( bool enabled );
+	bool						isZeroCopyEnabled() const	{ return mZeroCopyEnabled; }
+
+	bool						setFrameQueueDepth( std::size_t depth );
+	std::size_t					getFrameQueueDepth() const	{ return mFrameQueue.getDepth(); }
+	CapturedFrame*				popCapturedFrame()			{ return mFrameQueue.pop(); }
+	unsigned int				getNumDroppedFrames() const	{ return mFrameQueue.getNumDroppedFrames(); }
 
 protected:
 	static bool					getVideoMediaType( IMFSourceReader* sourceReader, DWORD index, VideoMediaType& mediaTypeInfo );
@@ -84,16 +100,23 @@ protected:
 	STDMETHODIMP				OnFlush( DWORD );
 	
 private:
+	bool						processSample( IMFSample* sample, LONGLONG timestamp );
+	BufferCapturedFrame*		getFreeFrame();
+
 	COMObjectSharedPtr<IMFActivate>	mActivate;			
 	std::string					mName;
-	mutable CRITICAL_SECTION	mCriticalSection;
+	mutable CriticalSection		mCriticalSection;
 	ULONG						mReferenceCounter;
 	COMObjectSharedPtr<IMFSourceReader> mSourceReaderRes;
 	bool						mIsCapturing;
 	VideoMediaTypes				mSupportedVideoMediaTypes;
+	DWORD						mCapturedMediaTypeIndex;
+	ImageFormat					mCapturedImageFormat;
 	unsigned int				mCapturedImageNumber;
-	LONGLONG					mCapturedImageTimestamp;
-	MemoryBuffer*				mCapturedImageBuffer;
+	bool						mZeroCopyEnabled;
+	CapturedFrame*				mCapturedFrame;				// The latest sample, still locked in zero-copy mode without queue, a copy of it otherwise
+	std::vector<BufferCapturedFrame*> mFrames;				// The frames the samples are copied into, allocated by startCapture()
+	CapturedFrameQueue			mFrameQueue;				// Copies of the samples not consumed yet. Lock-free
 };
 
 }
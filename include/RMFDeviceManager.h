@@ -24,6 +24,7 @@
 #pragma once
 
 #include "RMFDevice.h"
+#include "RMFDeviceManagerBackend.h"
 
 namespace RMF
 {
@@ -31,7 +32,10 @@ namespace RMF
 class DeviceManager
 {
 public:
-	DeviceManager();
+#ifdef _WIN32
+	DeviceManager();											// Uses the Media Foundation backend. Provided by the RapaMediaFoundation library
+#endif
+	DeviceManager( DeviceManagerBackend* backend );				// Takes ownership of the backend
 	virtual ~DeviceManager();
 
 	void			update();
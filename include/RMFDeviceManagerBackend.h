@@ -0,0 +1,65 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include "RMFDeviceBackend.h"
+
+namespace RMF
+{
+
+/*
+	DeviceManagerBackend
+
+	The interface through which a DeviceManager discovers the available devices
+	and creates the DeviceBackend of each one of them.
+	A DeviceManager owns its DeviceManagerBackend.
+*/
+class DeviceManagerBackend
+{
+public:
+	virtual ~DeviceManagerBackend() {}
+
+	class DeviceDescription
+	{
+	public:
+		DeviceDescription() {}
+		DeviceDescription( const std::string& deviceName, const std::string& deviceSymbolicLink ) 
+			: name(deviceName), symbolicLink(deviceSymbolicLink) {}
+		std::string		name;
+		std::string		symbolicLink;		// Uniquely identifies the device
+	};
+	typedef std::vector<DeviceDescription> DeviceDescriptions;
+
+	// Whether the list of devices might have changed since the last call to enumerateDevices()
+	virtual bool					hasDeviceListChanged() const = 0;
+	virtual void					enumerateDevices( DeviceDescriptions& descriptions ) = 0;
+
+	// Create the backend of a device returned by the last call to enumerateDevices(). 
+	// The caller takes ownership of the returned object
+	virtual DeviceBackend*			createDeviceBackend( const DeviceDescription& description ) = 0;
+};
+
+}
\ No newline at end of file
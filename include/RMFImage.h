@@ -23,29 +23,78 @@
 */
 #pragma once
 
+#include <cstddef>
 #include "RMFImageFormat.h"
 #include "RMFMemoryBuffer.h"
+#include "RMFImageView.h"
 
 namespace RMF
 {
 
 /*
 	Image
+
+	An ImageFormat and the MemoryBuffer holding the pixels.
+
+	The rows are stored one after the other in the buffer. The stride is the signed 
+	distance in bytes from the start of a row to the start of the next one: 
+	- it's larger than the number of bytes per line of the format when the rows are 
+	  padded, to align them for example (see getAlignedStride())
+	- it's negative when the image is stored bottom-up, the top row being the last 
+	  one in the buffer 
+	By default the rows are packed and stored top-down, the stride being the number 
+	of bytes per line of the format.
+
+	Always address the rows through getRow(), which accounts for the stride.
+
+	The planes of the planar encodings are stored one after the other in the buffer. 
+	The stride is the one of the first plane, the other planes being padded in 
+	proportion (see getPlaneStride()): for I420, the stride of the chroma planes is 
+	half the stride of the luma plane. Their rows are addressed through getPlaneRow().
+
+	An Image converts implicitly to an ImageView or a ConstImageView.
 */
 class Image
 {
 public:
 	Image();
 	Image( const ImageFormat& imageFormat );
+	Image( const ImageFormat& imageFormat, const MemoryBuffer::Options& bufferOptions );
+	Image( const ImageFormat& imageFormat, int stride, const MemoryBuffer::Options& bufferOptions=MemoryBuffer::Options() );
 	Image( const Image& other );
 
 	const ImageFormat&				getFormat() const		{ return mFormat; }
+	int								getStride() const		{ return mStride; }
+	bool							isBottomUp() const		{ return mStride<0; }
+	bool							hasPackedRows() const	{ return mStride==static_cast<int>( mFormat.getNumBytesPerLine() ); }
 	
+	const unsigned char*			getRow( unsigned int y ) const		{ return mBuffer.getBytes() + getRowOffset(0, y); }
+	unsigned char*					getRow( unsigned int y )			{ return mBuffer.getBytes() + getRowOffset(0, y); }
+
+	int								getPlaneStride( unsigned int plane ) const							{ return getPlaneStride( mFormat, mStride, plane ); }
+	const unsigned char*			getPlaneRow( unsigned int plane, unsigned int y ) const			{ return mBuffer.getBytes() + getRowOffset(plane, y); }
+	unsigned char*					getPlaneRow( unsigned int plane, unsigned int y )					{ return mBuffer.getBytes() + getRowOffset(plane, y); }
+
 	MemoryBuffer&					getBuffer()				{ return mBuffer; }
 	const MemoryBuffer&				getBuffer() const		{ return mBuffer; }
+
+	// Copy the pixels of an image or a view of the same format, whatever their strides
+	bool							copyFrom( const ConstImageView& other );
+
+	// The stride of top-down rows padded to a multiple of the alignment (in bytes)
+	static int						getAlignedStride( const ImageFormat& imageFormat, unsigned int alignment );
+
+	// The layout of the planes stored one after the other, given the stride of the first one
+	static int						getPlaneStride( const ImageFormat& imageFormat, int stride, unsigned int plane );
+	static std::size_t				getPlaneOffset( const ImageFormat& imageFormat, int stride, unsigned int plane );
+	static std::size_t				getBufferSizeInBytes( const ImageFormat& imageFormat, int stride );
 		
 private:
+	std::ptrdiff_t					getRowOffset( unsigned int plane, unsigned int y ) const;
+	static int						getValidStride( const ImageFormat& imageFormat, int stride );
+
 	ImageFormat						mFormat;
+	int								mStride;
 	MemoryBuffer					mBuffer;	
 };
 
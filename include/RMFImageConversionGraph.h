@@ -0,0 +1,98 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include "RMFImageConverter.h"
+
+namespace RMF
+{
+
+/*
+	ImageConversionGraph
+
+	The registry of the direct conversions of the ImageConverter, and the planner chaining 
+	them for the pairs of encodings that have none.
+
+	The nodes of the graph are the encodings and its edges the direct conversions, each with 
+	a cost. The default costs are declared from the converter benchmark: roughly the time to 
+	convert a 1280x720 image on an AVX2 processor, in tenths of a millisecond. They can be 
+	replaced by measured ones with setConversion(), on a graph of one's own passed to the 
+	ImageConverter in its Options.
+
+	A direct conversion is always used when there is one that keeps the color. Otherwise 
+	findPath() returns the cheapest chain, each intermediate image adding hopCost for being 
+	written and read back. 
+	The intermediate encodings never lose what both ends have:
+	- the color: no gray encoding between two color ones
+	- the chroma resolution: the RGB encodings keep all of it, the packed 4:2:2 ones half of 
+	  it, the 4:2:0 ones a quarter
+	- the alpha, when both ends have one
+	- the 16-bit luma, when both ends are GRAY16
+
+	The intermediate formats have the size of both ends. Until the path has gone through an 
+	RGB encoding, they have the color matrix and range of the source, then the ones of the 
+	destination. Only the conversions from or to RGB change the color matrix and range: between 
+	two other formats of different color, the path goes through RGB. The gray encodings only have 
+	a range. The graph doesn't resize: both ends must have the same size.
+*/
+class ImageConversionGraph
+{
+public:
+	typedef bool (*ConvertFunction)( const ConstImageView& sourceImage, const ImageView& destinationImage, const ImageConverter::Options& options );
+
+	enum { hopCost = 2 };
+
+	ImageConversionGraph();			// With all the direct conversions of the ImageConverter
+
+	static const ImageConversionGraph&	getDefault();
+
+	// A NULL function removes the conversion. The conversions to the same encoding are ignored
+	void				setConversion( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, ConvertFunction convert, unsigned int cost );
+	ConvertFunction		getConversion( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding ) const;
+	ConvertFunction		getConversion( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat ) const;	// NULL when the color must change
+	unsigned int		getCost( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding ) const;
+
+	// The formats from the source one to the destination one, both included. Returns false when 
+	// there is no path, when the formats are the same, or when their sizes differ
+	bool				findPath( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, std::vector<ImageFormat>& path ) const;
+
+private:
+	struct Conversion
+	{
+		ConvertFunction		convert;
+		unsigned int		cost;
+	};
+
+	void				setConversions( bool (*isSource)( ImageFormat::Encoding ), bool (*isDestination)( ImageFormat::Encoding ), ConvertFunction convert, unsigned int cost );
+	static bool			canBeIntermediate( ImageFormat::Encoding encoding, ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding );
+	static int			getNode( int encoding, bool isAfterRGB );
+	static bool			keepsColor( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat );
+	static int			getChromaResolution( ImageFormat::Encoding encoding );
+	static bool			hasAlpha( ImageFormat::Encoding encoding );
+
+	Conversion			mConversions[ImageFormat::EncodingCount][ImageFormat::EncodingCount];
+};
+
+}
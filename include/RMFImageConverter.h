@@ -23,33 +23,171 @@
 */
 #pragma once
 
+#include <functional>
+#include <vector>
 #include "RMFImage.h"
+#include "RMFMemoryBufferPool.h"
+#include "RMFImageConverterKernels.h"
+#include "RMFImageScaler.h"
+#include "RMFImageTransformer.h"
+#include "RMFThreadPool.h"
 
 namespace RMF
 {
 
+class ImageConversionGraph;
+
+/*
+	ImageConverter
+
+	Converts images from one encoding to another. The images are passed as views of any 
+	stride, negative for bottom-up images, so memory owned by someone else (a QImage, a 
+	captured frame) is read and written without an intermediate copy. With a ThreadPool 
+	in the Options, the image is converted by bands of at least minBandHeight rows. The 
+	output image comes from the MemoryBufferPool of the Options, the default one otherwise.
+
+	The "RGB" functions take any of the RGB encodings, the "YUV422" ones any of the packed 
+	4:2:2 encodings, the "YUV420" ones NV12, I420 and YV12, and the I420 ones YV12 too. A 
+	4-byte destination gets an opaque alpha when the source has none. The conversions to 
+	GRAY8 extract the luma of the YUV encodings as it is, the cheap path for the consumers 
+	that don't need the color. The color matrix and range of the YUV and gray formats are 
+	used by the conversions from and to RGB, the other ones keep the samples as they are.
+
+	convertImage() and update() convert between any two encodings, through intermediate ones 
+	when needed (see ImageConversionGraph), and through RGB to another color matrix or range. 
+	They also scale the image when the sizes differ (see ImageScaler), and flip or rotate it 
+	with the transform of the Options (see ImageTransformer), in its own encoding and chunk 
+	by chunk, converting each chunk while it's in the cache. convertRegions() converts regions 
+	of interest, reading only their pixels.
+
+	The YUV to RGB conversions can use lookup tables rather than multiplications (see 
+	YUVToRGBMethod), for the processors lacking SIMD kernels. The result is the same.
+*/
 class ImageConverter
 {
 public:
-	ImageConverter( const ImageFormat& outputImageFormat );
+	// How the YUV to RGB conversions compute the color of the pixels
+	enum YUVToRGBMethod
+	{
+		MultiplyMethod,			// The fixed-point formulas, with the best instruction set of the processor
+		LookupTableMethod,		// The scalar kernels looking up the products in YUVToRGBTables. For the processors 
+								// with no SIMD implementation: it is slower than the SIMD kernels
+	};
+
+	class Options
+	{
+	public:
+		Options();
+		ThreadPool*		threadPool;			// Not owned. NULL to convert on the calling thread only
+		unsigned int	minBandHeight;		// In rows
+		MemoryBuffer::Options outputBufferOptions;	// How the output image is allocated. From the default pool by default
+		unsigned int	outputRowAlignment;	// In bytes. The rows of the output image are padded to a multiple of it. 1 for packed rows
+		YUVToRGBMethod	yuvToRGBMethod;		// MultiplyMethod by default. Both give the same bytes
+		const ImageConversionGraph* conversionGraph;	// Not owned. NULL for the default one
+		ImageScaler::Filter scalingFilter;	// BoxFilter by default. Used when the source and destination sizes differ
+		ImageTransformer::Transform transform;	// Identity by default. Applied to the source before it's converted
+	};
+
+	ImageConverter( const ImageFormat& outputImageFormat, const Options& options=Options() );
 	virtual ~ImageConverter();
 
-	bool			update( const Image& sourceImage );
+	bool			update( const ConstImageView& sourceImage );
 	const Image&	getImage() const			{ return *mImage; }
 	Image&			getImage()					{ return *mImage; }
 
-	static bool		convertBGR24ImageToRGB24Image( const Image& bgr24Image, Image& rgb24Image );
-	static bool		convertRGB24ImageToBGR24Image( const Image& rgb24Image, Image& bgr24Image );
+	const Options&	getOptions() const							{ return mOptions; }
+	void			setOptions( const Options& options )		{ mOptions = options; mPath.clear(); }
+
+	static bool		convertBGR24ImageToRGB24Image( const ConstImageView& bgr24Image, const ImageView& rgb24Image, const Options& options=Options() );
+	static bool		convertRGB24ImageToBGR24Image( const ConstImageView& rgb24Image, const ImageView& bgr24Image, const Options& options=Options() );
 	
-	static bool		convertYUYVImageToRGB24Image( const Image& yuyvImage, Image& rgb24Image );
-	static bool		convertYUYVImageToBGR24Image( const Image& yuyvImage, Image& bgr24Image );
+	static bool		convertYUYVImageToRGB24Image( const ConstImageView& yuyvImage, const ImageView& rgb24Image, const Options& options=Options() );
+	static bool		convertYUYVImageToBGR24Image( const ConstImageView& yuyvImage, const ImageView& bgr24Image, const Options& options=Options() );
+	static bool		convertYUYVImageToNV12Image( const ConstImageView& yuyvImage, const ImageView& nv12Image, const Options& options=Options() );
+	static bool		convertYUYVImageToI420Image( const ConstImageView& yuyvImage, const ImageView& i420Image, const Options& options=Options() );
+
+	static bool		convertNV12ImageToRGB24Image( const ConstImageView& nv12Image, const ImageView& rgb24Image, const Options& options=Options() );
+	static bool		convertNV12ImageToBGR24Image( const ConstImageView& nv12Image, const ImageView& bgr24Image, const Options& options=Options() );
+	static bool		convertNV12ImageToYUYVImage( const ConstImageView& nv12Image, const ImageView& yuyvImage, const Options& options=Options() );
+
+	static bool		convertI420ImageToRGB24Image( const ConstImageView& i420Image, const ImageView& rgb24Image, const Options& options=Options() );
+	static bool		convertI420ImageToBGR24Image( const ConstImageView& i420Image, const ImageView& bgr24Image, const Options& options=Options() );
+	static bool		convertI420ImageToYUYVImage( const ConstImageView& i420Image, const ImageView& yuyvImage, const Options& options=Options() );
 	
-	static bool		convertImage( const Image& source, Image& destinationImage );
+	static bool		convertRGBImageToRGBImage( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options=Options() );
+	static bool		convertYUV422ImageToRGBImage( const ConstImageView& yuv422Image, const ImageView& rgbImage, const Options& options=Options() );
+	static bool		convertNV12ImageToRGBImage( const ConstImageView& nv12Image, const ImageView& rgbImage, const Options& options=Options() );
+	static bool		convertI420ImageToRGBImage( const ConstImageView& i420Image, const ImageView& rgbImage, const Options& options=Options() );
+	static bool		convertRGBImageToYUV422Image( const ConstImageView& rgbImage, const ImageView& yuv422Image, const Options& options=Options() );
+	static bool		convertRGBImageToNV12Image( const ConstImageView& rgbImage, const ImageView& nv12Image, const Options& options=Options() );
+	static bool		convertRGBImageToI420Image( const ConstImageView& rgbImage, const ImageView& i420Image, const Options& options=Options() );
+	static bool		convertYUV422ImageToNV12Image( const ConstImageView& yuv422Image, const ImageView& nv12Image, const Options& options=Options() );
+	static bool		convertYUV422ImageToI420Image( const ConstImageView& yuv422Image, const ImageView& i420Image, const Options& options=Options() );
+	static bool		convertYUV422ImageToYUV422Image( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options=Options() );
 
-private:
+	static bool		convertYUV422ImageToGRAY8Image( const ConstImageView& yuv422Image, const ImageView& gray8Image, const Options& options=Options() );
+	static bool		convertYUV420ImageToGRAY8Image( const ConstImageView& yuv420Image, const ImageView& gray8Image, const Options& options=Options() );
+	static bool		convertRGBImageToGRAY8Image( const ConstImageView& rgbImage, const ImageView& gray8Image, const Options& options=Options() );
+	static bool		convertGRAYImageToRGBImage( const ConstImageView& grayImage, const ImageView& rgbImage, const Options& options=Options() );
+	static bool		convertGRAYImageToGRAYImage( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options=Options() );
+
+	// Any two encodings, directly or not, scaling the image when the sizes differ and transforming it. 
+	// Returns false for the same format without a transform
+	static bool		convertImage( const ConstImageView& source, const ImageView& destinationImage, const Options& options=Options() );
+
+	// Converts (or copies, for the same format) each region of the source into the destination image 
+	// of the same index, scaling and transforming it like convertImage(). The regions must be valid, 
+	// see ImageView::alignRegion(). With more regions than threads, each one is converted by a thread
+	static bool		convertRegions( const ConstImageView& sourceImage, const std::vector<ImageRegion>& regions, const std::vector<ImageView>& destinationImages, const Options& options=Options() );
+
+	// In-place RGB24 <-> BGR24 conversion of a buffer of 3-byte pixels
 	static bool		swapFirstAndThirdBytesEveryThreeBytes( MemoryBuffer& buffer );
 
+private:
+	typedef ThreadPool::BandTask ConvertBandFunction;
+
+	static bool		haveSameSize( const ImageFormat& firstImageFormat, const ImageFormat& secondImageFormat );
+	static bool		isI420OrYV12( ImageFormat::Encoding encoding );
+
+	// Splits the rows into bands, a multiple of numRowsPerStep rows high, and converts them
+	static void		convertBands( const ConvertBandFunction& convertBand, unsigned int height, unsigned int numRowsPerStep, const Options& options );
+	static void		convertRows( ImageConverterKernels::ConvertRowFunction convertRow, const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options );
+	static void		convertYUV420Rows( ImageConverterKernels::ConvertYUV420RowFunction convertRow, const ConstImageView& yuv420Image, const ImageView& destinationImage, const Options& options );
+	static void		convertRowPairsToYUV420( ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair, const ConstImageView& sourceImage, const ImageView& yuv420Image, const Options& options );
+
+	// Same, for the kernels that take the coefficients of a color matrix and range, or their YUVToRGBTables
+	template<class Function, class Coefficients>
+	static void		convertRows( Function convertRow, const Coefficients& coefficients, const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options );
+	template<class Function, class Coefficients>
+	static void		convertYUV420Rows( Function convertRow, const Coefficients& coefficients, const ConstImageView& yuv420Image, const ImageView& destinationImage, const Options& options );
+	static void		convertRowPairsToYUV420( ImageConverterKernels::ConvertColorRowPairToYUV420Function convertRowPair, const YUVCoefficients& coefficients, const ConstImageView& sourceImage, const ImageView& yuv420Image, const Options& options );
+
+	static const ImageConversionGraph&	getConversionGraph( const Options& options );
+
+	// Converts from the first format of the path to the last one, reallocating the intermediate images when their format changes
+	static bool		convertAlongPath( const std::vector<ImageFormat>& path, const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<Image*>& intermediateImages, const Options& options );
+	static void		deleteImages( std::vector<Image*>& images );
+
+	// Scales the source to the size of the destination, in its own encoding, then converts it. 
+	// The path goes from the scaled format to the destination one, and is planned again when it doesn't
+	enum { numRowsPerChunk = 16 };
+	static bool		scaleAndConvertImage( const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& scaledImage, std::vector<Image*>& intermediateImages, const Options& options );
+
+	// Same with the transform of the Options, the source being scaled as a whole first when the sizes differ
+	static bool		transformAndConvertImage( const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& transformedImage, Image*& scaledImage, std::vector<Image*>& intermediateImages, const Options& options );
+
+	// Converts an image produced band by band, by the scaler or the transformer, into the destination. 
+	// With a direct conversion, each chunk of chunkHeight rows is converted right after being produced, 
+	// while it's in the cache. The produced image is the destination itself when it has its format
+	typedef std::function<void (const ImageView& producedImage, unsigned int firstRow, unsigned int endRow)> ProduceRowsFunction;
+	static bool		produceAndConvertImage( const ProduceRowsFunction& produceRows, const ImageFormat& producedFormat, unsigned int chunkHeight, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& producedImage, std::vector<Image*>& intermediateImages, const Options& options );
+
 	Image*			mImage;
+	Options			mOptions;
+	std::vector<ImageFormat>	mPath;					// From the format of the last source image
+	std::vector<Image*>			mIntermediateImages;
+	Image*						mScaledImage;			// When the sizes differ
+	Image*						mTransformedImage;		// With a transform
 };
 
 }
\ No newline at end of file
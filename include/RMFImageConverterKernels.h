@@ -0,0 +1,264 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFCPUFeatures.h"
+#include "RMFImageFormat.h"
+#include "RMFYUVCoefficients.h"
+
+namespace RMF
+{
+
+/*
+	ImageConverterKernels
+
+	The row-level building blocks of the ImageConverter. Each kernel converts a single 
+	row of pixels, so the ImageConverter only deals with image-level checks and row 
+	addressing.
+
+	A kernel can have several implementations, one per instruction set. The scalar one 
+	is the reference: the SIMD ones produce exactly the same bytes, only faster. 
+	The implementation to use is picked at runtime, depending on what the processor 
+	supports (see CPUFeatures). 
+	
+	The x86 implementations live in their own source files, compiled with the 
+	corresponding compiler flags, so the rest of the library doesn't require these 
+	instruction sets.
+
+	The kernels reading the YUV 4:2:0 encodings take a row of each plane, the chroma 
+	rows being shared by two consecutive image rows. For NV12, the U and V rows are 
+	the interleaved chroma row: vRow is uRow+1. YV12 is read by the I420 kernels, with 
+	the U and V rows swapped.
+	The kernels writing them take two consecutive image rows at a time, and average 
+	their chroma.
+
+	The RGB kernels take the RGB encodings they work on as parameters (see 
+	ImageFormat::isRGB()). They are written once for all of them, as templates (see 
+	RGBKernels). A 4-byte destination gets an opaque alpha when the source has none.
+	The same goes for the packed 4:2:2 kernels and their YUYV, UYVY, YVYU and VYUY 
+	encodings (see ImageFormat::isPackedYUV422() and YUV422Layout). 
+	The GRAY8 kernels extract the luma of the YUV encodings: a byte gather with no color 
+	math, a plain copy of the Y row for the 4:2:0 encodings. 
+
+	The "color" kernels, between the YUV or gray encodings and the RGB ones, take the 
+	YUVCoefficients of the color matrix and range of their YUV side as a last parameter. 
+	The SIMD implementations set up their vectors of coefficients once per row.
+	The YUV to RGB ones also have a scalar "table" flavor, taking the YUVToRGBTables of these 
+	coefficients: lookups and additions replace the multiplications and the clipping branches. 
+	It is meant for the processors that have no SIMD implementation.
+
+	The scaling kernels are the building blocks of the ImageScaler, for the 8-bit samples. 
+	Their weights are fixed-point numbers, scaled by 1<<scaleWeightBits, and can be negative. 
+	scaleColumns() sums numTaps source rows, sample by sample, into a row of 16-bit sums keeping 
+	scaleExtraBits more bits than a byte. scaleRow() then sums, for each destination sample, 
+	the numTaps consecutive sums starting at its first index, and rounds them back to a byte. 
+	Its numTaps is a multiple of scaleRowTapAlignment, the weights being padded with zeros, 
+	so the SIMD implementations don't handle partial groups of taps.
+*/
+class ImageConverterKernels
+{
+public:
+	enum InstructionSet
+	{
+		ScalarInstructionSet,
+		SSSE3InstructionSet,
+		AVX2InstructionSet,
+		NEONInstructionSet,
+
+		InstructionSetCount
+	};
+
+	enum { scaleWeightBits = 14, scaleExtraBits = 6, scaleRowTapAlignment = 4 };
+
+	static bool					isInstructionSetSupported( InstructionSet instructionSet );
+	static InstructionSet		getBestInstructionSet();
+	static const char*			getInstructionSetName( InstructionSet instructionSet );
+
+	typedef void (*ConvertRowFunction)( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width );
+	typedef void (*ConvertYUV420RowFunction)( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width );
+	typedef void (*ConvertRowPairToYUV420Function)( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+													unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width );
+
+	// The same, for the kernels doing color math between the YUV (or gray) and RGB encodings
+	typedef void (*ConvertColorRowFunction)( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients );
+	typedef void (*ConvertYUV420ColorRowFunction)( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, 
+												   const YUVCoefficients& coefficients );
+	typedef void (*ConvertColorRowPairToYUV420Function)( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+														 unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width, 
+														 const YUVCoefficients& coefficients );
+
+	// The YUV to RGB kernels looking up their products in YUVToRGBTables, instead of multiplying
+	typedef void (*ConvertTableRowFunction)( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVToRGBTables& tables );
+	typedef void (*ConvertYUV420TableRowFunction)( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, 
+												   const YUVToRGBTables& tables );
+
+	// The scaling kernels. sourceRows has numTaps rows, weights has numTaps weights for the 
+	// scaleColumns() ones, numTaps per destination sample for the scaleRow() ones
+	typedef void (*ScaleColumnsFunction)( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples );
+	typedef void (*ScaleRowFunction)( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width );
+
+	// Return NULL when the kernel has no implementation for the instruction set, 
+	// or when the instruction set is not supported by the processor 
+	static ConvertColorRowFunction	getConvertYUYVRowToRGB24Function( InstructionSet instructionSet );
+	static ConvertColorRowFunction	getConvertYUYVRowToBGR24Function( InstructionSet instructionSet );
+	static ConvertRowFunction	getSwapFirstAndThirdBytesRowFunction( InstructionSet instructionSet );
+
+	static ConvertYUV420ColorRowFunction		getConvertNV12RowToRGB24Function( InstructionSet instructionSet );
+	static ConvertYUV420ColorRowFunction		getConvertNV12RowToBGR24Function( InstructionSet instructionSet );
+	static ConvertYUV420RowFunction		getConvertNV12RowToYUYVFunction( InstructionSet instructionSet );
+	static ConvertYUV420ColorRowFunction		getConvertI420RowToRGB24Function( InstructionSet instructionSet );
+	static ConvertYUV420ColorRowFunction		getConvertI420RowToBGR24Function( InstructionSet instructionSet );
+	static ConvertYUV420RowFunction		getConvertI420RowToYUYVFunction( InstructionSet instructionSet );
+	
+	// Scalar only for now
+	static ConvertRowPairToYUV420Function	getConvertYUYVRowPairToNV12Function( InstructionSet instructionSet );
+	static ConvertRowPairToYUV420Function	getConvertYUYVRowPairToI420Function( InstructionSet instructionSet );
+
+	// Also return NULL when an encoding is not of the expected kind, or when both are the same
+	static ConvertRowFunction		getConvertRGBRowFunction( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet );
+	static ConvertColorRowFunction		getConvertYUV422RowToRGBFunction( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertYUV420ColorRowFunction	getConvertNV12RowToRGBFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertYUV420ColorRowFunction	getConvertI420RowToRGBFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertColorRowFunction				getConvertRGBRowToYUV422Function( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToNV12Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToI420Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+
+	// Scalar only: the lookups are what the SIMD implementations avoid
+	static ConvertTableRowFunction			getConvertYUV422RowToRGBTableFunction( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertYUV420TableRowFunction	getConvertNV12RowToRGBTableFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertYUV420TableRowFunction	getConvertI420RowToRGBTableFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+
+	// Scalar only for now
+	static ConvertRowPairToYUV420Function	getConvertYUV422RowPairToNV12Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet );
+	static ConvertRowPairToYUV420Function	getConvertYUV422RowPairToI420Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet );
+	static ConvertRowFunction				getConvertYUV422RowToYUV422Function( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet );
+
+	static ConvertRowFunction		getConvertYUV422RowToGRAY8Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet );
+	static ConvertColorRowFunction		getConvertRGBRowToGRAY8Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+
+	// Scalar only: the 4:2:0 luma is a plain copy, and the gray sources are not vectorized yet
+	static ConvertYUV420RowFunction	getConvertYUV420RowToGRAY8Function( InstructionSet instructionSet );
+	static ConvertColorRowFunction		getConvertGRAYRowToRGBFunction( ImageFormat::Encoding grayEncoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet );
+	static ConvertRowFunction		getConvertGRAYRowToGRAYFunction( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet );
+
+	static ScaleColumnsFunction		getScaleColumnsFunction( InstructionSet instructionSet );
+	static ScaleRowFunction			getScaleRowFunction( InstructionSet instructionSet );
+
+	// Scalar implementations. With an odd width, the last pixel has the chroma of the last macroblock
+	static void					convertYUYVRowToRGB24( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertYUYVRowToBGR24( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToRGB24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToBGR24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToYUYV( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertI420RowToRGB24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToBGR24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToYUYV( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertYUYVRowPairToNV12( const unsigned char* yuyvRow0, const unsigned char* yuyvRow1, 
+														  unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width );
+	static void					convertYUYVRowPairToI420( const unsigned char* yuyvRow0, const unsigned char* yuyvRow1, 
+														  unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width );
+	static void					convertYUV420RowToGRAY8( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* gray8Row, unsigned int width );
+	static void					convertGRAY8RowToGRAY16( const unsigned char* gray8Row, unsigned char* gray16Row, unsigned int width );
+	static void					convertGRAY16RowToGRAY8( const unsigned char* gray16Row, unsigned char* gray8Row, unsigned int width );
+	static void					scaleColumns( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples );
+	static void					scaleRow( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width );
+
+	// Swaps the first and third bytes of each 3-byte pixel, which converts RGB24 to BGR24 and 
+	// the other way around. The source and destination rows can be the same (in-place swap)
+	static void					swapFirstAndThirdBytesRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width );
+
+#if defined(RMF_X86)
+	static void					convertYUYVRowToRGB24SSSE3( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertYUYVRowToBGR24SSSE3( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					swapFirstAndThirdBytesRowSSSE3( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width );
+	static void					convertNV12RowToRGB24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToBGR24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToYUYVSSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertI420RowToRGB24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToBGR24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToYUYVSSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertYUYVRowToRGB24AVX2( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertYUYVRowToBGR24AVX2( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					swapFirstAndThirdBytesRowAVX2( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width );
+	static void					convertNV12RowToRGB24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToBGR24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToYUYVAVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertI420RowToRGB24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToBGR24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToYUYVAVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					scaleColumnsSSSE3( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples );
+	static void					scaleRowSSSE3( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width );
+	static void					scaleColumnsAVX2( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples );
+	static void					scaleRowAVX2( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width );
+
+	// The instantiations of the RGB and packed 4:2:2 kernels, one getter per instruction set (no support check)
+	static ConvertRowFunction		getConvertRGBRowFunctionSSSE3( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding );
+	static ConvertColorRowFunction		getConvertYUV422RowToRGBFunctionSSSE3( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertNV12RowToRGBFunctionSSSE3( ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertI420RowToRGBFunctionSSSE3( ImageFormat::Encoding rgbEncoding );
+	static ConvertRowFunction		getConvertYUV422RowToGRAY8FunctionSSSE3( ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowFunction		getConvertRGBRowToGRAY8FunctionSSSE3( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowFunction		getConvertRGBRowToYUV422FunctionSSSE3( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToNV12FunctionSSSE3( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToI420FunctionSSSE3( ImageFormat::Encoding rgbEncoding );
+	static ConvertRowFunction		getConvertRGBRowFunctionAVX2( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding );
+	static ConvertColorRowFunction		getConvertYUV422RowToRGBFunctionAVX2( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertNV12RowToRGBFunctionAVX2( ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertI420RowToRGBFunctionAVX2( ImageFormat::Encoding rgbEncoding );
+	static ConvertRowFunction		getConvertYUV422RowToGRAY8FunctionAVX2( ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowFunction		getConvertRGBRowToGRAY8FunctionAVX2( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowFunction		getConvertRGBRowToYUV422FunctionAVX2( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToNV12FunctionAVX2( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToI420FunctionAVX2( ImageFormat::Encoding rgbEncoding );
+#endif
+
+#if defined(RMF_NEON)
+	static void					convertYUYVRowToRGB24NEON( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertYUYVRowToBGR24NEON( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					swapFirstAndThirdBytesRowNEON( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width );
+	static void					convertNV12RowToRGB24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToBGR24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertNV12RowToYUYVNEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					convertI420RowToRGB24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToBGR24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients );
+	static void					convertI420RowToYUYVNEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width );
+	static void					scaleColumnsNEON( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples );
+	static void					scaleRowNEON( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width );
+
+	static ConvertRowFunction		getConvertRGBRowFunctionNEON( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding );
+	static ConvertColorRowFunction		getConvertYUV422RowToRGBFunctionNEON( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertNV12RowToRGBFunctionNEON( ImageFormat::Encoding rgbEncoding );
+	static ConvertYUV420ColorRowFunction	getConvertI420RowToRGBFunctionNEON( ImageFormat::Encoding rgbEncoding );
+	static ConvertRowFunction		getConvertYUV422RowToGRAY8FunctionNEON( ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowFunction		getConvertRGBRowToGRAY8FunctionNEON( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowFunction		getConvertRGBRowToYUV422FunctionNEON( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToNV12FunctionNEON( ImageFormat::Encoding rgbEncoding );
+	static ConvertColorRowPairToYUV420Function	getConvertRGBRowPairToI420FunctionNEON( ImageFormat::Encoding rgbEncoding );
+#endif
+
+private:
+	static const char*			mInstructionSetNames[InstructionSetCount];
+};
+
+}
\ No newline at end of file
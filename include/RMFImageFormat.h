@@ -42,9 +42,24 @@ namespace RMF
 	The Image/ImageFormat system only support
 	- uncompressed data (no variable-length spatial/temporal compression like JPG, H264, etc...)
 	- non-paletized image
-	- pixel-oriented or "interleaved" data storage (as opposed to planar-oriented data) 
+	- pixel-oriented or "interleaved" data storage, and planar storage for the YUV 4:2:0 
+	  encodings (NV12, I420 and YV12)
+
+	The planes of a planar encoding are stored one after the other, the luma plane first. 
+	Its chroma planes have half the width and half the height of the image, so the 4:2:0 
+	encodings expect an even width and height (the chroma planes are rounded up otherwise). 
+	getNumBytesPerLine() is the size of a line of the first plane, getPlaneNumBytesPerLine() 
+	and getPlaneHeight() describe each plane. The other encodings have a single plane.
+	The packed 4:2:2 encodings store whole macroblocks: with an odd width, the last one holds 
+	the chroma of the last pixel and a padding luma.
 	
-	The concept of stride/padding is not supported.
+	The concept of stride/padding belongs to the Image, not to its format. 
+	getNumBytesPerLine() and getDataSizeInBytes() describe packed rows.
+
+	The color matrix and range say how the YUV (and gray) samples relate to RGB. They don't 
+	change the memory layout, only the conversions to and from the RGB encodings. BT.601 
+	in limited range is the default, and what most SD webcams output. The RGB encodings 
+	always have the default, whatever is passed to the constructor.
 
 	Some references:
 	http://en.wikipedia.org/wiki/Color_model
@@ -68,23 +83,92 @@ public:
 				// and U0 and V0 represent the chroma component of both pixels.
 				// Again quite popular in Media Foundation
 
+		NV12,	// 12 bits per pixel, in two planes. The first one is the luma: one Y byte per pixel.
+				// The second one holds the interleaved chroma bytes U0, V0, U1, V1... one pair for 
+				// each 2x2 block of pixels. The native encoding of many webcams and hardware codecs
+
+		I420,	// 12 bits per pixel, in three planes: Y, U then V. The chroma planes have one byte 
+				// for each 2x2 block of pixels. Also known as IYUV
+
+		YV12,	// Same as I420, except that the V plane comes before the U plane
+
+		RGBA32,	// 4 bytes per pixel. The byte sequence is: red, green, blue, alpha
+
+		BGRA32,	// 4 bytes per pixel. The byte sequence is: blue, green, red, alpha.
+				// This is Media Foundation's ARGB32 (a little-endian 0xAARRGGBB word)
+
+		ARGB32,	// 4 bytes per pixel. The byte sequence is: alpha, red, green, blue
+
+		BGRX32,	// 4 bytes per pixel. The byte sequence is: blue, green, red, then an unused byte, 
+				// written as 255 by the conversions. This is Media Foundation's RGB32, also 
+				// known as XRGB32 (a little-endian 0xXXRRGGBB word), and Qt's QImage::Format_RGB32.
+				// The 4-byte encodings keep every pixel aligned, which suits GPUs and SIMD code
+
+		UYVY,	// Same as YUYV with the byte sequence: U0, Y0, V0, Y1. Also known as Y422 or HDYC 
+				// (the BT.709 flavor), it is output by many capture cards and some webcams
+
+		YVYU,	// Same as YUYV with the byte sequence: Y0, V0, Y1, U0
+
+		VYUY,	// Same as YUYV with the byte sequence: V0, Y0, U0, Y1
+
+		GRAY8,	// 1 byte per pixel: the luma alone, as in the YUV encodings (16 is black and 235 white).
+				// Extracting it from a YUV encoding doesn't involve any color math. Also known as Y8 or Y800
+
+		GRAY16,	// 2 bytes per pixel: a little-endian 16-bit luma, as output by some depth or infrared 
+				// cameras. Converting from GRAY8 multiplies by 257, converting to GRAY8 keeps the high byte
+
 		EncodingCount	
 	};
 
+	enum { maxNumPlanes = 3 };
+
+	enum ColorMatrix
+	{
+		BT601,			// Standard definition. Also the matrix of JPEG, in full range
+		BT709,			// High definition
+		BT2020,			// Ultra high definition, the non-constant luminance flavor
+
+		ColorMatrixCount
+	};
+
+	enum ColorRange
+	{
+		LimitedRange,	// The luma goes from 16 to 235, the chroma from 16 to 240. Also known as "TV" or "studio" range
+		FullRange,		// All the samples go from 0 to 255, as in JPEG (and MJPEG) images. Also known as "PC" range
+
+		ColorRangeCount
+	};
+
 	ImageFormat();
-	ImageFormat( unsigned int width, unsigned int height, Encoding encoding );
+	ImageFormat( unsigned int width, unsigned int height, Encoding encoding, ColorMatrix colorMatrix=BT601, ColorRange colorRange=LimitedRange );
 
 	unsigned int			getWidth() const			{ return mWidth; }
 	unsigned int			getHeight() const			{ return mHeight; }
 	Encoding				getEncoding() const			{ return mEncoding; }
 	const char*				getEncodingName() const		{ return getEncodingName( getEncoding() ); }
 	static const char*		getEncodingName( Encoding encoding );
+	ColorMatrix				getColorMatrix() const		{ return mColorMatrix; }
+	ColorRange				getColorRange() const		{ return mColorRange; }
+	static const char*		getColorMatrixName( ColorMatrix colorMatrix );
+	static const char*		getColorRangeName( ColorRange colorRange );
 	
-	unsigned int			getNumBitsPerPixel() const		{ return getNumBitsPerPixel( getEncoding() ); }
+	unsigned int			getNumBitsPerPixel() const		{ return getNumBitsPerPixel( getEncoding() ); }		// On average for the planar encodings
 	static unsigned int		getNumBitsPerPixel( Encoding encoding );
-	unsigned int			getNumBytesPerLine() const		{ return getNumBitsPerPixel()*getWidth()/8; }	// Note: rounded to the upper byte?
+	unsigned int			getNumBytesPerLine() const		{ return getPlaneNumBytesPerLine(0); }
 	unsigned int			getDataSizeInBytes() const;
 
+	unsigned int			getNumPlanes() const			{ return getNumPlanes( getEncoding() ); }
+	static unsigned int		getNumPlanes( Encoding encoding );
+	bool					isPlanar() const				{ return getNumPlanes()>1; }
+	bool					isRGB() const					{ return isRGB( getEncoding() ); }		// One of the RGB24, BGR24 and 32-bit encodings
+	static bool				isRGB( Encoding encoding );
+	bool					isPackedYUV422() const			{ return isPackedYUV422( getEncoding() ); }		// One of YUYV, UYVY, YVYU and VYUY
+	static bool				isPackedYUV422( Encoding encoding );
+	bool					isGray() const					{ return isGray( getEncoding() ); }		// GRAY8 or GRAY16
+	static bool				isGray( Encoding encoding );
+	unsigned int			getPlaneNumBytesPerLine( unsigned int plane ) const;
+	unsigned int			getPlaneHeight( unsigned int plane ) const;
+
 	bool					operator==( const ImageFormat& other ) const;
 	bool					operator!=( const ImageFormat& other ) const;
 
@@ -94,10 +178,14 @@ private:
 	
 	static const char*		mEncodingNames[EncodingCount];
 	static unsigned int		mEncodingBitsPerPixel[EncodingCount];
+	static const char*		mColorMatrixNames[ColorMatrixCount];
+	static const char*		mColorRangeNames[ColorRangeCount];
 	
 	unsigned int			mWidth;
 	unsigned int			mHeight;
 	Encoding				mEncoding;
+	ColorMatrix				mColorMatrix;
+	ColorRange				mColorRange;
 };
 
 }
@@ -0,0 +1,162 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "RMFImageView.h"
+#include "RMFImageConverterKernels.h"
+#include "RMFThreadPool.h"
+
+namespace RMF
+{
+
+/*
+	ImageScaler
+
+	Scales images without changing their encoding. It takes all the encodings, and scales 
+	each component separately: the chroma of the YUV encodings keeps its subsampling and 
+	is sampled at the position of the pixels it covers, not shifted toward the left or top.
+
+	The scaler is separable: each destination sample is a weighted sum of source samples 
+	along the columns, then along the rows. The weights depend only on the sizes and the 
+	filter. They are fixed-point numbers, scaled by 1<<weightBits, computed once and kept in 
+	a cache shared by all the scalers, which holds the maxNumCachedCoefficients most recently 
+	used tables. Creating a scaler for each frame of a stream only costs a lookup.
+
+	The 8-bit samples are scaled by the scaling kernels of the ImageConverterKernels, with 
+	the instruction set given to the constructor: along the columns on whole rows of a plane, 
+	whatever their components, then along the rows, component by component. The components 
+	of the packed encodings are gathered into a row of their own first, and scattered back. 
+	GRAY16's samples don't fit the 16-bit sums of the kernels, it is scaled by scalar code.
+
+	scale() splits the image into bands, scaled in parallel when it is given a ThreadPool. 
+	scaleRows() scales a single band of destination rows, which lets the ImageConverter 
+	scale and convert an image piece by piece while it is in the cache.
+
+	The components are scaled independently, alpha included: the colors aren't premultiplied. 
+	The color matrix and range of the source are kept.
+*/
+class ImageScaler
+{
+public:
+	enum Filter
+	{
+		BoxFilter,			// Averages the source pixels covered by each destination pixel, by the area they cover. 
+							// Reads all the source pixels, and doesn't alias when downscaling. Also known as "area"
+		BilinearFilter,		// Interpolates the 2x2 source pixels around the center of each destination pixel. Reads 
+							// at most 4 source pixels per destination pixel, but aliases below half the size
+		NearestFilter,		// Takes the source pixel under the center of each destination pixel. The cheapest, 
+							// but blocky when upscaling and aliasing when downscaling
+		LanczosFilter,		// A sinc windowed over 3 lobes, stretched by the downscaling factor. The sharpest, 
+							// but the slowest: 6 taps per dimension when upscaling, more when downscaling. 
+							// It can ring around sharp edges
+
+		FilterCount
+	};
+
+	enum { weightBits = ImageConverterKernels::scaleWeightBits };
+	enum { maxNumCachedCoefficients = 32 };
+	enum { defaultMinBandHeight = 64 };		// In destination rows
+
+	// The instruction set of the kernels. The scalar ones are used when it isn't supported
+	ImageScaler( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, Filter filter, 
+				 ImageConverterKernels::InstructionSet instructionSet=ImageConverterKernels::getBestInstructionSet() );
+
+	const ImageFormat&	getSourceFormat() const			{ return mSourceFormat; }
+	const ImageFormat&	getDestinationFormat() const	{ return mDestinationFormat; }
+	Filter				getFilter() const				{ return mFilter; }
+	static const char*	getFilterName( Filter filter );
+
+	// The same encoding, and no empty image
+	static bool			canScale( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat );
+
+	// The images must have the encoding and sizes of the formats of the scaler
+	void				scale( const ConstImageView& sourceImage, const ImageView& destinationImage, ThreadPool* threadPool=NULL, unsigned int minBandHeight=defaultMinBandHeight ) const;
+
+	// Same, for a band of destination rows. It must start on an even row for the 4:2:0 encodings, 
+	// and end on one unless it's the last
+	void				scaleRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const;
+
+	static bool			scaleImage( const ConstImageView& sourceImage, const ImageView& destinationImage, Filter filter, ThreadPool* threadPool=NULL );
+
+private:
+	// The weights of the source samples making each destination sample, along one dimension. 
+	// There are numTaps of them per destination sample, from its first index. The filter's 
+	// taps stay within the source, the ones padding numTaps to a multiple of tapAlignment 
+	// have zero weights and can go past it
+	class Coefficients
+	{
+	public:
+		Coefficients( unsigned int sourceSize, unsigned int destinationSize, double scale, Filter filter, unsigned int tapAlignment );
+
+		bool						matches( unsigned int sourceSize, unsigned int destinationSize, double scale, Filter filter, unsigned int tapAlignment ) const;
+
+		unsigned int				sourceSize;
+		unsigned int				destinationSize;
+		double						scale;
+		Filter						filter;
+		unsigned int				tapAlignment;
+
+		unsigned int				numTaps;
+		std::vector<unsigned int>	firstIndices;
+		std::vector<short>			weights;
+	};
+
+	// From the cache, or computed and added to it
+	static std::shared_ptr<const Coefficients>	getCoefficients( unsigned int sourceSize, unsigned int destinationSize, double scale, Filter filter, unsigned int tapAlignment );
+
+	// Where the samples of a component are in the planes, and whether they are subsampled 
+	// in each direction
+	struct Component
+	{
+		unsigned int	plane;
+		unsigned int	offset;			// In samples (bytes, or words for GRAY16), from the start of the row
+		unsigned int	step;			// In samples, between two samples of the component
+		bool			isHorizontallySubsampled;
+		bool			isVerticallySubsampled;
+	};
+
+	static unsigned int	getComponents( ImageFormat::Encoding encoding, Component components[] );
+	static unsigned int	getComponentWidth( const ImageFormat& imageFormat, const Component& component );
+	static unsigned int	getComponentHeight( const ImageFormat& imageFormat, const Component& component );
+
+	// Scales the rows of a plane of 8-bit samples with the kernels, and the rows of a GRAY16 image
+	void				scaleBytePlaneRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int plane, unsigned int firstRow, unsigned int endRow ) const;
+	void				scaleGRAY16Rows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const;
+
+	enum { maxNumComponents = 4 };
+
+	static const char*	mFilterNames[FilterCount];
+
+	ImageFormat			mSourceFormat;
+	ImageFormat			mDestinationFormat;
+	Filter				mFilter;
+	ImageConverterKernels::ScaleColumnsFunction		mScaleColumns;
+	ImageConverterKernels::ScaleRowFunction			mScaleRow;
+	std::shared_ptr<const Coefficients>	mHorizontalCoefficients[2];		// For the full-resolution components, then the subsampled ones
+	std::shared_ptr<const Coefficients>	mVerticalCoefficients[2];
+};
+
+}
@@ -0,0 +1,149 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFImageView.h"
+#include "RMFThreadPool.h"
+
+namespace RMF
+{
+
+/*
+	ImageTransformer
+
+	Flips, rotates and transposes images without changing their encoding, which is all the 
+	ways of turning an image by multiples of 90 degrees and mirroring it. This is what 
+	compensates for a camera mounted sideways or upside down, or for a bottom-up image. 
+
+	Each destination pixel is copied from a source pixel: the transforms are lossless, 
+	except for the packed 4:2:2 encodings when the rows and columns are swapped. Their 
+	chroma is shared by two horizontal pixels, which come from two rows of the source: 
+	it is averaged, rounding up. These need an even height, the destination's width. 
+	The 4:2:0 encodings are transformed plane by plane, their chroma following the luma. 
+
+	The transforms swapping the rows and the columns read the source by columns. They go 
+	through the image by square tiles of tileSize pixels, so the source rows of a tile stay 
+	in the cache while the destination rows are written, instead of being read again for 
+	each destination row. 
+
+	transform() splits the image into bands, transformed in parallel when it is given a 
+	ThreadPool. transformRows() transforms a single band of destination rows, which lets the 
+	ImageConverter transform and convert an image piece by piece while it is in the cache 
+	(see ImageConverter::Options::transform). 
+
+	The flips and the half-turn can also be done in place, on the calling thread. 
+	The others can't: the source and destination images must not overlap. 
+	cropImage() copies a rectangle of an image, see ImageView::getRegion() to crop it 
+	without copying.
+*/
+class ImageTransformer
+{
+public:
+	enum Transform
+	{
+		Identity,
+		FlipHorizontally,		// Mirrors the image left to right
+		FlipVertically,			// Mirrors the image top to bottom. Turns a bottom-up image into a top-down one
+		Rotate90,				// A quarter turn clockwise: the bottom-left pixel goes to the top-left corner
+		Rotate180,				// A half turn. Same as both flips
+		Rotate270,				// A quarter turn counterclockwise: the top-right pixel goes to the top-left corner
+		Transpose,				// Mirrors the image around its top-left to bottom-right diagonal
+		Transverse,				// Mirrors the image around its top-right to bottom-left diagonal
+
+		TransformCount
+	};
+
+	enum { tileSize = 32 };					// In pixels
+	enum { defaultMinBandHeight = 64 };		// In destination rows
+
+	ImageTransformer( const ImageFormat& sourceFormat, Transform transform );
+
+	const ImageFormat&	getSourceFormat() const			{ return mSourceFormat; }
+	const ImageFormat&	getDestinationFormat() const	{ return mDestinationFormat; }
+	Transform			getTransform() const			{ return mTransform; }
+	static const char*	getTransformName( Transform transform );
+
+	// The quarter turns and the transpositions
+	static bool			swapsRowsAndColumns( Transform transform );
+
+	// The format of the transformed image: the width and height are swapped when the transform swaps the rows and columns
+	static ImageFormat	getTransformedFormat( const ImageFormat& sourceFormat, Transform transform );
+
+	// The destination must have the transformed format
+	static bool			canTransform( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, Transform transform );
+	static bool			canTransformInPlace( const ImageFormat& imageFormat, Transform transform );
+
+	// The images must have the encoding and sizes of the formats of the transformer
+	void				transform( const ConstImageView& sourceImage, const ImageView& destinationImage, ThreadPool* threadPool=NULL, unsigned int minBandHeight=defaultMinBandHeight ) const;
+
+	// Same, for a band of destination rows. It must start on an even row for the 4:2:0 encodings, 
+	// and end on one unless it's the last
+	void				transformRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const;
+
+	static bool			transformImage( const ConstImageView& sourceImage, const ImageView& destinationImage, Transform transform, ThreadPool* threadPool=NULL );
+	static bool			transformImageInPlace( const ImageView& image, Transform transform );
+
+	// Copies the rectangle of the source starting at (x, y), of the size of the destination. 
+	// It must be a valid region of the source (see ImageView::isValidRegion())
+	static bool			cropImage( const ConstImageView& sourceImage, unsigned int x, unsigned int y, const ImageView& destinationImage );
+
+private:
+	// Where each destination pixel is taken from in the source: at the origin for the top-left 
+	// one, then moving by a pixel in the source for each step along a destination row or column. 
+	// The origin is a corner of the source, given by its sides: 0 for the left or top one, 
+	// 1 for the right or bottom one. The steps are -1, 0 or 1 in each dimension
+	struct Mapping
+	{
+		int			originX;
+		int			originY;
+		int			columnStepX;			// For the next pixel of a destination row
+		int			columnStepY;
+		int			rowStepX;				// For the next destination row
+		int			rowStepY;
+	};
+
+	// The same mapping, for the bytes of a plane whose samples are numBytes wide
+	struct PlaneMapping
+	{
+		const unsigned char*	origin;
+		std::ptrdiff_t			columnStep;
+		std::ptrdiff_t			rowStep;
+	};
+
+	PlaneMapping		getPlaneMapping( const ConstImageView& sourceImage, unsigned int plane, unsigned int width, unsigned int height, unsigned int numBytes ) const;
+
+	// Transform the destination rows [firstRow, endRow) of a plane, and of a packed 4:2:2 image 
+	// whose rows and columns are swapped
+	void				transformPlaneRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int plane, unsigned int firstRow, unsigned int endRow ) const;
+	void				transformYUV422Rows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const;
+
+	static const char*	mTransformNames[TransformCount];
+	static const Mapping mMappings[TransformCount];
+
+	ImageFormat			mSourceFormat;
+	ImageFormat			mDestinationFormat;
+	Transform			mTransform;
+};
+
+}
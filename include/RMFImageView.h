@@ -0,0 +1,149 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include "RMFImageFormat.h"
+
+namespace RMF
+{
+
+class Image;
+
+/*
+	ImageRegion
+
+	A rectangle of pixels of an image, from its top-left pixel. 
+	See ImageView::getRegion() and ImageConverter::convertRegions()
+*/
+class ImageRegion
+{
+public:
+	ImageRegion()
+		: x(0), y(0), width(0), height(0) {}
+	ImageRegion( unsigned int regionX, unsigned int regionY, unsigned int regionWidth, unsigned int regionHeight )
+		: x(regionX), y(regionY), width(regionWidth), height(regionHeight) {}
+
+	bool			operator==( const ImageRegion& other ) const	{ return x==other.x && y==other.y && width==other.width && height==other.height; }
+	bool			operator!=( const ImageRegion& other ) const	{ return !( *this==other ); }
+
+	unsigned int	x;
+	unsigned int	y;
+	unsigned int	width;
+	unsigned int	height;
+};
+
+/*
+	ImageView and ConstImageView
+
+	Non-owning views over pixels that live somewhere else: in an Image, in a CapturedFrame 
+	or in memory owned by a third party (a QImage, a memory-mapped file, a locked 
+	IMFMediaBuffer...). A view is made of an ImageFormat, the address of the top row and 
+	a stride, with the same meaning as in Image: negative for bottom-up images, larger 
+	than a line for padded rows. A stride of zero means packed top-down rows.
+
+	The planes of a planar image are located like in an Image, one after the other, unless 
+	the address of the top row and the stride of each plane are given separately. 
+
+	The conversion and transform functions take views, and Images convert to views 
+	implicitly, so third-party memory can be processed without being copied into an Image.
+	getRows() narrows a view to a band of rows, to process an image piece by piece, and 
+	getRegion() to a rectangle, to crop it without copying anything.
+	
+	A view is cheap to copy, but it must not outlive the memory it points to. 
+	An ImageView allows modifying the pixels, a ConstImageView doesn't. 
+*/
+class ImageView
+{
+public:
+	ImageView();
+	ImageView( const ImageFormat& imageFormat, unsigned char* topRow, int stride=0 );
+	ImageView( const ImageFormat& imageFormat, unsigned char* const planeTopRows[], const int planeStrides[] );
+	ImageView( Image& image );
+
+	const ImageFormat&		getFormat() const					{ return mFormat; }
+	int						getStride() const					{ return mPlaneStrides[0]; }
+	bool					isBottomUp() const					{ return mPlaneStrides[0]<0; }
+	bool					hasPackedRows() const;
+	bool					isNull() const						{ return mPlaneTopRows[0]==NULL; }
+	unsigned char*			getRow( unsigned int y ) const		{ return getPlaneRow( 0, y ); }
+
+	int						getPlaneStride( unsigned int plane ) const						{ return mPlaneStrides[plane]; }
+	unsigned char*			getPlaneRow( unsigned int plane, unsigned int y ) const		{ return mPlaneTopRows[plane] + static_cast<std::ptrdiff_t>(y) * mPlaneStrides[plane]; }
+
+	// The rows [firstRow, endRow) of the image. The first row must be even for the 4:2:0 encodings
+	ImageView				getRows( unsigned int firstRow, unsigned int endRow ) const;
+
+	// A rectangle of the image. It must be valid, see isValidRegion()
+	ImageView				getRegion( const ImageRegion& region ) const;
+
+	// Within the image, and aligned on the chroma samples: x and y must be even for the 4:2:0 
+	// encodings, x for the packed 4:2:2 ones
+	static bool				isValidRegion( const ImageFormat& imageFormat, const ImageRegion& region );
+
+	// The smallest valid region containing the given one, clipped to the image. When the region is 
+	// converted to another encoding, its width is also made even if either encoding is a 4:2:0 or 
+	// 4:2:2 one, and its height if the destination is a 4:2:0 one, so it has whole chroma samples. 
+	// Only the sides of the image can stay odd
+	static ImageRegion		alignRegion( const ImageFormat& imageFormat, const ImageRegion& region );
+	static ImageRegion		alignRegion( const ImageFormat& imageFormat, ImageFormat::Encoding destinationEncoding, const ImageRegion& region );
+
+	// Copy the pixels of a view of the same format, whatever their strides
+	bool					copyFrom( const class ConstImageView& other ) const;
+
+private:
+	ImageFormat				mFormat;
+	unsigned char*			mPlaneTopRows[ImageFormat::maxNumPlanes];
+	int						mPlaneStrides[ImageFormat::maxNumPlanes];
+};
+
+class ConstImageView
+{
+public:
+	ConstImageView();
+	ConstImageView( const ImageFormat& imageFormat, const unsigned char* topRow, int stride=0 );
+	ConstImageView( const ImageFormat& imageFormat, const unsigned char* const planeTopRows[], const int planeStrides[] );
+	ConstImageView( const Image& image );
+	ConstImageView( const ImageView& view );
+
+	const ImageFormat&		getFormat() const					{ return mFormat; }
+	int						getStride() const					{ return mPlaneStrides[0]; }
+	bool					isBottomUp() const					{ return mPlaneStrides[0]<0; }
+	bool					hasPackedRows() const;
+	bool					isNull() const						{ return mPlaneTopRows[0]==NULL; }
+	const unsigned char*	getRow( unsigned int y ) const		{ return getPlaneRow( 0, y ); }
+
+	int						getPlaneStride( unsigned int plane ) const						{ return mPlaneStrides[plane]; }
+	const unsigned char*	getPlaneRow( unsigned int plane, unsigned int y ) const		{ return mPlaneTopRows[plane] + static_cast<std::ptrdiff_t>(y) * mPlaneStrides[plane]; }
+
+	ConstImageView			getRows( unsigned int firstRow, unsigned int endRow ) const;
+	ConstImageView			getRegion( const ImageRegion& region ) const;
+
+private:
+	ImageFormat				mFormat;
+	const unsigned char*	mPlaneTopRows[ImageFormat::maxNumPlanes];
+	int						mPlaneStrides[ImageFormat::maxNumPlanes];
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <mfapi.h>
+#include <mfidl.h>
+#include "RMFCOMObjectSharedPtr.h"
+#include "RMFCapturedFrame.h"
+
+namespace RMF
+{
+
+/*
+	MediaFoundationCapturedFrame
+
+	A CapturedFrame pointing directly into the IMFMediaBuffer of a Media Foundation sample.
+	The buffer stays locked, and out of the hands of the SourceReader, until the frame 
+	is destroyed.
+
+	When the buffer supports the IMF2DBuffer interface, it is locked through it, which 
+	gives the actual pitch of its rows. Otherwise, the rows are located using the default 
+	stride of the MediaType.
+	http://msdn.microsoft.com/en-us/library/windows/desktop/aa473821(v=vs.85).aspx
+*/
+class MediaFoundationCapturedFrame : public CapturedFrame
+{
+public:
+	// Return NULL if the buffer can't be locked or is too small for the image format
+	static MediaFoundationCapturedFrame*	create( const ImageFormat& imageFormat, const COMObjectSharedPtr<IMFMediaBuffer>& mediaBuffer, 
+													LONG defaultStride, unsigned int sequenceNumber, LONGLONG timestamp );
+
+protected:
+	MediaFoundationCapturedFrame( const ImageFormat& imageFormat, const COMObjectSharedPtr<IMFMediaBuffer>& mediaBuffer );
+	virtual ~MediaFoundationCapturedFrame();
+
+	bool									lock( LONG defaultStride );
+
+private:
+	COMObjectSharedPtr<IMFMediaBuffer>		mMediaBuffer;
+	COMObjectSharedPtr<IMF2DBuffer>			m2DBuffer;			// Set when the buffer is locked as a 2D buffer
+	bool									mIsLocked;
+};
+
+}
\ No newline at end of file
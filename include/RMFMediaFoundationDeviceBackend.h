@@ -0,0 +1,75 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include "RMFDeviceBackend.h"
+#include "RMFDeviceInternals.h"
+
+namespace RMF
+{
+
+/*
+	MediaFoundationDeviceBackend
+
+	Exposes a DeviceInternals (a Media Foundation SourceReader on a video capture device)
+	as a DeviceBackend. Only the MediaTypes our Image class can handle are turned into 
+	CaptureSettings.
+
+	The samples are shared as MediaFoundationCapturedFrames in zero-copy mode. Otherwise 
+	they are copied top row first as they arrive, so bottom-up MediaTypes don't need to be 
+	flipped afterwards, and given back to the SourceReader right away.
+
+	The queued frames are always such copies, in frames allocated when the capture starts: 
+	the SourceReader only has a few samples, the queue never holds on to them whatever its depth.
+*/
+class MediaFoundationDeviceBackend : public DeviceBackend
+{
+public:
+	MediaFoundationDeviceBackend( const COMObjectSharedPtr<IMFActivate>& activate, const std::string& name );
+	virtual ~MediaFoundationDeviceBackend();
+
+	virtual const CaptureSettingsList&	getSupportedCaptureSettingsList() const	{ return mSupportedCaptureSettingsList; }
+
+	virtual bool						startCapture( std::size_t captureSettingsIndex );
+	virtual void						stopCapture();
+	virtual bool						isCapturing() const;
+
+	virtual unsigned int				getCapturedImageSequenceNumber() const;
+	virtual bool						getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const;
+	virtual CapturedFrame*				acquireCapturedFrame( std::size_t captureSettingsIndex ) const;
+	virtual bool						setZeroCopyEnabled( bool enabled );
+
+	virtual bool						setFrameQueueDepth( std::size_t depth );
+	virtual std::size_t					getFrameQueueDepth() const;
+	virtual CapturedFrame*				popCapturedFrame();
+	virtual unsigned int				getNumDroppedFrames() const;
+
+private:
+	DeviceInternals*					mInternals;
+	CaptureSettingsList					mSupportedCaptureSettingsList;
+	std::vector<std::size_t>			mMediaTypeIndices;				// For each CaptureSettings, contains the index of the corresponding MediaType
+};
+
+}
\ No newline at end of file
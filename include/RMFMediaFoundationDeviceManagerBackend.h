@@ -0,0 +1,73 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+
+#include <mfapi.h>
+#include <mfidl.h>
+#include "RMFCOMObjectSharedPtr.h"
+#include "RMFDeviceManagerBackend.h"
+
+namespace RMF
+{
+
+/*
+	MediaFoundationDeviceManagerBackend
+
+	Enumerates the video capture devices through Media Foundation and watches 
+	for devices being plugged or unplugged.
+	Creating an instance initializes COM and Media Foundation, deleting it shuts them down.
+*/
+class MediaFoundationDeviceManagerBackend : public DeviceManagerBackend
+{
+public:
+	MediaFoundationDeviceManagerBackend();
+	virtual ~MediaFoundationDeviceManagerBackend();
+
+	virtual bool			hasDeviceListChanged() const	{ return mDeviceListChanged; }
+	virtual void			enumerateDevices( DeviceDescriptions& descriptions );
+	virtual DeviceBackend*	createDeviceBackend( const DeviceDescription& description );
+
+protected:
+	static void		wideCharStringToMultiByteString( const wchar_t* wideCharString, std::string& multiByteString );
+
+	static void		getName( const IMFActivate* activate, std::string& name );
+	static void		getSymbolicLink( const IMFActivate* activate, std::string& symbolicLink );
+	
+	typedef std::vector< COMObjectSharedPtr<IMFActivate> > IMFActivates;
+	static void		enumerateActivates( IMFActivates& activates );
+
+	static LRESULT CALLBACK wndProcHook( int nCode, WPARAM wParam, LPARAM lParam );
+
+private:
+	bool			mDeviceListChanged;
+	IMFActivates	mActivates;			// The result of the last enumeration
+
+	typedef std::vector< MediaFoundationDeviceManagerBackend* > Instances;
+	static Instances mInstances;
+	static HHOOK	mHookHandle;
+};
+
+}
\ No newline at end of file
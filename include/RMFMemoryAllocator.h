@@ -0,0 +1,84 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+
+namespace RMF
+{
+
+/*
+	MemoryAllocator
+
+	Allocates the memory of the MemoryBuffers, aligned on any power of two and 
+	optionally backed by huge pages, which cover a whole image with a few TLB 
+	entries instead of hundreds:
+	- TransparentHugePages is a hint. On Linux, the memory is aligned on a huge page 
+	  and the kernel is advised to back it with huge pages (madvise). It only applies 
+	  to blocks of at least one huge page, and does nothing on the other systems.
+	- ExplicitHugePages asks the system for huge pages (mmap with MAP_HUGETLB on 
+	  Linux, VirtualAlloc with MEM_LARGE_PAGES on Windows). This fails when none 
+	  is reserved, or on Windows without the "Lock pages in memory" privilege, in 
+	  which case it falls back to TransparentHugePages.
+	The Allocation tells which kind of pages was actually obtained.
+*/
+class MemoryAllocator
+{
+public:
+	enum Pages
+	{
+		DefaultPages,
+		TransparentHugePages,
+		ExplicitHugePages
+	};
+
+	class Allocation
+	{
+	public:
+		Allocation();
+		unsigned char*		bytes;
+		unsigned int		sizeInBytes;
+		unsigned int		alignment;
+		Pages				requestedPages;
+		Pages				pages;				// What was obtained
+		std::size_t			mappedSizeInBytes;	// For explicit huge pages, rounded up to whole pages
+	};
+
+	static const unsigned int defaultAlignment = 64;	// A cache line, enough for the aligned loads of any SIMD instruction set we use
+
+	// The alignment must be a power of two. Return false if the memory couldn't be allocated at all
+	static bool				allocate( unsigned int sizeInBytes, unsigned int alignment, Pages pages, Allocation& allocation );
+	static void				deallocate( Allocation& allocation );
+
+	static bool				isAligned( const void* address, unsigned int alignment )	{ return ( reinterpret_cast<std::size_t>(address) & (alignment-1) )==0; }
+	
+	// The size of a huge page, zero if the system doesn't have any
+	static std::size_t		getHugePageSize();
+
+private:
+	static bool				allocateAligned( unsigned int sizeInBytes, unsigned int alignment, Allocation& allocation );
+	static bool				allocateExplicitHugePages( unsigned int sizeInBytes, Allocation& allocation );
+};
+
+}
\ No newline at end of file
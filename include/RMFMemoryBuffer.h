@@ -23,20 +23,49 @@
 */
 #pragma once
 
+#include "RMFMemoryAllocator.h"
+
 namespace RMF
 {
 
+class MemoryBufferPool;
+
+/*
+	MemoryBuffer
+
+	A block of bytes allocated at construction. By default the memory comes from 
+	the heap and is zero-filled. The Options can instead draw it from a 
+	MemoryBufferPool, where it returns when the buffer is destroyed, and skip the 
+	zero-filling when the contents are about to be overwritten anyway.
+
+	The bytes are aligned on 64 bytes by default, so the SIMD kernels can use 
+	aligned loads. The Options can also ask for huge pages, see MemoryAllocator.
+*/
 class MemoryBuffer
 {
 public:
+	class Options
+	{
+	public:
+		Options();
+		bool				zeroFill;
+		MemoryBufferPool*	pool;			// Not owned. NULL to allocate from the heap
+		unsigned int		alignment;		// In bytes, a power of two
+		MemoryAllocator::Pages pages;
+	};
+
 	MemoryBuffer();
 	MemoryBuffer( unsigned int sizeInBytes );
-	MemoryBuffer( const MemoryBuffer& other );
+	MemoryBuffer( unsigned int sizeInBytes, const Options& options );
+	MemoryBuffer( const MemoryBuffer& other );		// Allocated like the other buffer
 	~MemoryBuffer();	
 
 	unsigned int			getSizeInBytes() const	{ return mSizeInBytes; }
 	const unsigned char*	getBytes() const		{ return mBytes; }
 	unsigned char*			getBytes()				{ return mBytes; }
+
+	unsigned int			getAlignment() const	{ return mAllocation.alignment; }
+	MemoryAllocator::Pages	getPages() const		{ return mAllocation.pages; }		// The pages obtained, which may not be the ones requested
 	
 	void					fill( char value );
 	bool					copyFrom( const MemoryBuffer& other );
@@ -44,8 +73,12 @@ public:
 private:
 	MemoryBuffer& operator=( const MemoryBuffer& other );	// Not implemented on purpose
 
+	void					allocate( unsigned int alignment, MemoryAllocator::Pages pages );
+
 	unsigned char*			mBytes;
 	unsigned int			mSizeInBytes;
+	MemoryBufferPool*		mPool;
+	MemoryAllocator::Allocation mAllocation;
 };
 
 }
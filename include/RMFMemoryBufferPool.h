@@ -0,0 +1,88 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include "RMFCriticalSection.h"
+#include "RMFMemoryAllocator.h"
+
+namespace RMF
+{
+
+/*
+	MemoryBufferPool
+
+	Keeps the memory of released MemoryBuffers so the next buffers of the same size, 
+	alignment and kind of pages reuse it instead of going back to the allocator. Restarting a capture or recreating 
+	a converter with the same format then gets memory that is already mapped, instead 
+	of fresh pages the system has to fault in one by one.
+
+	The pool only retains up to getMaxNumBytes() of free memory: when a buffer is 
+	released beyond that, the least recently released memory is given back to the 
+	system first. It is thread-safe, buffers can be allocated and released from any 
+	thread.
+
+	The pool must outlive the buffers allocated from it. The default pool, used by 
+	the Device and the ImageConverter, is never destroyed.
+*/
+class MemoryBufferPool
+{
+public:
+	MemoryBufferPool( std::size_t maxNumBytes=defaultMaxNumBytes );
+	~MemoryBufferPool();
+
+	static MemoryBufferPool&	getDefault();
+
+	// The memory is not initialized. See MemoryAllocator
+	bool						allocate( unsigned int sizeInBytes, unsigned int alignment, MemoryAllocator::Pages pages, MemoryAllocator::Allocation& allocation );
+	void						release( MemoryAllocator::Allocation& allocation );
+
+	std::size_t					getMaxNumBytes() const;
+	void						setMaxNumBytes( std::size_t maxNumBytes );
+	std::size_t					getNumBytes() const;				// Retained, free
+	void						clear();							// Give all the retained memory back to the system
+
+	unsigned int				getNumAllocations() const;
+	unsigned int				getNumReusedAllocations() const;	// The allocations served by retained memory
+
+	static const std::size_t	defaultMaxNumBytes = 128 * 1024 * 1024;
+
+private:
+	MemoryBufferPool( const MemoryBufferPool& other );				// Not implemented on purpose
+	MemoryBufferPool& operator=( const MemoryBufferPool& other );	// Not implemented on purpose
+
+	void						trim( std::size_t maxNumBytes );
+
+	typedef std::list<MemoryAllocator::Allocation> Blocks;
+
+	mutable CriticalSection		mCriticalSection;
+	Blocks						mBlocks;							// From the least to the most recently released
+	std::size_t					mNumBytes;
+	std::size_t					mMaxNumBytes;
+	unsigned int				mNumAllocations;
+	unsigned int				mNumReusedAllocations;
+};
+
+}
\ No newline at end of file
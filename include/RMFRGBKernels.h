@@ -0,0 +1,454 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include "RMFImageFormat.h"
+#include "RMFYUVCoefficients.h"
+
+namespace RMF
+{
+
+/*
+	RGBLayout
+
+	Where the components of a pixel are, for each RGB encoding, as compile-time constants. 
+	This lets the kernels be written once for all the RGB encodings.
+	
+	alpha is the index of the 4th byte of the 4-byte encodings, -1 for the 3-byte ones.
+	When the encoding has no alpha (BGRX32), this byte is ignored when reading and 
+	written as 255, like the alpha of a destination whose source has no alpha.
+*/
+template<ImageFormat::Encoding encoding> struct RGBLayout;
+
+template<> struct RGBLayout<ImageFormat::RGB24>		{ enum { numBytes=3, red=0, green=1, blue=2, alpha=-1, hasAlpha=false }; };
+template<> struct RGBLayout<ImageFormat::BGR24>		{ enum { numBytes=3, red=2, green=1, blue=0, alpha=-1, hasAlpha=false }; };
+template<> struct RGBLayout<ImageFormat::RGBA32>	{ enum { numBytes=4, red=0, green=1, blue=2, alpha=3, hasAlpha=true }; };
+template<> struct RGBLayout<ImageFormat::BGRA32>	{ enum { numBytes=4, red=2, green=1, blue=0, alpha=3, hasAlpha=true }; };
+template<> struct RGBLayout<ImageFormat::ARGB32>	{ enum { numBytes=4, red=1, green=2, blue=3, alpha=0, hasAlpha=true }; };
+template<> struct RGBLayout<ImageFormat::BGRX32>	{ enum { numBytes=4, red=2, green=1, blue=0, alpha=3, hasAlpha=false }; };
+
+// Calls selector.select<encoding>() for a runtime RGB encoding, which turns it into a template 
+// argument. Returns a default Result (NULL for a function pointer) for the other encodings
+template<class Selector>
+typename Selector::Result selectRGBEncoding( const Selector& selector, ImageFormat::Encoding encoding )
+{
+	switch ( encoding )
+	{
+		case ImageFormat::RGB24:	return selector.template select<ImageFormat::RGB24>();
+		case ImageFormat::BGR24:	return selector.template select<ImageFormat::BGR24>();
+		case ImageFormat::RGBA32:	return selector.template select<ImageFormat::RGBA32>();
+		case ImageFormat::BGRA32:	return selector.template select<ImageFormat::BGRA32>();
+		case ImageFormat::ARGB32:	return selector.template select<ImageFormat::ARGB32>();
+		case ImageFormat::BGRX32:	return selector.template select<ImageFormat::BGRX32>();
+		default:					return typename Selector::Result();
+	}
+}
+
+/*
+	YUV422Layout
+
+	Where the components of a 2-pixel macroblock are, for each packed 4:2:2 encoding, as 
+	compile-time constants: the byte offsets of the luma of both pixels and of their shared 
+	chroma. Like RGBLayout, this lets the kernels be written once for all these encodings.
+*/
+template<ImageFormat::Encoding encoding> struct YUV422Layout;
+
+template<> struct YUV422Layout<ImageFormat::YUYV>	{ enum { y0=0, u=1, y1=2, v=3 }; };
+template<> struct YUV422Layout<ImageFormat::UYVY>	{ enum { y0=1, u=0, y1=3, v=2 }; };
+template<> struct YUV422Layout<ImageFormat::YVYU>	{ enum { y0=0, u=3, y1=2, v=1 }; };
+template<> struct YUV422Layout<ImageFormat::VYUY>	{ enum { y0=1, u=2, y1=3, v=0 }; };
+
+// The selectRGBEncoding() counterpart for the packed 4:2:2 encodings
+template<class Selector>
+typename Selector::Result selectYUV422Encoding( const Selector& selector, ImageFormat::Encoding encoding )
+{
+	switch ( encoding )
+	{
+		case ImageFormat::YUYV:		return selector.template select<ImageFormat::YUYV>();
+		case ImageFormat::UYVY:		return selector.template select<ImageFormat::UYVY>();
+		case ImageFormat::YVYU:		return selector.template select<ImageFormat::YVYU>();
+		case ImageFormat::VYUY:		return selector.template select<ImageFormat::VYUY>();
+		default:					return typename Selector::Result();
+	}
+}
+
+// The offsets of YUV422Layout at runtime, for the code that is not templated
+struct YUV422Offsets
+{
+	unsigned int y0, u, y1, v;
+};
+
+struct YUV422OffsetsSelector
+{
+	typedef YUV422Offsets Result;
+	template<ImageFormat::Encoding encoding> Result select() const
+	{
+		typedef YUV422Layout<encoding> Layout;
+		Result offsets = { Layout::y0, Layout::u, Layout::y1, Layout::v };
+		return offsets;
+	}
+};
+
+// All zeros for the other encodings
+inline YUV422Offsets getYUV422Offsets( ImageFormat::Encoding encoding )
+{
+	return selectYUV422Encoding( YUV422OffsetsSelector(), encoding );
+}
+
+/*
+	RGBKernels
+
+	The scalar kernels working on any RGB encoding, as templates. ImageConverterKernels 
+	instantiates them for its scalar implementations, and its SIMD implementations use 
+	them for the pixels left at the end of the rows.
+	
+	The YUV <-> RGB conversions use the fixed-point formulas of YUVCoefficients, for the color 
+	matrix and range they are given, and the packed 4:2:2 ones work on any of these encodings 
+	through YUV422Layout. The YUV to RGB ones have an overload taking YUVToRGBTables instead, 
+	which gives the same bytes. GRAY8 is the luma of these formulas: it is gathered as is from the 
+	YUV encodings, and converted like a YUV pixel with a neutral chroma to the RGB encodings. 
+	The RGB to YUV ones average the chroma of the pixels sharing it, rounding up. 
+	With an odd width, the last pixel has a chroma of its own: the YUV to RGB kernels convert 
+	it alone, the RGB to YUV ones give it its own chroma, averaged with the pixel below it for 
+	the 4:2:0 encodings. The padding luma of the last packed 4:2:2 macroblock repeats its luma.
+*/
+class RGBKernels
+{
+public:
+	static unsigned char clip( int value )		{ return value<0 ? 0 : ( value>255 ? 255 : static_cast<unsigned char>(value) ); }
+
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertPixel( const unsigned char* sourceBytes, unsigned char* destBytes )
+	{
+		typedef RGBLayout<source> Source;
+		typedef RGBLayout<destination> Destination;
+		unsigned char red = sourceBytes[Source::red];
+		unsigned char green = sourceBytes[Source::green];
+		unsigned char blue = sourceBytes[Source::blue];
+		destBytes[Destination::red] = red;
+		destBytes[Destination::green] = green;
+		destBytes[Destination::blue] = blue;
+		if ( Destination::numBytes==4 )
+			destBytes[Destination::alpha] = Source::hasAlpha && Destination::hasAlpha ? sourceBytes[Source::alpha] : 255;
+	}
+
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertRGBRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+	{
+		for ( unsigned int i=0; i<width; ++i )
+			convertPixel<source, destination>( sourceRow + i*RGBLayout<source>::numBytes, destinationRow + i*RGBLayout<destination>::numBytes );
+	}
+
+	// Converts two horizontally adjacent pixels sharing their chroma, or the last pixel of an odd width
+	template<ImageFormat::Encoding destination, int numPixels>
+	static void convertYUVPixels( int y0, int y1, int u, int v, unsigned char* destBytes, const YUVCoefficients& coefficients )
+	{
+		typedef RGBLayout<destination> Destination;
+		int d = u - 128;
+		int e = v - 128;
+		for ( int i=0; i<numPixels; ++i )
+		{
+			int c = ( i==0 ? y0 : y1 ) - coefficients.yOffset;
+			unsigned char* pixel = destBytes + i*Destination::numBytes;
+			pixel[Destination::red] = clip( ( coefficients.yFactor * c                               + coefficients.vToRed * e   + 128) >> 8 );
+			pixel[Destination::green] = clip( ( coefficients.yFactor * c + coefficients.uToGreen * d + coefficients.vToGreen * e + 128) >> 8 );
+			pixel[Destination::blue] = clip( ( coefficients.yFactor * c + coefficients.uToBlue * d                               + 128) >> 8 );
+			if ( Destination::numBytes==4 )
+				pixel[Destination::alpha] = 255;
+		}
+	}
+
+	// Same, with the lookup tables of the coefficients
+	template<ImageFormat::Encoding destination, int numPixels>
+	static void convertYUVPixels( int y0, int y1, int u, int v, unsigned char* destBytes, const YUVToRGBTables& tables )
+	{
+		typedef RGBLayout<destination> Destination;
+		int red = tables.vToRedTable[v];
+		int green = tables.uToGreenTable[u] + tables.vToGreenTable[v];
+		int blue = tables.uToBlueTable[u];
+		for ( int i=0; i<numPixels; ++i )
+		{
+			int luma = tables.yTable[ i==0 ? y0 : y1 ];
+			unsigned char* pixel = destBytes + i*Destination::numBytes;
+			pixel[Destination::red] = tables.clip( luma + red );
+			pixel[Destination::green] = tables.clip( luma + green );
+			pixel[Destination::blue] = tables.clip( luma + blue );
+			if ( Destination::numBytes==4 )
+				pixel[Destination::alpha] = 255;
+		}
+	}
+
+	// The row kernels work on a local copy of the coefficients: the byte stores could alias 
+	// the caller's ones otherwise, which would reload them for every pixel
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertYUV422Row( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		typedef YUV422Layout<source> Source;
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width/2; ++i )
+		{
+			const unsigned char* macroblock = sourceRow + i*4;
+			convertYUVPixels<destination, 2>( macroblock[Source::y0], macroblock[Source::y1], macroblock[Source::u], macroblock[Source::v], destinationRow + i*2*RGBLayout<destination>::numBytes, rowCoefficients );
+		}
+		if ( width%2!=0 )
+		{
+			const unsigned char* macroblock = sourceRow + (width/2)*4;
+			convertYUVPixels<destination, 1>( macroblock[Source::y0], 0, macroblock[Source::u], macroblock[Source::v], destinationRow + (width-1)*RGBLayout<destination>::numBytes, rowCoefficients );
+		}
+	}
+
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertYUV422Row( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVToRGBTables& tables )
+	{
+		typedef YUV422Layout<source> Source;
+		for ( unsigned int i=0; i<width/2; ++i )
+		{
+			const unsigned char* macroblock = sourceRow + i*4;
+			convertYUVPixels<destination, 2>( macroblock[Source::y0], macroblock[Source::y1], macroblock[Source::u], macroblock[Source::v], destinationRow + i*2*RGBLayout<destination>::numBytes, tables );
+		}
+		if ( width%2!=0 )
+		{
+			const unsigned char* macroblock = sourceRow + (width/2)*4;
+			convertYUVPixels<destination, 1>( macroblock[Source::y0], 0, macroblock[Source::u], macroblock[Source::v], destinationRow + (width-1)*RGBLayout<destination>::numBytes, tables );
+		}
+	}
+
+	// The chroma step is the distance between two U (or V) bytes: 2 for NV12, 1 for I420
+	template<ImageFormat::Encoding destination>
+	static void convertYUV420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned int chromaStep, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width/2; ++i )
+			convertYUVPixels<destination, 2>( yRow[i*2], yRow[i*2+1], uRow[i*chromaStep], vRow[i*chromaStep], destinationRow + i*2*RGBLayout<destination>::numBytes, rowCoefficients );
+		if ( width%2!=0 )
+			convertYUVPixels<destination, 1>( yRow[width-1], 0, uRow[(width/2)*chromaStep], vRow[(width/2)*chromaStep], destinationRow + (width-1)*RGBLayout<destination>::numBytes, rowCoefficients );
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertYUV420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned int chromaStep, unsigned char* destinationRow, unsigned int width, const YUVToRGBTables& tables )
+	{
+		for ( unsigned int i=0; i<width/2; ++i )
+			convertYUVPixels<destination, 2>( yRow[i*2], yRow[i*2+1], uRow[i*chromaStep], vRow[i*chromaStep], destinationRow + i*2*RGBLayout<destination>::numBytes, tables );
+		if ( width%2!=0 )
+			convertYUVPixels<destination, 1>( yRow[width-1], 0, uRow[(width/2)*chromaStep], vRow[(width/2)*chromaStep], destinationRow + (width-1)*RGBLayout<destination>::numBytes, tables );
+	}
+
+	// The RGB pixel of a luma with a neutral chroma: a gray, expanded to full swing in limited range
+	template<ImageFormat::Encoding destination>
+	static void convertLumaPixel( int y, unsigned char* destBytes, const YUVCoefficients& coefficients )
+	{
+		typedef RGBLayout<destination> Destination;
+		unsigned char value = clip( ( coefficients.yFactor * ( y - coefficients.yOffset ) + 128 ) >> 8 );
+		destBytes[Destination::red] = value;
+		destBytes[Destination::green] = value;
+		destBytes[Destination::blue] = value;
+		if ( Destination::numBytes==4 )
+			destBytes[Destination::alpha] = 255;
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertGRAY8Row( const unsigned char* gray8Row, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width; ++i )
+			convertLumaPixel<destination>( gray8Row[i], destinationRow + i*RGBLayout<destination>::numBytes, rowCoefficients );
+	}
+
+	// Only the high byte of the little-endian samples is used
+	template<ImageFormat::Encoding destination>
+	static void convertGRAY16Row( const unsigned char* gray16Row, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width; ++i )
+			convertLumaPixel<destination>( gray16Row[i*2+1], destinationRow + i*RGBLayout<destination>::numBytes, rowCoefficients );
+	}
+
+	template<ImageFormat::Encoding source>
+	static void convertYUV422RowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width )
+	{
+		typedef YUV422Layout<source> Source;
+		for ( unsigned int i=0; i<width/2; ++i )
+		{
+			gray8Row[i*2] = sourceRow[i*4+Source::y0];
+			gray8Row[i*2+1] = sourceRow[i*4+Source::y1];
+		}
+		if ( width%2!=0 )
+			gray8Row[width-1] = sourceRow[(width/2)*4+Source::y0];
+	}
+
+	// Only the order of the bytes of the macroblocks changes, the last one of an odd width included. 
+	// The source and destination rows can be the same
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertYUV422RowToYUV422( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+	{
+		typedef YUV422Layout<source> Source;
+		typedef YUV422Layout<destination> Destination;
+		for ( unsigned int i=0; i<(width+1)/2; ++i )
+		{
+			const unsigned char* sourceMacroblock = sourceRow + i*4;
+			unsigned char y0 = sourceMacroblock[Source::y0];
+			unsigned char u = sourceMacroblock[Source::u];
+			unsigned char y1 = sourceMacroblock[Source::y1];
+			unsigned char v = sourceMacroblock[Source::v];
+			unsigned char* destinationMacroblock = destinationRow + i*4;
+			destinationMacroblock[Destination::y0] = y0;
+			destinationMacroblock[Destination::u] = u;
+			destinationMacroblock[Destination::y1] = y1;
+			destinationMacroblock[Destination::v] = v;
+		}
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertNV12Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		convertYUV420Row<destination>( yRow, uRow, vRow, 2, destinationRow, width, coefficients );
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertI420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		convertYUV420Row<destination>( yRow, uRow, vRow, 1, destinationRow, width, coefficients );
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertNV12Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVToRGBTables& tables )
+	{
+		convertYUV420Row<destination>( yRow, uRow, vRow, 2, destinationRow, width, tables );
+	}
+
+	template<ImageFormat::Encoding destination>
+	static void convertI420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVToRGBTables& tables )
+	{
+		convertYUV420Row<destination>( yRow, uRow, vRow, 1, destinationRow, width, tables );
+	}
+
+	static int getLuma( int r, int g, int b, const YUVCoefficients& coefficients )
+	{
+		return ( ( coefficients.redToY * r + coefficients.greenToY * g + coefficients.blueToY * b + 128 ) >> 8 ) + coefficients.yOffset;
+	}
+
+	// The chroma is left before its +128 offset, for the callers to average it
+	template<ImageFormat::Encoding source>
+	static void convertPixelToYUV( const unsigned char* sourceBytes, int& y, int& u, int& v, const YUVCoefficients& coefficients )
+	{
+		typedef RGBLayout<source> Source;
+		int r = sourceBytes[Source::red];
+		int g = sourceBytes[Source::green];
+		int b = sourceBytes[Source::blue];
+		y = getLuma( r, g, b, coefficients );
+		u = ( coefficients.redToU * r + coefficients.greenToU * g + coefficients.blueToU * b + 128 ) >> 8;
+		v = ( coefficients.redToV * r + coefficients.greenToV * g + coefficients.blueToV * b + 128 ) >> 8;
+	}
+
+	template<ImageFormat::Encoding source>
+	static void convertRGBRowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		typedef RGBLayout<source> Source;
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width; ++i )
+		{
+			const unsigned char* pixel = sourceRow + i*Source::numBytes;
+			gray8Row[i] = static_cast<unsigned char>( getLuma( pixel[Source::red], pixel[Source::green], pixel[Source::blue], rowCoefficients ) );
+		}
+	}
+
+	// The averaged chroma is saturated: the full range one can reach 256
+	template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+	static void convertRGBRowToYUV422( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		typedef YUV422Layout<destination> Destination;
+		const unsigned int numBytes = RGBLayout<source>::numBytes;
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width/2; ++i )
+		{
+			int y0, u0, v0, y1, u1, v1;
+			convertPixelToYUV<source>( sourceRow + i*2*numBytes, y0, u0, v0, rowCoefficients );
+			convertPixelToYUV<source>( sourceRow + (i*2+1)*numBytes, y1, u1, v1, rowCoefficients );
+			unsigned char* macroblock = destinationRow + i*4;
+			macroblock[Destination::y0] = static_cast<unsigned char>(y0);
+			macroblock[Destination::u] = clip( ( ( u0 + u1 + 1 ) >> 1 ) + 128 );
+			macroblock[Destination::y1] = static_cast<unsigned char>(y1);
+			macroblock[Destination::v] = clip( ( ( v0 + v1 + 1 ) >> 1 ) + 128 );
+		}
+		if ( width%2!=0 )
+		{
+			int y, u, v;
+			convertPixelToYUV<source>( sourceRow + (width-1)*numBytes, y, u, v, rowCoefficients );
+			unsigned char* macroblock = destinationRow + (width/2)*4;
+			macroblock[Destination::y0] = static_cast<unsigned char>(y);
+			macroblock[Destination::u] = clip( u + 128 );
+			macroblock[Destination::y1] = static_cast<unsigned char>(y);
+			macroblock[Destination::v] = clip( v + 128 );
+		}
+	}
+
+	template<ImageFormat::Encoding source>
+	static void convertRGBRowPairToYUV420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, unsigned char* yRow0, unsigned char* yRow1, 
+										   unsigned char* uRow, unsigned char* vRow, unsigned int chromaStep, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		const unsigned int numBytes = RGBLayout<source>::numBytes;
+		const YUVCoefficients rowCoefficients = coefficients;
+		for ( unsigned int i=0; i<width/2; ++i )
+		{
+			int y[4], u[4], v[4];
+			convertPixelToYUV<source>( sourceRow0 + i*2*numBytes, y[0], u[0], v[0], rowCoefficients );
+			convertPixelToYUV<source>( sourceRow0 + (i*2+1)*numBytes, y[1], u[1], v[1], rowCoefficients );
+			convertPixelToYUV<source>( sourceRow1 + i*2*numBytes, y[2], u[2], v[2], rowCoefficients );
+			convertPixelToYUV<source>( sourceRow1 + (i*2+1)*numBytes, y[3], u[3], v[3], rowCoefficients );
+			yRow0[i*2] = static_cast<unsigned char>(y[0]);
+			yRow0[i*2+1] = static_cast<unsigned char>(y[1]);
+			yRow1[i*2] = static_cast<unsigned char>(y[2]);
+			yRow1[i*2+1] = static_cast<unsigned char>(y[3]);
+			uRow[i*chromaStep] = clip( ( ( u[0] + u[1] + u[2] + u[3] + 2 ) >> 2 ) + 128 );
+			vRow[i*chromaStep] = clip( ( ( v[0] + v[1] + v[2] + v[3] + 2 ) >> 2 ) + 128 );
+		}
+		if ( width%2!=0 )
+		{
+			int y[2], u[2], v[2];
+			convertPixelToYUV<source>( sourceRow0 + (width-1)*numBytes, y[0], u[0], v[0], rowCoefficients );
+			convertPixelToYUV<source>( sourceRow1 + (width-1)*numBytes, y[1], u[1], v[1], rowCoefficients );
+			yRow0[width-1] = static_cast<unsigned char>(y[0]);
+			yRow1[width-1] = static_cast<unsigned char>(y[1]);
+			uRow[(width/2)*chromaStep] = clip( ( ( u[0] + u[1] + 1 ) >> 1 ) + 128 );
+			vRow[(width/2)*chromaStep] = clip( ( ( v[0] + v[1] + 1 ) >> 1 ) + 128 );
+		}
+	}
+
+	template<ImageFormat::Encoding source>
+	static void convertRGBRowPairToNV12( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+										 unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		convertRGBRowPairToYUV420<source>( sourceRow0, sourceRow1, yRow0, yRow1, uRow, vRow, 2, width, coefficients );
+	}
+
+	template<ImageFormat::Encoding source>
+	static void convertRGBRowPairToI420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+										 unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width, const YUVCoefficients& coefficients )
+	{
+		convertRGBRowPairToYUV420<source>( sourceRow0, sourceRow1, yRow0, yRow1, uRow, vRow, 1, width, coefficients );
+	}
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include "RMFDeviceBackend.h"
+#include "RMFCriticalSection.h"
+
+namespace RMF
+{
+
+/*
+	ReplayDeviceBackend
+
+	A DeviceBackend that replays images previously recorded on disk, so a capture
+	session can be reproduced bit-for-bit without the camera. The path given at 
+	construction can be:
+	- a raw file made of one or more images stored back to back, with no header. 
+	  The format of the images is taken from the file name, which must end with 
+	  _<width>x<height>.<encoding name> (like "Camera_0_640x480.YUYV", as written 
+	  by the SimpleTest sample), unless it's specified in the Options
+	- a directory of such raw files, replayed in alphabetical order. Each distinct 
+	  image format found there is exposed as a separate CaptureSettings
+	- a YUV4MPEG2 (.y4m) file. Only the 4:2:2 chroma subsampling (C422) is supported, 
+	  its images are replayed as YUYV
+
+	The timestamps are read from an optional text file named after the path with a 
+	".timestamps" extension appended (for example "Camera_0_640x480.YUYV.timestamps"), 
+	containing one timestamp in seconds per image. Without it, they are deduced from 
+	the frame rate of the Y4M file, or from the one specified in the Options.
+
+	Images are read from disk when they're retrieved (see Options::preload), by the 
+	thread calling getCapturedImage(), typically the one updating the Device.
+*/
+class ReplayDeviceBackend : public DeviceBackend
+{
+public:
+	enum Pacing
+	{
+		RealTimePacing,				// An image becomes available when its timestamp is due. Images are skipped if the consumer is late, as with a camera
+		AsFastAsPossiblePacing		// Every image is delivered, the next one becoming available as soon as the previous one has been retrieved
+	};
+
+	class Options
+	{
+	public:
+		Options();
+		Pacing			pacing;
+		bool			loop;			// Whether to start again from the first image after the last one
+		bool			preload;		// Whether to read all the images in memory when the capture starts, to keep the disk out of the measurements
+		float			frameRate;		// Used when neither the timestamps nor the frame rate are recorded
+		ImageFormat		imageFormat;	// The format of raw files which name doesn't describe it. Ignored when its size is zero
+	};
+
+	ReplayDeviceBackend( const std::string& path, const Options& options=Options() );
+	virtual ~ReplayDeviceBackend();
+
+	virtual const CaptureSettingsList&	getSupportedCaptureSettingsList() const	{ return mSupportedCaptureSettingsList; }
+
+	virtual bool						startCapture( std::size_t captureSettingsIndex );
+	virtual void						stopCapture();
+	virtual bool						isCapturing() const;
+
+	virtual unsigned int				getCapturedImageSequenceNumber() const;
+	virtual bool						getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const;
+
+	static bool							parseImageFormat( const std::string& fileName, ImageFormat& imageFormat );
+
+protected:
+	enum Layout
+	{
+		RawLayout,						// As in memory
+		Y4M422Layout					// Planar 4:2:2, to be interleaved into YUYV
+	};
+
+	class Frame
+	{
+	public:
+		std::string			filePath;
+		long long			offset;		// In bytes, from the start of the file
+		long long			timestamp;	// In 100-nanosecond units, from the first image
+	};
+	typedef std::vector<Frame> Frames;
+
+	class Recording
+	{
+	public:
+		ImageFormat			imageFormat;
+		Layout				layout;
+		float				frameRate;
+		Frames				frames;
+		long long			duration;	// In 100-nanosecond units, including the display time of the last image. Used for looping
+	};
+	typedef std::vector<Recording> Recordings;
+
+	bool								addRawFile( const std::string& filePath, const ImageFormat& imageFormat );
+	bool								addY4MFile( const std::string& filePath );
+	Recording&							getRecording( const ImageFormat& imageFormat, Layout layout );
+	void								setTimestamps( const std::string& timestampsFilePath );
+
+	std::size_t							getFrameIndex( unsigned int sequenceNumber ) const;
+	long long							getTimestamp( unsigned int sequenceNumber ) const;
+	bool								readFrame( std::size_t frameIndex, MemoryBuffer& buffer ) const;
+
+private:
+	Options								mOptions;
+	Recordings							mRecordings;
+	CaptureSettingsList					mSupportedCaptureSettingsList;
+
+	mutable CriticalSection				mCriticalSection;
+	const Recording*					mRecording;						// The one being replayed, NULL when not capturing
+	std::chrono::steady_clock::time_point mCaptureStartTime;
+	mutable unsigned int				mRetrievedImageNumber;
+	std::vector<MemoryBuffer*>			mPreloadedImageBuffers;
+	mutable std::ifstream				mFileStream;
+	mutable std::string					mFileStreamPath;
+	mutable std::vector<unsigned char>	mPlanarBuffer;
+};
+
+}
\ No newline at end of file
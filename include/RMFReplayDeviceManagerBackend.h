@@ -0,0 +1,70 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFDeviceManagerBackend.h"
+#include "RMFReplayDeviceBackend.h"
+
+namespace RMF
+{
+
+/*
+	ReplayDeviceManagerBackend
+
+	A DeviceManagerBackend exposing ReplayDeviceBackend-based devices, one per 
+	recording declared with addDevice(). As with the SyntheticDeviceManagerBackend, 
+	adding or removing devices is picked up at the next update of the DeviceManager 
+	and must be done from the thread updating it.
+*/
+class ReplayDeviceManagerBackend : public DeviceManagerBackend
+{
+public:
+	ReplayDeviceManagerBackend();
+	virtual ~ReplayDeviceManagerBackend();
+
+	// Fails if the path doesn't contain any recording ReplayDeviceBackend can read
+	bool					addDevice( const std::string& name, const std::string& path, const ReplayDeviceBackend::Options& options=ReplayDeviceBackend::Options() );
+	bool					removeDevice( const std::string& name );
+
+	virtual bool			hasDeviceListChanged() const	{ return mDeviceListChanged; }
+	virtual void			enumerateDevices( DeviceDescriptions& descriptions );
+	virtual DeviceBackend*	createDeviceBackend( const DeviceDescription& description );
+
+	static std::string		getSymbolicLink( const std::string& name );
+
+private:
+	class ReplayDevice
+	{
+	public:
+		DeviceDescription				description;
+		std::string						path;
+		ReplayDeviceBackend::Options	options;
+	};
+	typedef std::vector<ReplayDevice> ReplayDevices;
+
+	bool					mDeviceListChanged;
+	ReplayDevices			mDevices;
+};
+
+}
\ No newline at end of file
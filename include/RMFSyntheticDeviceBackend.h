@@ -0,0 +1,120 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "RMFDeviceBackend.h"
+#include "RMFCriticalSection.h"
+#include "RMFImage.h"
+#include "RMFBufferCapturedFrame.h"
+#include "RMFCapturedFrameQueue.h"
+
+namespace RMF
+{
+
+/*
+	SyntheticDeviceBackend
+
+	A DeviceBackend that doesn't need any hardware. Once started, a capture thread 
+	generates test-pattern images at the frame rate of the chosen CaptureSettings 
+	(as fast as possible if the frame rate is zero), the same way a camera would 
+	deliver them through a Media Foundation callback. 
+
+	The test pattern is made of gradients that move from one image to the next. 
+	The sequence number of each image is also burned into its top rows as 32 black 
+	or white blocks (most significant bit first), so consumers can check which image 
+	they received. See readSequenceNumber().
+	
+	The timestamps are measured from the start of the capture.
+
+	The images are generated into BufferCapturedFrames that are shared as they are in 
+	zero-copy mode. A frame is reused once nobody but the backend references it anymore.
+	When the frame queue is enabled, each frame is also pushed into it.
+
+	With bottomUp, the images of the single-plane encodings are stored bottom-up, like 
+	those of a DIB-based camera, so the Device flips them.
+	
+	Supported encodings: the RGB ones (RGB24, BGR24 and the 32-bit ones), the packed 
+	4:2:2 ones (YUYV, UYVY, YVYU and VYUY), NV12, I420, YV12, GRAY8 and GRAY16.
+*/
+class SyntheticDeviceBackend : public DeviceBackend
+{
+public:
+	SyntheticDeviceBackend( const CaptureSettingsList& supportedCaptureSettingsList, bool bottomUp=false );
+	virtual ~SyntheticDeviceBackend();
+
+	virtual const CaptureSettingsList&	getSupportedCaptureSettingsList() const	{ return mSupportedCaptureSettingsList; }
+	virtual bool						isBottomUp( std::size_t captureSettingsIndex ) const;
+
+	virtual bool						startCapture( std::size_t captureSettingsIndex );
+	virtual void						stopCapture();
+	virtual bool						isCapturing() const;
+
+	virtual unsigned int				getCapturedImageSequenceNumber() const;
+	virtual bool						getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const;
+	virtual bool						getCapturedImage( const ImageView& image, unsigned int& sequenceNumber, long long& timestamp ) const;
+	virtual CapturedFrame*				acquireCapturedFrame( std::size_t captureSettingsIndex ) const;
+
+	virtual bool						setFrameQueueDepth( std::size_t depth );
+	virtual std::size_t					getFrameQueueDepth() const					{ return mFrameQueue.getDepth(); }
+	virtual CapturedFrame*				popCapturedFrame()							{ return mFrameQueue.pop(); }
+	virtual unsigned int				getNumDroppedFrames() const					{ return mFrameQueue.getNumDroppedFrames(); }
+
+	static bool							isEncodingSupported( ImageFormat::Encoding encoding );
+	static bool							generateImage( const ImageFormat& imageFormat, unsigned int sequenceNumber, MemoryBuffer& buffer );
+	static bool							readSequenceNumber( const ConstImageView& image, unsigned int& sequenceNumber );
+
+protected:
+	void								captureThreadFunction();
+	BufferCapturedFrame*				getFreeFrame();
+
+	static unsigned int					getSequenceNumberBlockWidth( const ImageFormat& imageFormat );
+	static unsigned int					getSequenceNumberBlockHeight( const ImageFormat& imageFormat );
+	static unsigned int					getNumBytesPerBlockPixel( const ImageFormat& imageFormat );
+	static void							burnSequenceNumber( const ImageFormat& imageFormat, unsigned int sequenceNumber, MemoryBuffer& buffer );
+	static void							flipRows( const ImageFormat& imageFormat, MemoryBuffer& buffer );
+
+private:
+	CaptureSettingsList					mSupportedCaptureSettingsList;
+	bool								mBottomUp;
+	CaptureSettings						mCaptureSettings;
+	bool								mCaptureBottomUp;				// Whether the images of the started capture are stored bottom-up
+	
+	mutable CriticalSection				mCriticalSection;				// Protects the members below
+	bool								mIsCapturing;
+	BufferCapturedFrame*				mCapturedFrame;					// The latest generated image
+	std::vector<BufferCapturedFrame*>	mFrames;						// All the frames, each holding a reference of the backend
+
+	CapturedFrameQueue					mFrameQueue;					// Lock-free, not protected by the critical section
+
+	std::thread*						mCaptureThread;
+	std::mutex							mCaptureThreadMutex;
+	std::condition_variable				mCaptureThreadCondition;		// Used to wake the capture thread up when stopping
+	bool								mCaptureThreadStopRequested;
+};
+
+}
\ No newline at end of file
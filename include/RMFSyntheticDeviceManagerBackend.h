@@ -0,0 +1,72 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFDeviceManagerBackend.h"
+
+namespace RMF
+{
+
+/*
+	SyntheticDeviceManagerBackend
+
+	A DeviceManagerBackend exposing SyntheticDeviceBackend-based devices, so the 
+	whole capture path (DeviceManager, Device, listeners) can be exercised and 
+	measured without any camera, on any platform. 
+
+	The devices are declared by the user with addDevice(). Adding or removing a 
+	device is picked up by the DeviceManager at its next update, just like plugging 
+	or unplugging a camera. This must be done from the thread updating the DeviceManager.
+	A device can store its images bottom-up (see SyntheticDeviceBackend).
+*/
+class SyntheticDeviceManagerBackend : public DeviceManagerBackend
+{
+public:
+	SyntheticDeviceManagerBackend();
+	virtual ~SyntheticDeviceManagerBackend();
+
+	bool					addDevice( const std::string& name, const CaptureSettingsList& supportedCaptureSettingsList, bool bottomUp=false );
+	bool					removeDevice( const std::string& name );
+
+	virtual bool			hasDeviceListChanged() const	{ return mDeviceListChanged; }
+	virtual void			enumerateDevices( DeviceDescriptions& descriptions );
+	virtual DeviceBackend*	createDeviceBackend( const DeviceDescription& description );
+
+	static std::string		getSymbolicLink( const std::string& name );
+
+private:
+	class SyntheticDevice
+	{
+	public:
+		DeviceDescription		description;
+		CaptureSettingsList		supportedCaptureSettingsList;
+		bool					bottomUp;
+	};
+	typedef std::vector<SyntheticDevice> SyntheticDevices;
+
+	bool					mDeviceListChanged;
+	SyntheticDevices		mDevices;
+};
+
+}
\ No newline at end of file
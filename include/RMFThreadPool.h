@@ -0,0 +1,90 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace RMF
+{
+
+/*
+	ThreadPool
+
+	A fixed set of worker threads used to split data-parallel work, like converting 
+	the rows of an image, over several processor cores.
+
+	run() executes a task a given number of times, passing it the index of each run. 
+	The runs are spread over the worker threads and the calling thread, which 
+	participates instead of idly waiting. run() returns once all of them are done.
+	Concurrent calls to run() from different threads are executed one after the other.
+
+	runBands() splits the rows of an image into horizontal bands, one per thread at most, 
+	and runs a task on each of them. The bands are at least minBandHeight rows high, so 
+	small images don't pay for the synchronization.
+*/
+class ThreadPool
+{
+public:
+	typedef std::function<void (unsigned int taskIndex)> Task;
+	typedef std::function<void (unsigned int firstRow, unsigned int endRow)> BandTask;
+
+	// With zero threads, the pool uses one thread per processor core, 
+	// minus one for the thread calling run()
+	ThreadPool( unsigned int numThreads=0 );
+	~ThreadPool();
+
+	unsigned int				getNumThreads() const		{ return static_cast<unsigned int>( mThreads.size() ); }
+	
+	void						run( const Task& task, unsigned int numTasks );
+
+	// The bands start on a multiple of numRowsPerStep, the last one ends with the rows. 
+	// With a NULL pool, the task runs once on all the rows, on the calling thread
+	static void					runBands( ThreadPool* threadPool, const BandTask& task, unsigned int numRows, unsigned int numRowsPerStep, unsigned int minBandHeight );
+
+private:
+	ThreadPool( const ThreadPool& other );				// Not implemented on purpose
+	ThreadPool& operator=( const ThreadPool& other );	// Not implemented on purpose
+
+	void						threadFunction();
+	void						runTasks( std::unique_lock<std::mutex>& lock );
+
+	std::vector<std::thread>	mThreads;
+	std::mutex					mRunMutex;
+	
+	std::mutex					mMutex;				// Protects the members below
+	std::condition_variable		mWorkCondition;
+	std::condition_variable		mDoneCondition;
+	const Task*					mTask;
+	unsigned int				mNumTasks;
+	unsigned int				mNextTaskIndex;
+	unsigned int				mNumCompletedTasks;
+	unsigned int				mGeneration;		// Incremented at each run so the workers know there is new work
+	bool						mStopRequested;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#pragma once
+
+#include "RMFImageFormat.h"
+
+namespace RMF
+{
+
+/*
+	YUVCoefficients
+
+	The fixed-point coefficients of the conversions between YUV and RGB, for a color matrix and 
+	range (see ImageFormat::ColorMatrix and ImageFormat::ColorRange). They are scaled by 256, 
+	and precomputed for all the combinations, so picking the right ones costs nothing.
+
+	From YUV, with c = Y - yOffset, d = U - 128 and e = V - 128:
+		R = ( yFactor*c + vToRed*e + 128 ) >> 8
+		G = ( yFactor*c + uToGreen*d + vToGreen*e + 128 ) >> 8
+		B = ( yFactor*c + uToBlue*d + 128 ) >> 8
+	
+	To YUV:
+		Y = ( ( redToY*R + greenToY*G + blueToY*B + 128 ) >> 8 ) + yOffset
+		U = ( ( redToU*R + greenToU*G + blueToU*B + 128 ) >> 8 ) + 128
+		V = ( ( redToV*R + greenToV*G + blueToV*B + 128 ) >> 8 ) + 128
+
+	The rounding keeps the white at 235 (limited range) or 255 (full range), and the grays 
+	without chroma. blueToU and redToV are half of the chroma scale, 112 or 128, and are the 
+	only positive chroma coefficients. In full range, 128 maps the most saturated blues and 
+	reds to a chroma of 256, saturated to 255 by the kernels.
+
+	The BT.601 limited range ones are the historical coefficients of the library:
+	http://msdn.microsoft.com/en-us/library/aa904813(VS.80).aspx#yuvformats_2
+*/
+class YUVCoefficients
+{
+public:
+	static const YUVCoefficients&	get( ImageFormat::ColorMatrix colorMatrix, ImageFormat::ColorRange colorRange );
+	static const YUVCoefficients&	get( const ImageFormat& imageFormat )		{ return get( imageFormat.getColorMatrix(), imageFormat.getColorRange() ); }
+
+	int		yOffset;
+	int		yFactor;
+	int		vToRed;
+	int		uToGreen;
+	int		vToGreen;
+	int		uToBlue;
+
+	int		redToY;
+	int		greenToY;
+	int		blueToY;
+	int		redToU;
+	int		greenToU;
+	int		blueToU;
+	int		redToV;
+	int		greenToV;
+	int		blueToV;
+
+private:
+	static const YUVCoefficients	mCoefficients[ImageFormat::ColorMatrixCount][ImageFormat::ColorRangeCount];
+};
+
+/*
+	YUVToRGBTables
+
+	The YUV to RGB formulas of YUVCoefficients as lookup tables: the contribution of each 
+	sample value to each component, multiplication and rounding included, and a table saturating 
+	their sum to a byte. A pixel then costs a few loads and additions, without multiplications 
+	nor branches, which pays off on the processors having no SIMD kernels. The bytes are exactly 
+	the same as with the formulas:
+		R = clip( yTable[Y] + vToRedTable[V] )
+		G = clip( yTable[Y] + uToGreenTable[U] + vToGreenTable[V] )
+		B = clip( yTable[Y] + uToBlueTable[U] )
+
+	The tables of the color matrices and ranges of ImageFormat are built the first time one of 
+	them is requested, about 6KB each.
+*/
+class YUVToRGBTables
+{
+public:
+	explicit YUVToRGBTables( const YUVCoefficients& coefficients );
+
+	static const YUVToRGBTables&	get( ImageFormat::ColorMatrix colorMatrix, ImageFormat::ColorRange colorRange );
+	static const YUVToRGBTables&	get( const ImageFormat& imageFormat )		{ return get( imageFormat.getColorMatrix(), imageFormat.getColorRange() ); }
+
+	// Takes a sum of contributions, still scaled by 256
+	unsigned char	clip( int value ) const		{ return mClipTable[ ( value >> 8 ) + clipTableOffset ]; }
+
+	int		yTable[256];			// yFactor * ( Y - yOffset ) + 128
+	int		vToRedTable[256];		// vToRed * ( V - 128 ), and so on
+	int		uToGreenTable[256];
+	int		vToGreenTable[256];
+	int		uToBlueTable[256];
+
+private:
+	// Wide enough for the sums of the standard coefficients, which stay within [-293, 550]
+	enum { clipTableOffset = 384, clipTableSize = 1024 };
+	unsigned char	mClipTable[clipTableSize];
+};
+
+}
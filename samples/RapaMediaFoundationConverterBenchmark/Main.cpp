@@ -0,0 +1,824 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConverter.h"
+#include "RMFMemoryBuffer.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+/*
+	Measures the speed of the ImageConverter row kernels for each instruction set 
+	supported by the processor, and checks they produce exactly the same bytes 
+	as the scalar reference implementation. The YUV 4:2:0 kernels, reading or 
+	writing these encodings, are measured on whole images, through their own tables.
+	The color kernels are measured with BT.601 in limited range, their small widths 
+	are checked with all the color matrices and ranges. The YUV to RGB kernels are also 
+	measured in their lookup table flavor (the "Tables" lines), which is checked against 
+	the scalar one too. Comparing it with the "Scalar" lines tells whether it is worth 
+	selecting on a processor without SIMD kernels (see ImageConverter::YUVToRGBMethod).
+	The ImageScaler is measured with each filter and instruction set, on a few encodings 
+	and ratios, and checked against its scalar kernels on small sizes too.
+	
+	The conversions of images of an odd width are checked to write all the bytes of their 
+	destination. The ones between the YUV and gray encodings of different color matrices and 
+	ranges are checked against going through RGB24.
+
+	Returns 1 if any implementation differs from the reference.
+
+	It then measures the whole-image YUYV to RGB24 conversion of the ImageConverter, 
+	on the calling thread only, with the lookup tables, and with a ThreadPool. And the 
+	conversion to an RGB24 preview a sixth of the size, scaled with each filter, which is 
+	checked against scaling the YUYV image then converting it separately. And the conversion 
+	to an RGB24 image turned a quarter clockwise, checked against and compared with turning 
+	the YUYV image (see ImageTransformer) then converting it separately. And the conversion of 
+	four regions of interest, checked against and compared with converting the whole image 
+	then cropping it.
+
+	Usage: RapaMediaFoundationConverterBenchmark [width height numIterations [numThreads]]
+*/
+
+typedef std::chrono::steady_clock Clock;
+typedef RMF::ImageConverterKernels Kernels;
+
+// The kernels are measured for each instruction set, then in their lookup table flavor
+static const int tablesVariant = Kernels::InstructionSetCount;
+static const int variantCount = Kernels::InstructionSetCount+1;
+
+static const char* getVariantName( int variant )
+{
+	if ( variant==tablesVariant )
+		return "Tables";
+	return Kernels::getInstructionSetName( static_cast<Kernels::InstructionSet>(variant) );
+}
+
+// The small widths are checked with all the color matrices and ranges in turn
+static RMF::ImageFormat getSmallWidthFormat( unsigned int width, unsigned int height, RMF::ImageFormat::Encoding encoding )
+{
+	return RMF::ImageFormat( width, height, encoding, 
+							 static_cast<RMF::ImageFormat::ColorMatrix>( width % RMF::ImageFormat::ColorMatrixCount ), 
+							 static_cast<RMF::ImageFormat::ColorRange>( width / RMF::ImageFormat::ColorMatrixCount % RMF::ImageFormat::ColorRangeCount ) );
+}
+
+// A row kernel: a color one, a table one, or one that needs neither. The color matrix and 
+// range of colorFormat give the coefficients or tables of the kernel
+struct RowFunction
+{
+	RowFunction( Kernels::ConvertRowFunction function=NULL ) : convertRow(function), convertColorRow(NULL), convertTableRow(NULL) {}
+	RowFunction( Kernels::ConvertColorRowFunction function ) : convertRow(NULL), convertColorRow(function), convertTableRow(NULL) {}
+	RowFunction( Kernels::ConvertTableRowFunction function ) : convertRow(NULL), convertColorRow(NULL), convertTableRow(function) {}
+	bool isNull() const		{ return !convertRow && !convertColorRow && !convertTableRow; }
+	void operator()( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const RMF::ImageFormat& colorFormat ) const
+	{
+		if ( convertColorRow )
+			convertColorRow( sourceRow, destinationRow, width, RMF::YUVCoefficients::get( colorFormat ) );
+		else if ( convertTableRow )
+			convertTableRow( sourceRow, destinationRow, width, RMF::YUVToRGBTables::get( colorFormat ) );
+		else
+			convertRow( sourceRow, destinationRow, width );
+	}
+	Kernels::ConvertRowFunction			convertRow;
+	Kernels::ConvertColorRowFunction	convertColorRow;
+	Kernels::ConvertTableRowFunction	convertTableRow;
+};
+
+// Same, for the kernels reading the YUV 4:2:0 encodings
+struct YUV420RowFunction
+{
+	YUV420RowFunction( Kernels::ConvertYUV420RowFunction function=NULL ) : convertRow(function), convertColorRow(NULL), convertTableRow(NULL) {}
+	YUV420RowFunction( Kernels::ConvertYUV420ColorRowFunction function ) : convertRow(NULL), convertColorRow(function), convertTableRow(NULL) {}
+	YUV420RowFunction( Kernels::ConvertYUV420TableRowFunction function ) : convertRow(NULL), convertColorRow(NULL), convertTableRow(function) {}
+	bool isNull() const		{ return !convertRow && !convertColorRow && !convertTableRow; }
+	void operator()( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const RMF::ImageFormat& colorFormat ) const
+	{
+		if ( convertColorRow )
+			convertColorRow( yRow, uRow, vRow, destinationRow, width, RMF::YUVCoefficients::get( colorFormat ) );
+		else if ( convertTableRow )
+			convertTableRow( yRow, uRow, vRow, destinationRow, width, RMF::YUVToRGBTables::get( colorFormat ) );
+		else
+			convertRow( yRow, uRow, vRow, destinationRow, width );
+	}
+	Kernels::ConvertYUV420RowFunction		convertRow;
+	Kernels::ConvertYUV420ColorRowFunction	convertColorRow;
+	Kernels::ConvertYUV420TableRowFunction	convertTableRow;
+};
+
+struct Kernel
+{
+	const char*						name;
+	bool							canWorkInPlace;
+	Kernels::ConvertRowFunction		(*getFunction)( Kernels::InstructionSet instructionSet );
+	RMF::ImageFormat::Encoding		sourceEncoding;				// For the kernels taking their encodings, with no getFunction
+	RMF::ImageFormat::Encoding		destinationEncoding;
+};
+
+static const Kernel kernels[] = 
+{
+	{ "YUYV to RGB24", false, NULL, RMF::ImageFormat::YUYV, RMF::ImageFormat::RGB24 },
+	{ "YUYV to BGR24", false, NULL, RMF::ImageFormat::YUYV, RMF::ImageFormat::BGR24 },
+	{ "BGR24 to RGB24", true, Kernels::getSwapFirstAndThirdBytesRowFunction, RMF::ImageFormat::BGR24, RMF::ImageFormat::RGB24 },
+	{ "YUYV to BGRA32", false, NULL, RMF::ImageFormat::YUYV, RMF::ImageFormat::BGRA32 },
+	{ "YUYV to RGBA32", false, NULL, RMF::ImageFormat::YUYV, RMF::ImageFormat::RGBA32 },
+	{ "UYVY to RGB24", false, NULL, RMF::ImageFormat::UYVY, RMF::ImageFormat::RGB24 },
+	{ "UYVY to BGRA32", false, NULL, RMF::ImageFormat::UYVY, RMF::ImageFormat::BGRA32 },
+	{ "YVYU to BGR24", false, NULL, RMF::ImageFormat::YVYU, RMF::ImageFormat::BGR24 },
+	{ "RGB24 to BGRA32", false, NULL, RMF::ImageFormat::RGB24, RMF::ImageFormat::BGRA32 },
+	{ "BGRA32 to RGB24", false, NULL, RMF::ImageFormat::BGRA32, RMF::ImageFormat::RGB24 },
+	{ "BGRA32 to RGBA32", true, NULL, RMF::ImageFormat::BGRA32, RMF::ImageFormat::RGBA32 },
+	{ "BGRX32 to ARGB32", true, NULL, RMF::ImageFormat::BGRX32, RMF::ImageFormat::ARGB32 },
+	{ "YUYV to GRAY8", false, NULL, RMF::ImageFormat::YUYV, RMF::ImageFormat::GRAY8 },
+	{ "UYVY to GRAY8", false, NULL, RMF::ImageFormat::UYVY, RMF::ImageFormat::GRAY8 },
+	{ "RGB24 to GRAY8", false, NULL, RMF::ImageFormat::RGB24, RMF::ImageFormat::GRAY8 },
+	{ "BGRA32 to GRAY8", false, NULL, RMF::ImageFormat::BGRA32, RMF::ImageFormat::GRAY8 },
+	{ "RGB24 to YUYV", false, NULL, RMF::ImageFormat::RGB24, RMF::ImageFormat::YUYV },
+	{ "BGR24 to YUYV", false, NULL, RMF::ImageFormat::BGR24, RMF::ImageFormat::YUYV },
+	{ "BGRA32 to UYVY", false, NULL, RMF::ImageFormat::BGRA32, RMF::ImageFormat::UYVY },
+};
+
+static RowFunction getKernelFunction( const Kernel& kernel, int variant )
+{
+	if ( variant==tablesVariant )
+	{
+		if ( RMF::ImageFormat::isPackedYUV422( kernel.sourceEncoding ) && RMF::ImageFormat::isRGB( kernel.destinationEncoding ) )
+			return Kernels::getConvertYUV422RowToRGBTableFunction( kernel.sourceEncoding, kernel.destinationEncoding, Kernels::ScalarInstructionSet );
+		return RowFunction();
+	}
+
+	Kernels::InstructionSet instructionSet = static_cast<Kernels::InstructionSet>(variant);
+	if ( kernel.getFunction )
+		return kernel.getFunction( instructionSet );
+	if ( kernel.destinationEncoding==RMF::ImageFormat::GRAY8 )
+	{
+		if ( RMF::ImageFormat::isPackedYUV422( kernel.sourceEncoding ) )
+			return Kernels::getConvertYUV422RowToGRAY8Function( kernel.sourceEncoding, instructionSet );
+		return Kernels::getConvertRGBRowToGRAY8Function( kernel.sourceEncoding, instructionSet );
+	}
+	if ( RMF::ImageFormat::isPackedYUV422( kernel.destinationEncoding ) )
+		return Kernels::getConvertRGBRowToYUV422Function( kernel.sourceEncoding, kernel.destinationEncoding, instructionSet );
+	if ( RMF::ImageFormat::isPackedYUV422( kernel.sourceEncoding ) )
+		return Kernels::getConvertYUV422RowToRGBFunction( kernel.sourceEncoding, kernel.destinationEncoding, instructionSet );
+	return Kernels::getConvertRGBRowFunction( kernel.sourceEncoding, kernel.destinationEncoding, instructionSet );
+}
+
+struct YUV420Kernel
+{
+	const char*								name;
+	RMF::ImageFormat::Encoding				sourceEncoding;
+	RMF::ImageFormat::Encoding				destinationEncoding;
+	Kernels::ConvertYUV420RowFunction		(*getFunction)( Kernels::InstructionSet instructionSet );
+};
+
+static const YUV420Kernel yuv420Kernels[] = 
+{
+	{ "NV12 to RGB24", RMF::ImageFormat::NV12, RMF::ImageFormat::RGB24, NULL },
+	{ "NV12 to BGR24", RMF::ImageFormat::NV12, RMF::ImageFormat::BGR24, NULL },
+	{ "NV12 to YUYV", RMF::ImageFormat::NV12, RMF::ImageFormat::YUYV, Kernels::getConvertNV12RowToYUYVFunction },
+	{ "I420 to RGB24", RMF::ImageFormat::I420, RMF::ImageFormat::RGB24, NULL },
+	{ "I420 to BGR24", RMF::ImageFormat::I420, RMF::ImageFormat::BGR24, NULL },
+	{ "I420 to YUYV", RMF::ImageFormat::I420, RMF::ImageFormat::YUYV, Kernels::getConvertI420RowToYUYVFunction },
+	{ "NV12 to BGRX32", RMF::ImageFormat::NV12, RMF::ImageFormat::BGRX32, NULL },
+	{ "I420 to RGBA32", RMF::ImageFormat::I420, RMF::ImageFormat::RGBA32, NULL },
+};
+
+static YUV420RowFunction getKernelFunction( const YUV420Kernel& kernel, int variant )
+{
+	if ( variant==tablesVariant )
+	{
+		if ( kernel.getFunction )
+			return YUV420RowFunction();
+		if ( kernel.sourceEncoding==RMF::ImageFormat::NV12 )
+			return Kernels::getConvertNV12RowToRGBTableFunction( kernel.destinationEncoding, Kernels::ScalarInstructionSet );
+		return Kernels::getConvertI420RowToRGBTableFunction( kernel.destinationEncoding, Kernels::ScalarInstructionSet );
+	}
+
+	Kernels::InstructionSet instructionSet = static_cast<Kernels::InstructionSet>(variant);
+	if ( kernel.getFunction )
+		return kernel.getFunction( instructionSet );
+	if ( kernel.sourceEncoding==RMF::ImageFormat::NV12 )
+		return Kernels::getConvertNV12RowToRGBFunction( kernel.destinationEncoding, instructionSet );
+	return Kernels::getConvertI420RowToRGBFunction( kernel.destinationEncoding, instructionSet );
+}
+
+struct RowPairKernel
+{
+	const char*								name;
+	RMF::ImageFormat::Encoding				sourceEncoding;
+	RMF::ImageFormat::Encoding				destinationEncoding;
+};
+
+static const RowPairKernel rowPairKernels[] = 
+{
+	{ "RGB24 to NV12", RMF::ImageFormat::RGB24, RMF::ImageFormat::NV12 },
+	{ "BGR24 to NV12", RMF::ImageFormat::BGR24, RMF::ImageFormat::NV12 },
+	{ "RGB24 to I420", RMF::ImageFormat::RGB24, RMF::ImageFormat::I420 },
+	{ "BGRA32 to NV12", RMF::ImageFormat::BGRA32, RMF::ImageFormat::NV12 },
+};
+
+static Kernels::ConvertColorRowPairToYUV420Function getKernelFunction( const RowPairKernel& kernel, Kernels::InstructionSet instructionSet )
+{
+	if ( kernel.destinationEncoding==RMF::ImageFormat::NV12 )
+		return Kernels::getConvertRGBRowPairToNV12Function( kernel.sourceEncoding, instructionSet );
+	return Kernels::getConvertRGBRowPairToI420Function( kernel.sourceEncoding, instructionSet );
+}
+
+// The destination size is the source one times numerator/denominator
+struct ScalerBenchmark
+{
+	const char*						name;
+	RMF::ImageFormat::Encoding		encoding;
+	unsigned int					numerator;
+	unsigned int					denominator;
+};
+
+static const ScalerBenchmark scalerBenchmarks[] = 
+{
+	{ "NV12 2/3", RMF::ImageFormat::NV12, 2, 3 },
+	{ "YUYV 1/4", RMF::ImageFormat::YUYV, 1, 4 },
+	{ "BGRA 3/2", RMF::ImageFormat::BGRA32, 3, 2 },
+};
+
+static void fillWithRandomBytes( RMF::MemoryBuffer& buffer )
+{
+	unsigned char* bytes = buffer.getBytes();
+	for ( unsigned int i=0; i<buffer.getSizeInBytes(); ++i )
+		bytes[i] = static_cast<unsigned char>( rand() & 0xFF );
+}
+
+// The buffers hold packed rows of these formats. The rows of the packed 4:2:2 encodings 
+// have an even number of pixels, the last pixel of an odd width is padding
+static RMF::ImageFormat getSourceFormat( const Kernel& kernel, unsigned int width, unsigned int height )
+{
+	return RMF::ImageFormat( width, height, kernel.sourceEncoding );
+}
+
+static RMF::ImageFormat getDestinationFormat( const Kernel& kernel, unsigned int width, unsigned int height )
+{
+	return RMF::ImageFormat( width, height, kernel.destinationEncoding );
+}
+
+static void convertImage( const RowFunction& convertRow, const Kernel& kernel, const RMF::MemoryBuffer& source, RMF::MemoryBuffer& destination, unsigned int width, unsigned int height )
+{
+	const RMF::ImageFormat colorFormat;		// BT.601 in limited range
+	unsigned int numSourceBytesPerLine = getSourceFormat( kernel, width, height ).getNumBytesPerLine();
+	unsigned int numDestinationBytesPerLine = getDestinationFormat( kernel, width, height ).getNumBytesPerLine();
+	for ( unsigned int y=0; y<height; ++y )
+		convertRow( source.getBytes() + y*numSourceBytesPerLine, destination.getBytes() + y*numDestinationBytesPerLine, width, colorFormat );
+}
+
+// Compares the in-place result with the reference out-of-place one
+static bool checkInPlace( const RowFunction& convertRow, const Kernel& kernel, const RMF::MemoryBuffer& source, const RMF::MemoryBuffer& referenceDestination, unsigned int width, unsigned int height )
+{
+	RMF::MemoryBuffer buffer( source );
+	convertImage( convertRow, kernel, buffer, buffer, width, height );
+	return memcmp( buffer.getBytes(), referenceDestination.getBytes(), buffer.getSizeInBytes() )==0;
+}
+
+// Compares with the reference on all the widths up to 128 pixels, to cover the remainders of the vector loops
+static bool checkSmallWidths( const RowFunction& convertRow, const RowFunction& referenceConvertRow, const Kernel& kernel )
+{
+	const unsigned int maxWidth = 128;
+	RMF::MemoryBuffer source( getSourceFormat( kernel, maxWidth, 1 ).getNumBytesPerLine() );
+	RMF::MemoryBuffer destination( getDestinationFormat( kernel, maxWidth, 1 ).getNumBytesPerLine() );
+	RMF::MemoryBuffer referenceDestination( getDestinationFormat( kernel, maxWidth, 1 ).getNumBytesPerLine() );
+	for ( unsigned int width=1; width<=maxWidth; ++width )
+	{
+		fillWithRandomBytes( source );
+		destination.fill( 0 );
+		referenceDestination.fill( 0 );
+		RMF::ImageFormat colorFormat = getSmallWidthFormat( width, 1, kernel.sourceEncoding );
+		convertRow( source.getBytes(), destination.getBytes(), width, colorFormat );
+		referenceConvertRow( source.getBytes(), referenceDestination.getBytes(), width, colorFormat );
+		if ( memcmp( destination.getBytes(), referenceDestination.getBytes(), destination.getSizeInBytes() )!=0 )
+			return false;
+	}
+	return true;
+}
+
+static void convertYUV420Image( const YUV420RowFunction& convertRow, const RMF::Image& source, RMF::Image& destination )
+{
+	bool isNV12 = source.getFormat().getEncoding()==RMF::ImageFormat::NV12;
+	for ( unsigned int y=0; y<source.getFormat().getHeight(); ++y )
+	{
+		const unsigned char* uRow = source.getPlaneRow( 1, y/2 );
+		const unsigned char* vRow = isNV12 ? uRow+1 : source.getPlaneRow( 2, y/2 );
+		convertRow( source.getRow(y), uRow, vRow, destination.getRow(y), source.getFormat().getWidth(), source.getFormat() );
+	}
+}
+
+// Same as benchmarking the single-plane kernels, except that the small widths are checked 
+// on a few rows so the chroma rows get shared
+static bool benchmarkYUV420Kernel( const YUV420Kernel& kernel, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image source( RMF::ImageFormat( width, height, kernel.sourceEncoding ) );
+	RMF::Image destination( RMF::ImageFormat( width, height, kernel.destinationEncoding ) );
+	RMF::Image referenceDestination( destination.getFormat() );
+	fillWithRandomBytes( source.getBuffer() );
+	
+	YUV420RowFunction referenceConvertRow = getKernelFunction( kernel, Kernels::ScalarInstructionSet );
+	convertYUV420Image( referenceConvertRow, source, referenceDestination );
+
+	bool allIdentical = true;
+	double referenceTimeInMs = 0;
+	for ( int variant=0; variant<variantCount; ++variant )
+	{
+		YUV420RowFunction convertRow = getKernelFunction( kernel, variant );
+		if ( convertRow.isNull() )
+			continue;
+
+		destination.getBuffer().fill( 0 );
+		Clock::time_point startTime = Clock::now();
+		for ( unsigned int j=0; j<numIterations; ++j )
+			convertYUV420Image( convertRow, source, destination );
+		double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+		if ( variant==Kernels::ScalarInstructionSet )
+			referenceTimeInMs = timeInMs;
+
+		bool identical = memcmp( destination.getBuffer().getBytes(), referenceDestination.getBuffer().getBytes(), destination.getBuffer().getSizeInBytes() )==0;
+		for ( unsigned int smallWidth=1; smallWidth<=128 && identical; ++smallWidth )
+		{
+			RMF::Image smallSource( getSmallWidthFormat( smallWidth, 4, kernel.sourceEncoding ) );
+			RMF::Image smallDestination( RMF::ImageFormat( smallWidth, 4, kernel.destinationEncoding ) );
+			RMF::Image smallReferenceDestination( smallDestination.getFormat() );
+			fillWithRandomBytes( smallSource.getBuffer() );
+			convertYUV420Image( convertRow, smallSource, smallDestination );
+			convertYUV420Image( referenceConvertRow, smallSource, smallReferenceDestination );
+			identical = memcmp( smallDestination.getBuffer().getBytes(), smallReferenceDestination.getBuffer().getBytes(), smallDestination.getBuffer().getSizeInBytes() )==0;
+		}
+		if ( !identical )
+			allIdentical = false;
+
+		printf("%-16s %-8s %8.3f ms  x%5.2f  %s\n", kernel.name, getVariantName( variant ), 
+			timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+	}
+	return allIdentical;
+}
+
+static void convertRowPairsToYUV420Image( Kernels::ConvertColorRowPairToYUV420Function convertRowPair, const RMF::Image& source, RMF::Image& destination )
+{
+	const RMF::YUVCoefficients& coefficients = RMF::YUVCoefficients::get( destination.getFormat() );
+	bool isNV12 = destination.getFormat().getEncoding()==RMF::ImageFormat::NV12;
+	for ( unsigned int y=0; y+1<source.getFormat().getHeight(); y+=2 )
+	{
+		unsigned char* uRow = destination.getPlaneRow( 1, y/2 );
+		unsigned char* vRow = isNV12 ? uRow+1 : destination.getPlaneRow( 2, y/2 );
+		convertRowPair( source.getRow(y), source.getRow(y+1), destination.getRow(y), destination.getRow(y+1), uRow, vRow, source.getFormat().getWidth(), coefficients );
+	}
+}
+
+// Same as benchmarkYUV420Kernel(), for the kernels writing the YUV 4:2:0 encodings
+static bool benchmarkRowPairKernel( const RowPairKernel& kernel, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image source( RMF::ImageFormat( width, height, kernel.sourceEncoding ) );
+	RMF::Image destination( RMF::ImageFormat( width, height, kernel.destinationEncoding ) );
+	RMF::Image referenceDestination( destination.getFormat() );
+	fillWithRandomBytes( source.getBuffer() );
+	
+	Kernels::ConvertColorRowPairToYUV420Function referenceConvertRowPair = getKernelFunction( kernel, Kernels::ScalarInstructionSet );
+	referenceDestination.getBuffer().fill( 0 );
+	convertRowPairsToYUV420Image( referenceConvertRowPair, source, referenceDestination );
+
+	bool allIdentical = true;
+	double referenceTimeInMs = 0;
+	for ( int i=0; i<Kernels::InstructionSetCount; ++i )
+	{
+		Kernels::InstructionSet instructionSet = static_cast<Kernels::InstructionSet>(i);
+		Kernels::ConvertColorRowPairToYUV420Function convertRowPair = getKernelFunction( kernel, instructionSet );
+		if ( !convertRowPair )
+			continue;
+
+		destination.getBuffer().fill( 0 );
+		Clock::time_point startTime = Clock::now();
+		for ( unsigned int j=0; j<numIterations; ++j )
+			convertRowPairsToYUV420Image( convertRowPair, source, destination );
+		double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+		if ( instructionSet==Kernels::ScalarInstructionSet )
+			referenceTimeInMs = timeInMs;
+
+		bool identical = memcmp( destination.getBuffer().getBytes(), referenceDestination.getBuffer().getBytes(), destination.getBuffer().getSizeInBytes() )==0;
+		for ( unsigned int smallWidth=1; smallWidth<=128 && identical; ++smallWidth )
+		{
+			RMF::Image smallSource( RMF::ImageFormat( smallWidth, 4, kernel.sourceEncoding ) );
+			RMF::Image smallDestination( getSmallWidthFormat( smallWidth, 4, kernel.destinationEncoding ) );
+			RMF::Image smallReferenceDestination( smallDestination.getFormat() );
+			fillWithRandomBytes( smallSource.getBuffer() );
+			smallDestination.getBuffer().fill( 0 );
+			smallReferenceDestination.getBuffer().fill( 0 );
+			convertRowPairsToYUV420Image( convertRowPair, smallSource, smallDestination );
+			convertRowPairsToYUV420Image( referenceConvertRowPair, smallSource, smallReferenceDestination );
+			identical = memcmp( smallDestination.getBuffer().getBytes(), smallReferenceDestination.getBuffer().getBytes(), smallDestination.getBuffer().getSizeInBytes() )==0;
+		}
+		if ( !identical )
+			allIdentical = false;
+
+		printf("%-16s %-8s %8.3f ms  x%5.2f  %s\n", kernel.name, Kernels::getInstructionSetName( instructionSet ), 
+			timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+	}
+	return allIdentical;
+}
+
+static RMF::ImageFormat getScaledFormat( const ScalerBenchmark& benchmark, unsigned int width, unsigned int height )
+{
+	return RMF::ImageFormat( std::max( width*benchmark.numerator/benchmark.denominator, 2u ), std::max( height*benchmark.numerator/benchmark.denominator, 2u ), benchmark.encoding );
+}
+
+static bool scaleImages( const RMF::Image& source, RMF::Image& destination, RMF::Image& referenceDestination, RMF::ImageScaler::Filter filter, Kernels::InstructionSet instructionSet )
+{
+	destination.getBuffer().fill( 0 );
+	referenceDestination.getBuffer().fill( 0 );
+	RMF::ImageScaler( source.getFormat(), destination.getFormat(), filter, instructionSet ).scale( source, destination );
+	RMF::ImageScaler( source.getFormat(), destination.getFormat(), filter, Kernels::ScalarInstructionSet ).scale( source, referenceDestination );
+	return memcmp( destination.getBuffer().getBytes(), referenceDestination.getBuffer().getBytes(), destination.getBuffer().getSizeInBytes() )==0;
+}
+
+// Same as benchmarkYUV420Kernel(), for the ImageScaler with each filter. The small sizes cover 
+// the remainders of the vector loops, and the filters reading past the edges of the source
+static bool benchmarkScaler( const ScalerBenchmark& benchmark, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image source( RMF::ImageFormat( width, height, benchmark.encoding ) );
+	RMF::Image destination( getScaledFormat( benchmark, width, height ) );
+	RMF::Image referenceDestination( destination.getFormat() );
+	fillWithRandomBytes( source.getBuffer() );
+
+	bool allIdentical = true;
+	for ( int f=0; f<RMF::ImageScaler::FilterCount; ++f )
+	{
+		RMF::ImageScaler::Filter filter = static_cast<RMF::ImageScaler::Filter>(f);
+		double referenceTimeInMs = 0;
+		for ( int i=0; i<Kernels::InstructionSetCount; ++i )
+		{
+			Kernels::InstructionSet instructionSet = static_cast<Kernels::InstructionSet>(i);
+			if ( !Kernels::isInstructionSetSupported( instructionSet ) )
+				continue;
+
+			RMF::ImageScaler scaler( source.getFormat(), destination.getFormat(), filter, instructionSet );
+			Clock::time_point startTime = Clock::now();
+			for ( unsigned int j=0; j<numIterations; ++j )
+				scaler.scale( source, destination );
+			double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+			if ( instructionSet==Kernels::ScalarInstructionSet )
+				referenceTimeInMs = timeInMs;
+
+			bool identical = scaleImages( source, destination, referenceDestination, filter, instructionSet );
+			for ( unsigned int smallWidth=2; smallWidth<=96 && identical; ++smallWidth )
+			{
+				RMF::Image smallSource( RMF::ImageFormat( smallWidth, 6, benchmark.encoding ) );
+				RMF::Image smallDestination( getScaledFormat( benchmark, smallWidth, 6 ) );
+				RMF::Image smallReferenceDestination( smallDestination.getFormat() );
+				fillWithRandomBytes( smallSource.getBuffer() );
+				identical = scaleImages( smallSource, smallDestination, smallReferenceDestination, filter, instructionSet );
+			}
+			if ( !identical )
+				allIdentical = false;
+
+			printf("%-8s %-8s %-7s %8.3f ms  x%5.2f  %s\n", benchmark.name, RMF::ImageScaler::getFilterName( filter ), 
+				Kernels::getInstructionSetName( instructionSet ), timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+		}
+	}
+	return allIdentical;
+}
+
+// Converts a YUYV image with the given options and compares the result with a single-threaded conversion
+static bool benchmarkImageConverter( const char* name, const RMF::ImageConverter::Options& options, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image yuyvImage( RMF::ImageFormat( width, height, RMF::ImageFormat::YUYV ) );
+	RMF::Image rgb24Image( RMF::ImageFormat( width, height, RMF::ImageFormat::RGB24 ) );
+	RMF::Image referenceRGB24Image( RMF::ImageFormat( width, height, RMF::ImageFormat::RGB24 ) );
+	fillWithRandomBytes( yuyvImage.getBuffer() );
+	RMF::ImageConverter::convertImage( yuyvImage, referenceRGB24Image );
+
+	Clock::time_point startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+		RMF::ImageConverter::convertImage( yuyvImage, rgb24Image, options );
+	double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+	
+	bool identical = memcmp( rgb24Image.getBuffer().getBytes(), referenceRGB24Image.getBuffer().getBytes(), rgb24Image.getBuffer().getSizeInBytes() )==0;
+	printf("%-25s %8.3f ms  %s\n", name, timeInMs, identical ? "identical" : "DIFFERENT" );
+	return identical;
+}
+
+// Converts a YUYV image to an RGB24 preview a sixth of its size, and compares the result with 
+// scaling the YUYV image then converting it
+static bool benchmarkPreviewImageConverter( const char* name, const RMF::ImageConverter::Options& options, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	unsigned int previewWidth = (width+5) / 6;
+	unsigned int previewHeight = (height+5) / 6;
+	RMF::Image yuyvImage( RMF::ImageFormat( width, height, RMF::ImageFormat::YUYV ) );
+	RMF::Image yuyvPreviewImage( RMF::ImageFormat( previewWidth, previewHeight, RMF::ImageFormat::YUYV ) );
+	RMF::Image rgb24Image( RMF::ImageFormat( previewWidth, previewHeight, RMF::ImageFormat::RGB24 ) );
+	RMF::Image referenceRGB24Image( RMF::ImageFormat( previewWidth, previewHeight, RMF::ImageFormat::RGB24 ) );
+	fillWithRandomBytes( yuyvImage.getBuffer() );
+	RMF::ImageScaler::scaleImage( yuyvImage, yuyvPreviewImage, options.scalingFilter );
+	RMF::ImageConverter::convertImage( yuyvPreviewImage, referenceRGB24Image );
+
+	RMF::ImageConverter converter( rgb24Image.getFormat(), options );
+	Clock::time_point startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+		converter.update( yuyvImage );
+	double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+	
+	bool identical = memcmp( converter.getImage().getBuffer().getBytes(), referenceRGB24Image.getBuffer().getBytes(), referenceRGB24Image.getBuffer().getSizeInBytes() )==0;
+	printf("%-25s %8.3f ms  %s\n", name, timeInMs, identical ? "identical" : "DIFFERENT" );
+	return identical;
+}
+
+// Converts a YUYV image to an RGB24 image turned a quarter clockwise, and compares the result 
+// and the time with transforming the YUYV image then converting it, in two passes
+static bool benchmarkRotatedImageConverter( const char* name, const RMF::ImageConverter::Options& options, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image yuyvImage( RMF::ImageFormat( width, height, RMF::ImageFormat::YUYV ) );
+	RMF::Image rotatedYUYVImage( RMF::ImageTransformer::getTransformedFormat( yuyvImage.getFormat(), RMF::ImageTransformer::Rotate90 ) );
+	RMF::Image rgb24Image( RMF::ImageFormat( height, width, RMF::ImageFormat::RGB24 ) );
+	RMF::Image referenceRGB24Image( RMF::ImageFormat( height, width, RMF::ImageFormat::RGB24 ) );
+	fillWithRandomBytes( yuyvImage.getBuffer() );
+
+	// The YUYV macroblocks can't be split: both ways fail when the width or the height is odd
+	if ( !RMF::ImageTransformer::canTransform( yuyvImage.getFormat(), rotatedYUYVImage.getFormat(), RMF::ImageTransformer::Rotate90 ) )
+	{
+		RMF::ImageConverter::Options rotatingOptions = options;
+		rotatingOptions.transform = RMF::ImageTransformer::Rotate90;
+		bool failed = !RMF::ImageConverter::convertImage( yuyvImage, rgb24Image, rotatingOptions );
+		printf("%-25s %s\n", name, failed ? "unsupported" : "DIFFERENT" );
+		return failed;
+	}
+
+	Clock::time_point startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+	{
+		RMF::ImageTransformer::transformImage( yuyvImage, rotatedYUYVImage, RMF::ImageTransformer::Rotate90, options.threadPool );
+		RMF::ImageConverter::convertImage( rotatedYUYVImage, referenceRGB24Image, options );
+	}
+	double referenceTimeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+
+	RMF::ImageConverter::Options rotatingOptions = options;
+	rotatingOptions.transform = RMF::ImageTransformer::Rotate90;
+	RMF::ImageConverter converter( rgb24Image.getFormat(), rotatingOptions );
+	startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+		converter.update( yuyvImage );
+	double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+
+	bool identical = memcmp( converter.getImage().getBuffer().getBytes(), referenceRGB24Image.getBuffer().getBytes(), referenceRGB24Image.getBuffer().getSizeInBytes() )==0;
+	printf("%-25s %8.3f ms  x%5.2f  %s\n", name, timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+	return identical;
+}
+
+// Converts four regions of a YUYV image, a sixteenth of its area each, to RGB24 images, and compares 
+// the result and the time with converting the whole YUYV image then cropping the RGB24 one
+static bool benchmarkRegionsImageConverter( const char* name, const RMF::ImageConverter::Options& options, unsigned int width, unsigned int height, unsigned int numIterations )
+{
+	RMF::Image yuyvImage( RMF::ImageFormat( width, height, RMF::ImageFormat::YUYV ) );
+	RMF::Image wholeRGB24Image( RMF::ImageFormat( width, height, RMF::ImageFormat::RGB24 ) );
+	fillWithRandomBytes( yuyvImage.getBuffer() );
+
+	const unsigned int numRegions = 4;
+	std::vector<RMF::ImageRegion> regions;
+	std::vector<RMF::Image*> rgb24Images;
+	std::vector<RMF::Image*> referenceRGB24Images;
+	std::vector<RMF::ImageView> rgb24Views;
+	for ( unsigned int i=0; i<numRegions; ++i )
+	{
+		RMF::ImageRegion region( width*(2*i+1)/11, height*i/5, width/4, height/4 );
+		region = RMF::ImageView::alignRegion( yuyvImage.getFormat(), RMF::ImageFormat::RGB24, region );
+		regions.push_back( region );
+		rgb24Images.push_back( new RMF::Image( RMF::ImageFormat( region.width, region.height, RMF::ImageFormat::RGB24 ) ) );
+		referenceRGB24Images.push_back( new RMF::Image( rgb24Images.back()->getFormat() ) );
+		rgb24Views.push_back( *rgb24Images.back() );
+	}
+
+	Clock::time_point startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+	{
+		RMF::ImageConverter::convertImage( yuyvImage, wholeRGB24Image, options );
+		for ( unsigned int j=0; j<numRegions; ++j )
+			referenceRGB24Images[j]->copyFrom( RMF::ConstImageView( wholeRGB24Image ).getRegion( regions[j] ) );
+	}
+	double referenceTimeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+
+	startTime = Clock::now();
+	for ( unsigned int i=0; i<numIterations; ++i )
+		RMF::ImageConverter::convertRegions( yuyvImage, regions, rgb24Views, options );
+	double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+
+	bool identical = true;
+	for ( unsigned int i=0; i<numRegions; ++i )
+	{
+		if ( memcmp( rgb24Images[i]->getBuffer().getBytes(), referenceRGB24Images[i]->getBuffer().getBytes(), rgb24Images[i]->getBuffer().getSizeInBytes() )!=0 )
+			identical = false;
+		delete rgb24Images[i];
+		delete referenceRGB24Images[i];
+	}
+	printf("%-25s %8.3f ms  x%5.2f  %s\n", name, timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+	return identical;
+}
+
+// Converts images of an odd width between all the encodings, into destinations filled with 
+// zeros then with 0xFF. Every byte must be written, so both give the same result
+static bool checkOddWidths()
+{
+	bool allWritten = true;
+	for ( int i=0; i<RMF::ImageFormat::EncodingCount; ++i )
+	{
+		RMF::Image sourceImage( RMF::ImageFormat( 37, 6, static_cast<RMF::ImageFormat::Encoding>(i) ) );
+		fillWithRandomBytes( sourceImage.getBuffer() );
+		for ( int j=0; j<RMF::ImageFormat::EncodingCount; ++j )
+		{
+			RMF::ImageFormat destinationFormat( 37, 6, static_cast<RMF::ImageFormat::Encoding>(j) );
+			if ( i==j )
+				continue;
+			RMF::Image zeroedImage( destinationFormat );
+			RMF::Image filledImage( destinationFormat );
+			zeroedImage.getBuffer().fill( 0 );
+			filledImage.getBuffer().fill( 0xFF );
+			bool converted = RMF::ImageConverter::convertImage( sourceImage, zeroedImage ) && RMF::ImageConverter::convertImage( sourceImage, filledImage );
+			if ( converted && memcmp( zeroedImage.getBuffer().getBytes(), filledImage.getBuffer().getBytes(), zeroedImage.getBuffer().getSizeInBytes() )==0 )
+				continue;
+			printf("%s to %s, odd width: %s\n", sourceImage.getFormat().getEncodingName(), destinationFormat.getEncodingName(), converted ? "DIFFERENT" : "FAILED" );
+			allWritten = false;
+		}
+	}
+	return allWritten;
+}
+
+// Converts between the YUV and gray encodings, from BT.709 in full range to BT.601 in limited 
+// range, with convertImage() and update(). Both must convert the colors, as through RGB24. 
+// GRAY16 to GRAY16 has no path, as it would lose the 16-bit luma
+static bool checkColorChanges()
+{
+	bool allConverted = true;
+	for ( int i=0; i<RMF::ImageFormat::EncodingCount; ++i )
+	{
+		RMF::ImageFormat::Encoding sourceEncoding = static_cast<RMF::ImageFormat::Encoding>(i);
+		if ( RMF::ImageFormat::isRGB( sourceEncoding ) )
+			continue;
+		RMF::Image sourceImage( RMF::ImageFormat( 38, 6, sourceEncoding, RMF::ImageFormat::BT709, RMF::ImageFormat::FullRange ) );
+		fillWithRandomBytes( sourceImage.getBuffer() );
+		RMF::Image rgbImage( RMF::ImageFormat( 38, 6, RMF::ImageFormat::RGB24 ) );
+		if ( !RMF::ImageConverter::convertImage( sourceImage, rgbImage ) )
+			return false;
+		for ( int j=0; j<RMF::ImageFormat::EncodingCount; ++j )
+		{
+			RMF::ImageFormat destinationFormat( 38, 6, static_cast<RMF::ImageFormat::Encoding>(j) );
+			if ( destinationFormat.isRGB() || ( sourceEncoding==RMF::ImageFormat::GRAY16 && destinationFormat.getEncoding()==RMF::ImageFormat::GRAY16 ) )
+				continue;
+			RMF::Image referenceImage( destinationFormat );
+			RMF::Image destinationImage( destinationFormat );
+			RMF::ImageConverter converter( destinationFormat );
+			bool converted = RMF::ImageConverter::convertImage( rgbImage, referenceImage ) && 
+							 RMF::ImageConverter::convertImage( sourceImage, destinationImage ) && 
+							 converter.update( sourceImage );
+			std::size_t size = referenceImage.getBuffer().getSizeInBytes();
+			if ( converted && memcmp( destinationImage.getBuffer().getBytes(), referenceImage.getBuffer().getBytes(), size )==0 &&
+				 memcmp( converter.getImage().getBuffer().getBytes(), referenceImage.getBuffer().getBytes(), size )==0 )
+				continue;
+			printf("%s to %s, BT.709 full to BT.601 limited: %s\n", sourceImage.getFormat().getEncodingName(), destinationFormat.getEncodingName(), converted ? "DIFFERENT" : "FAILED" );
+			allConverted = false;
+		}
+	}
+	return allConverted;
+}
+
+int main( int argc, char** argv )
+{
+	unsigned int width = 1920;
+	unsigned int height = 1080;
+	unsigned int numIterations = 100;
+	unsigned int numThreads = 0;
+	if ( argc>=4 )
+	{
+		width = static_cast<unsigned int>( atoi(argv[1]) );
+		height = static_cast<unsigned int>( atoi(argv[2]) );
+		numIterations = static_cast<unsigned int>( atoi(argv[3]) );
+		if ( argc>=5 )
+			numThreads = static_cast<unsigned int>( atoi(argv[4]) );
+	}
+	else if ( argc>1 )
+	{
+		printf("Usage: %s [width height numIterations [numThreads]]\n", argv[0]);
+		return 1;
+	}
+
+	printf("CPU features: %s\n", RMF::CPUFeatures::toString().c_str() );
+	printf("%ux%u pixels, %u iterations\n", width, height, numIterations );
+
+	bool allIdentical = true;
+	for ( std::size_t k=0; k<sizeof(kernels)/sizeof(kernels[0]); ++k )
+	{
+		const Kernel& kernel = kernels[k];
+		RMF::MemoryBuffer source( getSourceFormat( kernel, width, height ).getDataSizeInBytes() );
+		RMF::MemoryBuffer destination( getDestinationFormat( kernel, width, height ).getDataSizeInBytes() );
+		RMF::MemoryBuffer referenceDestination( getDestinationFormat( kernel, width, height ).getDataSizeInBytes() );
+		fillWithRandomBytes( source );
+		
+		RowFunction referenceConvertRow = getKernelFunction( kernel, Kernels::ScalarInstructionSet );
+		convertImage( referenceConvertRow, kernel, source, referenceDestination, width, height );
+
+		double referenceTimeInMs = 0;
+		for ( int variant=0; variant<variantCount; ++variant )
+		{
+			RowFunction convertRow = getKernelFunction( kernel, variant );
+			if ( convertRow.isNull() )
+				continue;
+
+			destination.fill( 0 );
+			Clock::time_point startTime = Clock::now();
+			for ( unsigned int j=0; j<numIterations; ++j )
+				convertImage( convertRow, kernel, source, destination, width, height );
+			double timeInMs = std::chrono::duration<double, std::milli>( Clock::now() - startTime ).count() / numIterations;
+			if ( variant==Kernels::ScalarInstructionSet )
+				referenceTimeInMs = timeInMs;
+
+			bool identical = memcmp( destination.getBytes(), referenceDestination.getBytes(), destination.getSizeInBytes() )==0 &&
+							 checkSmallWidths( convertRow, referenceConvertRow, kernel ) &&
+							 ( !kernel.canWorkInPlace || checkInPlace( convertRow, kernel, source, referenceDestination, width, height ) );
+			if ( !identical )
+				allIdentical = false;
+			
+			printf("%-16s %-8s %8.3f ms  x%5.2f  %s\n", kernel.name, getVariantName( variant ), 
+				timeInMs, referenceTimeInMs / timeInMs, identical ? "identical" : "DIFFERENT" );
+		}
+	}
+
+	for ( std::size_t k=0; k<sizeof(yuv420Kernels)/sizeof(yuv420Kernels[0]); ++k )
+	{
+		if ( !benchmarkYUV420Kernel( yuv420Kernels[k], width, height, numIterations ) )
+			allIdentical = false;
+	}
+
+	for ( std::size_t k=0; k<sizeof(rowPairKernels)/sizeof(rowPairKernels[0]); ++k )
+	{
+		if ( !benchmarkRowPairKernel( rowPairKernels[k], width, height, numIterations ) )
+			allIdentical = false;
+	}
+
+	for ( std::size_t k=0; k<sizeof(scalerBenchmarks)/sizeof(scalerBenchmarks[0]); ++k )
+	{
+		if ( !benchmarkScaler( scalerBenchmarks[k], width, height, numIterations ) )
+			allIdentical = false;
+	}
+
+	bool oddWidthsWritten = checkOddWidths();
+	printf("%-25s %s\n", "Odd widths", oddWidthsWritten ? "identical" : "DIFFERENT" );
+	if ( !oddWidthsWritten )
+		allIdentical = false;
+	bool colorsChanged = checkColorChanges();
+	printf("%-25s %s\n", "Color changes", colorsChanged ? "identical" : "DIFFERENT" );
+	if ( !colorsChanged )
+		allIdentical = false;
+
+	RMF::ThreadPool threadPool( numThreads );
+	RMF::ImageConverter::Options options;
+	if ( !benchmarkImageConverter( "YUYV to RGB24, 1 thread", options, width, height, numIterations ) )
+		allIdentical = false;
+	options.yuvToRGBMethod = RMF::ImageConverter::LookupTableMethod;
+	if ( !benchmarkImageConverter( "YUYV to RGB24, tables", options, width, height, numIterations ) )
+		allIdentical = false;
+	options.yuvToRGBMethod = RMF::ImageConverter::MultiplyMethod;
+	options.threadPool = &threadPool;
+	char name[64];
+	snprintf( name, sizeof(name), "YUYV to RGB24, %u threads", threadPool.getNumThreads()+1 );
+	if ( !benchmarkImageConverter( name, options, width, height, numIterations ) )
+		allIdentical = false;
+
+	options.threadPool = NULL;
+	if ( !benchmarkPreviewImageConverter( "YUYV to 1/6 RGB24, box", options, width, height, numIterations ) )
+		allIdentical = false;
+	options.scalingFilter = RMF::ImageScaler::BilinearFilter;
+	if ( !benchmarkPreviewImageConverter( "YUYV to 1/6 RGB24, bilin.", options, width, height, numIterations ) )
+		allIdentical = false;
+	options.scalingFilter = RMF::ImageScaler::BoxFilter;
+	options.threadPool = &threadPool;
+	snprintf( name, sizeof(name), "YUYV to 1/6 RGB24, %u thr.", threadPool.getNumThreads()+1 );
+	if ( !benchmarkPreviewImageConverter( name, options, width, height, numIterations ) )
+		allIdentical = false;
+
+	options.threadPool = NULL;
+	if ( !benchmarkRotatedImageConverter( "YUYV to RGB24, rotated", options, width, height, numIterations ) )
+		allIdentical = false;
+	if ( !benchmarkRegionsImageConverter( "YUYV to RGB24, 4 regions", options, width, height, numIterations ) )
+		allIdentical = false;
+
+	return allIdentical ? 0 : 1;
+}
\ No newline at end of file
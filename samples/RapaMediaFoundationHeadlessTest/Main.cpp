@@ -0,0 +1,311 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFDeviceManager.h"
+#include "RMFSyntheticDeviceManagerBackend.h"
+#include "RMFSyntheticDeviceBackend.h"
+#include "RMFReplayDeviceManagerBackend.h"
+#include "RMFImageConverter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+/*
+	A headless test of the whole capture path: a DeviceManager running on the synthetic backend 
+	(or replaying a recording) delivers images to a listener which checks them, converts them 
+	to RGB24 and measures the frame latency and throughput.
+
+	With -zerocopy, the Device runs in zero-copy mode: the listener receives the frames of 
+	the backend, and keeps each one until the next arrives to exercise the reference counting.
+	With -queue depth, the backend queues its images so none is missed when the updates lag.
+	With -bottomup, the synthetic backend stores its images bottom-up, as the single-plane 
+	encodings of some cameras are, and the Device turns them upright.
+
+	Usage: RapaMediaFoundationHeadlessTest [width height encoding frameRate durationInSec] [-zerocopy] [-queue depth] [-bottomup]
+	       RapaMediaFoundationHeadlessTest -replay path [durationInSec [-fast]] [-zerocopy]
+*/
+
+typedef std::chrono::steady_clock Clock;
+
+static double toMilliseconds( Clock::duration duration )
+{
+	return std::chrono::duration<double, std::milli>( duration ).count();
+}
+
+class Statistics
+{
+public:
+	Statistics()
+		: numImages(0), numMissedImages(0), numCorruptedImages(0), lastSequenceNumber(0),
+		  totalLatencyInMs(0), maxLatencyInMs(0), totalConversionTimeInMs(0),
+		  numUpdates(0), totalUpdateTimeInMs(0) {}
+	
+	unsigned int	numImages;
+	unsigned int	numMissedImages;
+	unsigned int	numCorruptedImages;
+	unsigned int	lastSequenceNumber;
+	double			totalLatencyInMs;
+	double			maxLatencyInMs;
+	double			totalConversionTimeInMs;
+	unsigned int	numUpdates;
+	double			totalUpdateTimeInMs;
+};
+
+class DeviceListener : public RMF::Device::Listener
+{
+public:
+	DeviceListener( Statistics& statistics, bool checkSequenceNumbers )
+		: mStatistics(statistics), 
+		  mCheckSequenceNumbers(checkSequenceNumbers),
+		  mConverter(NULL),
+		  mPreviousFrame(NULL)
+	{
+	}
+
+	~DeviceListener()
+	{
+		if ( mPreviousFrame )
+			mPreviousFrame->release();
+		delete mConverter;
+	}
+
+	void setCaptureStartTime( Clock::time_point time )	{ mCaptureStartTime = time; }
+
+	virtual void onDeviceCapturedImage( RMF::Device* device )
+	{
+		Clock::time_point now = Clock::now();
+		const RMF::CapturedImage* capturedImage = device->getCapturedImage();
+		processImage( now, capturedImage->getImage(), capturedImage->getSequenceNumber(), capturedImage->getTimestampInSec() );
+	}
+
+	virtual void onDeviceCapturedFrame( RMF::Device* /*device*/, RMF::CapturedFrame* frame )
+	{
+		Clock::time_point now = Clock::now();
+		
+		// Keep the frame until the next one arrives
+		frame->addReference();
+		if ( mPreviousFrame )
+			mPreviousFrame->release();
+		mPreviousFrame = frame;
+
+		// The checks and the conversion read the frame in place
+		processImage( now, frame->getView(), frame->getSequenceNumber(), frame->getTimestampInSec() );
+	}
+
+private:
+	void processImage( Clock::time_point now, const RMF::ConstImageView& image, unsigned int sequenceNumber, float timestampInSec )
+	{
+		// Latency: how long ago the backend timestamped the image
+		double latencyInMs = toMilliseconds( now - mCaptureStartTime ) - timestampInSec * 1000.0;
+		mStatistics.totalLatencyInMs += latencyInMs;
+		if ( latencyInMs>mStatistics.maxLatencyInMs )
+			mStatistics.maxLatencyInMs = latencyInMs;
+
+		// Check the sequence number burned into the synthetic image matches the one reported
+		unsigned int burnedSequenceNumber = 0;
+		if ( mCheckSequenceNumbers )
+		{
+			if ( !RMF::SyntheticDeviceBackend::readSequenceNumber( image, burnedSequenceNumber ) || burnedSequenceNumber!=sequenceNumber )
+				mStatistics.numCorruptedImages++;
+		}
+		if ( mStatistics.lastSequenceNumber!=0 && sequenceNumber>mStatistics.lastSequenceNumber+1 )
+			mStatistics.numMissedImages += sequenceNumber - mStatistics.lastSequenceNumber - 1;
+		mStatistics.lastSequenceNumber = sequenceNumber;
+		mStatistics.numImages++;
+
+		// Convert
+		if ( !mConverter )
+			mConverter = new RMF::ImageConverter( RMF::ImageFormat( image.getFormat().getWidth(), image.getFormat().getHeight(), RMF::ImageFormat::RGB24 ) );
+		Clock::time_point conversionStartTime = Clock::now();
+		mConverter->update( image );
+		mStatistics.totalConversionTimeInMs += toMilliseconds( Clock::now() - conversionStartTime );
+	}
+
+	Statistics&				mStatistics;
+	bool					mCheckSequenceNumbers;
+	RMF::ImageConverter*	mConverter;
+	RMF::CapturedFrame*		mPreviousFrame;
+	Clock::time_point		mCaptureStartTime;
+};
+
+static RMF::DeviceManager* createSyntheticDeviceManager( int argc, char** argv, bool bottomUp, float& durationInSec )
+{
+	unsigned int width = 1920;
+	unsigned int height = 1080;
+	RMF::ImageFormat::Encoding encoding = RMF::ImageFormat::YUYV;
+	float frameRate = 60.f;
+	if ( argc>=6 )
+	{
+		width = static_cast<unsigned int>( atoi(argv[1]) );
+		height = static_cast<unsigned int>( atoi(argv[2]) );
+		bool encodingFound = false;
+		for ( int i=0; i<RMF::ImageFormat::EncodingCount; ++i )
+		{
+			if ( strcmp( argv[3], RMF::ImageFormat::getEncodingName( static_cast<RMF::ImageFormat::Encoding>(i) ) )==0 )
+			{
+				encoding = static_cast<RMF::ImageFormat::Encoding>(i);
+				encodingFound = true;
+			}
+		}
+		if ( !encodingFound )
+		{
+			printf("Unknown encoding %s\n", argv[3]);
+			return NULL;
+		}
+		frameRate = static_cast<float>( atof(argv[4]) );
+		durationInSec = static_cast<float>( atof(argv[5]) );
+	}
+	else if ( argc>1 )
+	{
+		return NULL;
+	}
+
+	RMF::CaptureSettingsList settingsList;
+	settingsList.push_back( RMF::CaptureSettings( RMF::ImageFormat( width, height, encoding ), frameRate ) );
+	RMF::SyntheticDeviceManagerBackend* backend = new RMF::SyntheticDeviceManagerBackend();
+	backend->addDevice( "Synthetic", settingsList, bottomUp );
+	return new RMF::DeviceManager( backend );
+}
+
+static RMF::DeviceManager* createReplayDeviceManager( int argc, char** argv, float& durationInSec )
+{
+	if ( argc<3 )
+		return NULL;
+	RMF::ReplayDeviceBackend::Options options;
+	if ( argc>=4 )
+		durationInSec = static_cast<float>( atof(argv[3]) );
+	if ( argc>=5 && strcmp( argv[4], "-fast" )==0 )
+		options.pacing = RMF::ReplayDeviceBackend::AsFastAsPossiblePacing;
+	
+	RMF::ReplayDeviceManagerBackend* backend = new RMF::ReplayDeviceManagerBackend();
+	if ( !backend->addDevice( "Replay", argv[2], options ) )
+	{
+		printf("Nothing to replay in %s\n", argv[2]);
+		delete backend;
+		return NULL;
+	}
+	return new RMF::DeviceManager( backend );
+}
+
+// Take an option, and the given number of values following it, out of the arguments
+static bool takeOption( int& argc, char** argv, const char* option, int numValues, char** values )
+{
+	for ( int i=1; i+numValues<argc; ++i )
+	{
+		if ( strcmp( argv[i], option )==0 )
+		{
+			for ( int k=0; k<numValues; ++k )
+				values[k] = argv[i+1+k];
+			for ( int j=i; j<argc-1-numValues; ++j )
+				argv[j] = argv[j+1+numValues];
+			argc -= 1 + numValues;
+			return true;
+		}
+	}
+	return false;
+}
+
+int main( int argc, char** argv )
+{
+	bool zeroCopy = takeOption( argc, argv, "-zerocopy", 0, NULL );
+	char* queueDepthValue = NULL;
+	std::size_t queueDepth = 0;
+	if ( takeOption( argc, argv, "-queue", 1, &queueDepthValue ) )
+		queueDepth = static_cast<std::size_t>( atoi(queueDepthValue) );
+	bool bottomUp = takeOption( argc, argv, "-bottomup", 0, NULL );
+
+	float durationInSec = 5.f;
+	bool replay = argc>1 && strcmp( argv[1], "-replay" )==0;
+	bool fastReplay = replay && argc>=5 && strcmp( argv[4], "-fast" )==0;		// Timestamps are not wall clock then
+	RMF::DeviceManager* deviceManager = NULL;
+	if ( replay )
+		deviceManager = createReplayDeviceManager( argc, argv, durationInSec );
+	else
+		deviceManager = createSyntheticDeviceManager( argc, argv, bottomUp, durationInSec );
+	if ( !deviceManager )
+	{
+		printf("Usage: %s [width height encoding frameRate durationInSec] [-zerocopy] [-queue depth] [-bottomup]\n", argv[0]);
+		printf("       %s -replay path [durationInSec [-fast]] [-zerocopy]\n", argv[0]);
+		return 1;
+	}
+	deviceManager->update();
+	
+	const RMF::Devices& devices = deviceManager->getDevices();
+	if ( devices.empty() || devices[0]->getSupportedCaptureSettingsList().empty() )
+	{
+		printf("No supported capture settings\n");
+		delete deviceManager;
+		return 1;
+	}
+	RMF::Device* device = devices[0];
+	const RMF::CaptureSettings& settings = device->getSupportedCaptureSettingsList()[0];
+	printf("Capturing %s for %g s%s\n", settings.toString().c_str(), durationInSec, zeroCopy ? " in zero-copy mode" : "" );
+	device->setZeroCopyEnabled( zeroCopy );
+	if ( queueDepth>0 && !device->setFrameQueueDepth( queueDepth ) )
+	{
+		printf("The device doesn't support frame queues\n");
+		delete deviceManager;
+		return 1;
+	}
+
+	Statistics statistics;
+	DeviceListener listener( statistics, !replay );
+	device->addListener( &listener );
+
+	Clock::time_point startTime = Clock::now();
+	listener.setCaptureStartTime( startTime );
+	device->startCapture( static_cast<std::size_t>(0) );
+	while ( toMilliseconds( Clock::now() - startTime ) < durationInSec*1000.0 )
+	{
+		Clock::time_point updateStartTime = Clock::now();
+		deviceManager->update();
+		statistics.totalUpdateTimeInMs += toMilliseconds( Clock::now() - updateStartTime );
+		statistics.numUpdates++;
+		std::this_thread::yield();
+	}
+	double elapsedInSec = toMilliseconds( Clock::now() - startTime ) / 1000.0;
+	device->stopCapture();
+	device->removeListener( &listener );
+
+	unsigned int numImages = statistics.numImages;
+	printf("Images received:    %u (%.2f images/s)\n", numImages, numImages / elapsedInSec );
+	printf("Images missed:      %u\n", statistics.numMissedImages );
+	printf("Images corrupted:   %u\n", statistics.numCorruptedImages );
+	if ( queueDepth>0 )
+		printf("Images dropped:     %u (queue depth %u)\n", device->getNumDroppedFrames(), static_cast<unsigned int>(queueDepth) );
+	if ( numImages>0 )
+	{
+		if ( !fastReplay )
+			printf("Latency:            %.3f ms average, %.3f ms max\n", statistics.totalLatencyInMs / numImages, statistics.maxLatencyInMs );
+		printf("Conversion to RGB24: %.3f ms average\n", statistics.totalConversionTimeInMs / numImages );
+	}
+	if ( statistics.numUpdates>0 )
+		printf("DeviceManager::update(): %.3f ms average over %u calls\n", statistics.totalUpdateTimeInMs / statistics.numUpdates, statistics.numUpdates );
+	
+	delete deviceManager;
+	deviceManager = NULL;
+
+	return statistics.numCorruptedImages==0 ? 0 : 1;
+}
\ No newline at end of file
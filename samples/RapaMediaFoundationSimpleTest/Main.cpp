@@ -37,7 +37,13 @@ bool writeImageAsRaw( const RMF::Image& image, const char* filename )
 	std::ofstream stream( filename, std::ios::binary|std::ios::out );
 	if ( stream.is_open() )
 	{
-		stream.write( reinterpret_cast<const char*>( image.getBuffer().getBytes() ), image.getBuffer().getSizeInBytes() );
+		// Row by row, the image may have padded or bottom-up rows, and several planes
+		const RMF::ImageFormat& imageFormat = image.getFormat();
+		for ( unsigned int plane=0; plane<imageFormat.getNumPlanes(); ++plane )
+		{
+			for ( unsigned int y=0; y<imageFormat.getPlaneHeight(plane); ++y )
+				stream.write( reinterpret_cast<const char*>( image.getPlaneRow(plane, y) ), imageFormat.getPlaneNumBytesPerLine(plane) );
+		}
 		if ( stream.fail() )
 			return false;
 	}
@@ -50,7 +56,6 @@ bool writeRGB24ImageAsPPM( const RMF::Image& image, const char* filename )
 		return false;
 	
 	const RMF::ImageFormat& imageFormat = image.getFormat();
-	const RMF::MemoryBuffer& imageBuffer = image.getBuffer();
 
 	// Open file and write
 	std::ofstream stream( filename, std::ios::binary|std::ios::out );
@@ -59,7 +64,8 @@ bool writeRGB24ImageAsPPM( const RMF::Image& image, const char* filename )
 		stream << "P6 " << imageFormat.getWidth() << " " << imageFormat.getHeight() << " 255\n";
 		if ( stream.fail() )
 			return false;
-		stream.write( reinterpret_cast<const char*>(imageBuffer.getBytes()), imageBuffer.getSizeInBytes() );
+		for ( unsigned int y=0; y<imageFormat.getHeight(); ++y )
+			stream.write( reinterpret_cast<const char*>( image.getRow(y) ), imageFormat.getNumBytesPerLine() );
 		if ( stream.fail() )
 			return false;
 	}		
@@ -124,7 +124,6 @@ bool QDeviceWidget::writeRGB24ImageAsPPM( const Image& image, const char* filena
 		return false;
 
 	const ImageFormat& imageFormat = image.getFormat();
-	const MemoryBuffer& imageBuffer = image.getBuffer();
 
 	// Open file and write
 	std::ofstream stream( filename, std::ios::binary|std::ios::out );
@@ -133,7 +132,8 @@ bool QDeviceWidget::writeRGB24ImageAsPPM( const Image& image, const char* filena
 		stream << "P6 " << imageFormat.getWidth() << " " << imageFormat.getHeight() << " 255\n";
 		if ( stream.fail() )
 			return false;
-		stream.write( reinterpret_cast<const char*>(imageBuffer.getBytes()), imageBuffer.getSizeInBytes() );
+		for ( unsigned int y=0; y<imageFormat.getHeight(); ++y )
+			stream.write( reinterpret_cast<const char*>( image.getRow(y) ), imageFormat.getNumBytesPerLine() );
 		if ( stream.fail() )
 			return false;
 	}               
@@ -23,6 +23,8 @@
 */
 #include "RMFQImageWidget.h"
 
+#include <algorithm>
+
 namespace RMF
 {
 
@@ -53,10 +55,28 @@ void QImageWidget::paintEvent( QPaintEvent* /*paintEvent*/ )
 		painter.drawImage( QPointF(0,0), mQImageMaker->getQImage() );
 }
 	
-void QImageWidget::setImage( const RMF::Image& image )
+void QImageWidget::setImage( const RMF::ConstImageView& image )
 {
+	// The images larger than the widget are shrunk to fit it, keeping their aspect ratio. 
+	// The converter scales them while converting, for the cost of the displayed pixels only
 	unsigned int width = image.getFormat().getWidth();
 	unsigned int height = image.getFormat().getHeight();
+	unsigned int maxWidth = static_cast<unsigned int>( std::max( this->width(), 1 ) );
+	unsigned int maxHeight = static_cast<unsigned int>( std::max( this->height(), 1 ) );
+	if ( width>maxWidth || height>maxHeight )
+	{
+		if ( static_cast<unsigned long long>(width)*maxHeight > static_cast<unsigned long long>(height)*maxWidth )
+		{
+			height = std::max( static_cast<unsigned int>( static_cast<unsigned long long>(height)*maxWidth / width ), 1u );
+			width = maxWidth;
+		}
+		else
+		{
+			width = std::max( static_cast<unsigned int>( static_cast<unsigned long long>(width)*maxHeight / height ), 1u );
+			height = maxHeight;
+		}
+	}
+
 	int qwidth = 0;
 	int qheight = 0;
 	if ( mQImageMaker )
@@ -68,7 +88,7 @@ void QImageWidget::setImage( const RMF::Image& image )
 	if ( !mQImageMaker || qwidth!=static_cast<int>(width) || qheight!=static_cast<int>(height) )
 	{
 		delete mQImageMaker;
-		mQImageMaker = new QRGB888ImageMaker( width, height );
+		mQImageMaker = new QRGB32ImageMaker( width, height );
 	}
 	mQImageMaker->update( image );
 
@@ -76,38 +96,31 @@ void QImageWidget::setImage( const RMF::Image& image )
 }
 
 /*
-	QRGB888ImageMaker
+	QRGB32ImageMaker
 */
-QRGB888ImageMaker::QRGB888ImageMaker( int width, int height )
-	: mQImage(NULL),
-	  mImageConverter(NULL)
+QRGB32ImageMaker::QRGB32ImageMaker( int width, int height )
+	: mQImage(NULL)
 {
-	ImageFormat rgbFormat( width, height, ImageFormat::RGB24 );
-	mImageConverter = new ImageConverter( rgbFormat );
-	
-	// Get a grip onto the data of the image that serves as output of the ImageConverter
-	uchar* data = reinterpret_cast<uchar*>( mImageConverter->getImage().getBuffer().getBytes() );
-
-	// Create a QImage pointing *directly* onto this data
-	mQImage = new QImage( data, width, height, QImage::Format_RGB888 );
+	mQImage = new QImage( width, height, QImage::Format_RGB32 );
 }
 
-QRGB888ImageMaker::~QRGB888ImageMaker()
+QRGB32ImageMaker::~QRGB32ImageMaker()
 {
 	delete mQImage;
 	mQImage = NULL;
-
-	delete mImageConverter;
-	mImageConverter = NULL;
 }
 	
-bool QRGB888ImageMaker::update( const Image& image )
+bool QRGB32ImageMaker::update( const ConstImageView& image )
 {
-	// Here we just have to update the ImageConverter
-	// It internally updates the Image it contains.
-	// Without having to do anything, this updates the QImage because
-	// it shares its data with the the Image we just updated
-	return mImageConverter->update( image );
+	// View the pixels of the QImage as a RMF image, through the stride of 
+	// the QImage rows in case they're padded
+	ImageFormat rgbFormat( mQImage->width(), mQImage->height(), ImageFormat::BGRX32 );
+	ImageView qimageView( rgbFormat, mQImage->bits(), mQImage->bytesPerLine() );
+
+	// Convert (or copy) straight into them, scaling the image when its size differs
+	if ( image.getFormat()==rgbFormat )
+		return qimageView.copyFrom( image );
+	return ImageConverter::convertImage( image, qimageView );
 }
 
 }
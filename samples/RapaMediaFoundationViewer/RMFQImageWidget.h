@@ -36,18 +36,18 @@
 	#pragma warning( pop )
 #endif
 
-#include "RMFImage.h"
+#include "RMFImageView.h"
 #include "RMFImageConverter.h"
 
 namespace RMF
 {
 
-class QRGB888ImageMaker;
+class QRGB32ImageMaker;
 
 /*
 	QImageWidget
 
-	A widget able to display a RMF Image 
+	A widget able to display a RMF Image, or any view of one
 */
 class QImageWidget: public QFrame
 { 
@@ -57,37 +57,39 @@ public:
 	QImageWidget( QWidget* parent );
 	virtual ~QImageWidget();
 
-	void				setImage( const RMF::Image& image );
+	void				setImage( const RMF::ConstImageView& image );
 
 protected:
 	virtual void		paintEvent( QPaintEvent* paintEvent );
 
 private:
-	QRGB888ImageMaker*	mQImageMaker;
+	QRGB32ImageMaker*	mQImageMaker;
 };
 
 /*
-	QRGB888ImageMaker
+	QRGB32ImageMaker
 	
-	Produces a QImage with the QT RGB888 format from a RMF Image
+	Produces a QImage with the QT RGB32 format from a RMF Image
 	(performs the necessary conversion under the hood)	
+	The QImage owns its pixels: the conversion writes straight into them 
+	through an ImageView. RGB32 is the format QPainter draws the fastest.
 
-	Note: with QT's RGB888 format, if you read the QImage buffer *byte after byte* 
-	then the color components appear in this order: red, green, blue.
-	This format is strictly equivalent to the RMF::ImageFormat::RGB24.
+	Note: QT's RGB32 format stores each pixel as a 0xffRRGGBB 32-bit word. On a 
+	little-endian machine, if you read the QImage buffer *byte after byte* then the 
+	color components appear in this order: blue, green, red, 0xff.
+	This format is then strictly equivalent to the RMF::ImageFormat::BGRX32.
 */
-class QRGB888ImageMaker
+class QRGB32ImageMaker
 {
 public:
-	QRGB888ImageMaker( int width, int height );
-	~QRGB888ImageMaker();
+	QRGB32ImageMaker( int width, int height );
+	~QRGB32ImageMaker();
 	
-	bool			update( const Image& image );
+	bool			update( const ConstImageView& image );
 	const QImage&	getQImage() const { return *mQImage; }
 
 private:
 	QImage*			mQImage;
-	ImageConverter*	mImageConverter;
 };
 
 
@@ -0,0 +1,55 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFBufferCapturedFrame.h"
+
+#include "RMFMemoryBufferPool.h"
+
+namespace RMF
+{
+
+static MemoryBuffer::Options getBufferOptions()
+{
+	MemoryBuffer::Options options;
+	options.zeroFill = false;
+	options.pool = &MemoryBufferPool::getDefault();
+	options.pages = MemoryAllocator::TransparentHugePages;
+	return options;
+}
+
+BufferCapturedFrame::BufferCapturedFrame( const ImageFormat& imageFormat, bool isBottomUp )
+	: CapturedFrame(imageFormat),
+	  mBuffer(imageFormat.getDataSizeInBytes(), getBufferOptions())
+{
+	int numBytesPerLine = static_cast<int>( imageFormat.getNumBytesPerLine() );
+	if ( isBottomUp && imageFormat.getHeight()>0 )
+		setRows( mBuffer.getBytes() + numBytesPerLine * (imageFormat.getHeight()-1), -numBytesPerLine );
+	else
+		setRows( mBuffer.getBytes(), numBytesPerLine );
+}
+
+BufferCapturedFrame::~BufferCapturedFrame()
+{
+}
+
+}
\ No newline at end of file
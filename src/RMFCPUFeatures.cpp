@@ -0,0 +1,115 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFCPUFeatures.h"
+
+#if defined(RMF_X86)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace RMF
+{
+
+#if defined(RMF_X86)
+static void cpuid( unsigned int leaf, unsigned int registers[4] )
+{
+#if defined(_MSC_VER)
+	int values[4];
+	__cpuidex( values, static_cast<int>(leaf), 0 );
+	for ( int i=0; i<4; ++i )
+		registers[i] = static_cast<unsigned int>(values[i]);
+#else
+	__cpuid_count( leaf, 0, registers[0], registers[1], registers[2], registers[3] );
+#endif
+}
+
+static unsigned long long xgetbv()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int eax = 0;
+	unsigned int edx = 0;
+	__asm__ __volatile__( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+	return ( static_cast<unsigned long long>(edx) << 32 ) | eax;
+#endif
+}
+#endif
+
+CPUFeatures::CPUFeatures()
+	: mHasSSE2(false),
+	  mHasSSSE3(false),
+	  mHasAVX2(false),
+	  mHasNEON(false)
+{
+#if defined(RMF_X86)
+	unsigned int registers[4] = { 0, 0, 0, 0 };		// eax, ebx, ecx, edx
+	cpuid( 0, registers );
+	unsigned int maxLeaf = registers[0];
+	if ( maxLeaf<1 )
+		return;
+
+	cpuid( 1, registers );
+	mHasSSE2 = ( registers[3] & (1u<<26) )!=0;
+	mHasSSSE3 = ( registers[2] & (1u<<9) )!=0;
+	
+	// AVX2 needs the OS to save the YMM registers (OSXSAVE set and XCR0 bits 1 and 2 set)
+	bool osSavesYMM = ( registers[2] & (1u<<27) )!=0 && ( xgetbv() & 0x6 )==0x6;
+	if ( osSavesYMM && maxLeaf>=7 )
+	{
+		cpuid( 7, registers );
+		mHasAVX2 = ( registers[1] & (1u<<5) )!=0;
+	}
+#elif defined(RMF_NEON)
+	mHasNEON = true;
+#endif
+}
+
+const CPUFeatures& CPUFeatures::getFeatures()
+{
+	static CPUFeatures features;
+	return features;
+}
+
+std::string CPUFeatures::toString()
+{
+	std::string text;
+	if ( hasSSE2() )
+		text += "SSE2 ";
+	if ( hasSSSE3() )
+		text += "SSSE3 ";
+	if ( hasAVX2() )
+		text += "AVX2 ";
+	if ( hasNEON() )
+		text += "NEON ";
+	if ( text.empty() )
+		return "None";
+	text.erase( text.size()-1 );
+	return text;
+}
+
+}
\ No newline at end of file
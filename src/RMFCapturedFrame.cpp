@@ -0,0 +1,74 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFCapturedFrame.h"
+
+#include <assert.h>
+
+namespace RMF
+{
+
+CapturedFrame::CapturedFrame( const ImageFormat& imageFormat )
+	: mImageFormat(imageFormat),
+	  mView(imageFormat, NULL),
+	  mSequenceNumber(0),
+	  mTimestamp(0),
+	  mReferenceCount(1)
+{
+}
+
+CapturedFrame::~CapturedFrame()
+{
+	assert( mReferenceCount==0 );
+}
+
+void CapturedFrame::setRows( const unsigned char* topRow, int stride )
+{
+	mView = ConstImageView( mImageFormat, topRow, stride );
+}
+
+bool CapturedFrame::copyTo( const ImageView& image ) const
+{
+	return image.copyFrom( getView() );
+}
+
+bool CapturedFrame::copyTo( MemoryBuffer& buffer ) const
+{
+	if ( buffer.getSizeInBytes()!=mImageFormat.getDataSizeInBytes() || mView.isNull() )
+		return false;
+	return ImageView( mImageFormat, buffer.getBytes() ).copyFrom( mView );
+}
+
+void CapturedFrame::addReference()
+{
+	mReferenceCount++;
+}
+
+void CapturedFrame::release()
+{
+	assert( mReferenceCount>0 );
+	if ( --mReferenceCount==0 )
+		delete this;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFCapturedFrameQueue.h"
+
+#include <assert.h>
+
+namespace RMF
+{
+
+CapturedFrameQueue::CapturedFrameQueue( std::size_t depth )
+	: mSlots(depth),
+	  mHead(0),
+	  mTail(0),
+	  mNumPushedFrames(0),
+	  mNumDroppedFrames(0)
+{
+	for ( std::size_t i=0; i<mSlots.size(); ++i )
+		mSlots[i].store( NULL );
+}
+
+CapturedFrameQueue::~CapturedFrameQueue()
+{
+	clear();
+}
+
+bool CapturedFrameQueue::setDepth( std::size_t depth )
+{
+	if ( !isEmpty() )
+		return false;
+	if ( depth==mSlots.size() )
+		return true;
+	std::vector< std::atomic<CapturedFrame*> > slots(depth);
+	mSlots.swap( slots );
+	for ( std::size_t i=0; i<mSlots.size(); ++i )
+		mSlots[i].store( NULL );
+	mHead = 0;
+	mTail = 0;
+	return true;
+}
+
+bool CapturedFrameQueue::push( CapturedFrame* frame )
+{
+	assert( frame );
+	mNumPushedFrames++;
+	std::size_t depth = mSlots.size();
+	if ( depth==0 )
+	{
+		mNumDroppedFrames++;
+		frame->release();
+		return false;
+	}
+
+	bool dropped = false;
+	std::size_t head = mHead.load( std::memory_order_relaxed );
+	std::size_t tail = mTail.load( std::memory_order_acquire );
+	if ( head-tail==depth )
+	{
+		// The queue is full: take the oldest frame out, unless the consumer takes it first
+		// in which case there's room already. Either way the slot at the tail becomes free,  
+		// and it's the one the head points at
+		if ( mTail.compare_exchange_strong( tail, tail+1, std::memory_order_acq_rel ) )
+		{
+			CapturedFrame* oldestFrame = mSlots[head % depth].load( std::memory_order_relaxed );
+			oldestFrame->release();
+			mNumDroppedFrames++;
+			dropped = true;
+		}
+	}
+
+	mSlots[head % depth].store( frame, std::memory_order_relaxed );
+	mHead.store( head+1, std::memory_order_release );
+	return !dropped;
+}
+
+CapturedFrame* CapturedFrameQueue::pop()
+{
+	std::size_t depth = mSlots.size();
+	std::size_t tail = mTail.load( std::memory_order_acquire );
+	for ( ;; )
+	{
+		std::size_t head = mHead.load( std::memory_order_acquire );
+		if ( tail==head )
+			return NULL;
+		
+		// The frame is only ours if the producer didn't drop it in the meantime. If it did, 
+		// the compare-exchange fails, reloads the tail and we try again with the next frame
+		CapturedFrame* frame = mSlots[tail % depth].load( std::memory_order_relaxed );
+		if ( mTail.compare_exchange_weak( tail, tail+1, std::memory_order_acq_rel, std::memory_order_acquire ) )
+			return frame;
+	}
+}
+
+bool CapturedFrameQueue::isEmpty() const
+{
+	return mHead.load( std::memory_order_acquire )==mTail.load( std::memory_order_acquire );
+}
+
+void CapturedFrameQueue::releaseFrames()
+{
+	for ( CapturedFrame* frame=pop(); frame; frame=pop() )
+		frame->release();
+}
+
+void CapturedFrameQueue::clear()
+{
+	releaseFrames();
+	mNumPushedFrames = 0;
+	mNumDroppedFrames = 0;
+}
+
+}
\ No newline at end of file
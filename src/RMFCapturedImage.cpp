@@ -37,4 +37,11 @@ CapturedImage::CapturedImage( ImageFormat imageFormat )
 {
 }
 
+CapturedImage::CapturedImage( ImageFormat imageFormat, const MemoryBuffer::Options& bufferOptions )
+	: mImage(imageFormat, bufferOptions),
+	  mSequenceNumber(0),
+	  mTimestampInSec(0.f)
+{
+}
+
 }
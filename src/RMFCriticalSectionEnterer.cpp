@@ -28,15 +28,15 @@
 namespace RMF
 {
 
-CriticalSectionEnterer::CriticalSectionEnterer( CRITICAL_SECTION& criticalSection )
+CriticalSectionEnterer::CriticalSectionEnterer( CriticalSection& criticalSection )
 	: mCriticalSection( criticalSection )
 {
-	EnterCriticalSection( &mCriticalSection );
+	mCriticalSection.enter();
 }	
 
 CriticalSectionEnterer::~CriticalSectionEnterer()
 {
-	LeaveCriticalSection( &mCriticalSection );
+	mCriticalSection.leave();
 }
 
 }
@@ -24,63 +24,56 @@
 #include "RMFDevice.h"
 
 #include <assert.h>
+#include <cstring>
 #include <algorithm>
-#include "RMFDeviceInternals.h"
+#include "RMFDeviceBackend.h"
+#include "RMFMemoryBufferPool.h"
 
 namespace RMF
 {
 
-Device::Device( void* activateSharedPtrAsVoidPtr, const std::string& name, const std::string& symbolicLink )
+// A view of the image starting from its bottom row, each plane with a negative stride. 
+// Writing rows stored bottom-up into it in order turns them upright
+static ImageView getUpsideDownView( Image& image )
+{
+	ImageView view( image );
+	const ImageFormat& imageFormat = image.getFormat();
+	unsigned char* planeTopRows[ImageFormat::maxNumPlanes] = { NULL };
+	int planeStrides[ImageFormat::maxNumPlanes] = { 0 };
+	for ( unsigned int plane=0; plane<imageFormat.getNumPlanes(); ++plane )
+	{
+		unsigned int planeHeight = imageFormat.getPlaneHeight( plane );
+		planeTopRows[plane] = view.getPlaneRow( plane, planeHeight>0 ? planeHeight-1 : 0 );
+		planeStrides[plane] = -view.getPlaneStride( plane );
+	}
+	return ImageView( imageFormat, planeTopRows, planeStrides );
+}
+
+Device::Device( DeviceBackend* backend, const std::string& name, const std::string& symbolicLink )
 	: mName(name),
 	  mSymbolicLink(symbolicLink),
 	  mSupportedCaptureSettingsList(),
-	  mMediaTypeIndices(),
-	  mInternals(NULL),
+	  mBackend(backend),
 	  mStartedCaptureSettingsIndex(0),
 	  mCapturedImage(NULL),
-	  mTempImage(NULL)
+	  mZeroCopyEnabled(false),
+	  mCapturedFrame(NULL)
 {
-	COMObjectSharedPtr<IMFActivate>& activateSharedPtr = *(reinterpret_cast< COMObjectSharedPtr<IMFActivate>* >( activateSharedPtrAsVoidPtr ));
-	mInternals = new DeviceInternals( activateSharedPtr, name );
-
-	// Convert the supported VideoMediaTypes of the DeviceInternals into a CaptureSettingsList
-	// We only keep the types that our Image class can handle
-	CaptureSettingsList settingsList;
-	const DeviceInternals::VideoMediaTypes&	mediaTypes = mInternals->getSupportedVideoMediaTypes();
-	for ( std::size_t index=0; index<mediaTypes.size(); ++index )
-	{
-		const DeviceInternals::VideoMediaType mediaType = mediaTypes[index];
-		
-		bool supported = true;
-		ImageFormat::Encoding encoding = ImageFormat::BGR24;
-		if ( mediaType.subType==MFVideoFormat_RGB24 )
-			encoding = ImageFormat::BGR24;
-		else if ( mediaType.subType==MFVideoFormat_YUY2 )
-			encoding = ImageFormat::YUYV;
-		else 
-			supported = false;
-
-		if ( supported )
-		{
-			ImageFormat imageFormat = ImageFormat( mediaType.width, mediaType.height, encoding );
-			CaptureSettings settings( imageFormat, static_cast<float>( mediaType.frameRate ) );
-			mSupportedCaptureSettingsList.push_back( settings );
-			mMediaTypeIndices.push_back(index);
-		}
-	}
+	assert( mBackend );
+	mSupportedCaptureSettingsList = mBackend->getSupportedCaptureSettingsList();
 }
 
 Device::~Device()
 {
 	if ( isCapturing() )
 		stopCapture();
-	delete mInternals;
-	mInternals = NULL;
+	delete mBackend;
+	mBackend = NULL;
 }
 
 bool Device::isCapturing() const
 {
-	return mInternals->isCapturing();
+	return mBackend->isCapturing();
 }
 
 bool Device::startCapture( const CaptureSettings& captureSettings )
@@ -108,21 +101,20 @@ bool Device::startCapture( std::size_t captureSettingsIndex )
 	mStartedCaptureSettingsIndex = static_cast<unsigned int>(captureSettingsIndex);
 	
 	// Prepare the Image that will receive the data when the update method is called
+	// In zero-copy mode, the frames of the backend are used instead.
+	// The images come from the default pool, so restarting a capture doesn't allocate 
+	// fresh memory, and they're not zero-filled as they're overwritten before use.
+	// Large ones are backed by huge pages when the system allows it
 	const CaptureSettings& captureSettings = mSupportedCaptureSettingsList[mStartedCaptureSettingsIndex];
-	mCapturedImage = new CapturedImage( captureSettings.getImageFormat() );
-	
-	// Find the MediaType corresponding to the index of the CaptureSettings to use
-	assert( mStartedCaptureSettingsIndex<mMediaTypeIndices.size() );
-	int mediaTypeIndex = static_cast<int>(mMediaTypeIndices[mStartedCaptureSettingsIndex]);
-	const DeviceInternals::VideoMediaType& mediaType = mInternals->getSupportedVideoMediaTypes()[mediaTypeIndex];
-
-	// Prepare an image for vertical flip if necessary
-	assert( !mTempImage );
-	if ( mediaType.stride<0 )
-		mTempImage = new Image( captureSettings.getImageFormat() );
+	MemoryBuffer::Options bufferOptions;
+	bufferOptions.zeroFill = false;
+	bufferOptions.pool = &MemoryBufferPool::getDefault();
+	bufferOptions.pages = MemoryAllocator::TransparentHugePages;
+	if ( !mZeroCopyEnabled )
+		mCapturedImage = new CapturedImage( captureSettings.getImageFormat(), bufferOptions );
 	
 	// Start the capture
-	bool ret = mInternals->startCapture( mediaTypeIndex );
+	bool ret = mBackend->startCapture( mStartedCaptureSettingsIndex );
 	if ( ret )
 	{
 		// Notify
@@ -131,8 +123,8 @@ bool Device::startCapture( std::size_t captureSettingsIndex )
 	}
 	else
 	{
-		delete mTempImage;
-		mTempImage = NULL;
+		delete mCapturedImage;
+		mCapturedImage = NULL;
 	}
 
 	return ret;
@@ -165,96 +157,99 @@ void Device::stopCapture()
 	for ( Listeners::const_iterator itr=mListeners.begin(); itr!=mListeners.end(); ++itr )
 		(*itr)->onDeviceStopping( this );
 
-	mInternals->stopCapture();
+	mBackend->stopCapture();
 
 	// Delete the CaptureImage that receives the data
 	delete mCapturedImage;
 	mCapturedImage = NULL;
-	
-	// Also delete the TempImage when that is only created when a vertical flip is needed
-	delete mTempImage;
-	mTempImage = NULL;
+
+	// Give the latest frame back
+	if ( mCapturedFrame )
+		mCapturedFrame->release();
+	mCapturedFrame = NULL;
 
 	mStartedCaptureSettingsIndex = 0;
 }
 
-bool Device::flipImageVertically( const Image& sourceImage, Image& destinationImage )
+bool Device::setZeroCopyEnabled( bool enabled )
 {
-	if ( sourceImage.getFormat()!=destinationImage.getFormat() )
+	if ( isCapturing() )
 		return false;
-	unsigned int height = sourceImage.getFormat().getHeight();
-	unsigned int numBytesPerLine = sourceImage.getFormat().getNumBytesPerLine();
-	const unsigned char* sourceBytes = sourceImage.getBuffer().getBytes();
-	unsigned char* destinationBytes = destinationImage.getBuffer().getBytes() + ( numBytesPerLine * (height-1) );
-	for ( unsigned int y=0; y<height; ++y )
-	{
-		memcpy( destinationBytes, sourceBytes, numBytesPerLine );
-		destinationBytes -= numBytesPerLine;
-		sourceBytes += numBytesPerLine;
-	}
-	
+	if ( !mBackend->setZeroCopyEnabled( enabled ) )
+		return false;
+	mZeroCopyEnabled = enabled;
 	return true;
 }
 
+bool Device::setFrameQueueDepth( std::size_t depth )
+{
+	if ( isCapturing() )
+		return false;
+	return mBackend->setFrameQueueDepth( depth );
+}
+
+std::size_t Device::getFrameQueueDepth() const
+{
+	return mBackend->getFrameQueueDepth();
+}
+
+unsigned int Device::getNumDroppedFrames() const
+{
+	return mBackend->getNumDroppedFrames();
+}
+
 void Device::update()
 {
 	if ( !isCapturing() )
 		return;
 
+	if ( mBackend->getFrameQueueDepth()>0 )
+		updateFromFrameQueue();
+	else if ( mZeroCopyEnabled )
+		updateCapturedFrame();
+	else
+		updateCapturedImage();
+}
+
+void Device::updateCapturedImage()
+{
 	assert( mCapturedImage );
 
+	// Nothing to do if the backend hasn't captured a new image since the last update
+	unsigned int latestSequenceNumber = mBackend->getCapturedImageSequenceNumber();
+	if ( latestSequenceNumber==0 || latestSequenceNumber==mCapturedImage->getSequenceNumber() )
+		return;
+
 	unsigned int sequenceNumber = 0;
-	LONGLONG timestamp = 0;
+	long long timestamp = 0;
 		
-	if ( mTempImage )
+	if ( mBackend->isBottomUp( mStartedCaptureSettingsIndex ) )
 	{
-		// If we need to flip the image vertically, we ask the Internals object
-		// to copy its image buffer into the temporary Image
-		MemoryBuffer& buffer = mTempImage->getBuffer();
-		bool ret = mInternals->getCapturedImage( buffer, sequenceNumber, timestamp );
+		// The backend copies the bottom-up image row by row as it stores it, into a view of the 
+		// CapturedImage that starts from its bottom row: the rows land upright in a single pass
+		bool ret = mBackend->getCapturedImage( getUpsideDownView( mCapturedImage->getImage() ), sequenceNumber, timestamp );
 		
 		// It's legal for getCapturedImage() to fail even though isCapturing() returns true
 		// This happens when the camera has just started but hasn't captured the first image yet
 		if ( !ret )
 			return;
-
-		// We can then copy+flip the Temp image into the final CaptureImage
-		Image& capturedImage = mCapturedImage->getImage();
-		assert( mTempImage->getFormat()==capturedImage.getFormat() );
-		ret = flipImageVertically( *mTempImage, capturedImage );
-		assert( ret );	
-
-		// Note: in theory we could have the Internals object perform this copy+flip
-		// in one go and avoid having the Temp image at all, but I wanted the Internals
-		// to be dumb and simply fill a blob (a MemoryBuffer) with timestamp and 
-		// sequence number. I didn't want it to know anything about our Image class 
-		// and how to flip its contents. The Internals object is in theory capable of
-		// returning a complex blob like a JPG image (that happens when it's capturing
-		// in MJPG on the Apple FaceTime HD Camera for example, though we don't exploit
-		// this format yet). So introducing a flip option in the Internals would be a
-		// bit weird I think
 	}	
 	else
 	{
-		// When there's no flip involved, the CapturedImage is directly filled from
-		// the Internals object 
+		// The CapturedImage is directly filled from the backend 
 		MemoryBuffer& buffer = mCapturedImage->getImage().getBuffer();
-		bool ret = mInternals->getCapturedImage( buffer, sequenceNumber, timestamp );
+		bool ret = mBackend->getCapturedImage( buffer, sequenceNumber, timestamp );
 
 		// See comment above
 		if ( !ret )
 			return;
 	}
 	
-	
-	// Note: the sign of the stride in the underlying MediaType dictates whether we should
-	// flip the the image vertically. We don't do it for now...
-
 	// Set the sequence number
 	mCapturedImage->setSequenceNumber( sequenceNumber );
 	
 	// Set the timestamp
-	// The timestamp coming form the Internals object is in 100 nanosecond units
+	// The timestamp coming form the backend is in 100 nanosecond units
 	// http://msdn.microsoft.com/fr-fr/library/windows/desktop/dd374658(v=vs.85).aspx
 	float timestampInSec = static_cast<float>(timestamp) /  1e7f;		
 	mCapturedImage->setTimestampInSec( timestampInSec );	
@@ -264,6 +259,70 @@ void Device::update()
 		(*itr)->onDeviceCapturedImage( this );
 }
 
+void Device::updateCapturedFrame()
+{
+	// Same as above
+	unsigned int latestSequenceNumber = mBackend->getCapturedImageSequenceNumber();
+	unsigned int sequenceNumber = mCapturedFrame ? mCapturedFrame->getSequenceNumber() : 0;
+	if ( latestSequenceNumber==0 || latestSequenceNumber==sequenceNumber )
+		return;
+
+	CapturedFrame* frame = mBackend->acquireCapturedFrame( mStartedCaptureSettingsIndex );
+	if ( !frame )
+		return;
+	deliverCapturedFrame( frame );
+}
+
+void Device::updateFromFrameQueue()
+{
+	// Deliver at most a queue worth of frames, so the update returns even if the backend
+	// captures faster than the listeners consume. A listener may also stop the capture
+	std::size_t depth = mBackend->getFrameQueueDepth();
+	for ( std::size_t i=0; i<depth && isCapturing(); ++i )
+	{
+		CapturedFrame* frame = mBackend->popCapturedFrame();
+		if ( !frame )
+			return;
+
+		if ( mZeroCopyEnabled )
+		{
+			deliverCapturedFrame( frame );
+			continue;
+		}
+
+		// Copy the frame into the CapturedImage. This takes care of the bottom-up images. 
+		// A frame that can't be copied is skipped
+		assert( mCapturedImage );
+		bool ret = frame->copyTo( mCapturedImage->getImage() );
+		if ( ret )
+		{
+			mCapturedImage->setSequenceNumber( frame->getSequenceNumber() );
+			mCapturedImage->setTimestampInSec( frame->getTimestampInSec() );
+		}
+		frame->release();
+		if ( !ret )
+			continue;
+
+		// Notify
+		for ( Listeners::const_iterator itr=mListeners.begin(); itr!=mListeners.end(); ++itr )
+			(*itr)->onDeviceCapturedImage( this );
+	}
+}
+
+// Takes over the reference of the caller on the frame
+void Device::deliverCapturedFrame( CapturedFrame* frame )
+{
+	// The frame replaces the previous one, which is given back to the backend
+	// unless a listener kept a reference to it
+	if ( mCapturedFrame )
+		mCapturedFrame->release();
+	mCapturedFrame = frame;
+
+	// Notify
+	for ( Listeners::const_iterator itr=mListeners.begin(); itr!=mListeners.end(); ++itr )
+		(*itr)->onDeviceCapturedFrame( this, mCapturedFrame );
+}
+
 void Device::addListener( Listener* listener )
 {
 	assert(listener);
@@ -0,0 +1,51 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFDeviceBackend.h"
+
+#include "RMFBufferCapturedFrame.h"
+
+namespace RMF
+{
+
+CapturedFrame* DeviceBackend::acquireCapturedFrame( std::size_t captureSettingsIndex ) const
+{
+	const CaptureSettingsList& captureSettingsList = getSupportedCaptureSettingsList();
+	if ( captureSettingsIndex>=captureSettingsList.size() )
+		return NULL;
+
+	const ImageFormat& imageFormat = captureSettingsList[captureSettingsIndex].getImageFormat();
+	BufferCapturedFrame* frame = new BufferCapturedFrame( imageFormat, isBottomUp( captureSettingsIndex ) );
+	unsigned int sequenceNumber = 0;
+	long long timestamp = 0;
+	if ( !getCapturedImage( frame->getBuffer(), sequenceNumber, timestamp ) )
+	{
+		frame->release();
+		return NULL;
+	}
+	frame->setSequenceNumber( sequenceNumber );
+	frame->setTimestamp( timestamp );
+	return frame;
+}
+
+}
\ No newline at end of file
@@ -61,7 +61,9 @@ DeviceInternals::VideoMediaType::VideoMediaType()
 	: width(0),
 	  height(0),
 	  frameRate(0),
-	  subType()
+	  subType(),
+	  yuvMatrix(0),
+	  nominalRange(0)
 {
 }
 
@@ -70,7 +72,9 @@ bool DeviceInternals::VideoMediaType::operator==( const DeviceInternals::VideoMe
 	return	width==other.width &&
 			height==other.height &&
 			frameRate==other.frameRate &&
-			subType==other.subType;
+			subType==other.subType &&
+			yuvMatrix==other.yuvMatrix &&
+			nominalRange==other.nominalRange;
 }
 
 bool DeviceInternals::VideoMediaType::operator!=( const DeviceInternals::VideoMediaType& other ) const
@@ -120,7 +124,7 @@ std::string DeviceInternals::VideoMediaType::getSubTypeName( const GUID& mediaTy
 std::string DeviceInternals::VideoMediaType::toString() const
 {
 	std::stringstream stream;
-	stream << "width:" << width << " height:" << height << " stride:" << stride << " frameRate:" << frameRate << " subType:" << getSubTypeName();
+	stream << "width:" << width << " height:" << height << " stride:" << stride << " frameRate:" << frameRate << " subType:" << getSubTypeName() << " yuvMatrix:" << yuvMatrix << " nominalRange:" << nominalRange;
 	return stream.str();
 }
 
@@ -134,12 +138,14 @@ DeviceInternals::DeviceInternals( const COMObjectSharedPtr<IMFActivate>& activat
 	  mReferenceCounter(1),
 	  mSourceReaderRes(),
 	  mIsCapturing(false),
+	  mCapturedMediaTypeIndex(0),
+	  mCapturedImageFormat(),
 	  mCapturedImageNumber(0),
-	  mCapturedImageTimestamp(0),
-	  mCapturedImageBuffer(NULL)
+	  mZeroCopyEnabled(false),
+	  mCapturedFrame(NULL),
+	  mFrames(),
+	  mFrameQueue()
 {
-	InitializeCriticalSection( &mCriticalSection );
-
 	// Create a MediaSource temporarily just to get the list of the MediaTypes it supports
 	createMediaSourceReader();
 	if ( mSourceReaderRes.get() )
@@ -159,7 +165,6 @@ DeviceInternals::~DeviceInternals()
 		stopCapture();
 
 	mSupportedVideoMediaTypes.clear();
-	DeleteCriticalSection(&mCriticalSection);
 }
 /*
 bool DeviceInternals::startCapture( const VideoMediaType& videoMediaType )
@@ -182,7 +187,7 @@ bool DeviceInternals::startCapture( const VideoMediaType& videoMediaType )
 	return false;
 }*/
 
-bool DeviceInternals::startCapture( DWORD mediaTypeIndex )
+bool DeviceInternals::startCapture( DWORD mediaTypeIndex, const ImageFormat& imageFormat )
 {
 	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
 
@@ -205,10 +210,22 @@ bool DeviceInternals::startCapture( DWORD mediaTypeIndex )
 
 	// Update members
 	mIsCapturing = true;
+	mCapturedMediaTypeIndex = mediaTypeIndex;
+	mCapturedImageFormat = imageFormat;
 	mCapturedImageNumber = 0;
-	mCapturedImageTimestamp = 0;
-	assert( !mCapturedImageBuffer );
-	mCapturedImageBuffer = NULL;
+	assert( !mCapturedFrame );
+	mFrameQueue.clear();
+
+	// Allocate the frames the samples are copied into up front: one per queue slot, plus the 
+	// latest frame and the one a consumer is reading. More are only allocated if the consumer 
+	// holds on to several frames
+	assert( mFrames.empty() );
+	if ( !mZeroCopyEnabled || mFrameQueue.getDepth()>0 )
+	{
+		std::size_t numFrames = mFrameQueue.getDepth() + 2;
+		for ( std::size_t i=0; i<numFrames; ++i )
+			mFrames.push_back( new BufferCapturedFrame( mCapturedImageFormat ) );
+	}
 
 	// Request the first video frame
 	hr = mSourceReaderRes->ReadSample( (DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, NULL, NULL, NULL, NULL ); 
@@ -228,46 +245,78 @@ void DeviceInternals::stopCapture()
 	// Delete the SourceReader
 	deleteMediaSourceReader();
 
-	// Update members
+	// Update members. The latest frame is unlocked here, unless a consumer still references it
 	mIsCapturing = false;
 	mCapturedImageNumber = 0;
-	mCapturedImageTimestamp = 0;
-	delete mCapturedImageBuffer;
-	mCapturedImageBuffer = NULL;
+	if ( mCapturedFrame )
+		mCapturedFrame->release();
+	mCapturedFrame = NULL;
+	mFrameQueue.releaseFrames();
+
+	// The frames still referenced by a consumer are deleted when it releases them
+	for ( std::size_t i=0; i<mFrames.size(); ++i )
+		mFrames[i]->release();
+	mFrames.clear();
 }
 
-/*unsigned int DeviceInternals::getCapturedImageSequenceNumber() const
+unsigned int DeviceInternals::getCapturedImageSequenceNumber() const
 {
 	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
 	unsigned int number = mCapturedImageNumber;
 	return number;
-}*/
+}
 
 bool DeviceInternals::getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, LONGLONG& timestamp ) const
 {
-	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
-	
-	// Check that we're currently capturing and that a first image was already grabbed
-	if ( !mCapturedImageBuffer )
-		return false;
-
 	// Initialize output parameters
 	sequenceNumber = 0;
 	timestamp = 0;
 
-	// Check that the destination buffer matches the size
-	if ( buffer.getSizeInBytes()!=mCapturedImageBuffer->getSizeInBytes() )
+	// Check that we're currently capturing and that a first image was already grabbed.
+	// The reference keeps the frame alive outside of the critical section, so OnReadSample 
+	// doesn't have to wait for the copy
+	CapturedFrame* frame = acquireCapturedFrame();
+	if ( !frame )
 		return false;
-	
-	// Fill the output parameters
-	bool ret = buffer.copyFrom( *mCapturedImageBuffer );
-	assert( ret );
-	sequenceNumber = mCapturedImageNumber;
-	timestamp = mCapturedImageTimestamp;
-	
+
+	// Copy the rows top row first, straight out of the locked sample buffer in zero-copy mode. 
+	// This also takes care of the bottom-up images
+	bool ret = frame->copyTo( buffer );
+	if ( ret )
+	{
+		sequenceNumber = frame->getSequenceNumber();
+		timestamp = frame->getTimestamp();
+	}
+	frame->release();
+	return ret;
+}
+
+CapturedFrame* DeviceInternals::acquireCapturedFrame() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( !mCapturedFrame )
+		return NULL;
+	mCapturedFrame->addReference();
+	return mCapturedFrame;
+}
+
+bool DeviceInternals::setZeroCopyEnabled( bool enabled )
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( isCapturing() )
+		return false;
+	mZeroCopyEnabled = enabled;
 	return true;
 }
 
+bool DeviceInternals::setFrameQueueDepth( std::size_t depth )
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( isCapturing() )
+		return false;
+	return mFrameQueue.setDepth( depth );
+}
+
 bool DeviceInternals::getVideoMediaType( IMFSourceReader* sourceReader, DWORD index, VideoMediaType& mediaTypeInfo )
 {
 	// The list of MediaType attributes can be found here:
@@ -308,12 +357,23 @@ bool DeviceInternals::getVideoMediaType( IMFSourceReader* sourceReader, DWORD in
 
 	GUID subType = { 0 };
 	hr = mediaTypeRes.get()->GetGUID( MF_MT_SUBTYPE, &subType );
+
+	// The color matrix and range are optional attributes, most drivers don't set them. 
+	// Missing ones are left to 0 (unknown) and interpreted by the caller
+	UINT32 yuvMatrix = 0;
+	if ( FAILED( mediaTypeRes->GetUINT32( MF_MT_YUV_MATRIX, &yuvMatrix ) ) )
+		yuvMatrix = 0;
+	UINT32 nominalRange = 0;
+	if ( FAILED( mediaTypeRes->GetUINT32( MF_MT_VIDEO_NOMINAL_RANGE, &nominalRange ) ) )
+		nominalRange = 0;
 			
 	mediaTypeInfo.width = width;
 	mediaTypeInfo.height = height;
 	mediaTypeInfo.stride = stride;
 	mediaTypeInfo.frameRate = frameRate;
 	mediaTypeInfo.subType = subType;
+	mediaTypeInfo.yuvMatrix = yuvMatrix;
+	mediaTypeInfo.nominalRange = nominalRange;
 	
 	return true;
 }
@@ -426,66 +486,90 @@ STDMETHODIMP DeviceInternals::OnReadSample( HRESULT hrStatus, DWORD /*dwStreamIn
 	if ( FAILED(hrStatus) )
 		return S_FALSE;
 	
-	HRESULT hr = S_OK;
+	// A sample that can't be read is skipped, the capture goes on with the next one
 	if ( pSample )
-	{
-		// Get the MediaBuffer from the Sample
-		hr = S_OK;
-		IMFMediaBuffer* mediaBufferRaw = NULL;		// http://msdn.microsoft.com/en-us/library/windows/desktop/ms696261(v=vs.85).aspx
-		hr = pSample->ConvertToContiguousBuffer( &mediaBufferRaw );
-		COMObjectSharedPtr<IMFMediaBuffer> mediaBufferRes( mediaBufferRaw );
-		if ( FAILED(hr) )
-			return S_FALSE;
-	
-		// Instead of directly working with the IMFMediaBuffer, we should probably try to query its MF2DBuffer and use 
-		// it if it exists (which it didn't on most webcams when I tried). We might even check if the buffer is using 
-		// a Direct3D surface. This is explained here:
-		// http://msdn.microsoft.com/en-us/library/windows/desktop/aa473821(v=vs.85).aspx
-
-		// Lock	the MediaBuffer 
-		BYTE* bufferData = NULL;
-		DWORD maxLength = 0;
-		DWORD currentLength = 0;
-		hr = mediaBufferRes->Lock( &bufferData, &maxLength, &currentLength );
-		if ( FAILED(hr) )
-			return S_FALSE;
-
-		// If it's the first time since start that the callback is called, the ImageBuffer
-		// doesn't exist. We allocate one to receive this sample and the next one.
-		// By doing this, we assume that the size of the sample buffer doesn't change which
-		// seems fair enough
-		if ( !mCapturedImageBuffer )
-			mCapturedImageBuffer = new MemoryBuffer( currentLength );
-
-		unsigned int imageBufferSize = mCapturedImageBuffer->getSizeInBytes();
-		if ( imageBufferSize!=currentLength )
-		{
-			hr = mediaBufferRes->Unlock();		// No RAII locker object here :(
-			return S_FALSE;
-		}
-		
-		// Copy the data from the sample buffer into our image buffer
-		unsigned char* imageBufferData = mCapturedImageBuffer->getBytes();
-		memcpy( imageBufferData, bufferData, imageBufferSize ); 
-
-		// Update sequence number and timestamp
-		mCapturedImageNumber++;
-		mCapturedImageTimestamp = llTimestamp;
-	
-		// Unlock the MediaBuffer
-		hr = mediaBufferRes->Unlock();
-		if ( FAILED(hr) )
-			return S_FALSE;
-	}
+		processSample( pSample, llTimestamp );
 
 	// Request to read more samples
-	hr = mSourceReaderRes->ReadSample( (DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, NULL, NULL, NULL, NULL );
+	HRESULT hr = mSourceReaderRes->ReadSample( (DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, 0, NULL, NULL, NULL, NULL );
 	if ( FAILED(hr) )
 		return S_FALSE;
 
 	return S_OK;
 }
 
+// Called by OnReadSample(), in the critical section
+bool DeviceInternals::processSample( IMFSample* sample, LONGLONG timestamp )
+{
+	// Get the MediaBuffer from the Sample. Video samples normally hold a single buffer, which 
+	// is used as it is, padding included: the frame locates the rows with the actual pitch. 
+	// Only samples made of several buffers need to be made contiguous, which is a copy
+	HRESULT hr = S_OK;
+	IMFMediaBuffer* mediaBufferRaw = NULL;		// http://msdn.microsoft.com/en-us/library/windows/desktop/ms696261(v=vs.85).aspx
+	DWORD bufferCount = 0;
+	hr = sample->GetBufferCount( &bufferCount );
+	if ( SUCCEEDED(hr) && bufferCount==1 )
+		hr = sample->GetBufferByIndex( 0, &mediaBufferRaw );
+	else
+		hr = sample->ConvertToContiguousBuffer( &mediaBufferRaw );
+	COMObjectSharedPtr<IMFMediaBuffer> mediaBufferRes( mediaBufferRaw );
+	if ( FAILED(hr) )
+		return false;
+
+	// Lock the sample buffer in a frame. The frame queries the MF2DBuffer of the buffer when 
+	// it exists to get the actual pitch of the rows
+	const VideoMediaType& mediaType = mSupportedVideoMediaTypes[mCapturedMediaTypeIndex];
+	MediaFoundationCapturedFrame* sampleFrame = MediaFoundationCapturedFrame::create( mCapturedImageFormat, mediaBufferRes, mediaType.stride, mCapturedImageNumber+1, timestamp );
+	if ( !sampleFrame )
+		return false;
+
+	// In zero-copy mode, the frame keeps the sample locked until the next one arrives, or longer 
+	// if a consumer references it. Otherwise, and whenever the frames are queued, the sample is 
+	// copied into a frame of our own and given back right away: the SourceReader only has a few 
+	// of them, a queue of locked samples would exhaust them and stall the capture
+	CapturedFrame* frame = sampleFrame;
+	if ( !mZeroCopyEnabled || mFrameQueue.getDepth()>0 )
+	{
+		BufferCapturedFrame* bufferFrame = getFreeFrame();
+		bool copied = sampleFrame->copyTo( bufferFrame->getBuffer() );
+		sampleFrame->release();
+		if ( !copied )
+			return false;
+		bufferFrame->setSequenceNumber( mCapturedImageNumber+1 );
+		bufferFrame->setTimestamp( timestamp );
+		bufferFrame->addReference();
+		frame = bufferFrame;
+	}
+
+	// Update sequence number and latest frame
+	mCapturedImageNumber++;
+	if ( mCapturedFrame )
+		mCapturedFrame->release();
+	mCapturedFrame = frame;
+
+	// Queue it too. The queue drops its oldest frame rather than waiting for the consumer
+	if ( mFrameQueue.getDepth()>0 )
+	{
+		frame->addReference();
+		mFrameQueue.push( frame );
+	}
+	return true;
+}
+
+// A frame to copy a sample into, that no consumer nor the queue references. The frames 
+// are reused from one sample to the next
+BufferCapturedFrame* DeviceInternals::getFreeFrame()
+{
+	for ( std::size_t i=0; i<mFrames.size(); ++i )
+	{
+		if ( mFrames[i]->getReferenceCount()==1 )
+			return mFrames[i];
+	}
+	BufferCapturedFrame* frame = new BufferCapturedFrame( mCapturedImageFormat );
+	mFrames.push_back( frame );
+	return frame;
+}
+
 STDMETHODIMP DeviceInternals::OnEvent( DWORD, IMFMediaEvent* )
 {
 	return S_OK;
@@ -23,16 +23,9 @@
 */
 #include "RMFDeviceManager.h"
 
-#include <mfapi.h>
-#include <mfidl.h>
-#include <ks.h>
-#include <Dbt.h>
-
 #include <assert.h>
 #include <algorithm>
 
-#include "RMFCOMObjectSharedPtr.h"
-
 namespace RMF
 {
 
@@ -42,7 +35,7 @@ namespace RMF
 class DeviceManager::Internals
 {
 public:
-	Internals( DeviceManager* parentDeviceManager );
+	Internals( DeviceManager* parentDeviceManager, DeviceManagerBackend* backend );
 	~Internals();
 
 	void			update();
@@ -52,69 +45,27 @@ public:
 	bool			removeListener( Listener* listener );
 
 protected:
-	static void		wideCharStringToMultiByteString( const wchar_t* wideCharString, std::string& multiByteString );
-
-	static void		getName( const IMFActivate* activate, std::string& name );
-	static void		getSymbolicLink( const IMFActivate* activate, std::string& symbolicLink );
-	
-	typedef std::vector< COMObjectSharedPtr<IMFActivate> > IMFActivates;
-	static void		enumerateDevices( IMFActivates& activates );
 	void			updateDeviceList();
 
-	void			createDevice( COMObjectSharedPtr<IMFActivate>& activate );
+	void			createDevice( const DeviceManagerBackend::DeviceDescription& description );
 	void			deleteDevice( Device* device );
 
-	static LRESULT CALLBACK wndProcHook( int nCode, WPARAM wParam, LPARAM lParam );
-
 private:
 	DeviceManager*  mParentDeviceManager;
-	bool			mUpdateDeviceListAtNextUpdate;
+	DeviceManagerBackend* mBackend;
 	Devices			mDevices;
 
 	typedef	std::vector<DeviceManager::Listener*> Listeners; 
 	Listeners		mListeners;
-
-	typedef std::vector< DeviceManager::Internals* > InternalObjects;
-	static InternalObjects mInternalObjects;
-	HHOOK			mHookHandle;
-
 };
 
-// The list of all the DeviceManager::Internals instances that exist in the application
-// This is needed because of the static nature of the WindowProc hook
-DeviceManager::Internals::InternalObjects DeviceManager::Internals::mInternalObjects;
-
-DeviceManager::Internals::Internals( DeviceManager* parentDeviceManager )
+DeviceManager::Internals::Internals( DeviceManager* parentDeviceManager, DeviceManagerBackend* backend )
 	: mParentDeviceManager( parentDeviceManager ),
-	  mUpdateDeviceListAtNextUpdate(true),
+	  mBackend( backend ),
 	  mDevices(),
-	  mListeners(),
-	  mHookHandle(0)
+	  mListeners()
 {
-	// Initialize the COM library 
-	// We dont check the result on purpose here. See documentation: 
-	// http://msdn.microsoft.com/en-us/library/windows/desktop/ms695279(v=vs.85).aspx
-	HRESULT hr = S_OK;
-	hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
-	
-    // Initialize Media Foundation
-	// http://msdn.microsoft.com/en-us/library/windows/desktop/ms702238(v=vs.85).aspx
-    hr = MFStartup( MF_VERSION, MFSTARTUP_NOSOCKET );		// Note: in our case, we don't need the sockets library
-	assert( SUCCEEDED(hr) );	
-
-	// Add this instance to the static list
-	mInternalObjects.push_back( this );
-	
-	// Register hook when this is the first instance of DeviceManager::Internals created
-	// See this article for extra information
-	// http://www.codeproject.com/Articles/14500/Detecting-Hardware-Insertion-and-or-Removal
-	if ( mInternalObjects.size()==1 )
-	{
-		DWORD threadID = GetCurrentThreadId();
-		HINSTANCE hInstance = GetModuleHandle(NULL) ;
-		mHookHandle = SetWindowsHookEx( WH_CALLWNDPROC, wndProcHook, hInstance, threadID );
-		assert( mHookHandle );
-	}
+	assert( mBackend );
 }
 
 DeviceManager::Internals::~Internals()
@@ -125,64 +76,15 @@ DeviceManager::Internals::~Internals()
 		deleteDevice( devices[i] );
 	assert( mDevices.empty() );
 
-	// Shutdown Media Foundation and COM 
-	HRESULT hr = MFShutdown();
-	assert( SUCCEEDED(hr) );
-	
-	CoUninitialize();
-
-	// Remove this instance from the static list
-	InternalObjects::iterator itr = std::find( mInternalObjects.begin(), mInternalObjects.end(), this );
-	assert( itr!=mInternalObjects.end() );
-	mInternalObjects.erase(itr);
-
-	// If there's no more instances, remove the hook
-	if ( mInternalObjects.empty() )
-	{
-		BOOL ret = UnhookWindowsHookEx( mHookHandle );
-		assert( ret );
-		mHookHandle = 0;
-	}
-}
-
-
-LRESULT CALLBACK DeviceManager::Internals::wndProcHook( int nCode, WPARAM wParam, LPARAM lParam )
-{
-/*	std::wstringstream stream;
-	stream << std::hex;
-	stream << L"code=" << nCode << L" wparam=" << params.wParam << L" lparam=" << params.lParam << L" message=" << params.message << L" hwnd=" << params.hwnd << L"\n";
-	OutputDebugString(stream.str().c_str());
-*/
-	// Note:
-	// We only process the message if it is sent by the current thread.
-	// By "current" I guess that they mean the same thread as the one called the hook
-	// registration function... but that's a guess :(
-	// See http://msdn.microsoft.com/en-us/library/windows/desktop/ms644975(v=vs.85).aspx
-	// My goal is to use this information to avoid having to handle concurrency with 
-	// a critical section or whatnot.
-	// Because if this hook is called by different thread, there's a micro chance that the
-	// array of InternalObjects I'm using changes while I'm using it
-	if ( wParam!=0 )
-	{
-		const CWPSTRUCT& params = *reinterpret_cast<CWPSTRUCT*>(lParam);
-		if ( params.message==WM_DEVICECHANGE )
-		{
-			for ( std::size_t i=0; i<mInternalObjects.size(); ++i )
-				mInternalObjects[i]->mUpdateDeviceListAtNextUpdate = true;
-		}
-	}
-
-	// Process event
-	return CallNextHookEx( NULL, nCode, wParam, lParam );
+	// The backend goes last as the devices it created might depend on it
+	delete mBackend;
+	mBackend = NULL;
 }
 
 void DeviceManager::Internals::update()
 {
-	if ( mUpdateDeviceListAtNextUpdate )
-	{
+	if ( mBackend->hasDeviceListChanged() )
 		updateDeviceList();
-		mUpdateDeviceListAtNextUpdate = false;
-	}
 
 	for ( Devices::iterator itr=mDevices.begin(); itr!=mDevices.end(); ++itr )
 	{
@@ -191,55 +93,17 @@ void DeviceManager::Internals::update()
 	}
 }
 
-void DeviceManager::Internals::enumerateDevices( DeviceManager::Internals::IMFActivates& activates )
-{
-	activates.clear();
-	HRESULT hr = S_OK;
-	
-	// Prepare attributes for enumerating the devices
-	IMFAttributes* attributesRaw = NULL;	
-	hr = MFCreateAttributes( &attributesRaw, 1 );
-	COMObjectSharedPtr<IMFAttributes> attributesRes( attributesRaw );
-	if ( FAILED(hr) )
-		return;
-	
-	// Specify we're only interested in video devices
-    hr = attributesRes->SetGUID( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE, MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_GUID );
-	if ( FAILED(hr) )
-		return;
-
-    // Enumerate the devices
-	IMFActivate** activatesList = NULL;
-	UINT32 numActivates = 0;
-    hr = MFEnumDeviceSources( attributesRes.get(), &activatesList, &numActivates );
-	if ( FAILED(hr ) )
-		return;
-
-	// Populate our list of Activates with the result
-	activates.resize( numActivates );
-	for ( UINT32 i=0; i<numActivates; ++i )
-	{
-		COMObjectSharedPtr<IMFActivate> activate = activatesList[i];
-		activates[i] = activate;
-	}
-
-	// Release list of enumerated devices
-	CoTaskMemFree( activatesList );
-}
-
 void DeviceManager::Internals::updateDeviceList()
 {
 	// Get up-to-date list of Devices
-	DeviceManager::Internals::IMFActivates currentActivates;
-	DeviceManager::Internals::enumerateDevices( currentActivates );
+	DeviceManagerBackend::DeviceDescriptions currentDescriptions;
+	mBackend->enumerateDevices( currentDescriptions );
 
 	// Determine freshly added Devices
-	DeviceManager::Internals::IMFActivates newActivates;
-	std::string symbolicLink;
-	for ( std::size_t i=0; i<currentActivates.size(); ++i )
+	DeviceManagerBackend::DeviceDescriptions newDescriptions;
+	for ( std::size_t i=0; i<currentDescriptions.size(); ++i )
 	{
-		const COMObjectSharedPtr<IMFActivate>& currentActivate = currentActivates[i];
-		getSymbolicLink( currentActivate.get(), symbolicLink );
+		const std::string& symbolicLink = currentDescriptions[i].symbolicLink;
 		bool found = false;
 		for ( std::size_t j=0; j<mDevices.size(); ++j )
 		{
@@ -251,7 +115,7 @@ void DeviceManager::Internals::updateDeviceList()
 		}
 
 		if ( !found )
-			newActivates.push_back( currentActivates[i] );
+			newDescriptions.push_back( currentDescriptions[i] );
 	}
 	
 	// Determine freshly removed Devices
@@ -261,12 +125,9 @@ void DeviceManager::Internals::updateDeviceList()
 		Device* device = mDevices[i];
 		bool found = false;
 
-		for ( std::size_t j=0; j<currentActivates.size(); ++j )
+		for ( std::size_t j=0; j<currentDescriptions.size(); ++j )
 		{	
-			const COMObjectSharedPtr<IMFActivate>& currentActivate = currentActivates[j];
-			getSymbolicLink( currentActivate.get(), symbolicLink );
-		
-			if ( device->getSymbolicLink()==symbolicLink )
+			if ( device->getSymbolicLink()==currentDescriptions[j].symbolicLink )
 			{
 				found = true;
 				break;
@@ -277,27 +138,25 @@ void DeviceManager::Internals::updateDeviceList()
 	}
 
 	// Create and add the new Devices
-	for ( std::size_t i=0; i<newActivates.size(); ++i )
-		createDevice( newActivates[i] );
+	for ( std::size_t i=0; i<newDescriptions.size(); ++i )
+		createDevice( newDescriptions[i] );
 	
 	// Remove detached Devices
 	for ( std::size_t i=0; i<removedDevices.size(); ++i )
 		deleteDevice( removedDevices[i] );
 }
 
-void DeviceManager::Internals::createDevice( COMObjectSharedPtr<IMFActivate>& activate )
+void DeviceManager::Internals::createDevice( const DeviceManagerBackend::DeviceDescription& description )
 {
+	DeviceBackend* deviceBackend = mBackend->createDeviceBackend( description );
+	if ( !deviceBackend )
+		return;
+
 	// Notify 
 	for ( Listeners::const_iterator itr=mListeners.begin(); itr!=mListeners.end(); ++itr )
 		(*itr)->onDeviceAdding( mParentDeviceManager );
 
-	std::string name;
-	getName( activate.get(), name );
-
-	std::string symbolicLink;
-	getSymbolicLink( activate.get(), symbolicLink );
-
-	Device* device = new Device( &activate, name, symbolicLink );
+	Device* device = new Device( deviceBackend, description.name, description.symbolicLink );
 	mDevices.push_back( device );
 
 	// Notify 
@@ -323,49 +182,6 @@ void DeviceManager::Internals::deleteDevice( Device* device )
 		(*itr)->onDeviceRemoved( mParentDeviceManager, device );
 }
 
-void DeviceManager::Internals::wideCharStringToMultiByteString( const wchar_t* wideCharString, std::string& multiByteString )
-{
-	assert( wideCharString );
-	size_t size = wcslen(wideCharString)+1;
-	char* buffer = new char[size];
-	size_t numCharConverted = 0;
-	int ret = wcstombs_s( &numCharConverted, buffer, size, wideCharString, size );
-	if ( ret==0 )
-		multiByteString = buffer;
-	delete[] buffer;
-}
-
-void DeviceManager::Internals::getName( const IMFActivate* activate, std::string& name )
-{
-	// See http://msdn.microsoft.com/de-de/library/bb970406(v=vs.85).aspx
-	WCHAR* theName = NULL;
-	HRESULT hr = const_cast<IMFActivate*>(activate)->GetAllocatedString( MF_DEVSOURCE_ATTRIBUTE_FRIENDLY_NAME, &theName, NULL );	
-	if ( SUCCEEDED(hr) )
-	{
-		wideCharStringToMultiByteString( theName, name );
-		CoTaskMemFree( theName );
-	}
-	else
-	{
-		name = "No name";
-	}
-}
-
-void DeviceManager::Internals::getSymbolicLink( const IMFActivate* activate, std::string& symbolicLink )
-{
-	WCHAR* theSymbolicLink;
-	HRESULT hr = const_cast<IMFActivate*>(activate)->GetAllocatedString( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_SYMBOLIC_LINK, &theSymbolicLink, NULL );
-	if ( SUCCEEDED(hr) )
-	{	
-		wideCharStringToMultiByteString( theSymbolicLink, symbolicLink );
-		CoTaskMemFree( theSymbolicLink );
-	}
-	else
-	{
-		symbolicLink = "No symbolic link";
-	}
-}
-
 void DeviceManager::Internals::addListener( Listener* listener )
 {
 	assert(listener);
@@ -384,10 +200,10 @@ bool DeviceManager::Internals::removeListener( Listener* listener )
 /*
 	DeviceManager
 */
-DeviceManager::DeviceManager()
+DeviceManager::DeviceManager( DeviceManagerBackend* backend )
 	: mInternals(NULL)
 {
-	mInternals = new Internals(this);
+	mInternals = new Internals(this, backend);
 }
 
 DeviceManager::~DeviceManager()
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <cstring>
 #include <assert.h>
+#include <algorithm>
 
 namespace RMF
 {
@@ -34,6 +35,7 @@ namespace RMF
 // be filled with data later using the assignment operator (which can modify its format).
 Image::Image()
 	: mFormat(),
+	  mStride(0),
 	  mBuffer()
 {
 }
@@ -41,15 +43,97 @@ Image::Image()
 // Construct a blank image of a specific format. The internal image data is allocated and zero-filled
 Image::Image( const ImageFormat& imageFormat )
 	: mFormat( imageFormat), 
+	  mStride( static_cast<int>( imageFormat.getNumBytesPerLine() ) ),
 	  mBuffer( imageFormat.getDataSizeInBytes() )
 {
 }
 
-// Construct an image from another one. The source image data is copied during the process
+// Construct an image of a specific format which data is allocated as specified. It's only 
+// zero-filled if the options say so
+Image::Image( const ImageFormat& imageFormat, const MemoryBuffer::Options& bufferOptions )
+	: mFormat( imageFormat), 
+	  mStride( static_cast<int>( imageFormat.getNumBytesPerLine() ) ),
+	  mBuffer( imageFormat.getDataSizeInBytes(), bufferOptions )
+{
+}
+
+// Construct an image with padded and/or bottom-up rows. A stride smaller than a line of the  
+// format (zero for example) is replaced by the number of bytes per line, with the same sign
+Image::Image( const ImageFormat& imageFormat, int stride, const MemoryBuffer::Options& bufferOptions )
+	: mFormat( imageFormat), 
+	  mStride( getValidStride( imageFormat, stride ) ),
+	  mBuffer( static_cast<unsigned int>( getBufferSizeInBytes( imageFormat, mStride ) ), bufferOptions )
+{
+}
+
+// Construct an image from another one. The source image data is copied during the process,
+// the stride is kept
 Image::Image( const Image& other )
 	: mFormat( other.getFormat() ), 
+	  mStride( other.getStride() ),
 	  mBuffer( other.getBuffer() )
 {
 }
 
+std::ptrdiff_t Image::getRowOffset( unsigned int plane, unsigned int y ) const
+{
+	std::ptrdiff_t offset = static_cast<std::ptrdiff_t>( getPlaneOffset( mFormat, mStride, plane ) );
+	std::ptrdiff_t stride = getPlaneStride( mFormat, mStride, plane );
+	if ( stride>=0 )
+		return offset + static_cast<std::ptrdiff_t>(y) * stride;
+	return offset + static_cast<std::ptrdiff_t>( mFormat.getPlaneHeight(plane)-1-y ) * (-stride);
+}
+
+int Image::getValidStride( const ImageFormat& imageFormat, int stride )
+{
+	int numBytesPerLine = static_cast<int>( imageFormat.getNumBytesPerLine() );
+	if ( stride<0 )
+		return stride<=-numBytesPerLine ? stride : -numBytesPerLine;
+	return stride>=numBytesPerLine ? stride : numBytesPerLine;
+}
+
+int Image::getAlignedStride( const ImageFormat& imageFormat, unsigned int alignment )
+{
+	unsigned int numBytesPerLine = imageFormat.getNumBytesPerLine();
+	if ( alignment<=1 )
+		return static_cast<int>( numBytesPerLine );
+	return static_cast<int>( (numBytesPerLine + alignment - 1) / alignment * alignment );
 }
+
+int Image::getPlaneStride( const ImageFormat& imageFormat, int stride, unsigned int plane )
+{
+	if ( plane==0 )
+		return stride;
+
+	// The padding of the first plane is scaled to the width of the plane, rounding up
+	unsigned int firstPlaneNumBytesPerLine = imageFormat.getPlaneNumBytesPerLine(0);
+	unsigned int numBytesPerLine = imageFormat.getPlaneNumBytesPerLine(plane);
+	unsigned int absoluteStride = static_cast<unsigned int>( stride<0 ? -stride : stride );
+	unsigned int planeStride = numBytesPerLine;
+	if ( firstPlaneNumBytesPerLine>0 )
+		planeStride = std::max( ( absoluteStride * numBytesPerLine + firstPlaneNumBytesPerLine - 1 ) / firstPlaneNumBytesPerLine, numBytesPerLine );
+	return stride<0 ? -static_cast<int>(planeStride) : static_cast<int>(planeStride);
+}
+
+std::size_t Image::getPlaneOffset( const ImageFormat& imageFormat, int stride, unsigned int plane )
+{
+	std::size_t offset = 0;
+	for ( unsigned int previousPlane=0; previousPlane<plane && previousPlane<imageFormat.getNumPlanes(); ++previousPlane )
+	{
+		int planeStride = getPlaneStride( imageFormat, stride, previousPlane );
+		offset += static_cast<std::size_t>( planeStride<0 ? -planeStride : planeStride ) * imageFormat.getPlaneHeight(previousPlane);
+	}
+	return offset;
+}
+
+std::size_t Image::getBufferSizeInBytes( const ImageFormat& imageFormat, int stride )
+{
+	return getPlaneOffset( imageFormat, stride, imageFormat.getNumPlanes() );
+}
+
+bool Image::copyFrom( const ConstImageView& other )
+{
+	return ImageView( *this ).copyFrom( other );
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,288 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConversionGraph.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace RMF
+{
+
+namespace
+{
+
+bool isNV12( ImageFormat::Encoding encoding )			{ return encoding==ImageFormat::NV12; }
+bool isI420OrYV12( ImageFormat::Encoding encoding )		{ return encoding==ImageFormat::I420 || encoding==ImageFormat::YV12; }
+bool isYUV420( ImageFormat::Encoding encoding )			{ return isNV12( encoding ) || isI420OrYV12( encoding ); }
+bool isYUYV( ImageFormat::Encoding encoding )			{ return encoding==ImageFormat::YUYV; }
+bool isGRAY8( ImageFormat::Encoding encoding )			{ return encoding==ImageFormat::GRAY8; }
+
+}
+
+ImageConversionGraph::ImageConversionGraph()
+{
+	for ( int i=0; i<ImageFormat::EncodingCount; ++i )
+	{
+		for ( int j=0; j<ImageFormat::EncodingCount; ++j )
+		{
+			mConversions[i][j].convert = NULL;
+			mConversions[i][j].cost = 0;
+		}
+	}
+
+	// The generic conversions, then the ones of the historical encodings, which pick the 
+	// same kernels. The scalar only ones are measured too
+	setConversions( ImageFormat::isRGB, ImageFormat::isRGB, ImageConverter::convertRGBImageToRGBImage, 3 );
+	setConversions( ImageFormat::isPackedYUV422, ImageFormat::isRGB, ImageConverter::convertYUV422ImageToRGBImage, 5 );
+	setConversions( isNV12, ImageFormat::isRGB, ImageConverter::convertNV12ImageToRGBImage, 6 );
+	setConversions( isI420OrYV12, ImageFormat::isRGB, ImageConverter::convertI420ImageToRGBImage, 6 );
+	setConversions( ImageFormat::isRGB, ImageFormat::isPackedYUV422, ImageConverter::convertRGBImageToYUV422Image, 9 );
+	setConversions( ImageFormat::isRGB, isNV12, ImageConverter::convertRGBImageToNV12Image, 11 );
+	setConversions( ImageFormat::isRGB, isI420OrYV12, ImageConverter::convertRGBImageToI420Image, 11 );
+	setConversions( ImageFormat::isPackedYUV422, isNV12, ImageConverter::convertYUV422ImageToNV12Image, 4 );
+	setConversions( ImageFormat::isPackedYUV422, isI420OrYV12, ImageConverter::convertYUV422ImageToI420Image, 4 );
+	setConversions( ImageFormat::isPackedYUV422, ImageFormat::isPackedYUV422, ImageConverter::convertYUV422ImageToYUV422Image, 3 );
+	setConversions( isNV12, isYUYV, ImageConverter::convertNV12ImageToYUYVImage, 2 );
+	setConversions( isI420OrYV12, isYUYV, ImageConverter::convertI420ImageToYUYVImage, 2 );
+	setConversions( ImageFormat::isPackedYUV422, isGRAY8, ImageConverter::convertYUV422ImageToGRAY8Image, 1 );
+	setConversions( isYUV420, isGRAY8, ImageConverter::convertYUV420ImageToGRAY8Image, 1 );
+	setConversions( ImageFormat::isRGB, isGRAY8, ImageConverter::convertRGBImageToGRAY8Image, 3 );
+	setConversions( ImageFormat::isGray, ImageFormat::isRGB, ImageConverter::convertGRAYImageToRGBImage, 4 );
+	setConversions( ImageFormat::isGray, ImageFormat::isGray, ImageConverter::convertGRAYImageToGRAYImage, 1 );
+
+	setConversion( ImageFormat::BGR24, ImageFormat::RGB24, ImageConverter::convertBGR24ImageToRGB24Image, 3 );
+	setConversion( ImageFormat::RGB24, ImageFormat::BGR24, ImageConverter::convertRGB24ImageToBGR24Image, 3 );
+	setConversion( ImageFormat::YUYV, ImageFormat::RGB24, ImageConverter::convertYUYVImageToRGB24Image, 5 );
+	setConversion( ImageFormat::YUYV, ImageFormat::BGR24, ImageConverter::convertYUYVImageToBGR24Image, 5 );
+	setConversion( ImageFormat::YUYV, ImageFormat::NV12, ImageConverter::convertYUYVImageToNV12Image, 4 );
+	setConversion( ImageFormat::YUYV, ImageFormat::I420, ImageConverter::convertYUYVImageToI420Image, 4 );
+	setConversion( ImageFormat::YUYV, ImageFormat::YV12, ImageConverter::convertYUYVImageToI420Image, 4 );
+	setConversion( ImageFormat::NV12, ImageFormat::RGB24, ImageConverter::convertNV12ImageToRGB24Image, 6 );
+	setConversion( ImageFormat::NV12, ImageFormat::BGR24, ImageConverter::convertNV12ImageToBGR24Image, 6 );
+	setConversion( ImageFormat::I420, ImageFormat::RGB24, ImageConverter::convertI420ImageToRGB24Image, 6 );
+	setConversion( ImageFormat::I420, ImageFormat::BGR24, ImageConverter::convertI420ImageToBGR24Image, 6 );
+	setConversion( ImageFormat::YV12, ImageFormat::RGB24, ImageConverter::convertI420ImageToRGB24Image, 6 );
+	setConversion( ImageFormat::YV12, ImageFormat::BGR24, ImageConverter::convertI420ImageToBGR24Image, 6 );
+}
+
+const ImageConversionGraph& ImageConversionGraph::getDefault()
+{
+	static ImageConversionGraph graph;
+	return graph;
+}
+
+void ImageConversionGraph::setConversion( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, ConvertFunction convert, unsigned int cost )
+{
+	if ( sourceEncoding>=ImageFormat::EncodingCount || destinationEncoding>=ImageFormat::EncodingCount || sourceEncoding==destinationEncoding )
+		return;
+	Conversion& conversion = mConversions[sourceEncoding][destinationEncoding];
+	conversion.convert = convert;
+	conversion.cost = convert ? cost : 0;
+}
+
+void ImageConversionGraph::setConversions( bool (*isSource)( ImageFormat::Encoding ), bool (*isDestination)( ImageFormat::Encoding ), ConvertFunction convert, unsigned int cost )
+{
+	for ( int i=0; i<ImageFormat::EncodingCount; ++i )
+	{
+		for ( int j=0; j<ImageFormat::EncodingCount; ++j )
+		{
+			ImageFormat::Encoding sourceEncoding = static_cast<ImageFormat::Encoding>(i);
+			ImageFormat::Encoding destinationEncoding = static_cast<ImageFormat::Encoding>(j);
+			if ( isSource( sourceEncoding ) && isDestination( destinationEncoding ) )
+				setConversion( sourceEncoding, destinationEncoding, convert, cost );
+		}
+	}
+}
+
+ImageConversionGraph::ConvertFunction ImageConversionGraph::getConversion( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding ) const
+{
+	if ( sourceEncoding>=ImageFormat::EncodingCount || destinationEncoding>=ImageFormat::EncodingCount )
+		return NULL;
+	return mConversions[sourceEncoding][destinationEncoding].convert;
+}
+
+ImageConversionGraph::ConvertFunction ImageConversionGraph::getConversion( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat ) const
+{
+	if ( !keepsColor( sourceFormat, destinationFormat ) )
+		return NULL;
+	return getConversion( sourceFormat.getEncoding(), destinationFormat.getEncoding() );
+}
+
+unsigned int ImageConversionGraph::getCost( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding ) const
+{
+	if ( sourceEncoding>=ImageFormat::EncodingCount || destinationEncoding>=ImageFormat::EncodingCount )
+		return 0;
+	return mConversions[sourceEncoding][destinationEncoding].cost;
+}
+
+bool ImageConversionGraph::findPath( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, std::vector<ImageFormat>& path ) const
+{
+	path.clear();
+	if ( sourceFormat==destinationFormat )
+		return false;
+	if ( sourceFormat.getWidth()!=destinationFormat.getWidth() || sourceFormat.getHeight()!=destinationFormat.getHeight() )
+		return false;
+
+	int source = sourceFormat.getEncoding();
+	int destination = destinationFormat.getEncoding();
+	if ( source>=ImageFormat::EncodingCount || destination>=ImageFormat::EncodingCount )
+		return false;
+
+	// Dijkstra's algorithm on the encodings, from the destinations of the conversions of the 
+	// source: the source itself is not a node yet, so that the path can come back to it when 
+	// both ends have the same encoding. Each encoding has a node before the path goes through 
+	// RGB, with the color of the source, and one after, with the color of the destination
+	const int numNodes = 2*ImageFormat::EncodingCount;
+	const unsigned int infinity = UINT_MAX;
+	bool keepsSourceColor = keepsColor( sourceFormat, destinationFormat );
+	unsigned int costs[numNodes];
+	int previous[numNodes];
+	bool isSettled[numNodes];
+	bool isAllowed[numNodes];
+	for ( int i=0; i<numNodes; ++i )
+	{
+		int encoding = i % ImageFormat::EncodingCount;
+		bool isAfterRGB = i>=ImageFormat::EncodingCount;
+		if ( encoding==destination )
+			isAllowed[i] = isAfterRGB || keepsSourceColor;
+		else if ( encoding==source )
+			isAllowed[i] = isAfterRGB && !keepsSourceColor && canBeIntermediate( static_cast<ImageFormat::Encoding>(encoding), sourceFormat.getEncoding(), destinationFormat.getEncoding() );
+		else
+			isAllowed[i] = canBeIntermediate( static_cast<ImageFormat::Encoding>(encoding), sourceFormat.getEncoding(), destinationFormat.getEncoding() );
+		costs[i] = infinity;
+		previous[i] = -1;
+		isSettled[i] = false;
+	}
+	for ( int i=0; i<ImageFormat::EncodingCount; ++i )
+	{
+		int node = getNode( i, sourceFormat.isRGB() );
+		if ( mConversions[source][i].convert && isAllowed[node] )
+			costs[node] = mConversions[source][i].cost;
+	}
+
+	// A direct conversion is always preferred
+	int destinationNode = costs[destination]!=infinity ? destination : getNode( destination, true );
+	if ( costs[destinationNode]==infinity )
+	{
+		for ( ;; )
+		{
+			int current = -1;
+			for ( int i=0; i<numNodes; ++i )
+			{
+				if ( !isSettled[i] && costs[i]!=infinity && ( current<0 || costs[i]<costs[current] ) )
+					current = i;
+			}
+			if ( current<0 )
+				return false;
+			if ( current % ImageFormat::EncodingCount==destination )
+			{
+				destinationNode = current;
+				break;
+			}
+			isSettled[current] = true;
+
+			bool isAfterRGB = current>=ImageFormat::EncodingCount;
+			for ( int next=0; next<ImageFormat::EncodingCount; ++next )
+			{
+				const Conversion& conversion = mConversions[current % ImageFormat::EncodingCount][next];
+				int nextNode = getNode( next, isAfterRGB );
+				if ( !conversion.convert || !isAllowed[nextNode] || isSettled[nextNode] )
+					continue;
+				unsigned int cost = costs[current] + hopCost + conversion.cost;
+				if ( cost<costs[nextNode] )
+				{
+					costs[nextNode] = cost;
+					previous[nextNode] = current;
+				}
+			}
+		}
+	}
+
+	// Walk the path back, then give the intermediate formats their size and color
+	std::vector<int> nodes;
+	for ( int node=previous[destinationNode]; node>=0; node=previous[node] )
+		nodes.push_back( node );
+	std::reverse( nodes.begin(), nodes.end() );
+
+	path.push_back( sourceFormat );
+	for ( std::size_t i=0; i<nodes.size(); ++i )
+	{
+		ImageFormat::Encoding encoding = static_cast<ImageFormat::Encoding>( nodes[i] % ImageFormat::EncodingCount );
+		const ImageFormat& colorFormat = nodes[i]>=ImageFormat::EncodingCount ? destinationFormat : sourceFormat;
+		path.push_back( ImageFormat( sourceFormat.getWidth(), sourceFormat.getHeight(), encoding, colorFormat.getColorMatrix(), colorFormat.getColorRange() ) );
+	}
+	path.push_back( destinationFormat );
+	return true;
+}
+
+bool ImageConversionGraph::canBeIntermediate( ImageFormat::Encoding encoding, ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding )
+{
+	if ( getChromaResolution( encoding ) < std::min( getChromaResolution( sourceEncoding ), getChromaResolution( destinationEncoding ) ) )
+		return false;
+	if ( hasAlpha( sourceEncoding ) && hasAlpha( destinationEncoding ) && !hasAlpha( encoding ) )
+		return false;
+	if ( sourceEncoding==ImageFormat::GRAY16 && destinationEncoding==ImageFormat::GRAY16 )
+		return false;
+	return true;
+}
+
+// The node of the encoding in findPath(): from an RGB encoding on, the path is after RGB
+int ImageConversionGraph::getNode( int encoding, bool isAfterRGB )
+{
+	if ( isAfterRGB || ImageFormat::isRGB( static_cast<ImageFormat::Encoding>(encoding) ) )
+		return encoding + ImageFormat::EncodingCount;
+	return encoding;
+}
+
+// Whether the samples can be kept as they are from one format to the other. The RGB encodings 
+// have no color matrix nor range, and the gray ones only use the range
+bool ImageConversionGraph::keepsColor( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat )
+{
+	if ( sourceFormat.isRGB() || destinationFormat.isRGB() )
+		return true;
+	if ( sourceFormat.getColorRange()!=destinationFormat.getColorRange() )
+		return false;
+	if ( sourceFormat.isGray() || destinationFormat.isGray() )
+		return true;
+	return sourceFormat.getColorMatrix()==destinationFormat.getColorMatrix();
+}
+
+// 0 for the gray encodings, which have no chroma
+int ImageConversionGraph::getChromaResolution( ImageFormat::Encoding encoding )
+{
+	if ( ImageFormat::isRGB( encoding ) )
+		return 3;
+	if ( ImageFormat::isPackedYUV422( encoding ) )
+		return 2;
+	if ( isYUV420( encoding ) )
+		return 1;
+	return 0;
+}
+
+bool ImageConversionGraph::hasAlpha( ImageFormat::Encoding encoding )
+{
+	return encoding==ImageFormat::RGBA32 || encoding==ImageFormat::BGRA32 || encoding==ImageFormat::ARGB32;
+}
+
+}
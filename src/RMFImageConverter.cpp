@@ -24,46 +24,77 @@
 #include "RMFImageConverter.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include "RMFImageConversionGraph.h"
 
 namespace RMF
 {
 
-ImageConverter::ImageConverter( const ImageFormat& outputImageFormat )
-	: mImage(NULL)	
+ImageConverter::Options::Options()
+	: threadPool(NULL),
+	  minBandHeight(64),
+	  outputBufferOptions(),
+	  outputRowAlignment(1),
+	  yuvToRGBMethod(MultiplyMethod),
+	  conversionGraph(NULL),
+	  scalingFilter(ImageScaler::BoxFilter),
+	  transform(ImageTransformer::Identity)
 {
-	mImage = new Image( outputImageFormat );
+	outputBufferOptions.pool = &MemoryBufferPool::getDefault();
+}
+
+ImageConverter::ImageConverter( const ImageFormat& outputImageFormat, const Options& options )
+	: mImage(NULL),
+	  mOptions(options),
+	  mScaledImage(NULL),
+	  mTransformedImage(NULL)
+{
+	int stride = Image::getAlignedStride( outputImageFormat, mOptions.outputRowAlignment );
+	mImage = new Image( outputImageFormat, stride, mOptions.outputBufferOptions );
 }
 
 ImageConverter::~ImageConverter()
 {
 	delete mImage;
 	mImage = NULL;
+	deleteImages( mIntermediateImages );
+	delete mScaledImage;
+	mScaledImage = NULL;
+	delete mTransformedImage;
+	mTransformedImage = NULL;
 }
 
-bool ImageConverter::update( const Image& sourceImage )
+bool ImageConverter::update( const ConstImageView& sourceImage )
 {
+	if ( mOptions.transform!=ImageTransformer::Identity )
+		return transformAndConvertImage( sourceImage, *mImage, mPath, mTransformedImage, mScaledImage, mIntermediateImages, mOptions );
 	if ( sourceImage.getFormat()==mImage->getFormat() )
-		return mImage->getBuffer().copyFrom( sourceImage.getBuffer() );
-	return convertImage( sourceImage, *mImage );
+		return mImage->copyFrom( sourceImage );
+	if ( !haveSameSize( sourceImage.getFormat(), mImage->getFormat() ) )
+		return scaleAndConvertImage( sourceImage, *mImage, mPath, mScaledImage, mIntermediateImages, mOptions );
+
+	// The path is planned again when the format of the source changes
+	if ( mPath.empty() || mPath.front()!=sourceImage.getFormat() )
+	{
+		if ( !getConversionGraph( mOptions ).findPath( sourceImage.getFormat(), mImage->getFormat(), mPath ) )
+			return false;
+	}
+	return convertAlongPath( mPath, sourceImage, *mImage, mIntermediateImages, mOptions );
 }
 	
 bool ImageConverter::swapFirstAndThirdBytesEveryThreeBytes( MemoryBuffer& buffer )
 {
 	if ( buffer.getSizeInBytes() % 3 !=0 )
 		return false;
-	unsigned int count = buffer.getSizeInBytes();
-	unsigned char* bytes = buffer.getBytes();
-	unsigned char tempByte = 0;
-	for ( unsigned int i=0; i<count; i+=3 )
-	{
-		tempByte = bytes[i];
-		bytes[i] = bytes[i+2];
-		bytes[i+2] = tempByte;
-	}
+	
+	// The buffer is handled as a single row of 3-byte pixels, swapped in place
+	ImageConverterKernels::ConvertRowFunction swapRow = ImageConverterKernels::getSwapFirstAndThirdBytesRowFunction( ImageConverterKernels::getBestInstructionSet() );
+	swapRow( buffer.getBytes(), buffer.getBytes(), buffer.getSizeInBytes() / 3 );
 	return true;
 }
 
-bool ImageConverter::convertBGR24ImageToRGB24Image( const Image& bgr24Image, Image& rgb24Image )
+bool ImageConverter::convertBGR24ImageToRGB24Image( const ConstImageView& bgr24Image, const ImageView& rgb24Image, const Options& options )
 {
 	// Pre-checks
 	if ( bgr24Image.getFormat().getEncoding()!=ImageFormat::BGR24 )
@@ -76,14 +107,13 @@ bool ImageConverter::convertBGR24ImageToRGB24Image( const Image& bgr24Image, Ima
 	if ( rgb24Image.getFormat().getWidth()!=width || rgb24Image.getFormat().getHeight()!=height )
 		 return false;
 
-	// The following two-step copy-transformation could be written as a single step one
-	rgb24Image.getBuffer().copyFrom( bgr24Image.getBuffer() );
-	swapFirstAndThirdBytesEveryThreeBytes( rgb24Image.getBuffer() );
-
+	// Single pass: the bytes are swapped while being copied
+	ImageConverterKernels::ConvertRowFunction swapRow = ImageConverterKernels::getSwapFirstAndThirdBytesRowFunction( ImageConverterKernels::getBestInstructionSet() );
+	convertRows( swapRow, bgr24Image, rgb24Image, options );
 	return true;
 }
 
-bool ImageConverter::convertRGB24ImageToBGR24Image( const Image& rgb24Image, Image& bgr24Image )
+bool ImageConverter::convertRGB24ImageToBGR24Image( const ConstImageView& rgb24Image, const ImageView& bgr24Image, const Options& options )
 {
 	// Pre-checks
 	if ( rgb24Image.getFormat().getEncoding()!=ImageFormat::RGB24 )
@@ -96,16 +126,13 @@ bool ImageConverter::convertRGB24ImageToBGR24Image( const Image& rgb24Image, Ima
 	if ( bgr24Image.getFormat().getWidth()!=width || bgr24Image.getFormat().getHeight()!=height )
 		 return false;
 
-	// Same remark here
-	bgr24Image.getBuffer().copyFrom( rgb24Image.getBuffer() );
-	swapFirstAndThirdBytesEveryThreeBytes( bgr24Image.getBuffer() );
-
+	// Same here
+	ImageConverterKernels::ConvertRowFunction swapRow = ImageConverterKernels::getSwapFirstAndThirdBytesRowFunction( ImageConverterKernels::getBestInstructionSet() );
+	convertRows( swapRow, rgb24Image, bgr24Image, options );
 	return true;
 }	
 
-#define CLIP_INT_TO_UCHAR(value) ( (value)<0 ? 0 : ( (value)>255 ? 255 : static_cast<unsigned char>(value) ) ) 
-
-bool ImageConverter::convertYUYVImageToRGB24Image( const Image& yuyvImage, Image& rgb24Image )
+bool ImageConverter::convertYUYVImageToRGB24Image( const ConstImageView& yuyvImage, const ImageView& rgb24Image, const Options& options )
 {
 	// Pre-checks
 	if ( yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV )
@@ -118,44 +145,15 @@ bool ImageConverter::convertYUYVImageToRGB24Image( const Image& yuyvImage, Image
 	if ( rgb24Image.getFormat().getWidth()!=width || rgb24Image.getFormat().getHeight()!=height )
 		 return false;
 
-	// General information about YUV color space can be found here:
-	// http://en.wikipedia.org/wiki/YUV 
-	// or here:
-	// http://www.fourcc.org/yuv.php
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertYUV422ImageToRGBImage( yuyvImage, rgb24Image, options );
 
-	// The following conversion code comes from here:
-	// http://stackoverflow.com/questions/4491649/how-to-convert-yuy2-to-a-bitmap-in-c
-	// http://msdn.microsoft.com/en-us/library/aa904813(VS.80).aspx#yuvformats_2
-	const unsigned char* sourceBytes = yuyvImage.getBuffer().getBytes();
-	unsigned char* destBytes = rgb24Image.getBuffer().getBytes();
-	for ( unsigned int y=0; y<height; ++y )
-	{
-		for ( unsigned int i=0; i<width/2; ++i )
-		{
-			int y0 = sourceBytes[0];
-			int u0 = sourceBytes[1];
-			int y1 = sourceBytes[2];
-			int v0 = sourceBytes[3];
-			sourceBytes += 4;	
-			
-			int c = y0 - 16;
-			int d = u0 - 128;
-			int e = v0 - 128;
-			destBytes[0] = CLIP_INT_TO_UCHAR(( 298 * c           + 409 * e + 128) >> 8);		// Red
-			destBytes[1] = CLIP_INT_TO_UCHAR(( 298 * c - 100 * d - 208 * e + 128) >> 8);		// Green
-			destBytes[2] = CLIP_INT_TO_UCHAR(( 298 * c + 516 * d           + 128) >> 8);		// Blue
-			
-			c = y1 - 16;
-			destBytes[3] = CLIP_INT_TO_UCHAR(( 298 * c           + 409 * e + 128) >> 8);		// Red
-			destBytes[4] = CLIP_INT_TO_UCHAR(( 298 * c - 100 * d - 208 * e + 128) >> 8);		// Green
-			destBytes[5] = CLIP_INT_TO_UCHAR(( 298 * c + 516 * d           + 128) >> 8);		// Blue
-			destBytes += 6;
-		}
-	}
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertYUYVRowToRGB24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, YUVCoefficients::get( yuyvImage.getFormat() ), yuyvImage, rgb24Image, options );
 	return true;	
 }
 
-bool ImageConverter::convertYUYVImageToBGR24Image( const Image& yuyvImage, Image& bgr24Image )
+bool ImageConverter::convertYUYVImageToBGR24Image( const ConstImageView& yuyvImage, const ImageView& bgr24Image, const Options& options )
 {
 	// Pre-checks
 	if ( yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV )
@@ -168,61 +166,706 @@ bool ImageConverter::convertYUYVImageToBGR24Image( const Image& yuyvImage, Image
 	if ( bgr24Image.getFormat().getWidth()!=width || bgr24Image.getFormat().getHeight()!=height )
 		 return false;
 
-	// General information about YUV color space can be found here:
-	// http://en.wikipedia.org/wiki/YUV 
-	// or here:
-	// http://www.fourcc.org/yuv.php
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertYUV422ImageToRGBImage( yuyvImage, bgr24Image, options );
+
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertYUYVRowToBGR24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, YUVCoefficients::get( yuyvImage.getFormat() ), yuyvImage, bgr24Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUYVImageToNV12Image( const ConstImageView& yuyvImage, const ImageView& nv12Image, const Options& options )
+{
+	if ( yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV || nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 )
+		return false;
+	if ( !haveSameSize( yuyvImage.getFormat(), nv12Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertYUYVRowPairToNV12Function( ImageConverterKernels::ScalarInstructionSet );
+	convertRowPairsToYUV420( convertRowPair, yuyvImage, nv12Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUYVImageToI420Image( const ConstImageView& yuyvImage, const ImageView& i420Image, const Options& options )
+{
+	if ( yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV || !isI420OrYV12( i420Image.getFormat().getEncoding() ) )
+		return false;
+	if ( !haveSameSize( yuyvImage.getFormat(), i420Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertYUYVRowPairToI420Function( ImageConverterKernels::ScalarInstructionSet );
+	convertRowPairsToYUV420( convertRowPair, yuyvImage, i420Image, options );
+	return true;
+}
+
+bool ImageConverter::convertNV12ImageToRGB24Image( const ConstImageView& nv12Image, const ImageView& rgb24Image, const Options& options )
+{
+	if ( nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 || rgb24Image.getFormat().getEncoding()!=ImageFormat::RGB24 )
+		return false;
+	if ( !haveSameSize( nv12Image.getFormat(), rgb24Image.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertNV12ImageToRGBImage( nv12Image, rgb24Image, options );
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertNV12RowToRGB24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( nv12Image.getFormat() ), nv12Image, rgb24Image, options );
+	return true;
+}
+
+bool ImageConverter::convertNV12ImageToBGR24Image( const ConstImageView& nv12Image, const ImageView& bgr24Image, const Options& options )
+{
+	if ( nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 || bgr24Image.getFormat().getEncoding()!=ImageFormat::BGR24 )
+		return false;
+	if ( !haveSameSize( nv12Image.getFormat(), bgr24Image.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertNV12ImageToRGBImage( nv12Image, bgr24Image, options );
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertNV12RowToBGR24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( nv12Image.getFormat() ), nv12Image, bgr24Image, options );
+	return true;
+}
+
+bool ImageConverter::convertNV12ImageToYUYVImage( const ConstImageView& nv12Image, const ImageView& yuyvImage, const Options& options )
+{
+	if ( nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 || yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV )
+		return false;
+	if ( !haveSameSize( nv12Image.getFormat(), yuyvImage.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertYUV420RowFunction convertRow = ImageConverterKernels::getConvertNV12RowToYUYVFunction( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, nv12Image, yuyvImage, options );
+	return true;
+}
+
+bool ImageConverter::convertI420ImageToRGB24Image( const ConstImageView& i420Image, const ImageView& rgb24Image, const Options& options )
+{
+	if ( !isI420OrYV12( i420Image.getFormat().getEncoding() ) || rgb24Image.getFormat().getEncoding()!=ImageFormat::RGB24 )
+		return false;
+	if ( !haveSameSize( i420Image.getFormat(), rgb24Image.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertI420ImageToRGBImage( i420Image, rgb24Image, options );
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertI420RowToRGB24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( i420Image.getFormat() ), i420Image, rgb24Image, options );
+	return true;
+}
+
+bool ImageConverter::convertI420ImageToBGR24Image( const ConstImageView& i420Image, const ImageView& bgr24Image, const Options& options )
+{
+	if ( !isI420OrYV12( i420Image.getFormat().getEncoding() ) || bgr24Image.getFormat().getEncoding()!=ImageFormat::BGR24 )
+		return false;
+	if ( !haveSameSize( i420Image.getFormat(), bgr24Image.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+		return convertI420ImageToRGBImage( i420Image, bgr24Image, options );
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertI420RowToBGR24Function( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( i420Image.getFormat() ), i420Image, bgr24Image, options );
+	return true;
+}
+
+bool ImageConverter::convertI420ImageToYUYVImage( const ConstImageView& i420Image, const ImageView& yuyvImage, const Options& options )
+{
+	if ( !isI420OrYV12( i420Image.getFormat().getEncoding() ) || yuyvImage.getFormat().getEncoding()!=ImageFormat::YUYV )
+		return false;
+	if ( !haveSameSize( i420Image.getFormat(), yuyvImage.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertYUV420RowFunction convertRow = ImageConverterKernels::getConvertI420RowToYUYVFunction( ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, i420Image, yuyvImage, options );
+	return true;
+}
+
+bool ImageConverter::convertRGBImageToRGBImage( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
+	ImageFormat::Encoding sourceEncoding = sourceImage.getFormat().getEncoding();
+	ImageFormat::Encoding destinationEncoding = destinationImage.getFormat().getEncoding();
+	if ( !ImageFormat::isRGB( sourceEncoding ) || !ImageFormat::isRGB( destinationEncoding ) || sourceEncoding==destinationEncoding )
+		return false;
+	if ( !haveSameSize( sourceImage.getFormat(), destinationImage.getFormat() ) )
+		return false;
 
-	// The following conversion code comes from here:
-	// http://stackoverflow.com/questions/4491649/how-to-convert-yuy2-to-a-bitmap-in-c
-	// http://msdn.microsoft.com/en-us/library/aa904813(VS.80).aspx#yuvformats_2
-	const unsigned char* sourceBytes = yuyvImage.getBuffer().getBytes();
-	unsigned char* destBytes = bgr24Image.getBuffer().getBytes();
-	for ( unsigned int y=0; y<height; ++y )
+	ImageConverterKernels::ConvertRowFunction convertRow = ImageConverterKernels::getConvertRGBRowFunction( sourceEncoding, destinationEncoding, ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, sourceImage, destinationImage, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV422ImageToRGBImage( const ConstImageView& yuv422Image, const ImageView& rgbImage, const Options& options )
+{
+	if ( !yuv422Image.getFormat().isPackedYUV422() || !rgbImage.getFormat().isRGB() )
+		return false;
+	if ( !haveSameSize( yuv422Image.getFormat(), rgbImage.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
 	{
-		for ( unsigned int i=0; i<width/2; ++i )
-		{
-			int y0 = sourceBytes[0];
-			int u0 = sourceBytes[1];
-			int y1 = sourceBytes[2];
-			int v0 = sourceBytes[3];
-			sourceBytes += 4;	
-			
-			int c = y0 - 16;
-			int d = u0 - 128;
-			int e = v0 - 128;
-			destBytes[0] = CLIP_INT_TO_UCHAR(( 298 * c + 516 * d           + 128) >> 8);		// Blue
-			destBytes[1] = CLIP_INT_TO_UCHAR(( 298 * c - 100 * d - 208 * e + 128) >> 8);		// Green
-			destBytes[2] = CLIP_INT_TO_UCHAR(( 298 * c           + 409 * e + 128) >> 8);		// Red
-			
-			c = y1 - 16;
-			destBytes[3] = CLIP_INT_TO_UCHAR(( 298 * c + 516 * d           + 128) >> 8);		// Blue
-			destBytes[4] = CLIP_INT_TO_UCHAR(( 298 * c - 100 * d - 208 * e + 128) >> 8);		// Green
-			destBytes[5] = CLIP_INT_TO_UCHAR(( 298 * c           + 409 * e + 128) >> 8);		// Red
-			destBytes += 6;
-		}
+		ImageConverterKernels::ConvertTableRowFunction convertRow = ImageConverterKernels::getConvertYUV422RowToRGBTableFunction( yuv422Image.getFormat().getEncoding(), rgbImage.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+		convertRows( convertRow, YUVToRGBTables::get( yuv422Image.getFormat() ), yuv422Image, rgbImage, options );
+		return true;
+	}
+
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertYUV422RowToRGBFunction( yuv422Image.getFormat().getEncoding(), rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, YUVCoefficients::get( yuv422Image.getFormat() ), yuv422Image, rgbImage, options );
+	return true;
+}
+
+bool ImageConverter::convertNV12ImageToRGBImage( const ConstImageView& nv12Image, const ImageView& rgbImage, const Options& options )
+{
+	if ( nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 || !rgbImage.getFormat().isRGB() )
+		return false;
+	if ( !haveSameSize( nv12Image.getFormat(), rgbImage.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+	{
+		ImageConverterKernels::ConvertYUV420TableRowFunction convertRow = ImageConverterKernels::getConvertNV12RowToRGBTableFunction( rgbImage.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+		convertYUV420Rows( convertRow, YUVToRGBTables::get( nv12Image.getFormat() ), nv12Image, rgbImage, options );
+		return true;
+	}
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertNV12RowToRGBFunction( rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( nv12Image.getFormat() ), nv12Image, rgbImage, options );
+	return true;
+}
+
+bool ImageConverter::convertI420ImageToRGBImage( const ConstImageView& i420Image, const ImageView& rgbImage, const Options& options )
+{
+	if ( !isI420OrYV12( i420Image.getFormat().getEncoding() ) || !rgbImage.getFormat().isRGB() )
+		return false;
+	if ( !haveSameSize( i420Image.getFormat(), rgbImage.getFormat() ) )
+		return false;
+
+	if ( options.yuvToRGBMethod==LookupTableMethod )
+	{
+		ImageConverterKernels::ConvertYUV420TableRowFunction convertRow = ImageConverterKernels::getConvertI420RowToRGBTableFunction( rgbImage.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+		convertYUV420Rows( convertRow, YUVToRGBTables::get( i420Image.getFormat() ), i420Image, rgbImage, options );
+		return true;
 	}
+
+	ImageConverterKernels::ConvertYUV420ColorRowFunction convertRow = ImageConverterKernels::getConvertI420RowToRGBFunction( rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertYUV420Rows( convertRow, YUVCoefficients::get( i420Image.getFormat() ), i420Image, rgbImage, options );
+	return true;
+}
+
+bool ImageConverter::convertRGBImageToYUV422Image( const ConstImageView& rgbImage, const ImageView& yuv422Image, const Options& options )
+{
+	if ( !rgbImage.getFormat().isRGB() || !yuv422Image.getFormat().isPackedYUV422() )
+		return false;
+	if ( !haveSameSize( rgbImage.getFormat(), yuv422Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertRGBRowToYUV422Function( rgbImage.getFormat().getEncoding(), yuv422Image.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, YUVCoefficients::get( yuv422Image.getFormat() ), rgbImage, yuv422Image, options );
+	return true;
+}
+
+bool ImageConverter::convertRGBImageToNV12Image( const ConstImageView& rgbImage, const ImageView& nv12Image, const Options& options )
+{
+	if ( !rgbImage.getFormat().isRGB() || nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 )
+		return false;
+	if ( !haveSameSize( rgbImage.getFormat(), nv12Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertColorRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertRGBRowPairToNV12Function( rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRowPairsToYUV420( convertRowPair, YUVCoefficients::get( nv12Image.getFormat() ), rgbImage, nv12Image, options );
+	return true;
+}
+
+bool ImageConverter::convertRGBImageToI420Image( const ConstImageView& rgbImage, const ImageView& i420Image, const Options& options )
+{
+	if ( !rgbImage.getFormat().isRGB() || !isI420OrYV12( i420Image.getFormat().getEncoding() ) )
+		return false;
+	if ( !haveSameSize( rgbImage.getFormat(), i420Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertColorRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertRGBRowPairToI420Function( rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRowPairsToYUV420( convertRowPair, YUVCoefficients::get( i420Image.getFormat() ), rgbImage, i420Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV422ImageToNV12Image( const ConstImageView& yuv422Image, const ImageView& nv12Image, const Options& options )
+{
+	if ( !yuv422Image.getFormat().isPackedYUV422() || nv12Image.getFormat().getEncoding()!=ImageFormat::NV12 )
+		return false;
+	if ( !haveSameSize( yuv422Image.getFormat(), nv12Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertYUV422RowPairToNV12Function( yuv422Image.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+	convertRowPairsToYUV420( convertRowPair, yuv422Image, nv12Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV422ImageToI420Image( const ConstImageView& yuv422Image, const ImageView& i420Image, const Options& options )
+{
+	if ( !yuv422Image.getFormat().isPackedYUV422() || !isI420OrYV12( i420Image.getFormat().getEncoding() ) )
+		return false;
+	if ( !haveSameSize( yuv422Image.getFormat(), i420Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair = ImageConverterKernels::getConvertYUV422RowPairToI420Function( yuv422Image.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+	convertRowPairsToYUV420( convertRowPair, yuv422Image, i420Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV422ImageToYUV422Image( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
+	ImageFormat::Encoding sourceEncoding = sourceImage.getFormat().getEncoding();
+	ImageFormat::Encoding destinationEncoding = destinationImage.getFormat().getEncoding();
+	if ( !ImageFormat::isPackedYUV422( sourceEncoding ) || !ImageFormat::isPackedYUV422( destinationEncoding ) || sourceEncoding==destinationEncoding )
+		return false;
+	if ( !haveSameSize( sourceImage.getFormat(), destinationImage.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowFunction convertRow = ImageConverterKernels::getConvertYUV422RowToYUV422Function( sourceEncoding, destinationEncoding, ImageConverterKernels::ScalarInstructionSet );
+	convertRows( convertRow, sourceImage, destinationImage, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV422ImageToGRAY8Image( const ConstImageView& yuv422Image, const ImageView& gray8Image, const Options& options )
+{
+	if ( !yuv422Image.getFormat().isPackedYUV422() || gray8Image.getFormat().getEncoding()!=ImageFormat::GRAY8 )
+		return false;
+	if ( !haveSameSize( yuv422Image.getFormat(), gray8Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowFunction convertRow = ImageConverterKernels::getConvertYUV422RowToGRAY8Function( yuv422Image.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, yuv422Image, gray8Image, options );
+	return true;
+}
+
+bool ImageConverter::convertYUV420ImageToGRAY8Image( const ConstImageView& yuv420Image, const ImageView& gray8Image, const Options& options )
+{
+	ImageFormat::Encoding yuv420Encoding = yuv420Image.getFormat().getEncoding();
+	if ( ( yuv420Encoding!=ImageFormat::NV12 && !isI420OrYV12( yuv420Encoding ) ) || gray8Image.getFormat().getEncoding()!=ImageFormat::GRAY8 )
+		return false;
+	if ( !haveSameSize( yuv420Image.getFormat(), gray8Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertYUV420RowFunction convertRow = ImageConverterKernels::getConvertYUV420RowToGRAY8Function( ImageConverterKernels::ScalarInstructionSet );
+	convertYUV420Rows( convertRow, yuv420Image, gray8Image, options );
+	return true;
+}
+
+bool ImageConverter::convertRGBImageToGRAY8Image( const ConstImageView& rgbImage, const ImageView& gray8Image, const Options& options )
+{
+	if ( !rgbImage.getFormat().isRGB() || gray8Image.getFormat().getEncoding()!=ImageFormat::GRAY8 )
+		return false;
+	if ( !haveSameSize( rgbImage.getFormat(), gray8Image.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertRGBRowToGRAY8Function( rgbImage.getFormat().getEncoding(), ImageConverterKernels::getBestInstructionSet() );
+	convertRows( convertRow, YUVCoefficients::get( gray8Image.getFormat() ), rgbImage, gray8Image, options );
 	return true;
 }
 
-bool ImageConverter::convertImage( const Image& sourceImage, Image& destinationImage )
+bool ImageConverter::convertGRAYImageToRGBImage( const ConstImageView& grayImage, const ImageView& rgbImage, const Options& options )
 {
-	if ( sourceImage.getFormat()==destinationImage.getFormat() )
+	if ( !grayImage.getFormat().isGray() || !rgbImage.getFormat().isRGB() )
+		return false;
+	if ( !haveSameSize( grayImage.getFormat(), rgbImage.getFormat() ) )
 		return false;
 
+	ImageConverterKernels::ConvertColorRowFunction convertRow = ImageConverterKernels::getConvertGRAYRowToRGBFunction( grayImage.getFormat().getEncoding(), rgbImage.getFormat().getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+	convertRows( convertRow, YUVCoefficients::get( grayImage.getFormat() ), grayImage, rgbImage, options );
+	return true;
+}
+
+bool ImageConverter::convertGRAYImageToGRAYImage( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
 	ImageFormat::Encoding sourceEncoding = sourceImage.getFormat().getEncoding();
 	ImageFormat::Encoding destinationEncoding = destinationImage.getFormat().getEncoding();
+	if ( !ImageFormat::isGray( sourceEncoding ) || !ImageFormat::isGray( destinationEncoding ) || sourceEncoding==destinationEncoding )
+		return false;
+	if ( !haveSameSize( sourceImage.getFormat(), destinationImage.getFormat() ) )
+		return false;
+
+	ImageConverterKernels::ConvertRowFunction convertRow = ImageConverterKernels::getConvertGRAYRowToGRAYFunction( sourceEncoding, destinationEncoding, ImageConverterKernels::ScalarInstructionSet );
+	convertRows( convertRow, sourceImage, destinationImage, options );
+	return true;
+}
+
+bool ImageConverter::haveSameSize( const ImageFormat& firstImageFormat, const ImageFormat& secondImageFormat )
+{
+	return	firstImageFormat.getWidth()==secondImageFormat.getWidth() && 
+			firstImageFormat.getHeight()==secondImageFormat.getHeight();
+}
+
+bool ImageConverter::isI420OrYV12( ImageFormat::Encoding encoding )
+{
+	return encoding==ImageFormat::I420 || encoding==ImageFormat::YV12;
+}
+
+void ImageConverter::convertBands( const ConvertBandFunction& convertBand, unsigned int height, unsigned int numRowsPerStep, const Options& options )
+{
+	ThreadPool::runBands( options.threadPool, convertBand, height, numRowsPerStep, options.minBandHeight );
+}
+
+void ImageConverter::convertRows( ImageConverterKernels::ConvertRowFunction convertRow, const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
+	// The strides of the images can differ, and be negative for bottom-up images
+	unsigned int width = sourceImage.getFormat().getWidth();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; ++y )
+				convertRow( sourceImage.getRow(y), destinationImage.getRow(y), width );
+		};
+	convertBands( convertBand, sourceImage.getFormat().getHeight(), 1, options );
+}
+
+namespace
+{
+
+// The U and V rows of a 4:2:0 image, for the given image row
+template<class View, class Byte>
+void getChromaRows( const View& yuv420Image, unsigned int y, Byte*& uRow, Byte*& vRow )
+{
+	switch ( yuv420Image.getFormat().getEncoding() )
+	{
+		case ImageFormat::NV12:
+			uRow = yuv420Image.getPlaneRow( 1, y/2 );
+			vRow = uRow + 1;
+			break;
+		case ImageFormat::YV12:
+			vRow = yuv420Image.getPlaneRow( 1, y/2 );
+			uRow = yuv420Image.getPlaneRow( 2, y/2 );
+			break;
+		default:
+			uRow = yuv420Image.getPlaneRow( 1, y/2 );
+			vRow = yuv420Image.getPlaneRow( 2, y/2 );
+			break;
+	}
+}
+
+}
+
+void ImageConverter::convertYUV420Rows( ImageConverterKernels::ConvertYUV420RowFunction convertRow, const ConstImageView& yuv420Image, const ImageView& destinationImage, const Options& options )
+{
+	// Each chroma row is used by two image rows
+	unsigned int width = yuv420Image.getFormat().getWidth();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; ++y )
+			{
+				const unsigned char* uRow = NULL;
+				const unsigned char* vRow = NULL;
+				getChromaRows( yuv420Image, y, uRow, vRow );
+				convertRow( yuv420Image.getRow(y), uRow, vRow, destinationImage.getRow(y), width );
+			}
+		};
+	convertBands( convertBand, yuv420Image.getFormat().getHeight(), 1, options );
+}
+
+void ImageConverter::convertRowPairsToYUV420( ImageConverterKernels::ConvertRowPairToYUV420Function convertRowPair, const ConstImageView& sourceImage, const ImageView& yuv420Image, const Options& options )
+{
+	// With an odd height, the last row is paired with itself
+	unsigned int width = sourceImage.getFormat().getWidth();
+	unsigned int height = sourceImage.getFormat().getHeight();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; y+=2 )
+			{
+				unsigned int nextY = y+1<height ? y+1 : y;
+				unsigned char* uRow = NULL;
+				unsigned char* vRow = NULL;
+				getChromaRows( yuv420Image, y, uRow, vRow );
+				convertRowPair( sourceImage.getRow(y), sourceImage.getRow(nextY), yuv420Image.getRow(y), yuv420Image.getRow(nextY), uRow, vRow, width );
+			}
+		};
+	convertBands( convertBand, height, 2, options );
+}
+
+template<class Function, class Coefficients>
+void ImageConverter::convertRows( Function convertRow, const Coefficients& coefficients, const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
+	unsigned int width = sourceImage.getFormat().getWidth();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; ++y )
+				convertRow( sourceImage.getRow(y), destinationImage.getRow(y), width, coefficients );
+		};
+	convertBands( convertBand, sourceImage.getFormat().getHeight(), 1, options );
+}
+
+template<class Function, class Coefficients>
+void ImageConverter::convertYUV420Rows( Function convertRow, const Coefficients& coefficients, const ConstImageView& yuv420Image, const ImageView& destinationImage, const Options& options )
+{
+	unsigned int width = yuv420Image.getFormat().getWidth();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; ++y )
+			{
+				const unsigned char* uRow = NULL;
+				const unsigned char* vRow = NULL;
+				getChromaRows( yuv420Image, y, uRow, vRow );
+				convertRow( yuv420Image.getRow(y), uRow, vRow, destinationImage.getRow(y), width, coefficients );
+			}
+		};
+	convertBands( convertBand, yuv420Image.getFormat().getHeight(), 1, options );
+}
 
-	if ( sourceEncoding==ImageFormat::BGR24 && destinationEncoding==ImageFormat::RGB24 )
-		return convertBGR24ImageToRGB24Image( sourceImage, destinationImage );
-	else if ( sourceEncoding==ImageFormat::RGB24 && destinationEncoding==ImageFormat::BGR24 )
-		return convertRGB24ImageToBGR24Image( sourceImage, destinationImage );
-	else if ( sourceEncoding==ImageFormat::YUYV && destinationEncoding==ImageFormat::RGB24 )
-		return convertYUYVImageToRGB24Image( sourceImage, destinationImage );
-	else if ( sourceEncoding==ImageFormat::YUYV && destinationEncoding==ImageFormat::BGR24 )
-		return convertYUYVImageToBGR24Image( sourceImage, destinationImage );
-	return false;
+void ImageConverter::convertRowPairsToYUV420( ImageConverterKernels::ConvertColorRowPairToYUV420Function convertRowPair, const YUVCoefficients& coefficients, const ConstImageView& sourceImage, const ImageView& yuv420Image, const Options& options )
+{
+	unsigned int width = sourceImage.getFormat().getWidth();
+	unsigned int height = sourceImage.getFormat().getHeight();
+	ConvertBandFunction convertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int y=firstRow; y<endRow; y+=2 )
+			{
+				unsigned int nextY = y+1<height ? y+1 : y;
+				unsigned char* uRow = NULL;
+				unsigned char* vRow = NULL;
+				getChromaRows( yuv420Image, y, uRow, vRow );
+				convertRowPair( sourceImage.getRow(y), sourceImage.getRow(nextY), yuv420Image.getRow(y), yuv420Image.getRow(nextY), uRow, vRow, width, coefficients );
+			}
+		};
+	convertBands( convertBand, height, 2, options );
+}
+
+bool ImageConverter::convertImage( const ConstImageView& sourceImage, const ImageView& destinationImage, const Options& options )
+{
+	if ( options.transform!=ImageTransformer::Identity )
+	{
+		std::vector<ImageFormat> path;
+		Image* transformedImage = NULL;
+		Image* scaledImage = NULL;
+		std::vector<Image*> intermediateImages;
+		bool converted = transformAndConvertImage( sourceImage, destinationImage, path, transformedImage, scaledImage, intermediateImages, options );
+		delete transformedImage;
+		delete scaledImage;
+		deleteImages( intermediateImages );
+		return converted;
+	}
+	if ( !haveSameSize( sourceImage.getFormat(), destinationImage.getFormat() ) )
+	{
+		std::vector<ImageFormat> path;
+		Image* scaledImage = NULL;
+		std::vector<Image*> intermediateImages;
+		bool converted = scaleAndConvertImage( sourceImage, destinationImage, path, scaledImage, intermediateImages, options );
+		delete scaledImage;
+		deleteImages( intermediateImages );
+		return converted;
+	}
+
+	const ImageConversionGraph& graph = getConversionGraph( options );
+	ImageConversionGraph::ConvertFunction convert = graph.getConversion( sourceImage.getFormat(), destinationImage.getFormat() );
+	if ( convert )
+		return convert( sourceImage, destinationImage, options );
+
+	std::vector<ImageFormat> path;
+	if ( !graph.findPath( sourceImage.getFormat(), destinationImage.getFormat(), path ) )
+		return false;
+	std::vector<Image*> intermediateImages;
+	bool converted = convertAlongPath( path, sourceImage, destinationImage, intermediateImages, options );
+	deleteImages( intermediateImages );
+	return converted;
+}
+
+bool ImageConverter::convertRegions( const ConstImageView& sourceImage, const std::vector<ImageRegion>& regions, const std::vector<ImageView>& destinationImages, const Options& options )
+{
+	if ( regions.size()!=destinationImages.size() )
+		return false;
+	for ( std::size_t i=0; i<regions.size(); ++i )
+	{
+		if ( !ImageView::isValidRegion( sourceImage.getFormat(), regions[i] ) )
+			return false;
+	}
+
+	// Few regions are converted one after the other, each split in bands. Many regions keep 
+	// all the threads busy on their own, without synchronizing after each of them
+	unsigned int numRegions = static_cast<unsigned int>( regions.size() );
+	bool convertsRegionsInParallel = options.threadPool && numRegions>options.threadPool->getNumThreads();
+	Options regionOptions = options;
+	if ( convertsRegionsInParallel )
+		regionOptions.threadPool = NULL;
+
+	std::atomic<bool> converted( true );
+	ThreadPool::Task convertRegion = [&]( unsigned int index )
+		{
+			ConstImageView sourceRegion = sourceImage.getRegion( regions[index] );
+			const ImageView& destinationImage = destinationImages[index];
+			bool convertedRegion = false;
+			if ( sourceRegion.getFormat()==destinationImage.getFormat() && options.transform==ImageTransformer::Identity )
+				convertedRegion = destinationImage.copyFrom( sourceRegion );
+			else
+				convertedRegion = convertImage( sourceRegion, destinationImage, regionOptions );
+			if ( !convertedRegion )
+				converted = false;
+		};
+	if ( convertsRegionsInParallel )
+	{
+		options.threadPool->run( convertRegion, numRegions );
+	}
+	else
+	{
+		for ( unsigned int i=0; i<numRegions; ++i )
+			convertRegion( i );
+	}
+	return converted;
+}
+
+const ImageConversionGraph& ImageConverter::getConversionGraph( const Options& options )
+{
+	if ( options.conversionGraph )
+		return *options.conversionGraph;
+	return ImageConversionGraph::getDefault();
+}
+
+bool ImageConverter::convertAlongPath( const std::vector<ImageFormat>& path, const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<Image*>& intermediateImages, const Options& options )
+{
+	if ( path.size()<2 || sourceImage.getFormat()!=path.front() || destinationImage.getFormat()!=path.back() )
+		return false;
+
+	std::size_t numIntermediateImages = path.size()-2;
+	while ( intermediateImages.size()>numIntermediateImages )
+	{
+		delete intermediateImages.back();
+		intermediateImages.pop_back();
+	}
+	intermediateImages.resize( numIntermediateImages, NULL );
+	for ( std::size_t i=0; i<numIntermediateImages; ++i )
+	{
+		if ( intermediateImages[i] && intermediateImages[i]->getFormat()==path[i+1] )
+			continue;
+		delete intermediateImages[i];
+		intermediateImages[i] = new Image( path[i+1], options.outputBufferOptions );
+	}
+
+	const ImageConversionGraph& graph = getConversionGraph( options );
+	for ( std::size_t i=0; i+1<path.size(); ++i )
+	{
+		ImageConversionGraph::ConvertFunction convert = graph.getConversion( path[i], path[i+1] );
+		if ( !convert )
+			return false;
+		ConstImageView hopSourceImage = i==0 ? sourceImage : ConstImageView( *intermediateImages[i-1] );
+		ImageView hopDestinationImage = i+2==path.size() ? destinationImage : ImageView( *intermediateImages[i] );
+		if ( !convert( hopSourceImage, hopDestinationImage, options ) )
+			return false;
+	}
+	return true;
+}
+
+void ImageConverter::deleteImages( std::vector<Image*>& images )
+{
+	for ( std::size_t i=0; i<images.size(); ++i )
+		delete images[i];
+	images.clear();
+}
+
+bool ImageConverter::scaleAndConvertImage( const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& scaledImage, std::vector<Image*>& intermediateImages, const Options& options )
+{
+	const ImageFormat& sourceFormat = sourceImage.getFormat();
+	const ImageFormat& destinationFormat = destinationImage.getFormat();
+	ImageFormat scaledFormat( destinationFormat.getWidth(), destinationFormat.getHeight(), sourceFormat.getEncoding(), sourceFormat.getColorMatrix(), sourceFormat.getColorRange() );
+	if ( !ImageScaler::canScale( sourceFormat, scaledFormat ) )
+		return false;
+
+	ImageScaler scaler( sourceFormat, scaledFormat, options.scalingFilter );
+	ProduceRowsFunction scaleRows = [&]( const ImageView& scaledView, unsigned int firstRow, unsigned int endRow )
+		{
+			scaler.scaleRows( sourceImage, scaledView, firstRow, endRow );
+		};
+	return produceAndConvertImage( scaleRows, scaledFormat, numRowsPerChunk, destinationImage, path, scaledImage, intermediateImages, options );
+}
+
+bool ImageConverter::transformAndConvertImage( const ConstImageView& sourceImage, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& transformedImage, Image*& scaledImage, std::vector<Image*>& intermediateImages, const Options& options )
+{
+	// The size the transform turns into the one of the destination. Transforming the 
+	// destination's size gives it back, as the transforms swap the width and height or not
+	const ImageFormat& sourceFormat = sourceImage.getFormat();
+	ImageFormat untransformedFormat = ImageTransformer::getTransformedFormat( destinationImage.getFormat(), options.transform );
+	ConstImageView transformSourceImage = sourceImage;
+	if ( !haveSameSize( sourceFormat, untransformedFormat ) )
+	{
+		ImageFormat scaledFormat( untransformedFormat.getWidth(), untransformedFormat.getHeight(), sourceFormat.getEncoding(), sourceFormat.getColorMatrix(), sourceFormat.getColorRange() );
+		if ( !ImageScaler::canScale( sourceFormat, scaledFormat ) )
+			return false;
+		if ( !scaledImage || scaledImage->getFormat()!=scaledFormat )
+		{
+			delete scaledImage;
+			scaledImage = new Image( scaledFormat, options.outputBufferOptions );
+		}
+		ImageScaler scaler( sourceFormat, scaledFormat, options.scalingFilter );
+		scaler.scale( sourceImage, *scaledImage, options.threadPool, options.minBandHeight );
+		transformSourceImage = *scaledImage;
+	}
+
+	ImageTransformer transformer( transformSourceImage.getFormat(), options.transform );
+	const ImageFormat& transformedFormat = transformer.getDestinationFormat();
+	if ( !ImageTransformer::canTransform( transformSourceImage.getFormat(), transformedFormat, options.transform ) )
+		return false;
+
+	// The chunks are as high as the tiles, which are read by columns
+	ProduceRowsFunction transformRows = [&]( const ImageView& transformedView, unsigned int firstRow, unsigned int endRow )
+		{
+			transformer.transformRows( transformSourceImage, transformedView, firstRow, endRow );
+		};
+	return produceAndConvertImage( transformRows, transformedFormat, ImageTransformer::tileSize, destinationImage, path, transformedImage, intermediateImages, options );
 }
 
+bool ImageConverter::produceAndConvertImage( const ProduceRowsFunction& produceRows, const ImageFormat& producedFormat, unsigned int chunkHeight, const ImageView& destinationImage, std::vector<ImageFormat>& path, Image*& producedImage, std::vector<Image*>& intermediateImages, const Options& options )
+{
+	const ImageFormat& destinationFormat = destinationImage.getFormat();
+	unsigned int height = destinationFormat.getHeight();
+	unsigned int numRowsPerStep = ( producedFormat.isPlanar() || destinationFormat.isPlanar() ) ? 2 : 1;
+	if ( producedFormat==destinationFormat )
+	{
+		ConvertBandFunction produceBand = [&]( unsigned int firstRow, unsigned int endRow )
+			{
+				produceRows( destinationImage, firstRow, endRow );
+			};
+		convertBands( produceBand, height, numRowsPerStep, options );
+		return true;
+	}
+
+	const ImageConversionGraph& graph = getConversionGraph( options );
+	if ( path.empty() || path.front()!=producedFormat || path.back()!=destinationFormat )
+	{
+		if ( !graph.findPath( producedFormat, destinationFormat, path ) )
+			return false;
+	}
+	if ( !producedImage || producedImage->getFormat()!=producedFormat )
+	{
+		delete producedImage;
+		producedImage = new Image( producedFormat, options.outputBufferOptions );
+	}
+	ImageView producedView( *producedImage );
+
+	// Without a direct conversion, the whole produced image goes through the intermediate ones
+	if ( path.size()>2 )
+	{
+		ConvertBandFunction produceBand = [&]( unsigned int firstRow, unsigned int endRow )
+			{
+				produceRows( producedView, firstRow, endRow );
+			};
+		convertBands( produceBand, height, numRowsPerStep, options );
+		return convertAlongPath( path, *producedImage, destinationImage, intermediateImages, options );
+	}
+
+	// Each chunk of rows is converted right after being produced, on the thread of its band
+	ImageConversionGraph::ConvertFunction convert = graph.getConversion( producedFormat, destinationFormat );
+	if ( !convert )
+		return false;
+	Options chunkOptions = options;
+	chunkOptions.threadPool = NULL;
+	std::atomic<bool> converted( true );
+	ConvertBandFunction produceAndConvertBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			for ( unsigned int chunkRow=firstRow; chunkRow<endRow; chunkRow+=chunkHeight )
+			{
+				unsigned int chunkEndRow = std::min( chunkRow+chunkHeight, endRow );
+				produceRows( producedView, chunkRow, chunkEndRow );
+				if ( !convert( producedView.getRows( chunkRow, chunkEndRow ), destinationImage.getRows( chunkRow, chunkEndRow ), chunkOptions ) )
+					converted = false;
+			}
+		};
+	convertBands( produceAndConvertBand, height, numRowsPerStep, options );
+	return converted;
 }
 
+}
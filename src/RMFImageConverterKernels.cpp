@@ -0,0 +1,969 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConverterKernels.h"
+
+#include <cstring>
+#include "RMFRGBKernels.h"
+
+namespace RMF
+{
+
+const char* ImageConverterKernels::mInstructionSetNames[InstructionSetCount] = 
+{
+	"Scalar",
+	"SSSE3",
+	"AVX2",
+	"NEON"
+};
+
+bool ImageConverterKernels::isInstructionSetSupported( InstructionSet instructionSet )
+{
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return true;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return CPUFeatures::hasSSSE3();
+		case AVX2InstructionSet:
+			return CPUFeatures::hasAVX2();
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return CPUFeatures::hasNEON();
+#endif
+		default:
+			return false;
+	}
+}
+
+ImageConverterKernels::InstructionSet ImageConverterKernels::getBestInstructionSet()
+{
+	if ( isInstructionSetSupported( AVX2InstructionSet ) )
+		return AVX2InstructionSet;
+	if ( isInstructionSetSupported( SSSE3InstructionSet ) )
+		return SSSE3InstructionSet;
+	if ( isInstructionSetSupported( NEONInstructionSet ) )
+		return NEONInstructionSet;
+	return ScalarInstructionSet;
+}
+
+const char* ImageConverterKernels::getInstructionSetName( InstructionSet instructionSet )
+{
+	if ( instructionSet>=InstructionSetCount )
+		return "Unknown";
+	return mInstructionSetNames[instructionSet];
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUYVRowToRGB24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertYUYVRowToRGB24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertYUYVRowToRGB24SSSE3;
+		case AVX2InstructionSet:
+			return convertYUYVRowToRGB24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertYUYVRowToRGB24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUYVRowToBGR24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertYUYVRowToBGR24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertYUYVRowToBGR24SSSE3;
+		case AVX2InstructionSet:
+			return convertYUYVRowToBGR24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertYUYVRowToBGR24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getSwapFirstAndThirdBytesRowFunction( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return swapFirstAndThirdBytesRow;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return swapFirstAndThirdBytesRowSSSE3;
+		case AVX2InstructionSet:
+			return swapFirstAndThirdBytesRowAVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return swapFirstAndThirdBytesRowNEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToRGB24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertNV12RowToRGB24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertNV12RowToRGB24SSSE3;
+		case AVX2InstructionSet:
+			return convertNV12RowToRGB24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertNV12RowToRGB24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToBGR24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertNV12RowToBGR24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertNV12RowToBGR24SSSE3;
+		case AVX2InstructionSet:
+			return convertNV12RowToBGR24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertNV12RowToBGR24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420RowFunction ImageConverterKernels::getConvertNV12RowToYUYVFunction( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertNV12RowToYUYV;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertNV12RowToYUYVSSSE3;
+		case AVX2InstructionSet:
+			return convertNV12RowToYUYVAVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertNV12RowToYUYVNEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToRGB24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertI420RowToRGB24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertI420RowToRGB24SSSE3;
+		case AVX2InstructionSet:
+			return convertI420RowToRGB24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertI420RowToRGB24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToBGR24Function( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertI420RowToBGR24;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertI420RowToBGR24SSSE3;
+		case AVX2InstructionSet:
+			return convertI420RowToBGR24AVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertI420RowToBGR24NEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420RowFunction ImageConverterKernels::getConvertI420RowToYUYVFunction( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return convertI420RowToYUYV;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return convertI420RowToYUYVSSSE3;
+		case AVX2InstructionSet:
+			return convertI420RowToYUYVAVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return convertI420RowToYUYVNEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertRowPairToYUV420Function ImageConverterKernels::getConvertYUYVRowPairToNV12Function( InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return convertYUYVRowPairToNV12;
+}
+
+ImageConverterKernels::ConvertRowPairToYUV420Function ImageConverterKernels::getConvertYUYVRowPairToI420Function( InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return convertYUYVRowPairToI420;
+}
+
+namespace
+{
+
+// Turn the runtime encodings into template arguments of the scalar kernels (see selectRGBEncoding())
+template<ImageFormat::Encoding source>
+struct RGBRowSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertRGBRow<source, destination>; }
+};
+
+struct RGBSourceSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	RGBSourceSelector( ImageFormat::Encoding destinationEncoding ) : mDestinationEncoding(destinationEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( RGBRowSelector<source>(), mDestinationEncoding ); }
+	ImageFormat::Encoding mDestinationEncoding;
+};
+
+// The YUV to RGB selectors take the type of kernel, which picks the coefficient or the table overload
+template<class Function, ImageFormat::Encoding source>
+struct YUV422RowToRGBSelector
+{
+	typedef Function Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertYUV422Row<source, destination>; }
+};
+
+template<class Function>
+struct YUV422SourceSelector
+{
+	typedef Function Result;
+	YUV422SourceSelector( ImageFormat::Encoding rgbEncoding ) : mRGBEncoding(rgbEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( YUV422RowToRGBSelector<Function, source>(), mRGBEncoding ); }
+	ImageFormat::Encoding mRGBEncoding;
+};
+
+template<class Function>
+struct NV12RowToRGBSelector
+{
+	typedef Function Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertNV12Row<destination>; }
+};
+
+template<class Function>
+struct I420RowToRGBSelector
+{
+	typedef Function Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertI420Row<destination>; }
+};
+
+template<ImageFormat::Encoding source>
+struct RGBRowToYUV422Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertRGBRowToYUV422<source, destination>; }
+};
+
+struct RGBToYUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	RGBToYUV422SourceSelector( ImageFormat::Encoding yuv422Encoding ) : mYUV422Encoding(yuv422Encoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectYUV422Encoding( RGBRowToYUV422Selector<source>(), mYUV422Encoding ); }
+	ImageFormat::Encoding mYUV422Encoding;
+};
+
+struct RGBRowPairToNV12Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return RGBKernels::convertRGBRowPairToNV12<source>; }
+};
+
+struct RGBRowPairToI420Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return RGBKernels::convertRGBRowPairToI420<source>; }
+};
+
+// The luma is copied, the chroma of the two rows is averaged (rounding up). 
+// The padding luma of an odd last macroblock is skipped
+template<ImageFormat::Encoding source>
+void convertYUV422RowPairToYUV420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, unsigned char* yRow0, unsigned char* yRow1, 
+								   unsigned char* uRow, unsigned char* vRow, unsigned int chromaStep, unsigned int width )
+{
+	typedef YUV422Layout<source> Source;
+	for ( unsigned int i=0; i<width/2; ++i )
+	{
+		const unsigned char* macroblock0 = sourceRow0 + i*4;
+		const unsigned char* macroblock1 = sourceRow1 + i*4;
+		yRow0[i*2] = macroblock0[Source::y0];
+		yRow0[i*2+1] = macroblock0[Source::y1];
+		yRow1[i*2] = macroblock1[Source::y0];
+		yRow1[i*2+1] = macroblock1[Source::y1];
+		uRow[i*chromaStep] = static_cast<unsigned char>( ( macroblock0[Source::u] + macroblock1[Source::u] + 1 ) >> 1 );
+		vRow[i*chromaStep] = static_cast<unsigned char>( ( macroblock0[Source::v] + macroblock1[Source::v] + 1 ) >> 1 );
+	}
+	if ( width%2!=0 )
+	{
+		unsigned int i = width/2;
+		const unsigned char* macroblock0 = sourceRow0 + i*4;
+		const unsigned char* macroblock1 = sourceRow1 + i*4;
+		yRow0[width-1] = macroblock0[Source::y0];
+		yRow1[width-1] = macroblock1[Source::y0];
+		uRow[i*chromaStep] = static_cast<unsigned char>( ( macroblock0[Source::u] + macroblock1[Source::u] + 1 ) >> 1 );
+		vRow[i*chromaStep] = static_cast<unsigned char>( ( macroblock0[Source::v] + macroblock1[Source::v] + 1 ) >> 1 );
+	}
+}
+
+template<ImageFormat::Encoding source>
+void convertYUV422RowPairToNV12( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+								 unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width )
+{
+	convertYUV422RowPairToYUV420<source>( sourceRow0, sourceRow1, yRow0, yRow1, uRow, vRow, 2, width );
+}
+
+template<ImageFormat::Encoding source>
+void convertYUV422RowPairToI420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, 
+								 unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width )
+{
+	convertYUV422RowPairToYUV420<source>( sourceRow0, sourceRow1, yRow0, yRow1, uRow, vRow, 1, width );
+}
+
+struct YUV422RowPairToNV12Selector
+{
+	typedef ImageConverterKernels::ConvertRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertYUV422RowPairToNV12<source>; }
+};
+
+struct YUV422RowPairToI420Selector
+{
+	typedef ImageConverterKernels::ConvertRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertYUV422RowPairToI420<source>; }
+};
+
+template<ImageFormat::Encoding source>
+struct YUV422RowToYUV422Selector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertYUV422RowToYUV422<source, destination>; }
+};
+
+struct YUV422ToYUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	YUV422ToYUV422SourceSelector( ImageFormat::Encoding destinationEncoding ) : mDestinationEncoding(destinationEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectYUV422Encoding( YUV422RowToYUV422Selector<source>(), mDestinationEncoding ); }
+	ImageFormat::Encoding mDestinationEncoding;
+};
+
+struct YUV422RowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return RGBKernels::convertYUV422RowToGRAY8<source>; }
+};
+
+struct RGBRowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return RGBKernels::convertRGBRowToGRAY8<source>; }
+};
+
+struct GRAY8RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertGRAY8Row<destination>; }
+};
+
+struct GRAY16RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return RGBKernels::convertGRAY16Row<destination>; }
+};
+
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertRGBRowFunction( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	if ( sourceEncoding==destinationEncoding || !ImageFormat::isRGB( sourceEncoding ) || !ImageFormat::isRGB( destinationEncoding ) )
+		return NULL;
+
+	// Between the two 3-byte encodings, the dedicated swap kernels
+	if ( ImageFormat::getNumBitsPerPixel( sourceEncoding )==24 && ImageFormat::getNumBitsPerPixel( destinationEncoding )==24 )
+		return getSwapFirstAndThirdBytesRowFunction( instructionSet );
+
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( RGBSourceSelector( destinationEncoding ), sourceEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertRGBRowFunctionSSSE3( sourceEncoding, destinationEncoding );
+		case AVX2InstructionSet:
+			return getConvertRGBRowFunctionAVX2( sourceEncoding, destinationEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertRGBRowFunctionNEON( sourceEncoding, destinationEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUV422RowToRGBFunction( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( yuv422Encoding==ImageFormat::YUYV && rgbEncoding==ImageFormat::RGB24 )
+		return getConvertYUYVRowToRGB24Function( instructionSet );
+	if ( yuv422Encoding==ImageFormat::YUYV && rgbEncoding==ImageFormat::BGR24 )
+		return getConvertYUYVRowToBGR24Function( instructionSet );
+
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectYUV422Encoding( YUV422SourceSelector<ConvertColorRowFunction>( rgbEncoding ), yuv422Encoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertYUV422RowToRGBFunctionSSSE3( yuv422Encoding, rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertYUV422RowToRGBFunctionAVX2( yuv422Encoding, rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertYUV422RowToRGBFunctionNEON( yuv422Encoding, rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToRGBFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( rgbEncoding==ImageFormat::RGB24 )
+		return getConvertNV12RowToRGB24Function( instructionSet );
+	if ( rgbEncoding==ImageFormat::BGR24 )
+		return getConvertNV12RowToBGR24Function( instructionSet );
+
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( NV12RowToRGBSelector<ConvertYUV420ColorRowFunction>(), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertNV12RowToRGBFunctionSSSE3( rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertNV12RowToRGBFunctionAVX2( rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertNV12RowToRGBFunctionNEON( rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToRGBFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( rgbEncoding==ImageFormat::RGB24 )
+		return getConvertI420RowToRGB24Function( instructionSet );
+	if ( rgbEncoding==ImageFormat::BGR24 )
+		return getConvertI420RowToBGR24Function( instructionSet );
+
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( I420RowToRGBSelector<ConvertYUV420ColorRowFunction>(), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertI420RowToRGBFunctionSSSE3( rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertI420RowToRGBFunctionAVX2( rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertI420RowToRGBFunctionNEON( rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToYUV422Function( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( RGBToYUV422SourceSelector( yuv422Encoding ), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertRGBRowToYUV422FunctionSSSE3( rgbEncoding, yuv422Encoding );
+		case AVX2InstructionSet:
+			return getConvertRGBRowToYUV422FunctionAVX2( rgbEncoding, yuv422Encoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertRGBRowToYUV422FunctionNEON( rgbEncoding, yuv422Encoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToNV12Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( RGBRowPairToNV12Selector(), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertRGBRowPairToNV12FunctionSSSE3( rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertRGBRowPairToNV12FunctionAVX2( rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertRGBRowPairToNV12FunctionNEON( rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToI420Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( RGBRowPairToI420Selector(), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertRGBRowPairToI420FunctionSSSE3( rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertRGBRowPairToI420FunctionAVX2( rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertRGBRowPairToI420FunctionNEON( rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertTableRowFunction ImageConverterKernels::getConvertYUV422RowToRGBTableFunction( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return selectYUV422Encoding( YUV422SourceSelector<ConvertTableRowFunction>( rgbEncoding ), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertYUV420TableRowFunction ImageConverterKernels::getConvertNV12RowToRGBTableFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return selectRGBEncoding( NV12RowToRGBSelector<ConvertYUV420TableRowFunction>(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertYUV420TableRowFunction ImageConverterKernels::getConvertI420RowToRGBTableFunction( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return selectRGBEncoding( I420RowToRGBSelector<ConvertYUV420TableRowFunction>(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertRowPairToYUV420Function ImageConverterKernels::getConvertYUV422RowPairToNV12Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return selectYUV422Encoding( YUV422RowPairToNV12Selector(), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertRowPairToYUV420Function ImageConverterKernels::getConvertYUV422RowPairToI420Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return selectYUV422Encoding( YUV422RowPairToI420Selector(), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertYUV422RowToYUV422Function( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet || sourceEncoding==destinationEncoding )
+		return NULL;
+	return selectYUV422Encoding( YUV422ToYUV422SourceSelector( destinationEncoding ), sourceEncoding );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertYUV422RowToGRAY8Function( ImageFormat::Encoding yuv422Encoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectYUV422Encoding( YUV422RowToGRAY8Selector(), yuv422Encoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertYUV422RowToGRAY8FunctionSSSE3( yuv422Encoding );
+		case AVX2InstructionSet:
+			return getConvertYUV422RowToGRAY8FunctionAVX2( yuv422Encoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertYUV422RowToGRAY8FunctionNEON( yuv422Encoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToGRAY8Function( ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return selectRGBEncoding( RGBRowToGRAY8Selector(), rgbEncoding );
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return getConvertRGBRowToGRAY8FunctionSSSE3( rgbEncoding );
+		case AVX2InstructionSet:
+			return getConvertRGBRowToGRAY8FunctionAVX2( rgbEncoding );
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return getConvertRGBRowToGRAY8FunctionNEON( rgbEncoding );
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ConvertYUV420RowFunction ImageConverterKernels::getConvertYUV420RowToGRAY8Function( InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	return convertYUV420RowToGRAY8;
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertGRAYRowToRGBFunction( ImageFormat::Encoding grayEncoding, ImageFormat::Encoding rgbEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	if ( grayEncoding==ImageFormat::GRAY8 )
+		return selectRGBEncoding( GRAY8RowToRGBSelector(), rgbEncoding );
+	if ( grayEncoding==ImageFormat::GRAY16 )
+		return selectRGBEncoding( GRAY16RowToRGBSelector(), rgbEncoding );
+	return NULL;
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertGRAYRowToGRAYFunction( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding, InstructionSet instructionSet )
+{
+	if ( instructionSet!=ScalarInstructionSet )
+		return NULL;
+	if ( sourceEncoding==ImageFormat::GRAY8 && destinationEncoding==ImageFormat::GRAY16 )
+		return convertGRAY8RowToGRAY16;
+	if ( sourceEncoding==ImageFormat::GRAY16 && destinationEncoding==ImageFormat::GRAY8 )
+		return convertGRAY16RowToGRAY8;
+	return NULL;
+}
+
+ImageConverterKernels::ScaleColumnsFunction ImageConverterKernels::getScaleColumnsFunction( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return scaleColumns;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return scaleColumnsSSSE3;
+		case AVX2InstructionSet:
+			return scaleColumnsAVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return scaleColumnsNEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ImageConverterKernels::ScaleRowFunction ImageConverterKernels::getScaleRowFunction( InstructionSet instructionSet )
+{
+	if ( !isInstructionSetSupported( instructionSet ) )
+		return NULL;
+	switch ( instructionSet )
+	{
+		case ScalarInstructionSet:
+			return scaleRow;
+#if defined(RMF_X86)
+		case SSSE3InstructionSet:
+			return scaleRowSSSE3;
+		case AVX2InstructionSet:
+			return scaleRowAVX2;
+#endif
+#if defined(RMF_NEON)
+		case NEONInstructionSet:
+			return scaleRowNEON;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+// General information about YUV color space can be found here:
+// http://en.wikipedia.org/wiki/YUV 
+// or here:
+// http://www.fourcc.org/yuv.php
+
+namespace
+{
+
+// With an odd width, the padding luma of the last macroblock repeats the luma of the last pixel
+void convertYUV420RowToYUYV( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned int chromaStep, unsigned char* yuyvRow, unsigned int width )
+{
+	for ( unsigned int i=0; i<width/2; ++i )
+	{
+		yuyvRow[i*4] = yRow[i*2];
+		yuyvRow[i*4+1] = uRow[i*chromaStep];
+		yuyvRow[i*4+2] = yRow[i*2+1];
+		yuyvRow[i*4+3] = vRow[i*chromaStep];
+	}
+	if ( width%2!=0 )
+	{
+		unsigned int i = width/2;
+		yuyvRow[i*4] = yRow[width-1];
+		yuyvRow[i*4+1] = uRow[i*chromaStep];
+		yuyvRow[i*4+2] = yRow[width-1];
+		yuyvRow[i*4+3] = vRow[i*chromaStep];
+	}
+}
+
+}
+
+// The conversion formulas of RGBKernels come from here:
+// http://stackoverflow.com/questions/4491649/how-to-convert-yuy2-to-a-bitmap-in-c
+// http://msdn.microsoft.com/en-us/library/aa904813(VS.80).aspx#yuvformats_2
+void ImageConverterKernels::convertYUYVRowToRGB24( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertYUV422Row<ImageFormat::YUYV, ImageFormat::RGB24>( yuyvRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertYUYVRowToBGR24( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertYUV422Row<ImageFormat::YUYV, ImageFormat::BGR24>( yuyvRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::swapFirstAndThirdBytesRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	const unsigned char* sourceBytes = sourceRow;
+	unsigned char* destBytes = destinationRow;
+	for ( unsigned int i=0; i<width; ++i )
+	{
+		unsigned char firstByte = sourceBytes[0];
+		destBytes[1] = sourceBytes[1];
+		destBytes[0] = sourceBytes[2];
+		destBytes[2] = firstByte;
+		sourceBytes += 3;
+		destBytes += 3;
+	}
+}
+
+void ImageConverterKernels::convertNV12RowToRGB24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertNV12Row<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToBGR24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertNV12Row<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToYUYV( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	convertYUV420RowToYUYV( yRow, uRow, vRow, 2, yuyvRow, width );
+}
+
+void ImageConverterKernels::convertI420RowToRGB24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertI420Row<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToBGR24( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	RGBKernels::convertI420Row<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToYUYV( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	convertYUV420RowToYUYV( yRow, uRow, vRow, 1, yuyvRow, width );
+}
+
+void ImageConverterKernels::convertYUYVRowPairToNV12( const unsigned char* yuyvRow0, const unsigned char* yuyvRow1, 
+													  unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width )
+{
+	convertYUV422RowPairToNV12<ImageFormat::YUYV>( yuyvRow0, yuyvRow1, yRow0, yRow1, uRow, vRow, width );
+}
+
+void ImageConverterKernels::convertYUYVRowPairToI420( const unsigned char* yuyvRow0, const unsigned char* yuyvRow1, 
+													  unsigned char* yRow0, unsigned char* yRow1, unsigned char* uRow, unsigned char* vRow, unsigned int width )
+{
+	convertYUV422RowPairToI420<ImageFormat::YUYV>( yuyvRow0, yuyvRow1, yRow0, yRow1, uRow, vRow, width );
+}
+
+void ImageConverterKernels::convertYUV420RowToGRAY8( const unsigned char* yRow, const unsigned char* /*uRow*/, const unsigned char* /*vRow*/, unsigned char* gray8Row, unsigned int width )
+{
+	memcpy( gray8Row, yRow, width );
+}
+
+// A 16-bit sample is its byte repeated, which maps 255 to 65535
+void ImageConverterKernels::convertGRAY8RowToGRAY16( const unsigned char* gray8Row, unsigned char* gray16Row, unsigned int width )
+{
+	for ( unsigned int i=0; i<width; ++i )
+	{
+		gray16Row[i*2] = gray8Row[i];
+		gray16Row[i*2+1] = gray8Row[i];
+	}
+}
+
+void ImageConverterKernels::convertGRAY16RowToGRAY8( const unsigned char* gray16Row, unsigned char* gray8Row, unsigned int width )
+{
+	for ( unsigned int i=0; i<width; ++i )
+		gray8Row[i] = gray16Row[i*2+1];
+}
+
+// The sums of the columns are rounded and saturated to 16 bits, which the weights 
+// of the filters with negative lobes can exceed
+void ImageConverterKernels::scaleColumns( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples )
+{
+	const int shift = scaleWeightBits - scaleExtraBits;
+	for ( unsigned int i=0; i<numSamples; ++i )
+	{
+		int sum = 0;
+		for ( unsigned int tap=0; tap<numTaps; ++tap )
+			sum += weights[tap] * sourceRows[tap][i];
+		sum = ( sum + (1 << (shift-1)) ) >> shift;
+		destinationRow[i] = static_cast<short>( sum<-32768 ? -32768 : ( sum>32767 ? 32767 : sum ) );
+	}
+}
+
+void ImageConverterKernels::scaleRow( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width )
+{
+	const int shift = scaleWeightBits + scaleExtraBits;
+	for ( unsigned int i=0; i<width; ++i, weights+=numTaps )
+	{
+		const short* samples = sourceRow + firstIndices[i];
+		int sum = 0;
+		for ( unsigned int tap=0; tap<numTaps; ++tap )
+			sum += weights[tap] * samples[tap];
+		destinationRow[i] = RGBKernels::clip( ( sum + (1 << (shift-1)) ) >> shift );
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,889 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConverterKernels.h"
+#include "RMFRGBKernels.h"
+
+#if defined(RMF_X86)
+
+#include <immintrin.h>
+
+namespace RMF
+{
+
+namespace
+{
+
+// Pairs of 16-bit values, as expected by _mm256_madd_epi16
+inline __m256i setPairs( short first, short second )
+{
+	return _mm256_setr_epi16( first, second, first, second, first, second, first, second, 
+							  first, second, first, second, first, second, first, second );
+}
+
+// Same as the SSSE3 version
+struct YUVToRGBVectors
+{
+	YUVToRGBVectors( const YUVCoefficients& coefficients )
+		: offsets( setPairs( coefficients.yOffset, 128 ) ),
+		  red( setPairs( coefficients.yFactor, coefficients.vToRed ) ),
+		  greenU( setPairs( coefficients.yFactor, coefficients.uToGreen ) ),
+		  greenV( setPairs( 0, coefficients.vToGreen ) ),
+		  blue( setPairs( coefficients.yFactor, coefficients.uToBlue ) )
+	{
+	}
+	__m256i offsets;
+	__m256i red;
+	__m256i greenU;
+	__m256i greenV;
+	__m256i blue;
+};
+
+// Same as the SSSE3 version, except that each 128-bit lane converts its own 4 pixels
+inline void convertYUV422Pixels4x2( __m256i yuv422, __m256i ceShuffle, __m256i cdShuffle, const YUVToRGBVectors& vectors, __m256i& r, __m256i& g, __m256i& b )
+{
+	const __m256i rounding = _mm256_set1_epi32( 128 );
+
+	__m256i ce = _mm256_sub_epi16( _mm256_shuffle_epi8( yuv422, ceShuffle ), vectors.offsets );
+	__m256i cd = _mm256_sub_epi16( _mm256_shuffle_epi8( yuv422, cdShuffle ), vectors.offsets );
+	
+	r = _mm256_madd_epi16( ce, vectors.red );
+	g = _mm256_add_epi32( _mm256_madd_epi16( cd, vectors.greenU ), _mm256_madd_epi16( ce, vectors.greenV ) );
+	b = _mm256_madd_epi16( cd, vectors.blue );
+	r = _mm256_srai_epi32( _mm256_add_epi32( r, rounding ), 8 );
+	g = _mm256_srai_epi32( _mm256_add_epi32( g, rounding ), 8 );
+	b = _mm256_srai_epi32( _mm256_add_epi32( b, rounding ), 8 );
+}
+
+// The shuffle giving the (Y, chroma) 16-bit pairs of the 4 pixels of the two macroblocks starting 
+// at the given byte of each lane. All the arguments are compile-time constants, so is the shuffle
+template<ImageFormat::Encoding source>
+inline __m256i getLumaChromaShuffle( char firstByte, char chroma )
+{
+	typedef YUV422Layout<source> Source;
+	const char m0 = firstByte;
+	const char m1 = firstByte + 4;
+	return _mm256_broadcastsi128_si256( _mm_setr_epi8( m0+Source::y0, -128, m0+chroma, -128, m0+Source::y1, -128, m0+chroma, -128, 
+													   m1+Source::y0, -128, m1+chroma, -128, m1+Source::y1, -128, m1+chroma, -128 ) );
+}
+
+// Converts 16 pixels (32 bytes) of packed 4:2:2 to 16-bit red, green and blue values, in pixel order
+template<ImageFormat::Encoding source>
+inline void convertYUV422Pixels16( __m256i yuv422, const YUVToRGBVectors& vectors, __m256i& r, __m256i& g, __m256i& b )
+{
+	typedef YUV422Layout<source> Source;
+	const __m256i ceLowShuffle = getLumaChromaShuffle<source>( 0, Source::v );
+	const __m256i cdLowShuffle = getLumaChromaShuffle<source>( 0, Source::u );
+	const __m256i ceHighShuffle = getLumaChromaShuffle<source>( 8, Source::v );
+	const __m256i cdHighShuffle = getLumaChromaShuffle<source>( 8, Source::u );
+
+	__m256i rLow, gLow, bLow;
+	__m256i rHigh, gHigh, bHigh;
+	convertYUV422Pixels4x2( yuv422, ceLowShuffle, cdLowShuffle, vectors, rLow, gLow, bLow );			// Pixels 0-3 and 8-11
+	convertYUV422Pixels4x2( yuv422, ceHighShuffle, cdHighShuffle, vectors, rHigh, gHigh, bHigh );		// Pixels 4-7 and 12-15
+	r = _mm256_packs_epi32( rLow, rHigh );
+	g = _mm256_packs_epi32( gLow, gHigh );
+	b = _mm256_packs_epi32( bLow, bHigh );
+}
+
+// Packs two sets of 16 16-bit values to 32 bytes, in order
+inline __m256i packInOrder( __m256i first, __m256i second )
+{
+	// The pack works per 128-bit lane, hence the 64-bit blocks permutation 
+	return _mm256_permute4x64_epi64( _mm256_packus_epi16( first, second ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+}
+
+// Interleaves 32 values of each of the three components into 96 bytes
+inline void storeInterleaved( unsigned char* destination, __m256i first, __m256i second, __m256i third )
+{
+	const __m256i shuffle00 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5 ) );
+	const __m256i shuffle01 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128 ) );
+	const __m256i shuffle02 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128 ) );
+	const __m256i shuffle10 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128 ) );
+	const __m256i shuffle11 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10 ) );
+	const __m256i shuffle12 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128 ) );
+	const __m256i shuffle20 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128 ) );
+	const __m256i shuffle21 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128 ) );
+	const __m256i shuffle22 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15 ) );
+
+	// Each lane produces the 48 bytes of its own 16 pixels: the low lanes bytes 0-47, the high lanes bytes 48-95
+	__m256i block0 = _mm256_or_si256( _mm256_or_si256( _mm256_shuffle_epi8( first, shuffle00 ), _mm256_shuffle_epi8( second, shuffle01 ) ), _mm256_shuffle_epi8( third, shuffle02 ) );
+	__m256i block1 = _mm256_or_si256( _mm256_or_si256( _mm256_shuffle_epi8( first, shuffle10 ), _mm256_shuffle_epi8( second, shuffle11 ) ), _mm256_shuffle_epi8( third, shuffle12 ) );
+	__m256i block2 = _mm256_or_si256( _mm256_or_si256( _mm256_shuffle_epi8( first, shuffle20 ), _mm256_shuffle_epi8( second, shuffle21 ) ), _mm256_shuffle_epi8( third, shuffle22 ) );
+
+	__m256i* destinationBlocks = reinterpret_cast<__m256i*>(destination);
+	_mm256_storeu_si256( destinationBlocks, _mm256_permute2x128_si256( block0, block1, 0x20 ) );
+	_mm256_storeu_si256( destinationBlocks+1, _mm256_permute2x128_si256( block2, block0, 0x30 ) );
+	_mm256_storeu_si256( destinationBlocks+2, _mm256_permute2x128_si256( block1, block2, 0x31 ) );
+}
+
+// Interleaves 32 values of each of the four components into 128 bytes
+inline void storeInterleaved( unsigned char* destination, __m256i first, __m256i second, __m256i third, __m256i fourth )
+{
+	// The unpacks work per 128-bit lane: the low lanes hold pixels 0-15, the high lanes pixels 16-31
+	__m256i firstSecondLow = _mm256_unpacklo_epi8( first, second );
+	__m256i firstSecondHigh = _mm256_unpackhi_epi8( first, second );
+	__m256i thirdFourthLow = _mm256_unpacklo_epi8( third, fourth );
+	__m256i thirdFourthHigh = _mm256_unpackhi_epi8( third, fourth );
+	__m256i pixels0 = _mm256_unpacklo_epi16( firstSecondLow, thirdFourthLow );		// Pixels 0-3 and 16-19
+	__m256i pixels1 = _mm256_unpackhi_epi16( firstSecondLow, thirdFourthLow );		// Pixels 4-7 and 20-23
+	__m256i pixels2 = _mm256_unpacklo_epi16( firstSecondHigh, thirdFourthHigh );	// Pixels 8-11 and 24-27
+	__m256i pixels3 = _mm256_unpackhi_epi16( firstSecondHigh, thirdFourthHigh );	// Pixels 12-15 and 28-31
+
+	__m256i* destinationBlocks = reinterpret_cast<__m256i*>(destination);
+	_mm256_storeu_si256( destinationBlocks, _mm256_permute2x128_si256( pixels0, pixels1, 0x20 ) );
+	_mm256_storeu_si256( destinationBlocks+1, _mm256_permute2x128_si256( pixels2, pixels3, 0x20 ) );
+	_mm256_storeu_si256( destinationBlocks+2, _mm256_permute2x128_si256( pixels0, pixels1, 0x31 ) );
+	_mm256_storeu_si256( destinationBlocks+3, _mm256_permute2x128_si256( pixels2, pixels3, 0x31 ) );
+}
+
+// Stores the components of 32 pixels in the order of the RGB encoding, with an opaque alpha
+template<ImageFormat::Encoding destination>
+inline void storeRGB32( unsigned char* destinationBytes, __m256i r, __m256i g, __m256i b )
+{
+	typedef RGBLayout<destination> Destination;
+	__m256i components[4];
+	components[Destination::red] = r;
+	components[Destination::green] = g;
+	components[Destination::blue] = b;
+	if ( Destination::numBytes==4 )
+	{
+		components[Destination::numBytes==4 ? Destination::alpha : 3] = _mm256_set1_epi8( -1 );
+		storeInterleaved( destinationBytes, components[0], components[1], components[2], components[3] );
+	}
+	else
+	{
+		storeInterleaved( destinationBytes, components[0], components[1], components[2] );
+	}
+}
+
+// Converts 32 pixels of packed 4:2:2 (two blocks of 32 bytes) to an RGB encoding
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+inline void convertYUV422Pixels32( __m256i block0, __m256i block1, const YUVToRGBVectors& vectors, unsigned char* destinationBytes )
+{
+	__m256i r0, g0, b0;
+	__m256i r1, g1, b1;
+	convertYUV422Pixels16<source>( block0, vectors, r0, g0, b0 );
+	convertYUV422Pixels16<source>( block1, vectors, r1, g1, b1 );
+	storeRGB32<destination>( destinationBytes, packInOrder( r0, r1 ), packInOrder( g0, g1 ), packInOrder( b0, b1 ) );
+}
+
+// 32 pixels per iteration, the remaining ones are handled by the scalar kernel
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertYUV422Row( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	const unsigned int numBytes = RGBLayout<destination>::numBytes;
+	const YUVToRGBVectors vectors( coefficients );
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+	{
+		const __m256i* sourceBlocks = reinterpret_cast<const __m256i*>(sourceRow + x*2);
+		convertYUV422Pixels32<source, destination>( _mm256_loadu_si256( sourceBlocks ), _mm256_loadu_si256( sourceBlocks+1 ), vectors, destinationRow + x*numBytes );
+	}
+	RGBKernels::convertYUV422Row<source, destination>( sourceRow + numVectorPixels*2, destinationRow + numVectorPixels*numBytes, width - numVectorPixels, coefficients );
+}
+
+// Interleaves the luma of 32 pixels with their chroma pairs (U0, V0, U1, V1...), which gives 
+// their YUYV bytes. The unpacks work per 128-bit lane, so the lanes are put back in order
+inline void interleaveYUV420( __m256i y, __m256i uv, __m256i& yuyv0, __m256i& yuyv1 )
+{
+	__m256i low = _mm256_unpacklo_epi8( y, uv );		// Pixels 0-7 and 16-23
+	__m256i high = _mm256_unpackhi_epi8( y, uv );		// Pixels 8-15 and 24-31
+	yuyv0 = _mm256_permute2x128_si256( low, high, 0x20 );
+	yuyv1 = _mm256_permute2x128_si256( low, high, 0x31 );
+}
+
+// Loads 32 pixels of NV12, whose chroma is already interleaved
+inline void loadNV12( const unsigned char* yRow, const unsigned char* uvRow, __m256i& yuyv0, __m256i& yuyv1 )
+{
+	interleaveYUV420( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(yRow) ), _mm256_loadu_si256( reinterpret_cast<const __m256i*>(uvRow) ), yuyv0, yuyv1 );
+}
+
+// Loads 32 pixels of I420 (or YV12), interleaving the 16 bytes of each chroma plane
+inline void loadI420( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, __m256i& yuyv0, __m256i& yuyv1 )
+{
+	__m128i u = _mm_loadu_si128( reinterpret_cast<const __m128i*>(uRow) );
+	__m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>(vRow) );
+	__m256i uv = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_unpacklo_epi8( u, v ) ), _mm_unpackhi_epi8( u, v ), 1 );
+	interleaveYUV420( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(yRow) ), uv, yuyv0, yuyv1 );
+}
+
+// Stores 32 pixels of YUYV bytes to the destination encoding: converted to an RGB encoding, 
+// or as they are for YUYV
+template<ImageFormat::Encoding destination>
+struct YUYV32Store
+{
+	enum { numBytesPerPixel = RGBLayout<destination>::numBytes };
+	YUYV32Store( const YUVCoefficients& coefficients ) : mVectors( coefficients ) {}
+	void store( __m256i yuyv0, __m256i yuyv1, unsigned char* destinationBytes ) const		{ convertYUV422Pixels32<ImageFormat::YUYV, destination>( yuyv0, yuyv1, mVectors, destinationBytes ); }
+	YUVToRGBVectors mVectors;
+};
+
+template<>
+struct YUYV32Store<ImageFormat::YUYV>
+{
+	enum { numBytesPerPixel = 2 };
+	void store( __m256i yuyv0, __m256i yuyv1, unsigned char* destinationBytes ) const
+	{
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(destinationBytes), yuyv0 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(destinationBytes)+1, yuyv1 );
+	}
+};
+
+// 32 pixels per iteration, the remaining ones are left to the scalar kernels
+template<ImageFormat::Encoding destination>
+unsigned int convertNV12Row( const unsigned char* yRow, const unsigned char* uvRow, unsigned char* destinationRow, unsigned int width, const YUYV32Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+	{
+		__m256i yuyv0, yuyv1;
+		loadNV12( yRow + x, uvRow + x, yuyv0, yuyv1 );
+		store.store( yuyv0, yuyv1, destinationRow + x*YUYV32Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+unsigned int convertI420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUYV32Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+	{
+		__m256i yuyv0, yuyv1;
+		loadI420( yRow + x, uRow + x/2, vRow + x/2, yuyv0, yuyv1 );
+		store.store( yuyv0, yuyv1, destinationRow + x*YUYV32Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+void convertNV12RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertNV12Row<destination>( yRow, uRow, destinationRow, width, YUYV32Store<destination>( coefficients ) );
+	RGBKernels::convertNV12Row<destination>( yRow + x, uRow + x, vRow + x, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+template<ImageFormat::Encoding destination>
+void convertI420RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertI420Row<destination>( yRow, uRow, vRow, destinationRow, width, YUYV32Store<destination>( coefficients ) );
+	RGBKernels::convertI420Row<destination>( yRow + x, uRow + x/2, vRow + x/2, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+// Same as the SSSE3 version, 8 pixels at a time: each 128-bit lane converts its own 4 pixels.
+// The 3-byte pixels of a lane are loaded or stored on their own, 12 bytes after the ones of the 
+// low lane, the low lane being stored first
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	typedef RGBLayout<source> Source;
+	typedef RGBLayout<destination> Destination;
+	
+	char shuffleBytes[16];
+	char opaqueBytes[16];
+	for ( int i=0; i<16; ++i )
+	{
+		shuffleBytes[i] = -128;
+		opaqueBytes[i] = 0;
+	}
+	for ( int pixel=0; pixel<4; ++pixel )
+	{
+		char* pixelShuffle = shuffleBytes + pixel*Destination::numBytes;
+		char sourceIndex = static_cast<char>( pixel*Source::numBytes );
+		pixelShuffle[Destination::red] = sourceIndex + Source::red;
+		pixelShuffle[Destination::green] = sourceIndex + Source::green;
+		pixelShuffle[Destination::blue] = sourceIndex + Source::blue;
+		if ( Destination::numBytes==4 )
+		{
+			if ( Source::hasAlpha && Destination::hasAlpha )
+				pixelShuffle[Destination::alpha] = sourceIndex + Source::alpha;
+			else
+				opaqueBytes[pixel*4 + Destination::alpha] = -1;
+		}
+	}
+	const __m256i shuffle = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(shuffleBytes) ) );
+	const __m256i opaque = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(opaqueBytes) ) );
+
+	const unsigned int numPixelsPerBlock = Source::numBytes==3 || Destination::numBytes==3 ? 10 : 8;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerBlock<=width; x+=8 )
+	{
+		const unsigned char* sourceBytes = sourceRow + x*Source::numBytes;
+		__m256i pixels;
+		if ( Source::numBytes==4 )
+			pixels = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(sourceBytes) );
+		else
+			pixels = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceBytes) ) ), 
+											  _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceBytes+12) ), 1 );
+		
+		pixels = _mm256_or_si256( _mm256_shuffle_epi8( pixels, shuffle ), opaque );
+		
+		unsigned char* destinationBytes = destinationRow + x*Destination::numBytes;
+		if ( Destination::numBytes==4 )
+		{
+			_mm256_storeu_si256( reinterpret_cast<__m256i*>(destinationBytes), pixels );
+		}
+		else
+		{
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(destinationBytes), _mm256_castsi256_si128( pixels ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(destinationBytes+12), _mm256_extracti128_si256( pixels, 1 ) );
+		}
+	}
+	RGBKernels::convertRGBRow<source, destination>( sourceRow + x*Source::numBytes, destinationRow + x*Destination::numBytes, width - x );
+}
+
+// Turn the runtime encodings into template arguments (see selectRGBEncoding())
+template<ImageFormat::Encoding source>
+struct RGBRowSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRow<source, destination>; }
+};
+
+struct RGBSourceSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	RGBSourceSelector( ImageFormat::Encoding destinationEncoding ) : mDestinationEncoding(destinationEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( RGBRowSelector<source>(), mDestinationEncoding ); }
+	ImageFormat::Encoding mDestinationEncoding;
+};
+
+template<ImageFormat::Encoding source>
+struct YUV422RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertYUV422Row<source, destination>; }
+};
+
+struct YUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	YUV422SourceSelector( ImageFormat::Encoding rgbEncoding ) : mRGBEncoding(rgbEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( YUV422RowToRGBSelector<source>(), mRGBEncoding ); }
+	ImageFormat::Encoding mRGBEncoding;
+};
+
+struct NV12RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertNV12RowToRGB<destination>; }
+};
+
+struct I420RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertI420RowToRGB<destination>; }
+};
+
+// Same as the SSSE3 version, 32 pixels at a time. The per-lane shuffles leave the luma of each lane's 
+// 8 pixels in its low 8 bytes, so the unpack gives pixels 0-7, 16-23 | 8-15, 24-31, put back in order
+template<ImageFormat::Encoding source>
+void convertYUV422RowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width )
+{
+	typedef YUV422Layout<source> Source;
+	const __m256i lumaShuffle = _mm256_broadcastsi128_si256( _mm_setr_epi8( Source::y0, Source::y1, 4+Source::y0, 4+Source::y1, 8+Source::y0, 8+Source::y1, 12+Source::y0, 12+Source::y1, 
+																			-128, -128, -128, -128, -128, -128, -128, -128 ) );
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+	{
+		const __m256i* sourceBlocks = reinterpret_cast<const __m256i*>(sourceRow + x*2);
+		__m256i luma0 = _mm256_shuffle_epi8( _mm256_loadu_si256( sourceBlocks ), lumaShuffle );
+		__m256i luma1 = _mm256_shuffle_epi8( _mm256_loadu_si256( sourceBlocks+1 ), lumaShuffle );
+		__m256i luma = _mm256_permute4x64_epi64( _mm256_unpacklo_epi64( luma0, luma1 ), 0xD8 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(gray8Row + x), luma );
+	}
+	RGBKernels::convertYUV422RowToGRAY8<source>( sourceRow + numVectorPixels*2, gray8Row + numVectorPixels, width - numVectorPixels );
+}
+
+// The shuffle moving the red, green and blue bytes of the 4 pixels of each lane to the first three 
+// bytes of 4-byte slots, the fourth one being zeroed
+template<ImageFormat::Encoding source>
+inline __m256i getRGB0Shuffle()
+{
+	typedef RGBLayout<source> Source;
+	const char n = Source::numBytes;
+	return _mm256_broadcastsi128_si256( _mm_setr_epi8( Source::red, Source::green, Source::blue, -128, n+Source::red, n+Source::green, n+Source::blue, -128, 
+													   2*n+Source::red, 2*n+Source::green, 2*n+Source::blue, -128, 3*n+Source::red, 3*n+Source::green, 3*n+Source::blue, -128 ) );
+}
+
+// Loads 8 pixels of an RGB encoding laid out by getRGB0Shuffle(): pixels 0-3 in the low lane. 
+// The 3-byte pixels are loaded like in convertRGBRow(), the last 4 bytes are not used
+template<ImageFormat::Encoding source>
+inline __m256i loadRGB0Pixels8( const unsigned char* sourceBytes, __m256i shuffle )
+{
+	typedef RGBLayout<source> Source;
+	__m256i pixels;
+	if ( Source::numBytes==4 )
+		pixels = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(sourceBytes) );
+	else
+		pixels = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceBytes) ) ), 
+										  _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceBytes+12) ), 1 );
+	return _mm256_shuffle_epi8( pixels, shuffle );
+}
+
+// The coefficients of the RGB to YUV conversion, repeated as c0, c1, c2, 0 like in the SSSE3 version
+inline __m256i setTriplets( short c0, short c1, short c2 )
+{
+	return _mm256_setr_epi16( c0, c1, c2, 0, c0, c1, c2, 0, c0, c1, c2, 0, c0, c1, c2, 0 );
+}
+
+struct RGBToYUVVectors
+{
+	RGBToYUVVectors( const YUVCoefficients& coefficients )
+		: y( setTriplets( coefficients.redToY, coefficients.greenToY, coefficients.blueToY ) ),
+		  u( setTriplets( coefficients.redToU, coefficients.greenToU, coefficients.blueToU ) ),
+		  v( setTriplets( coefficients.redToV, coefficients.greenToV, coefficients.blueToV ) ),
+		  yOffset( _mm256_set1_epi16( coefficients.yOffset ) )
+	{
+	}
+	__m256i y;
+	__m256i u;
+	__m256i v;
+	__m256i yOffset;
+};
+
+// The ( c0*R + c1*G + c2*B + 128 ) >> 8 sums of 8 pixels, as in the SSSE3 version: 32-bit values, 
+// pixels 0-3 in the low lane
+inline __m256i getWeightedSums8( __m256i rgb0, __m256i coefficients )
+{
+	__m256i low = _mm256_madd_epi16( _mm256_unpacklo_epi8( rgb0, _mm256_setzero_si256() ), coefficients );
+	__m256i high = _mm256_madd_epi16( _mm256_unpackhi_epi8( rgb0, _mm256_setzero_si256() ), coefficients );
+	return _mm256_srai_epi32( _mm256_add_epi32( _mm256_hadd_epi32( low, high ), _mm256_set1_epi32( 128 ) ), 8 );
+}
+
+// Packs the 32-bit luma of 4 groups of 8 pixels, and adds the offset. The packs work per lane, 
+// so the 4-pixel groups end up out of order and a final permutation puts them back
+inline __m256i packLuma32( const __m256i y[4], __m256i offset )
+{
+	const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+	__m256i luma01 = _mm256_add_epi16( _mm256_packs_epi32( y[0], y[1] ), offset );
+	__m256i luma23 = _mm256_add_epi16( _mm256_packs_epi32( y[2], y[3] ), offset );
+	return _mm256_permutevar8x32_epi32( _mm256_packus_epi16( luma01, luma23 ), order );
+}
+
+// 32 pixels per iteration
+template<ImageFormat::Encoding source>
+void convertRGBRowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m256i shuffle = getRGB0Shuffle<source>();
+	const __m256i yCoefficients = setTriplets( coefficients.redToY, coefficients.greenToY, coefficients.blueToY );
+	const __m256i offset = _mm256_set1_epi16( coefficients.yOffset );
+
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 34 : 32;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=32 )
+	{
+		__m256i y[4];
+		for ( unsigned int i=0; i<4; ++i )
+			y[i] = getWeightedSums8( loadRGB0Pixels8<source>( sourceRow + (x+i*8)*Source::numBytes, shuffle ), yCoefficients );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(gray8Row + x), packLuma32( y, offset ) );
+	}
+	RGBKernels::convertRGBRowToGRAY8<source>( sourceRow + x*Source::numBytes, gray8Row + x, width - x, coefficients );
+}
+
+// Converts 32 pixels of any RGB encoding: returns their luma, and gives the sums of the U and 
+// of the V of each pair of pixels, for the callers to average. The pairs are in the order of 
+// the lanes, like the luma before packLuma32()
+template<ImageFormat::Encoding source>
+inline __m256i convertRGBPixels32( const unsigned char* sourceBytes, __m256i shuffle, const RGBToYUVVectors& vectors, __m256i uPairSums[2], __m256i vPairSums[2] )
+{
+	typedef RGBLayout<source> Source;
+
+	__m256i y[4], u[4], v[4];
+	for ( unsigned int i=0; i<4; ++i )
+	{
+		__m256i rgb0 = loadRGB0Pixels8<source>( sourceBytes + i*8*Source::numBytes, shuffle );
+		y[i] = getWeightedSums8( rgb0, vectors.y );
+		u[i] = getWeightedSums8( rgb0, vectors.u );
+		v[i] = getWeightedSums8( rgb0, vectors.v );
+	}
+	uPairSums[0] = _mm256_hadd_epi32( u[0], u[1] );
+	uPairSums[1] = _mm256_hadd_epi32( u[2], u[3] );
+	vPairSums[0] = _mm256_hadd_epi32( v[0], v[1] );
+	vPairSums[1] = _mm256_hadd_epi32( v[2], v[3] );
+	return packLuma32( y, vectors.yOffset );
+}
+
+// Averages 16 chroma sums of 2^shift values each, rounding up like the scalar code, and packs 
+// them with saturation. Returns the 16 U bytes in the low lane and the 16 V bytes in the high lane, in order
+template<int shift>
+inline __m256i averageChroma16( const __m256i uSums[2], const __m256i vSums[2] )
+{
+	const __m256i rounding = _mm256_set1_epi32( 1 << (shift-1) );
+	const __m256i offset = _mm256_set1_epi16( 128 );
+	const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+	__m256i u = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_add_epi32( uSums[0], rounding ), shift ), _mm256_srai_epi32( _mm256_add_epi32( uSums[1], rounding ), shift ) );
+	__m256i v = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_add_epi32( vSums[0], rounding ), shift ), _mm256_srai_epi32( _mm256_add_epi32( vSums[1], rounding ), shift ) );
+	u = _mm256_add_epi16( _mm256_permutevar8x32_epi32( u, order ), offset );
+	v = _mm256_add_epi16( _mm256_permutevar8x32_epi32( v, order ), offset );
+	return _mm256_permute4x64_epi64( _mm256_packus_epi16( u, v ), 0xD8 );
+}
+
+// Reorders the bytes of YUYV macroblocks into the ones of another packed 4:2:2 encoding
+template<ImageFormat::Encoding destination>
+inline __m256i getYUYVToYUV422Shuffle()
+{
+	typedef YUV422Layout<destination> Destination;
+	char indices[16];
+	for ( char i=0; i<16; i+=4 )
+	{
+		indices[i+Destination::y0] = i;
+		indices[i+Destination::u] = i+1;
+		indices[i+Destination::y1] = i+2;
+		indices[i+Destination::v] = i+3;
+	}
+	return _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(indices) ) );
+}
+
+// 32 pixels per iteration, the chroma of each pair of pixels is averaged. The byte unpacks work 
+// per lane, so the low lanes hold pixels 0-15 and the high lanes pixels 16-31
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRowToYUV422( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m256i shuffle = getRGB0Shuffle<source>();
+	const RGBToYUVVectors vectors( coefficients );
+	const __m256i destinationShuffle = getYUYVToYUV422Shuffle<destination>();
+
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 34 : 32;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=32 )
+	{
+		__m256i uPairSums[2], vPairSums[2];
+		__m256i luma = convertRGBPixels32<source>( sourceRow + x*Source::numBytes, shuffle, vectors, uPairSums, vPairSums );
+		__m256i chroma = averageChroma16<1>( uPairSums, vPairSums );
+		__m128i u = _mm256_castsi256_si128( chroma );
+		__m128i v = _mm256_extracti128_si256( chroma, 1 );
+		__m256i uv = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_unpacklo_epi8( u, v ) ), _mm_unpackhi_epi8( u, v ), 1 );
+		__m256i macroblocks0 = _mm256_shuffle_epi8( _mm256_unpacklo_epi8( luma, uv ), destinationShuffle );
+		__m256i macroblocks1 = _mm256_shuffle_epi8( _mm256_unpackhi_epi8( luma, uv ), destinationShuffle );
+		__m256i* destinationBlocks = reinterpret_cast<__m256i*>(destinationRow + x*2);
+		_mm256_storeu_si256( destinationBlocks, _mm256_permute2x128_si256( macroblocks0, macroblocks1, 0x20 ) );
+		_mm256_storeu_si256( destinationBlocks+1, _mm256_permute2x128_si256( macroblocks0, macroblocks1, 0x31 ) );
+	}
+	RGBKernels::convertRGBRowToYUV422<source, destination>( sourceRow + x*Source::numBytes, destinationRow + x*2, width - x, coefficients );
+}
+
+// 32 pixels of both rows per iteration, the chroma of each 2x2 block is averaged. 
+// The chroma step is 2 for NV12 (the interleaved U and V bytes) and 1 for I420
+template<ImageFormat::Encoding source, unsigned int chromaStep>
+void convertRGBRowPairToYUV420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, unsigned char* yRow0, unsigned char* yRow1, 
+								unsigned char* uRow, unsigned char* vRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m256i shuffle = getRGB0Shuffle<source>();
+	const RGBToYUVVectors vectors( coefficients );
+
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 34 : 32;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=32 )
+	{
+		__m256i uPairSums0[2], vPairSums0[2], uPairSums1[2], vPairSums1[2];
+		__m256i luma0 = convertRGBPixels32<source>( sourceRow0 + x*Source::numBytes, shuffle, vectors, uPairSums0, vPairSums0 );
+		__m256i luma1 = convertRGBPixels32<source>( sourceRow1 + x*Source::numBytes, shuffle, vectors, uPairSums1, vPairSums1 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(yRow0 + x), luma0 );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>(yRow1 + x), luma1 );
+
+		__m256i uBlockSums[2] = { _mm256_add_epi32( uPairSums0[0], uPairSums1[0] ), _mm256_add_epi32( uPairSums0[1], uPairSums1[1] ) };
+		__m256i vBlockSums[2] = { _mm256_add_epi32( vPairSums0[0], vPairSums1[0] ), _mm256_add_epi32( vPairSums0[1], vPairSums1[1] ) };
+		__m256i chroma = averageChroma16<2>( uBlockSums, vBlockSums );
+		__m128i u = _mm256_castsi256_si128( chroma );
+		__m128i v = _mm256_extracti128_si256( chroma, 1 );
+		if ( chromaStep==2 )
+		{
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(uRow + x), _mm_unpacklo_epi8( u, v ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(uRow + x + 16), _mm_unpackhi_epi8( u, v ) );
+		}
+		else
+		{
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(uRow + x/2), u );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(vRow + x/2), v );
+		}
+	}
+	RGBKernels::convertRGBRowPairToYUV420<source>( sourceRow0 + x*Source::numBytes, sourceRow1 + x*Source::numBytes, yRow0 + x, yRow1 + x, 
+												   uRow + x/2*chromaStep, vRow + x/2*chromaStep, chromaStep, width - x, coefficients );
+}
+
+struct YUV422RowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertYUV422RowToGRAY8<source>; }
+};
+
+struct RGBRowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowToGRAY8<source>; }
+};
+
+template<ImageFormat::Encoding source>
+struct RGBRowToYUV422Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRowToYUV422<source, destination>; }
+};
+
+struct RGBToYUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	RGBToYUV422SourceSelector( ImageFormat::Encoding yuv422Encoding ) : mYUV422Encoding(yuv422Encoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectYUV422Encoding( RGBRowToYUV422Selector<source>(), mYUV422Encoding ); }
+	ImageFormat::Encoding mYUV422Encoding;
+};
+
+struct RGBRowPairToNV12Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 2>; }
+};
+
+struct RGBRowPairToI420Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 1>; }
+};
+
+// Swaps the first and third bytes of 32 3-byte pixels (96 bytes). The six 16-byte blocks are 
+// paired so that both 128-bit lanes hold blocks at the same position relative to the 
+// 48-byte pixel pattern (blocks 0 and 3, 1 and 4, 2 and 5). Then each lane does the same 
+// work as the SSSE3 version
+inline void swapFirstAndThirdBytes32( const unsigned char* source, unsigned char* destination )
+{
+	const __m256i shuffle00 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -128 ) );
+	const __m256i shuffle01 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 1 ) );
+	const __m256i shuffle10 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 ) );
+	const __m256i shuffle11 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 0, -128, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, -128, 15 ) );
+	const __m256i shuffle12 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, -128 ) );
+	const __m256i shuffle21 = _mm256_broadcastsi128_si256( _mm_setr_epi8( 14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 ) );
+	const __m256i shuffle22 = _mm256_broadcastsi128_si256( _mm_setr_epi8( -128, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13 ) );
+
+	const __m256i* sourceBlocks = reinterpret_cast<const __m256i*>(source);
+	__m256i blocks01 = _mm256_loadu_si256( sourceBlocks );
+	__m256i blocks23 = _mm256_loadu_si256( sourceBlocks+1 );
+	__m256i blocks45 = _mm256_loadu_si256( sourceBlocks+2 );
+	__m256i blocks03 = _mm256_permute2x128_si256( blocks01, blocks23, 0x30 );
+	__m256i blocks14 = _mm256_permute2x128_si256( blocks01, blocks45, 0x21 );
+	__m256i blocks25 = _mm256_permute2x128_si256( blocks23, blocks45, 0x30 );
+
+	__m256i swappedBlocks03 = _mm256_or_si256( _mm256_shuffle_epi8( blocks03, shuffle00 ), _mm256_shuffle_epi8( blocks14, shuffle01 ) );
+	__m256i swappedBlocks14 = _mm256_or_si256( _mm256_or_si256( _mm256_shuffle_epi8( blocks03, shuffle10 ), _mm256_shuffle_epi8( blocks14, shuffle11 ) ), _mm256_shuffle_epi8( blocks25, shuffle12 ) );
+	__m256i swappedBlocks25 = _mm256_or_si256( _mm256_shuffle_epi8( blocks14, shuffle21 ), _mm256_shuffle_epi8( blocks25, shuffle22 ) );
+	
+	__m256i* destinationBlocks = reinterpret_cast<__m256i*>(destination);
+	_mm256_storeu_si256( destinationBlocks, _mm256_permute2x128_si256( swappedBlocks03, swappedBlocks14, 0x20 ) );
+	_mm256_storeu_si256( destinationBlocks+1, _mm256_permute2x128_si256( swappedBlocks25, swappedBlocks03, 0x30 ) );
+	_mm256_storeu_si256( destinationBlocks+2, _mm256_permute2x128_si256( swappedBlocks14, swappedBlocks25, 0x31 ) );
+}
+
+// Same as the SSSE3 version, for 32 destination samples. The bytes are widened to 16 bits first, 
+// so the interleaved pairs and the packed results stay in the order of the samples
+inline void scaleColumnPair32( const unsigned char* samples0, const unsigned char* samples1, __m256i pairWeights, __m256i sums[4] )
+{
+	for ( unsigned int i=0; i<2; ++i )
+	{
+		__m256i row0 = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples0 + i*16) ) );
+		__m256i row1 = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples1 + i*16) ) );
+		sums[i*2] = _mm256_add_epi32( sums[i*2], _mm256_madd_epi16( _mm256_unpacklo_epi16( row0, row1 ), pairWeights ) );
+		sums[i*2+1] = _mm256_add_epi32( sums[i*2+1], _mm256_madd_epi16( _mm256_unpackhi_epi16( row0, row1 ), pairWeights ) );
+	}
+}
+
+// The taps of two destination samples, as 4 partial 32-bit sums in each lane. numTaps is a multiple of 4
+inline __m256i sumTaps2( const short* samples0, const short* samples1, const short* weights, unsigned int numTaps )
+{
+	__m256i sum = _mm256_setzero_si256();
+	unsigned int tap = 0;
+	for ( ; tap+8<=numTaps; tap+=8 )
+	{
+		__m256i samples = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples0 + tap) ) ), 
+												   _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples1 + tap) ), 1 );
+		__m256i tapWeights = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>(weights + tap) ) ), 
+													  _mm_loadu_si128( reinterpret_cast<const __m128i*>(weights + numTaps + tap) ), 1 );
+		sum = _mm256_add_epi32( sum, _mm256_madd_epi16( samples, tapWeights ) );
+	}
+	if ( tap<numTaps )
+	{
+		__m256i samples = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(samples0 + tap) ) ), 
+												   _mm_loadl_epi64( reinterpret_cast<const __m128i*>(samples1 + tap) ), 1 );
+		__m256i tapWeights = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(weights + tap) ) ), 
+													  _mm_loadl_epi64( reinterpret_cast<const __m128i*>(weights + numTaps + tap) ), 1 );
+		sum = _mm256_add_epi32( sum, _mm256_madd_epi16( samples, tapWeights ) );
+	}
+	return sum;
+}
+
+}
+
+void ImageConverterKernels::convertYUYVRowToRGB24AVX2( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::RGB24>( yuyvRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertYUYVRowToBGR24AVX2( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::BGR24>( yuyvRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::swapFirstAndThirdBytesRowAVX2( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+		swapFirstAndThirdBytes32( sourceRow + x*3, destinationRow + x*3 );
+	swapFirstAndThirdBytesRow( sourceRow + numVectorPixels*3, destinationRow + numVectorPixels*3, width - numVectorPixels );
+}
+
+void ImageConverterKernels::convertNV12RowToRGB24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToBGR24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToYUYVAVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertNV12Row<ImageFormat::YUYV>( yRow, uRow, yuyvRow, width, YUYV32Store<ImageFormat::YUYV>() );
+	convertNV12RowToYUYV( yRow + x, uRow + x, vRow + x, yuyvRow + x*2, width - x );
+}
+
+void ImageConverterKernels::convertI420RowToRGB24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToBGR24AVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToYUYVAVX2( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertI420Row<ImageFormat::YUYV>( yRow, uRow, vRow, yuyvRow, width, YUYV32Store<ImageFormat::YUYV>() );
+	convertI420RowToYUYV( yRow + x, uRow + x/2, vRow + x/2, yuyvRow + x*2, width - x );
+}
+
+// Same as the SSSE3 version, 32 samples at a time
+void ImageConverterKernels::scaleColumnsAVX2( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples )
+{
+	if ( numSamples<32 )
+	{
+		scaleColumns( sourceRows, weights, numTaps, destinationRow, numSamples );
+		return;
+	}
+
+	const int shift = scaleWeightBits - scaleExtraBits;
+	const __m256i rounding = _mm256_set1_epi32( 1 << (shift-1) );
+	for ( unsigned int x=0; x<numSamples; x+=32 )
+	{
+		if ( x+32>numSamples )
+			x = numSamples - 32;
+		__m256i sums[4] = { rounding, rounding, rounding, rounding };
+		for ( unsigned int tap=0; tap<numTaps; tap+=2 )
+		{
+			if ( tap+1<numTaps )
+				scaleColumnPair32( sourceRows[tap] + x, sourceRows[tap+1] + x, setPairs( weights[tap], weights[tap+1] ), sums );
+			else
+				scaleColumnPair32( sourceRows[tap] + x, sourceRows[tap] + x, setPairs( weights[tap], 0 ), sums );
+		}
+		__m256i* destination = reinterpret_cast<__m256i*>(destinationRow + x);
+		_mm256_storeu_si256( destination, _mm256_packs_epi32( _mm256_srai_epi32( sums[0], shift ), _mm256_srai_epi32( sums[1], shift ) ) );
+		_mm256_storeu_si256( destination+1, _mm256_packs_epi32( _mm256_srai_epi32( sums[2], shift ), _mm256_srai_epi32( sums[3], shift ) ) );
+	}
+}
+
+// Two destination samples per vector, one in each lane. The horizontal additions leave the 
+// even samples in the low lane and the odd ones in the high lane, which the permutation interleaves
+void ImageConverterKernels::scaleRowAVX2( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width )
+{
+	const int shift = scaleWeightBits + scaleExtraBits;
+	const __m256i rounding = _mm256_set1_epi32( 1 << (shift-1) );
+	const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+	unsigned int numVectorSamples = width & ~7u;
+	for ( unsigned int x=0; x<numVectorSamples; x+=8 )
+	{
+		const short* sampleWeights = weights + x*numTaps;
+		__m256i sums01 = sumTaps2( sourceRow + firstIndices[x], sourceRow + firstIndices[x+1], sampleWeights, numTaps );
+		__m256i sums23 = sumTaps2( sourceRow + firstIndices[x+2], sourceRow + firstIndices[x+3], sampleWeights + 2*numTaps, numTaps );
+		__m256i sums45 = sumTaps2( sourceRow + firstIndices[x+4], sourceRow + firstIndices[x+5], sampleWeights + 4*numTaps, numTaps );
+		__m256i sums67 = sumTaps2( sourceRow + firstIndices[x+6], sourceRow + firstIndices[x+7], sampleWeights + 6*numTaps, numTaps );
+		__m256i sums = _mm256_hadd_epi32( _mm256_hadd_epi32( sums01, sums23 ), _mm256_hadd_epi32( sums45, sums67 ) );
+		sums = _mm256_srai_epi32( _mm256_add_epi32( _mm256_permutevar8x32_epi32( sums, order ), rounding ), shift );
+		__m128i samples = _mm_packs_epi32( _mm256_castsi256_si128( sums ), _mm256_extracti128_si256( sums, 1 ) );
+		_mm_storel_epi64( reinterpret_cast<__m128i*>(destinationRow + x), _mm_packus_epi16( samples, samples ) );
+	}
+	unsigned int x = numVectorSamples;
+	scaleRow( sourceRow, firstIndices + x, weights + x*numTaps, numTaps, destinationRow + x, width - x );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertRGBRowFunctionAVX2( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding )
+{
+	return selectRGBEncoding( RGBSourceSelector( destinationEncoding ), sourceEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUV422RowToRGBFunctionAVX2( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding )
+{
+	return selectYUV422Encoding( YUV422SourceSelector( rgbEncoding ), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToRGBFunctionAVX2( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( NV12RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToRGBFunctionAVX2( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( I420RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertYUV422RowToGRAY8FunctionAVX2( ImageFormat::Encoding yuv422Encoding )
+{
+	return selectYUV422Encoding( YUV422RowToGRAY8Selector(), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToGRAY8FunctionAVX2( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowToGRAY8Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToYUV422FunctionAVX2( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding )
+{
+	return selectRGBEncoding( RGBToYUV422SourceSelector( yuv422Encoding ), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToNV12FunctionAVX2( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToNV12Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToI420FunctionAVX2( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToI420Selector(), rgbEncoding );
+}
+
+}
+
+#endif
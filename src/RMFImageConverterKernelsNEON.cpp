@@ -0,0 +1,640 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConverterKernels.h"
+#include "RMFRGBKernels.h"
+
+#if defined(RMF_NEON)
+
+#include <arm_neon.h>
+
+namespace RMF
+{
+
+namespace
+{
+
+// Computes ( yFactor*c + dFactor*d + eFactor*e + 128 ) >> 8 on 32 bits, like the scalar code, 
+// and saturates the result to [0,255]
+inline uint8x8_t convertComponent( int16x8_t c, int16x8_t d, int16x8_t e, short yFactor, short dFactor, short eFactor )
+{
+	const int32x4_t rounding = vdupq_n_s32( 128 );
+
+	int32x4_t low = vmlal_n_s16( rounding, vget_low_s16(c), yFactor );
+	low = vmlal_n_s16( low, vget_low_s16(d), dFactor );
+	low = vmlal_n_s16( low, vget_low_s16(e), eFactor );
+	
+	int32x4_t high = vmlal_n_s16( rounding, vget_high_s16(c), yFactor );
+	high = vmlal_n_s16( high, vget_high_s16(d), dFactor );
+	high = vmlal_n_s16( high, vget_high_s16(e), eFactor );
+
+	return vqmovun_s16( vcombine_s16( vshrn_n_s32( low, 8 ), vshrn_n_s32( high, 8 ) ) );
+}
+
+// Merges the components of the even and odd pixels
+inline uint8x16_t zipPixels( uint8x8_t evenPixels, uint8x8_t oddPixels )
+{
+	uint8x8x2_t pixels = vzip_u8( evenPixels, oddPixels );
+	return vcombine_u8( pixels.val[0], pixels.val[1] );
+}
+
+// Loads or stores the deinterleaved components of 16 pixels of 3 or 4 bytes
+template<int numBytes> struct RGB16Access;
+
+template<>
+struct RGB16Access<3>
+{
+	static void load( const unsigned char* source, uint8x16_t components[4] )
+	{
+		uint8x16x3_t pixels = vld3q_u8( source );
+		for ( int i=0; i<3; ++i )
+			components[i] = pixels.val[i];
+	}
+	static void store( unsigned char* destination, const uint8x16_t components[4] )
+	{
+		uint8x16x3_t pixels;
+		for ( int i=0; i<3; ++i )
+			pixels.val[i] = components[i];
+		vst3q_u8( destination, pixels );
+	}
+};
+
+template<>
+struct RGB16Access<4>
+{
+	static void load( const unsigned char* source, uint8x16_t components[4] )
+	{
+		uint8x16x4_t pixels = vld4q_u8( source );
+		for ( int i=0; i<4; ++i )
+			components[i] = pixels.val[i];
+	}
+	static void store( unsigned char* destination, const uint8x16_t components[4] )
+	{
+		uint8x16x4_t pixels;
+		for ( int i=0; i<4; ++i )
+			pixels.val[i] = components[i];
+		vst4q_u8( destination, pixels );
+	}
+};
+
+// Stores the components of 16 pixels in the order of the RGB encoding, with an opaque alpha
+template<ImageFormat::Encoding destination>
+inline void storeRGB16( unsigned char* destinationBytes, uint8x16_t r, uint8x16_t g, uint8x16_t b )
+{
+	typedef RGBLayout<destination> Destination;
+	uint8x16_t components[4];
+	components[Destination::red] = r;
+	components[Destination::green] = g;
+	components[Destination::blue] = b;
+	if ( Destination::numBytes==4 )
+		components[Destination::numBytes==4 ? Destination::alpha : 3] = vdupq_n_u8( 255 );
+	RGB16Access<Destination::numBytes>::store( destinationBytes, components );
+}
+
+// Converts 16 pixels given as the luma of the even pixels, U, the luma of the odd pixels 
+// and V, the layout the YUYV bytes get deinterleaved to
+template<ImageFormat::Encoding destination>
+inline void convertYUV16( uint8x8x4_t yuyv, const YUVCoefficients& coefficients, unsigned char* destinationBytes )
+{
+	const uint8x8_t yOffset = vdup_n_u8( coefficients.yOffset );
+	int16x8_t c0 = vreinterpretq_s16_u16( vsubl_u8( yuyv.val[0], yOffset ) );
+	int16x8_t d = vreinterpretq_s16_u16( vsubl_u8( yuyv.val[1], vdup_n_u8(128) ) );
+	int16x8_t c1 = vreinterpretq_s16_u16( vsubl_u8( yuyv.val[2], yOffset ) );
+	int16x8_t e = vreinterpretq_s16_u16( vsubl_u8( yuyv.val[3], vdup_n_u8(128) ) );
+
+	const short yFactor = coefficients.yFactor;
+	uint8x16_t r = zipPixels( convertComponent( c0, d, e, yFactor, 0, coefficients.vToRed ), convertComponent( c1, d, e, yFactor, 0, coefficients.vToRed ) );
+	uint8x16_t g = zipPixels( convertComponent( c0, d, e, yFactor, coefficients.uToGreen, coefficients.vToGreen ), convertComponent( c1, d, e, yFactor, coefficients.uToGreen, coefficients.vToGreen ) );
+	uint8x16_t b = zipPixels( convertComponent( c0, d, e, yFactor, coefficients.uToBlue, 0 ), convertComponent( c1, d, e, yFactor, coefficients.uToBlue, 0 ) );
+	storeRGB16<destination>( destinationBytes, r, g, b );
+}
+
+// 16 pixels per iteration, the remaining ones are handled by the scalar kernel. The coefficients 
+// are copied so the stores, through unsigned char pointers, can't make the compiler reload them
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertYUV422Row( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef YUV422Layout<source> Source;
+	const unsigned int numBytes = RGBLayout<destination>::numBytes;
+	const YUVCoefficients rowCoefficients = coefficients;
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		// The load deinterleaves the 4 bytes of the macroblocks, which are then picked in the YUYV order
+		uint8x8x4_t macroblocks = vld4_u8( sourceRow + x*2 );
+		uint8x8x4_t yuyv = { { macroblocks.val[Source::y0], macroblocks.val[Source::u], macroblocks.val[Source::y1], macroblocks.val[Source::v] } };
+		convertYUV16<destination>( yuyv, rowCoefficients, destinationRow + x*numBytes );
+	}
+	RGBKernels::convertYUV422Row<source, destination>( sourceRow + numVectorPixels*2, destinationRow + numVectorPixels*numBytes, width - numVectorPixels, coefficients );
+}
+
+// Stores 16 pixels loaded to the YUYV layout to the destination encoding: converted to 
+// an RGB encoding, or as they are for YUYV
+template<ImageFormat::Encoding destination>
+struct YUV16Store
+{
+	enum { numBytesPerPixel = RGBLayout<destination>::numBytes };
+	YUV16Store( const YUVCoefficients& coefficients ) : mCoefficients( coefficients ) {}
+	void store( uint8x8x4_t yuyv, unsigned char* destinationBytes ) const		{ convertYUV16<destination>( yuyv, mCoefficients, destinationBytes ); }
+	YUVCoefficients mCoefficients;
+};
+
+template<>
+struct YUV16Store<ImageFormat::YUYV>
+{
+	enum { numBytesPerPixel = 2 };
+	void store( uint8x8x4_t yuyv, unsigned char* destinationBytes ) const		{ vst4_u8( destinationBytes, yuyv ); }
+};
+
+// The 4:2:0 rows are loaded to the same layout as the YUYV ones. 16 pixels per iteration, 
+// the remaining ones are left to the scalar kernels
+template<ImageFormat::Encoding destination>
+unsigned int convertNV12Row( const unsigned char* yRow, const unsigned char* uvRow, unsigned char* destinationRow, unsigned int width, const YUV16Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		uint8x8x2_t y = vld2_u8( yRow + x );
+		uint8x8x2_t uv = vld2_u8( uvRow + x );
+		uint8x8x4_t yuyv = { { y.val[0], uv.val[0], y.val[1], uv.val[1] } };
+		store.store( yuyv, destinationRow + x*YUV16Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+unsigned int convertI420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUV16Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		uint8x8x2_t y = vld2_u8( yRow + x );
+		uint8x8x4_t yuyv = { { y.val[0], vld1_u8( uRow + x/2 ), y.val[1], vld1_u8( vRow + x/2 ) } };
+		store.store( yuyv, destinationRow + x*YUV16Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+void convertNV12RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertNV12Row<destination>( yRow, uRow, destinationRow, width, YUV16Store<destination>( coefficients ) );
+	RGBKernels::convertNV12Row<destination>( yRow + x, uRow + x, vRow + x, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+template<ImageFormat::Encoding destination>
+void convertI420RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertI420Row<destination>( yRow, uRow, vRow, destinationRow, width, YUV16Store<destination>( coefficients ) );
+	RGBKernels::convertI420Row<destination>( yRow + x, uRow + x/2, vRow + x/2, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+// The loads and stores deinterleave the components, which are then simply reordered. 16 pixels per iteration
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	typedef RGBLayout<source> Source;
+	typedef RGBLayout<destination> Destination;
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		uint8x16_t sourceComponents[4];
+		RGB16Access<Source::numBytes>::load( sourceRow + x*Source::numBytes, sourceComponents );
+		
+		uint8x16_t destinationComponents[4];
+		destinationComponents[Destination::red] = sourceComponents[Source::red];
+		destinationComponents[Destination::green] = sourceComponents[Source::green];
+		destinationComponents[Destination::blue] = sourceComponents[Source::blue];
+		if ( Destination::numBytes==4 )
+		{
+			if ( Source::hasAlpha && Destination::hasAlpha )
+				destinationComponents[Destination::alpha] = sourceComponents[Source::hasAlpha ? Source::alpha : 3];
+			else
+				destinationComponents[Destination::numBytes==4 ? Destination::alpha : 3] = vdupq_n_u8( 255 );
+		}
+		RGB16Access<Destination::numBytes>::store( destinationRow + x*Destination::numBytes, destinationComponents );
+	}
+	RGBKernels::convertRGBRow<source, destination>( sourceRow + numVectorPixels*Source::numBytes, destinationRow + numVectorPixels*Destination::numBytes, width - numVectorPixels );
+}
+
+// Turn the runtime encodings into template arguments (see selectRGBEncoding())
+template<ImageFormat::Encoding source>
+struct RGBRowSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRow<source, destination>; }
+};
+
+struct RGBSourceSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	RGBSourceSelector( ImageFormat::Encoding destinationEncoding ) : mDestinationEncoding(destinationEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( RGBRowSelector<source>(), mDestinationEncoding ); }
+	ImageFormat::Encoding mDestinationEncoding;
+};
+
+template<ImageFormat::Encoding source>
+struct YUV422RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertYUV422Row<source, destination>; }
+};
+
+struct YUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	YUV422SourceSelector( ImageFormat::Encoding rgbEncoding ) : mRGBEncoding(rgbEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( YUV422RowToRGBSelector<source>(), mRGBEncoding ); }
+	ImageFormat::Encoding mRGBEncoding;
+};
+
+struct NV12RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertNV12RowToRGB<destination>; }
+};
+
+struct I420RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertI420RowToRGB<destination>; }
+};
+
+// 32 pixels per iteration: the load deinterleaves the 4 bytes of the macroblocks, the luma ones 
+// are interleaved back by the store
+template<ImageFormat::Encoding source>
+void convertYUV422RowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width )
+{
+	typedef YUV422Layout<source> Source;
+	unsigned int numVectorPixels = width & ~31u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=32 )
+	{
+		uint8x16x4_t macroblocks = vld4q_u8( sourceRow + x*2 );
+		uint8x16x2_t luma = { { macroblocks.val[Source::y0], macroblocks.val[Source::y1] } };
+		vst2q_u8( gray8Row + x, luma );
+	}
+	RGBKernels::convertYUV422RowToGRAY8<source>( sourceRow + numVectorPixels*2, gray8Row + numVectorPixels, width - numVectorPixels );
+}
+
+// The luma sum of 8 pixels fits in 16 unsigned bits (the coefficients add up to 256 at most), and 
+// the rounding narrowing shift is the scalar (sum + 128) >> 8
+inline uint8x8_t convertRGBToLuma8( uint8x8_t r, uint8x8_t g, uint8x8_t b, const YUVCoefficients& coefficients )
+{
+	uint16x8_t sum = vmull_u8( r, vdup_n_u8( coefficients.redToY ) );
+	sum = vmlal_u8( sum, g, vdup_n_u8( coefficients.greenToY ) );
+	sum = vmlal_u8( sum, b, vdup_n_u8( coefficients.blueToY ) );
+	return vadd_u8( vrshrn_n_u16( sum, 8 ), vdup_n_u8( coefficients.yOffset ) );
+}
+
+// 16 pixels per iteration, the remaining ones are handled by the scalar kernel
+template<ImageFormat::Encoding source>
+void convertRGBRowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const YUVCoefficients rowCoefficients = coefficients;
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		uint8x16_t components[4];
+		RGB16Access<Source::numBytes>::load( sourceRow + x*Source::numBytes, components );
+		uint8x16_t r = components[Source::red];
+		uint8x16_t g = components[Source::green];
+		uint8x16_t b = components[Source::blue];
+		uint8x8_t low = convertRGBToLuma8( vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), rowCoefficients );
+		uint8x8_t high = convertRGBToLuma8( vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), rowCoefficients );
+		vst1q_u8( gray8Row + x, vcombine_u8( low, high ) );
+	}
+	RGBKernels::convertRGBRowToGRAY8<source>( sourceRow + numVectorPixels*Source::numBytes, gray8Row + numVectorPixels, width - numVectorPixels, coefficients );
+}
+
+// The chroma of 8 pixels before its +128 offset: ( k0*a - k1*b - k2*c + 128 ) >> 8, like the 
+// scalar code. The sums fit in 16 signed bits, so the wrap-around of the unsigned multiply-subtracts 
+// is harmless. The rounding shift doesn't overflow, where adding 128 would in full range
+inline int16x8_t convertRGBToChroma8( uint8x8_t a, uint8x8_t b, uint8x8_t c, uint8_t k0, uint8_t k1, uint8_t k2 )
+{
+	uint16x8_t sum = vmull_u8( a, vdup_n_u8(k0) );
+	sum = vmlsl_u8( sum, b, vdup_n_u8(k1) );
+	sum = vmlsl_u8( sum, c, vdup_n_u8(k2) );
+	return vrshrq_n_s16( vreinterpretq_s16_u16(sum), 8 );
+}
+
+// Adds the chroma of each pair of pixels
+inline int16x8_t addPixelPairs( int16x8_t low, int16x8_t high )
+{
+	return vcombine_s16( vpadd_s16( vget_low_s16(low), vget_high_s16(low) ), vpadd_s16( vget_low_s16(high), vget_high_s16(high) ) );
+}
+
+// Converts 16 pixels of any RGB encoding: returns their luma, and gives the sums of the U and 
+// of the V of each pair of pixels, for the callers to average. Blue is the only positive term of 
+// U, and red the one of V
+template<ImageFormat::Encoding source>
+inline uint8x16_t convertRGBPixels16( const unsigned char* sourceBytes, const YUVCoefficients& coefficients, int16x8_t& uPairSums, int16x8_t& vPairSums )
+{
+	typedef RGBLayout<source> Source;
+	uint8x16_t components[4];
+	RGB16Access<Source::numBytes>::load( sourceBytes, components );
+	uint8x16_t r = components[Source::red];
+	uint8x16_t g = components[Source::green];
+	uint8x16_t b = components[Source::blue];
+	const uint8_t u0 = coefficients.blueToU;
+	const uint8_t u1 = -coefficients.redToU;
+	const uint8_t u2 = -coefficients.greenToU;
+	const uint8_t v0 = coefficients.redToV;
+	const uint8_t v1 = -coefficients.greenToV;
+	const uint8_t v2 = -coefficients.blueToV;
+	uPairSums = addPixelPairs( convertRGBToChroma8( vget_low_u8(b), vget_low_u8(r), vget_low_u8(g), u0, u1, u2 ), 
+							   convertRGBToChroma8( vget_high_u8(b), vget_high_u8(r), vget_high_u8(g), u0, u1, u2 ) );
+	vPairSums = addPixelPairs( convertRGBToChroma8( vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), v0, v1, v2 ), 
+							   convertRGBToChroma8( vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), v0, v1, v2 ) );
+	return vcombine_u8( convertRGBToLuma8( vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), coefficients ), 
+						convertRGBToLuma8( vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), coefficients ) );
+}
+
+// Averages chroma sums of 2^shift values each, rounding up like the scalar code, and saturates them
+template<int shift>
+inline uint8x8_t averageChroma8( int16x8_t sums )
+{
+	return vqmovun_s16( vaddq_s16( vrshrq_n_s16( sums, shift ), vdupq_n_s16(128) ) );
+}
+
+// 16 pixels per iteration, the chroma of each pair of pixels is averaged. The store interleaves 
+// the 4 bytes of the macroblocks in the order of the destination encoding
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRowToYUV422( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	typedef YUV422Layout<destination> Destination;
+	const YUVCoefficients rowCoefficients = coefficients;
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		int16x8_t uPairSums, vPairSums;
+		uint8x16_t luma = convertRGBPixels16<source>( sourceRow + x*Source::numBytes, rowCoefficients, uPairSums, vPairSums );
+		uint8x8x2_t evenOddLuma = vuzp_u8( vget_low_u8(luma), vget_high_u8(luma) );
+		uint8x8x4_t macroblocks;
+		macroblocks.val[Destination::y0] = evenOddLuma.val[0];
+		macroblocks.val[Destination::u] = averageChroma8<1>( uPairSums );
+		macroblocks.val[Destination::y1] = evenOddLuma.val[1];
+		macroblocks.val[Destination::v] = averageChroma8<1>( vPairSums );
+		vst4_u8( destinationRow + x*2, macroblocks );
+	}
+	RGBKernels::convertRGBRowToYUV422<source, destination>( sourceRow + numVectorPixels*Source::numBytes, destinationRow + numVectorPixels*2, width - numVectorPixels, coefficients );
+}
+
+// 16 pixels of both rows per iteration, the chroma of each 2x2 block is averaged. 
+// The chroma step is 2 for NV12 (the interleaved U and V bytes) and 1 for I420
+template<ImageFormat::Encoding source, unsigned int chromaStep>
+void convertRGBRowPairToYUV420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, unsigned char* yRow0, unsigned char* yRow1, 
+								unsigned char* uRow, unsigned char* vRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const YUVCoefficients rowCoefficients = coefficients;
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		int16x8_t uPairSums0, vPairSums0, uPairSums1, vPairSums1;
+		vst1q_u8( yRow0 + x, convertRGBPixels16<source>( sourceRow0 + x*Source::numBytes, rowCoefficients, uPairSums0, vPairSums0 ) );
+		vst1q_u8( yRow1 + x, convertRGBPixels16<source>( sourceRow1 + x*Source::numBytes, rowCoefficients, uPairSums1, vPairSums1 ) );
+		uint8x8_t u = averageChroma8<2>( vaddq_s16( uPairSums0, uPairSums1 ) );
+		uint8x8_t v = averageChroma8<2>( vaddq_s16( vPairSums0, vPairSums1 ) );
+		if ( chromaStep==2 )
+		{
+			uint8x8x2_t uv = { { u, v } };
+			vst2_u8( uRow + x, uv );
+		}
+		else
+		{
+			vst1_u8( uRow + x/2, u );
+			vst1_u8( vRow + x/2, v );
+		}
+	}
+	RGBKernels::convertRGBRowPairToYUV420<source>( sourceRow0 + numVectorPixels*Source::numBytes, sourceRow1 + numVectorPixels*Source::numBytes, 
+												   yRow0 + numVectorPixels, yRow1 + numVectorPixels, uRow + numVectorPixels/2*chromaStep, 
+												   vRow + numVectorPixels/2*chromaStep, chromaStep, width - numVectorPixels, coefficients );
+}
+
+struct YUV422RowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertYUV422RowToGRAY8<source>; }
+};
+
+struct RGBRowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowToGRAY8<source>; }
+};
+
+template<ImageFormat::Encoding source>
+struct RGBRowToYUV422Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRowToYUV422<source, destination>; }
+};
+
+struct RGBToYUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	RGBToYUV422SourceSelector( ImageFormat::Encoding yuv422Encoding ) : mYUV422Encoding(yuv422Encoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectYUV422Encoding( RGBRowToYUV422Selector<source>(), mYUV422Encoding ); }
+	ImageFormat::Encoding mYUV422Encoding;
+};
+
+struct RGBRowPairToNV12Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 2>; }
+};
+
+struct RGBRowPairToI420Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 1>; }
+};
+
+// The taps of 4 destination samples from x, rounded back to 8 bits of precision. numTaps is a multiple of 4
+inline int16x4_t scaleRow4( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned int x )
+{
+	int32x2_t pairs[4];
+	for ( unsigned int i=0; i<4; ++i )
+	{
+		const short* samples = sourceRow + firstIndices[x+i];
+		const short* sampleWeights = weights + (x+i)*numTaps;
+		int32x4_t sum = vdupq_n_s32( 0 );
+		for ( unsigned int tap=0; tap<numTaps; tap+=4 )
+			sum = vmlal_s16( sum, vld1_s16( samples + tap ), vld1_s16( sampleWeights + tap ) );
+		pairs[i] = vadd_s32( vget_low_s32( sum ), vget_high_s32( sum ) );
+	}
+	int32x4_t sums = vcombine_s32( vpadd_s32( pairs[0], pairs[1] ), vpadd_s32( pairs[2], pairs[3] ) );
+	return vqmovn_s32( vrshrq_n_s32( sums, ImageConverterKernels::scaleWeightBits + ImageConverterKernels::scaleExtraBits ) );
+}
+
+}
+
+void ImageConverterKernels::convertYUYVRowToRGB24NEON( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::RGB24>( yuyvRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertYUYVRowToBGR24NEON( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::BGR24>( yuyvRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::swapFirstAndThirdBytesRowNEON( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		uint8x16x3_t pixels = vld3q_u8( sourceRow + x*3 );
+		uint8x16_t firstBytes = pixels.val[0];
+		pixels.val[0] = pixels.val[2];
+		pixels.val[2] = firstBytes;
+		vst3q_u8( destinationRow + x*3, pixels );
+	}
+	swapFirstAndThirdBytesRow( sourceRow + numVectorPixels*3, destinationRow + numVectorPixels*3, width - numVectorPixels );
+}
+
+void ImageConverterKernels::convertNV12RowToRGB24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToBGR24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToYUYVNEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertNV12Row<ImageFormat::YUYV>( yRow, uRow, yuyvRow, width, YUV16Store<ImageFormat::YUYV>() );
+	convertNV12RowToYUYV( yRow + x, uRow + x, vRow + x, yuyvRow + x*2, width - x );
+}
+
+void ImageConverterKernels::convertI420RowToRGB24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToBGR24NEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToYUYVNEON( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertI420Row<ImageFormat::YUYV>( yRow, uRow, vRow, yuyvRow, width, YUV16Store<ImageFormat::YUYV>() );
+	convertI420RowToYUYV( yRow + x, uRow + x/2, vRow + x/2, yuyvRow + x*2, width - x );
+}
+
+// The rounding shifts give the same results as the scalar code. With at least 16 samples, 
+// the last block overlaps the previous one rather than going scalar
+void ImageConverterKernels::scaleColumnsNEON( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples )
+{
+	if ( numSamples<16 )
+	{
+		scaleColumns( sourceRows, weights, numTaps, destinationRow, numSamples );
+		return;
+	}
+
+	for ( unsigned int x=0; x<numSamples; x+=16 )
+	{
+		if ( x+16>numSamples )
+			x = numSamples - 16;
+		int32x4_t sums[4] = { vdupq_n_s32( 0 ), vdupq_n_s32( 0 ), vdupq_n_s32( 0 ), vdupq_n_s32( 0 ) };
+		for ( unsigned int tap=0; tap<numTaps; ++tap )
+		{
+			uint8x16_t row = vld1q_u8( sourceRows[tap] + x );
+			int16x8_t low = vreinterpretq_s16_u16( vmovl_u8( vget_low_u8( row ) ) );
+			int16x8_t high = vreinterpretq_s16_u16( vmovl_u8( vget_high_u8( row ) ) );
+			sums[0] = vmlal_n_s16( sums[0], vget_low_s16( low ), weights[tap] );
+			sums[1] = vmlal_n_s16( sums[1], vget_high_s16( low ), weights[tap] );
+			sums[2] = vmlal_n_s16( sums[2], vget_low_s16( high ), weights[tap] );
+			sums[3] = vmlal_n_s16( sums[3], vget_high_s16( high ), weights[tap] );
+		}
+		const int shift = scaleWeightBits - scaleExtraBits;
+		vst1q_s16( destinationRow + x, vcombine_s16( vqrshrn_n_s32( sums[0], shift ), vqrshrn_n_s32( sums[1], shift ) ) );
+		vst1q_s16( destinationRow + x + 8, vcombine_s16( vqrshrn_n_s32( sums[2], shift ), vqrshrn_n_s32( sums[3], shift ) ) );
+	}
+}
+
+void ImageConverterKernels::scaleRowNEON( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width )
+{
+	unsigned int numVectorSamples = width & ~7u;
+	for ( unsigned int x=0; x<numVectorSamples; x+=8 )
+	{
+		int16x8_t samples = vcombine_s16( scaleRow4( sourceRow, firstIndices, weights, numTaps, x ), scaleRow4( sourceRow, firstIndices, weights, numTaps, x+4 ) );
+		vst1_u8( destinationRow + x, vqmovun_s16( samples ) );
+	}
+	unsigned int x = numVectorSamples;
+	scaleRow( sourceRow, firstIndices + x, weights + x*numTaps, numTaps, destinationRow + x, width - x );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertRGBRowFunctionNEON( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding )
+{
+	return selectRGBEncoding( RGBSourceSelector( destinationEncoding ), sourceEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUV422RowToRGBFunctionNEON( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding )
+{
+	return selectYUV422Encoding( YUV422SourceSelector( rgbEncoding ), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToRGBFunctionNEON( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( NV12RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToRGBFunctionNEON( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( I420RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertYUV422RowToGRAY8FunctionNEON( ImageFormat::Encoding yuv422Encoding )
+{
+	return selectYUV422Encoding( YUV422RowToGRAY8Selector(), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToGRAY8FunctionNEON( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowToGRAY8Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToYUV422FunctionNEON( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding )
+{
+	return selectRGBEncoding( RGBToYUV422SourceSelector( yuv422Encoding ), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToNV12FunctionNEON( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToNV12Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToI420FunctionNEON( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToI420Selector(), rgbEncoding );
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,814 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageConverterKernels.h"
+#include "RMFRGBKernels.h"
+
+#if defined(RMF_X86)
+
+#include <tmmintrin.h>
+
+namespace RMF
+{
+
+namespace
+{
+
+// Pairs of 16-bit values, as expected by _mm_madd_epi16
+inline __m128i setPairs( short first, short second )
+{
+	return _mm_setr_epi16( first, second, first, second, first, second, first, second );
+}
+
+// The coefficients of the YUV to RGB conversion (see YUVCoefficients) as pairs for the 
+// multiply-adds, set up once per row
+struct YUVToRGBVectors
+{
+	YUVToRGBVectors( const YUVCoefficients& coefficients )
+		: offsets( setPairs( coefficients.yOffset, 128 ) ),
+		  red( setPairs( coefficients.yFactor, coefficients.vToRed ) ),
+		  greenU( setPairs( coefficients.yFactor, coefficients.uToGreen ) ),
+		  greenV( setPairs( 0, coefficients.vToGreen ) ),
+		  blue( setPairs( coefficients.yFactor, coefficients.uToBlue ) )
+	{
+	}
+	__m128i offsets;
+	__m128i red;
+	__m128i greenU;
+	__m128i greenV;
+	__m128i blue;
+};
+
+// Converts 4 pixels (8 bytes) of packed 4:2:2 to 32-bit red, green and blue values. The shuffles
+// lay out the (Y-yOffset, V-128) and (Y-yOffset, U-128) pairs of each pixel so that the multiply-adds 
+// compute exactly the same fixed-point sums as the scalar code
+inline void convertYUV422Pixels4( __m128i yuv422, __m128i ceShuffle, __m128i cdShuffle, const YUVToRGBVectors& vectors, __m128i& r, __m128i& g, __m128i& b )
+{
+	const __m128i rounding = _mm_set1_epi32( 128 );
+
+	__m128i ce = _mm_sub_epi16( _mm_shuffle_epi8( yuv422, ceShuffle ), vectors.offsets );
+	__m128i cd = _mm_sub_epi16( _mm_shuffle_epi8( yuv422, cdShuffle ), vectors.offsets );
+	
+	r = _mm_madd_epi16( ce, vectors.red );
+	g = _mm_add_epi32( _mm_madd_epi16( cd, vectors.greenU ), _mm_madd_epi16( ce, vectors.greenV ) );
+	b = _mm_madd_epi16( cd, vectors.blue );
+	r = _mm_srai_epi32( _mm_add_epi32( r, rounding ), 8 );
+	g = _mm_srai_epi32( _mm_add_epi32( g, rounding ), 8 );
+	b = _mm_srai_epi32( _mm_add_epi32( b, rounding ), 8 );
+}
+
+// The shuffle giving the (Y, chroma) 16-bit pairs of the 4 pixels of the two macroblocks starting 
+// at the given byte. All the arguments are compile-time constants, so is the shuffle
+template<ImageFormat::Encoding source>
+inline __m128i getLumaChromaShuffle( char firstByte, char chroma )
+{
+	typedef YUV422Layout<source> Source;
+	const char m0 = firstByte;
+	const char m1 = firstByte + 4;
+	return _mm_setr_epi8( m0+Source::y0, -128, m0+chroma, -128, m0+Source::y1, -128, m0+chroma, -128, 
+						  m1+Source::y0, -128, m1+chroma, -128, m1+Source::y1, -128, m1+chroma, -128 );
+}
+
+// Converts 8 pixels (16 bytes) of packed 4:2:2 to 16-bit red, green and blue values
+template<ImageFormat::Encoding source>
+inline void convertYUV422Pixels8( __m128i yuv422, const YUVToRGBVectors& vectors, __m128i& r, __m128i& g, __m128i& b )
+{
+	typedef YUV422Layout<source> Source;
+	const __m128i ceLowShuffle = getLumaChromaShuffle<source>( 0, Source::v );
+	const __m128i cdLowShuffle = getLumaChromaShuffle<source>( 0, Source::u );
+	const __m128i ceHighShuffle = getLumaChromaShuffle<source>( 8, Source::v );
+	const __m128i cdHighShuffle = getLumaChromaShuffle<source>( 8, Source::u );
+
+	__m128i rLow, gLow, bLow;
+	__m128i rHigh, gHigh, bHigh;
+	convertYUV422Pixels4( yuv422, ceLowShuffle, cdLowShuffle, vectors, rLow, gLow, bLow );
+	convertYUV422Pixels4( yuv422, ceHighShuffle, cdHighShuffle, vectors, rHigh, gHigh, bHigh );
+	r = _mm_packs_epi32( rLow, rHigh );
+	g = _mm_packs_epi32( gLow, gHigh );
+	b = _mm_packs_epi32( bLow, bHigh );
+}
+
+// Interleaves 16 values of each of the three components into 48 bytes
+inline void storeInterleaved( unsigned char* destination, __m128i first, __m128i second, __m128i third )
+{
+	const __m128i shuffle00 = _mm_setr_epi8( 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5 );
+	const __m128i shuffle01 = _mm_setr_epi8( -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128 );
+	const __m128i shuffle02 = _mm_setr_epi8( -128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128 );
+	const __m128i shuffle10 = _mm_setr_epi8( -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128 );
+	const __m128i shuffle11 = _mm_setr_epi8( 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10 );
+	const __m128i shuffle12 = _mm_setr_epi8( -128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128 );
+	const __m128i shuffle20 = _mm_setr_epi8( -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128 );
+	const __m128i shuffle21 = _mm_setr_epi8( -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128 );
+	const __m128i shuffle22 = _mm_setr_epi8( 10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15 );
+
+	__m128i* destinationBlocks = reinterpret_cast<__m128i*>(destination);
+	_mm_storeu_si128( destinationBlocks, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( first, shuffle00 ), _mm_shuffle_epi8( second, shuffle01 ) ), _mm_shuffle_epi8( third, shuffle02 ) ) );
+	_mm_storeu_si128( destinationBlocks+1, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( first, shuffle10 ), _mm_shuffle_epi8( second, shuffle11 ) ), _mm_shuffle_epi8( third, shuffle12 ) ) );
+	_mm_storeu_si128( destinationBlocks+2, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( first, shuffle20 ), _mm_shuffle_epi8( second, shuffle21 ) ), _mm_shuffle_epi8( third, shuffle22 ) ) );
+}
+
+// Interleaves 16 values of each of the four components into 64 bytes
+inline void storeInterleaved( unsigned char* destination, __m128i first, __m128i second, __m128i third, __m128i fourth )
+{
+	__m128i firstSecondLow = _mm_unpacklo_epi8( first, second );
+	__m128i firstSecondHigh = _mm_unpackhi_epi8( first, second );
+	__m128i thirdFourthLow = _mm_unpacklo_epi8( third, fourth );
+	__m128i thirdFourthHigh = _mm_unpackhi_epi8( third, fourth );
+
+	__m128i* destinationBlocks = reinterpret_cast<__m128i*>(destination);
+	_mm_storeu_si128( destinationBlocks, _mm_unpacklo_epi16( firstSecondLow, thirdFourthLow ) );
+	_mm_storeu_si128( destinationBlocks+1, _mm_unpackhi_epi16( firstSecondLow, thirdFourthLow ) );
+	_mm_storeu_si128( destinationBlocks+2, _mm_unpacklo_epi16( firstSecondHigh, thirdFourthHigh ) );
+	_mm_storeu_si128( destinationBlocks+3, _mm_unpackhi_epi16( firstSecondHigh, thirdFourthHigh ) );
+}
+
+// Stores the components of 16 pixels in the order of the RGB encoding, with an opaque alpha
+template<ImageFormat::Encoding destination>
+inline void storeRGB16( unsigned char* destinationBytes, __m128i r, __m128i g, __m128i b )
+{
+	typedef RGBLayout<destination> Destination;
+	__m128i components[4];
+	components[Destination::red] = r;
+	components[Destination::green] = g;
+	components[Destination::blue] = b;
+	if ( Destination::numBytes==4 )
+	{
+		components[Destination::numBytes==4 ? Destination::alpha : 3] = _mm_set1_epi8( -1 );
+		storeInterleaved( destinationBytes, components[0], components[1], components[2], components[3] );
+	}
+	else
+	{
+		storeInterleaved( destinationBytes, components[0], components[1], components[2] );
+	}
+}
+
+// Converts 16 pixels of packed 4:2:2 (two blocks of 16 bytes) to an RGB encoding
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+inline void convertYUV422Pixels16( __m128i block0, __m128i block1, const YUVToRGBVectors& vectors, unsigned char* destinationBytes )
+{
+	__m128i r0, g0, b0;
+	__m128i r1, g1, b1;
+	convertYUV422Pixels8<source>( block0, vectors, r0, g0, b0 );
+	convertYUV422Pixels8<source>( block1, vectors, r1, g1, b1 );
+	storeRGB16<destination>( destinationBytes, _mm_packus_epi16( r0, r1 ), _mm_packus_epi16( g0, g1 ), _mm_packus_epi16( b0, b1 ) );
+}
+
+// 16 pixels per iteration, the remaining ones are handled by the scalar kernel
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertYUV422Row( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	const unsigned int numBytes = RGBLayout<destination>::numBytes;
+	const YUVToRGBVectors vectors( coefficients );
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		const __m128i* sourceBlocks = reinterpret_cast<const __m128i*>(sourceRow + x*2);
+		convertYUV422Pixels16<source, destination>( _mm_loadu_si128( sourceBlocks ), _mm_loadu_si128( sourceBlocks+1 ), vectors, destinationRow + x*numBytes );
+	}
+	RGBKernels::convertYUV422Row<source, destination>( sourceRow + numVectorPixels*2, destinationRow + numVectorPixels*numBytes, width - numVectorPixels, coefficients );
+}
+
+// Interleaves the luma of 16 pixels with their chroma pairs (U0, V0, U1, V1...), which gives 
+// their YUYV bytes: the 4:2:0 kernels are then the YUYV ones
+inline void interleaveYUV420( __m128i y, __m128i uv, __m128i& yuyv0, __m128i& yuyv1 )
+{
+	yuyv0 = _mm_unpacklo_epi8( y, uv );
+	yuyv1 = _mm_unpackhi_epi8( y, uv );
+}
+
+// Loads 16 pixels of NV12, whose chroma is already interleaved
+inline void loadNV12( const unsigned char* yRow, const unsigned char* uvRow, __m128i& yuyv0, __m128i& yuyv1 )
+{
+	interleaveYUV420( _mm_loadu_si128( reinterpret_cast<const __m128i*>(yRow) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(uvRow) ), yuyv0, yuyv1 );
+}
+
+// Loads 16 pixels of I420 (or YV12), interleaving the 8 bytes of each chroma plane
+inline void loadI420( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, __m128i& yuyv0, __m128i& yuyv1 )
+{
+	__m128i uv = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(uRow) ), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(vRow) ) );
+	interleaveYUV420( _mm_loadu_si128( reinterpret_cast<const __m128i*>(yRow) ), uv, yuyv0, yuyv1 );
+}
+
+// Stores 16 pixels of YUYV bytes to the destination encoding: converted to an RGB encoding, 
+// or as they are for YUYV
+template<ImageFormat::Encoding destination>
+struct YUYV16Store
+{
+	enum { numBytesPerPixel = RGBLayout<destination>::numBytes };
+	YUYV16Store( const YUVCoefficients& coefficients ) : mVectors( coefficients ) {}
+	void store( __m128i yuyv0, __m128i yuyv1, unsigned char* destinationBytes ) const		{ convertYUV422Pixels16<ImageFormat::YUYV, destination>( yuyv0, yuyv1, mVectors, destinationBytes ); }
+	YUVToRGBVectors mVectors;
+};
+
+template<>
+struct YUYV16Store<ImageFormat::YUYV>
+{
+	enum { numBytesPerPixel = 2 };
+	void store( __m128i yuyv0, __m128i yuyv1, unsigned char* destinationBytes ) const
+	{
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(destinationBytes), yuyv0 );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(destinationBytes)+1, yuyv1 );
+	}
+};
+
+// 16 pixels per iteration, the remaining ones are left to the scalar kernels
+template<ImageFormat::Encoding destination>
+unsigned int convertNV12Row( const unsigned char* yRow, const unsigned char* uvRow, unsigned char* destinationRow, unsigned int width, const YUYV16Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		__m128i yuyv0, yuyv1;
+		loadNV12( yRow + x, uvRow + x, yuyv0, yuyv1 );
+		store.store( yuyv0, yuyv1, destinationRow + x*YUYV16Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+unsigned int convertI420Row( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUYV16Store<destination>& store )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		__m128i yuyv0, yuyv1;
+		loadI420( yRow + x, uRow + x/2, vRow + x/2, yuyv0, yuyv1 );
+		store.store( yuyv0, yuyv1, destinationRow + x*YUYV16Store<destination>::numBytesPerPixel );
+	}
+	return numVectorPixels;
+}
+
+template<ImageFormat::Encoding destination>
+void convertNV12RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertNV12Row<destination>( yRow, uRow, destinationRow, width, YUYV16Store<destination>( coefficients ) );
+	RGBKernels::convertNV12Row<destination>( yRow + x, uRow + x, vRow + x, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+template<ImageFormat::Encoding destination>
+void convertI420RowToRGB( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	unsigned int x = convertI420Row<destination>( yRow, uRow, vRow, destinationRow, width, YUYV16Store<destination>( coefficients ) );
+	RGBKernels::convertI420Row<destination>( yRow + x, uRow + x/2, vRow + x/2, destinationRow + x*RGBLayout<destination>::numBytes, width - x, coefficients );
+}
+
+// Converts between two RGB encodings, one of them at least being a 4-byte one, 4 pixels at a time: 
+// a single shuffle moves the components, then the missing alpha is set. The 3-byte pixels only use 
+// 12 of the 16 loaded or stored bytes, so the loop stops early enough for these 16 bytes to stay 
+// within the row. A store's 4 extra bytes are overwritten by the next one
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRow( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	typedef RGBLayout<source> Source;
+	typedef RGBLayout<destination> Destination;
+	
+	char shuffleBytes[16];
+	char opaqueBytes[16];
+	for ( int i=0; i<16; ++i )
+	{
+		shuffleBytes[i] = -128;
+		opaqueBytes[i] = 0;
+	}
+	for ( int pixel=0; pixel<4; ++pixel )
+	{
+		char* pixelShuffle = shuffleBytes + pixel*Destination::numBytes;
+		char sourceIndex = static_cast<char>( pixel*Source::numBytes );
+		pixelShuffle[Destination::red] = sourceIndex + Source::red;
+		pixelShuffle[Destination::green] = sourceIndex + Source::green;
+		pixelShuffle[Destination::blue] = sourceIndex + Source::blue;
+		if ( Destination::numBytes==4 )
+		{
+			if ( Source::hasAlpha && Destination::hasAlpha )
+				pixelShuffle[Destination::alpha] = sourceIndex + Source::alpha;
+			else
+				opaqueBytes[pixel*4 + Destination::alpha] = -1;
+		}
+	}
+	const __m128i shuffle = _mm_loadu_si128( reinterpret_cast<const __m128i*>(shuffleBytes) );
+	const __m128i opaque = _mm_loadu_si128( reinterpret_cast<const __m128i*>(opaqueBytes) );
+
+	const unsigned int numPixelsPerBlock = Source::numBytes==3 || Destination::numBytes==3 ? 6 : 4;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerBlock<=width; x+=4 )
+	{
+		__m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceRow + x*Source::numBytes) );
+		pixels = _mm_or_si128( _mm_shuffle_epi8( pixels, shuffle ), opaque );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(destinationRow + x*Destination::numBytes), pixels );
+	}
+	RGBKernels::convertRGBRow<source, destination>( sourceRow + x*Source::numBytes, destinationRow + x*Destination::numBytes, width - x );
+}
+
+// Turn the runtime encodings into template arguments (see selectRGBEncoding())
+template<ImageFormat::Encoding source>
+struct RGBRowSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRow<source, destination>; }
+};
+
+struct RGBSourceSelector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	RGBSourceSelector( ImageFormat::Encoding destinationEncoding ) : mDestinationEncoding(destinationEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( RGBRowSelector<source>(), mDestinationEncoding ); }
+	ImageFormat::Encoding mDestinationEncoding;
+};
+
+template<ImageFormat::Encoding source>
+struct YUV422RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertYUV422Row<source, destination>; }
+};
+
+struct YUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	YUV422SourceSelector( ImageFormat::Encoding rgbEncoding ) : mRGBEncoding(rgbEncoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectRGBEncoding( YUV422RowToRGBSelector<source>(), mRGBEncoding ); }
+	ImageFormat::Encoding mRGBEncoding;
+};
+
+struct NV12RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertNV12RowToRGB<destination>; }
+};
+
+struct I420RowToRGBSelector
+{
+	typedef ImageConverterKernels::ConvertYUV420ColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertI420RowToRGB<destination>; }
+};
+
+// Gathers the luma bytes of 16 pixels of packed 4:2:2 (two blocks of 16 bytes): each block gives 8 
+template<ImageFormat::Encoding source>
+void convertYUV422RowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width )
+{
+	typedef YUV422Layout<source> Source;
+	const __m128i lumaShuffle = _mm_setr_epi8( Source::y0, Source::y1, 4+Source::y0, 4+Source::y1, 8+Source::y0, 8+Source::y1, 12+Source::y0, 12+Source::y1, 
+											   -128, -128, -128, -128, -128, -128, -128, -128 );
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+	{
+		const __m128i* sourceBlocks = reinterpret_cast<const __m128i*>(sourceRow + x*2);
+		__m128i luma0 = _mm_shuffle_epi8( _mm_loadu_si128( sourceBlocks ), lumaShuffle );
+		__m128i luma1 = _mm_shuffle_epi8( _mm_loadu_si128( sourceBlocks+1 ), lumaShuffle );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(gray8Row + x), _mm_unpacklo_epi64( luma0, luma1 ) );
+	}
+	RGBKernels::convertYUV422RowToGRAY8<source>( sourceRow + numVectorPixels*2, gray8Row + numVectorPixels, width - numVectorPixels );
+}
+
+// The shuffle moving the red, green and blue bytes of 4 pixels of an RGB encoding to the first 
+// three bytes of 4-byte slots, the fourth one being zeroed
+template<ImageFormat::Encoding source>
+inline __m128i getRGB0Shuffle()
+{
+	typedef RGBLayout<source> Source;
+	const char n = Source::numBytes;
+	return _mm_setr_epi8( Source::red, Source::green, Source::blue, -128, n+Source::red, n+Source::green, n+Source::blue, -128, 
+						  2*n+Source::red, 2*n+Source::green, 2*n+Source::blue, -128, 3*n+Source::red, 3*n+Source::green, 3*n+Source::blue, -128 );
+}
+
+// The coefficients of the RGB to YUV conversion (see YUVCoefficients), repeated as c0, c1, c2, 0 
+// for getWeightedSums4(), set up once per row
+inline __m128i setTriplets( short c0, short c1, short c2 )
+{
+	return _mm_setr_epi16( c0, c1, c2, 0, c0, c1, c2, 0 );
+}
+
+struct RGBToYUVVectors
+{
+	RGBToYUVVectors( const YUVCoefficients& coefficients )
+		: y( setTriplets( coefficients.redToY, coefficients.greenToY, coefficients.blueToY ) ),
+		  u( setTriplets( coefficients.redToU, coefficients.greenToU, coefficients.blueToU ) ),
+		  v( setTriplets( coefficients.redToV, coefficients.greenToV, coefficients.blueToV ) ),
+		  yOffset( _mm_set1_epi16( coefficients.yOffset ) )
+	{
+	}
+	__m128i y;
+	__m128i u;
+	__m128i v;
+	__m128i yOffset;
+};
+
+// The ( c0*R + c1*G + c2*B + 128 ) >> 8 sums of the scalar code, for 4 pixels laid out by 
+// getRGB0Shuffle(). One multiply-add gives (c0*R + c1*G) and c2*B for each pixel, the 
+// horizontal add finishes the sums
+inline __m128i getWeightedSums4( __m128i rgb0, __m128i coefficients )
+{
+	__m128i low = _mm_madd_epi16( _mm_unpacklo_epi8( rgb0, _mm_setzero_si128() ), coefficients );
+	__m128i high = _mm_madd_epi16( _mm_unpackhi_epi8( rgb0, _mm_setzero_si128() ), coefficients );
+	return _mm_srai_epi32( _mm_add_epi32( _mm_hadd_epi32( low, high ), _mm_set1_epi32( 128 ) ), 8 );
+}
+
+// Converts 16 pixels of any RGB encoding: returns their luma, and gives the sums of the U and 
+// of the V of each pair of pixels, for the callers to average. The 3-byte pixels only use 12 
+// of the 16 bytes of the last load, so 2 more pixels must be readable
+template<ImageFormat::Encoding source>
+inline __m128i convertRGBPixels16( const unsigned char* sourceBytes, __m128i shuffle, const RGBToYUVVectors& vectors, __m128i uPairSums[2], __m128i vPairSums[2] )
+{
+	typedef RGBLayout<source> Source;
+
+	__m128i y[4], u[4], v[4];
+	for ( unsigned int i=0; i<4; ++i )
+	{
+		__m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceBytes + i*4*Source::numBytes) );
+		__m128i rgb0 = _mm_shuffle_epi8( pixels, shuffle );
+		y[i] = getWeightedSums4( rgb0, vectors.y );
+		u[i] = getWeightedSums4( rgb0, vectors.u );
+		v[i] = getWeightedSums4( rgb0, vectors.v );
+	}
+	uPairSums[0] = _mm_hadd_epi32( u[0], u[1] );
+	uPairSums[1] = _mm_hadd_epi32( u[2], u[3] );
+	vPairSums[0] = _mm_hadd_epi32( v[0], v[1] );
+	vPairSums[1] = _mm_hadd_epi32( v[2], v[3] );
+	return _mm_packus_epi16( _mm_add_epi16( _mm_packs_epi32( y[0], y[1] ), vectors.yOffset ), _mm_add_epi16( _mm_packs_epi32( y[2], y[3] ), vectors.yOffset ) );
+}
+
+// Averages 8 chroma sums of 2^shift values each, rounding up like the scalar code, 
+// and packs them with saturation: the 8 U bytes first, then the 8 V bytes
+template<int shift>
+inline __m128i averageChroma8( const __m128i uSums[2], const __m128i vSums[2] )
+{
+	const __m128i rounding = _mm_set1_epi32( 1 << (shift-1) );
+	const __m128i offset = _mm_set1_epi16( 128 );
+	__m128i u = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( uSums[0], rounding ), shift ), _mm_srai_epi32( _mm_add_epi32( uSums[1], rounding ), shift ) );
+	__m128i v = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( vSums[0], rounding ), shift ), _mm_srai_epi32( _mm_add_epi32( vSums[1], rounding ), shift ) );
+	return _mm_packus_epi16( _mm_add_epi16( u, offset ), _mm_add_epi16( v, offset ) );
+}
+
+// 16 pixels per iteration, computing the same fixed-point luma as the scalar code
+template<ImageFormat::Encoding source>
+void convertRGBRowToGRAY8( const unsigned char* sourceRow, unsigned char* gray8Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m128i shuffle = getRGB0Shuffle<source>();
+	const __m128i yCoefficients = setTriplets( coefficients.redToY, coefficients.greenToY, coefficients.blueToY );
+	const __m128i offset = _mm_set1_epi16( coefficients.yOffset );
+
+	// The 3-byte pixels only use 12 of the 16 bytes of the last load, so the loop stops early 
+	// enough for them to stay within the row
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 18 : 16;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=16 )
+	{
+		__m128i sums[4];
+		for ( unsigned int i=0; i<4; ++i )
+		{
+			__m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>(sourceRow + (x+i*4)*Source::numBytes) );
+			sums[i] = getWeightedSums4( _mm_shuffle_epi8( pixels, shuffle ), yCoefficients );
+		}
+		__m128i luma0 = _mm_add_epi16( _mm_packs_epi32( sums[0], sums[1] ), offset );
+		__m128i luma1 = _mm_add_epi16( _mm_packs_epi32( sums[2], sums[3] ), offset );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(gray8Row + x), _mm_packus_epi16( luma0, luma1 ) );
+	}
+	RGBKernels::convertRGBRowToGRAY8<source>( sourceRow + x*Source::numBytes, gray8Row + x, width - x, coefficients );
+}
+
+// Reorders the bytes of YUYV macroblocks into the ones of another packed 4:2:2 encoding
+template<ImageFormat::Encoding destination>
+inline __m128i getYUYVToYUV422Shuffle()
+{
+	typedef YUV422Layout<destination> Destination;
+	char indices[16];
+	for ( char i=0; i<16; i+=4 )
+	{
+		indices[i+Destination::y0] = i;
+		indices[i+Destination::u] = i+1;
+		indices[i+Destination::y1] = i+2;
+		indices[i+Destination::v] = i+3;
+	}
+	return _mm_loadu_si128( reinterpret_cast<const __m128i*>(indices) );
+}
+
+// 16 pixels per iteration, the chroma of each pair of pixels is averaged
+template<ImageFormat::Encoding source, ImageFormat::Encoding destination>
+void convertRGBRowToYUV422( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m128i shuffle = getRGB0Shuffle<source>();
+	const RGBToYUVVectors vectors( coefficients );
+	const __m128i destinationShuffle = getYUYVToYUV422Shuffle<destination>();
+
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 18 : 16;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=16 )
+	{
+		__m128i uPairSums[2], vPairSums[2];
+		__m128i luma = convertRGBPixels16<source>( sourceRow + x*Source::numBytes, shuffle, vectors, uPairSums, vPairSums );
+		__m128i chroma = averageChroma8<1>( uPairSums, vPairSums );
+		__m128i uv = _mm_unpacklo_epi8( chroma, _mm_srli_si128( chroma, 8 ) );
+		__m128i* destinationBlocks = reinterpret_cast<__m128i*>(destinationRow + x*2);
+		_mm_storeu_si128( destinationBlocks, _mm_shuffle_epi8( _mm_unpacklo_epi8( luma, uv ), destinationShuffle ) );
+		_mm_storeu_si128( destinationBlocks+1, _mm_shuffle_epi8( _mm_unpackhi_epi8( luma, uv ), destinationShuffle ) );
+	}
+	RGBKernels::convertRGBRowToYUV422<source, destination>( sourceRow + x*Source::numBytes, destinationRow + x*2, width - x, coefficients );
+}
+
+// 16 pixels of both rows per iteration, the chroma of each 2x2 block is averaged. 
+// The chroma step is 2 for NV12 (the interleaved U and V bytes) and 1 for I420
+template<ImageFormat::Encoding source, unsigned int chromaStep>
+void convertRGBRowPairToYUV420( const unsigned char* sourceRow0, const unsigned char* sourceRow1, unsigned char* yRow0, unsigned char* yRow1, 
+								unsigned char* uRow, unsigned char* vRow, unsigned int width, const YUVCoefficients& coefficients )
+{
+	typedef RGBLayout<source> Source;
+	const __m128i shuffle = getRGB0Shuffle<source>();
+	const RGBToYUVVectors vectors( coefficients );
+
+	const unsigned int numPixelsPerIteration = Source::numBytes==3 ? 18 : 16;
+	unsigned int x = 0;
+	for ( ; x+numPixelsPerIteration<=width; x+=16 )
+	{
+		__m128i uPairSums0[2], vPairSums0[2], uPairSums1[2], vPairSums1[2];
+		__m128i luma0 = convertRGBPixels16<source>( sourceRow0 + x*Source::numBytes, shuffle, vectors, uPairSums0, vPairSums0 );
+		__m128i luma1 = convertRGBPixels16<source>( sourceRow1 + x*Source::numBytes, shuffle, vectors, uPairSums1, vPairSums1 );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(yRow0 + x), luma0 );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(yRow1 + x), luma1 );
+
+		__m128i uBlockSums[2] = { _mm_add_epi32( uPairSums0[0], uPairSums1[0] ), _mm_add_epi32( uPairSums0[1], uPairSums1[1] ) };
+		__m128i vBlockSums[2] = { _mm_add_epi32( vPairSums0[0], vPairSums1[0] ), _mm_add_epi32( vPairSums0[1], vPairSums1[1] ) };
+		__m128i chroma = averageChroma8<2>( uBlockSums, vBlockSums );
+		if ( chromaStep==2 )
+		{
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(uRow + x), _mm_unpacklo_epi8( chroma, _mm_srli_si128( chroma, 8 ) ) );
+		}
+		else
+		{
+			_mm_storel_epi64( reinterpret_cast<__m128i*>(uRow + x/2), chroma );
+			_mm_storel_epi64( reinterpret_cast<__m128i*>(vRow + x/2), _mm_srli_si128( chroma, 8 ) );
+		}
+	}
+	RGBKernels::convertRGBRowPairToYUV420<source>( sourceRow0 + x*Source::numBytes, sourceRow1 + x*Source::numBytes, yRow0 + x, yRow1 + x, 
+												   uRow + x/2*chromaStep, vRow + x/2*chromaStep, chromaStep, width - x, coefficients );
+}
+
+struct YUV422RowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertYUV422RowToGRAY8<source>; }
+};
+
+struct RGBRowToGRAY8Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowToGRAY8<source>; }
+};
+
+template<ImageFormat::Encoding source>
+struct RGBRowToYUV422Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	template<ImageFormat::Encoding destination> Result select() const { return convertRGBRowToYUV422<source, destination>; }
+};
+
+struct RGBToYUV422SourceSelector
+{
+	typedef ImageConverterKernels::ConvertColorRowFunction Result;
+	RGBToYUV422SourceSelector( ImageFormat::Encoding yuv422Encoding ) : mYUV422Encoding(yuv422Encoding) {}
+	template<ImageFormat::Encoding source> Result select() const { return selectYUV422Encoding( RGBRowToYUV422Selector<source>(), mYUV422Encoding ); }
+	ImageFormat::Encoding mYUV422Encoding;
+};
+
+struct RGBRowPairToNV12Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 2>; }
+};
+
+struct RGBRowPairToI420Selector
+{
+	typedef ImageConverterKernels::ConvertColorRowPairToYUV420Function Result;
+	template<ImageFormat::Encoding source> Result select() const { return convertRGBRowPairToYUV420<source, 1>; }
+};
+
+// Swaps the first and third bytes of 16 3-byte pixels (48 bytes). As the pixels straddle the 
+// 16-byte blocks, the bytes crossing a block boundary come from the neighbouring block.
+// All the blocks are loaded before anything is stored, so the swap can be done in place
+inline void swapFirstAndThirdBytes16( const unsigned char* source, unsigned char* destination )
+{
+	const __m128i shuffle00 = _mm_setr_epi8( 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, -128 );
+	const __m128i shuffle01 = _mm_setr_epi8( -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 1 );
+	const __m128i shuffle10 = _mm_setr_epi8( -128, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 );
+	const __m128i shuffle11 = _mm_setr_epi8( 0, -128, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, -128, 15 );
+	const __m128i shuffle12 = _mm_setr_epi8( -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, -128 );
+	const __m128i shuffle21 = _mm_setr_epi8( 14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 );
+	const __m128i shuffle22 = _mm_setr_epi8( -128, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13 );
+
+	const __m128i* sourceBlocks = reinterpret_cast<const __m128i*>(source);
+	__m128i block0 = _mm_loadu_si128( sourceBlocks );
+	__m128i block1 = _mm_loadu_si128( sourceBlocks+1 );
+	__m128i block2 = _mm_loadu_si128( sourceBlocks+2 );
+	
+	__m128i* destinationBlocks = reinterpret_cast<__m128i*>(destination);
+	_mm_storeu_si128( destinationBlocks, _mm_or_si128( _mm_shuffle_epi8( block0, shuffle00 ), _mm_shuffle_epi8( block1, shuffle01 ) ) );
+	_mm_storeu_si128( destinationBlocks+1, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( block0, shuffle10 ), _mm_shuffle_epi8( block1, shuffle11 ) ), _mm_shuffle_epi8( block2, shuffle12 ) ) );
+	_mm_storeu_si128( destinationBlocks+2, _mm_or_si128( _mm_shuffle_epi8( block1, shuffle21 ), _mm_shuffle_epi8( block2, shuffle22 ) ) );
+}
+
+// Sums the samples of two source rows for 16 destination samples, with their pair of weights. 
+// The bytes of both rows are interleaved so each multiply-add takes one sample of each
+inline void scaleColumnPair16( const unsigned char* samples0, const unsigned char* samples1, __m128i pairWeights, __m128i sums[4] )
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i row0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples0) );
+	__m128i row1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples1) );
+	__m128i low = _mm_unpacklo_epi8( row0, row1 );
+	__m128i high = _mm_unpackhi_epi8( row0, row1 );
+	sums[0] = _mm_add_epi32( sums[0], _mm_madd_epi16( _mm_unpacklo_epi8( low, zero ), pairWeights ) );
+	sums[1] = _mm_add_epi32( sums[1], _mm_madd_epi16( _mm_unpackhi_epi8( low, zero ), pairWeights ) );
+	sums[2] = _mm_add_epi32( sums[2], _mm_madd_epi16( _mm_unpacklo_epi8( high, zero ), pairWeights ) );
+	sums[3] = _mm_add_epi32( sums[3], _mm_madd_epi16( _mm_unpackhi_epi8( high, zero ), pairWeights ) );
+}
+
+// The taps of a destination sample, as 4 partial 32-bit sums. numTaps is a multiple of 4
+inline __m128i sumTaps( const short* samples, const short* weights, unsigned int numTaps )
+{
+	__m128i sum = _mm_setzero_si128();
+	unsigned int tap = 0;
+	for ( ; tap+8<=numTaps; tap+=8 )
+	{
+		__m128i products = _mm_madd_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>(samples + tap) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>(weights + tap) ) );
+		sum = _mm_add_epi32( sum, products );
+	}
+	if ( tap<numTaps )
+	{
+		__m128i products = _mm_madd_epi16( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(samples + tap) ), _mm_loadl_epi64( reinterpret_cast<const __m128i*>(weights + tap) ) );
+		sum = _mm_add_epi32( sum, products );
+	}
+	return sum;
+}
+
+// The 4 destination samples from x, rounded back to 8 bits of precision on 32 bits
+inline __m128i scaleRow4( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned int x )
+{
+	const int shift = ImageConverterKernels::scaleWeightBits + ImageConverterKernels::scaleExtraBits;
+	const __m128i rounding = _mm_set1_epi32( 1 << (shift-1) );
+	weights += x*numTaps;
+	__m128i sums01 = _mm_hadd_epi32( sumTaps( sourceRow + firstIndices[x], weights, numTaps ), sumTaps( sourceRow + firstIndices[x+1], weights + numTaps, numTaps ) );
+	__m128i sums23 = _mm_hadd_epi32( sumTaps( sourceRow + firstIndices[x+2], weights + 2*numTaps, numTaps ), sumTaps( sourceRow + firstIndices[x+3], weights + 3*numTaps, numTaps ) );
+	return _mm_srai_epi32( _mm_add_epi32( _mm_hadd_epi32( sums01, sums23 ), rounding ), shift );
+}
+
+}
+
+void ImageConverterKernels::convertYUYVRowToRGB24SSSE3( const unsigned char* yuyvRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::RGB24>( yuyvRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertYUYVRowToBGR24SSSE3( const unsigned char* yuyvRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertYUV422Row<ImageFormat::YUYV, ImageFormat::BGR24>( yuyvRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::swapFirstAndThirdBytesRowSSSE3( const unsigned char* sourceRow, unsigned char* destinationRow, unsigned int width )
+{
+	unsigned int numVectorPixels = width & ~15u;
+	for ( unsigned int x=0; x<numVectorPixels; x+=16 )
+		swapFirstAndThirdBytes16( sourceRow + x*3, destinationRow + x*3 );
+	swapFirstAndThirdBytesRow( sourceRow + numVectorPixels*3, destinationRow + numVectorPixels*3, width - numVectorPixels );
+}
+
+void ImageConverterKernels::convertNV12RowToRGB24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToBGR24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertNV12RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertNV12RowToYUYVSSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertNV12Row<ImageFormat::YUYV>( yRow, uRow, yuyvRow, width, YUYV16Store<ImageFormat::YUYV>() );
+	convertNV12RowToYUYV( yRow + x, uRow + x, vRow + x, yuyvRow + x*2, width - x );
+}
+
+void ImageConverterKernels::convertI420RowToRGB24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* rgb24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::RGB24>( yRow, uRow, vRow, rgb24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToBGR24SSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* bgr24Row, unsigned int width, const YUVCoefficients& coefficients )
+{
+	convertI420RowToRGB<ImageFormat::BGR24>( yRow, uRow, vRow, bgr24Row, width, coefficients );
+}
+
+void ImageConverterKernels::convertI420RowToYUYVSSSE3( const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* yuyvRow, unsigned int width )
+{
+	unsigned int x = convertI420Row<ImageFormat::YUYV>( yRow, uRow, vRow, yuyvRow, width, YUYV16Store<ImageFormat::YUYV>() );
+	convertI420RowToYUYV( yRow + x, uRow + x/2, vRow + x/2, yuyvRow + x*2, width - x );
+}
+
+// The taps go by pairs, an odd last one being paired with itself and a zero weight. With 
+// at least 16 samples, the last block overlaps the previous one rather than going scalar
+void ImageConverterKernels::scaleColumnsSSSE3( const unsigned char* const sourceRows[], const short* weights, unsigned int numTaps, short* destinationRow, unsigned int numSamples )
+{
+	if ( numSamples<16 )
+	{
+		scaleColumns( sourceRows, weights, numTaps, destinationRow, numSamples );
+		return;
+	}
+
+	const int shift = scaleWeightBits - scaleExtraBits;
+	const __m128i rounding = _mm_set1_epi32( 1 << (shift-1) );
+	for ( unsigned int x=0; x<numSamples; x+=16 )
+	{
+		if ( x+16>numSamples )
+			x = numSamples - 16;
+		__m128i sums[4] = { rounding, rounding, rounding, rounding };
+		for ( unsigned int tap=0; tap<numTaps; tap+=2 )
+		{
+			if ( tap+1<numTaps )
+				scaleColumnPair16( sourceRows[tap] + x, sourceRows[tap+1] + x, setPairs( weights[tap], weights[tap+1] ), sums );
+			else
+				scaleColumnPair16( sourceRows[tap] + x, sourceRows[tap] + x, setPairs( weights[tap], 0 ), sums );
+		}
+		__m128i* destination = reinterpret_cast<__m128i*>(destinationRow + x);
+		_mm_storeu_si128( destination, _mm_packs_epi32( _mm_srai_epi32( sums[0], shift ), _mm_srai_epi32( sums[1], shift ) ) );
+		_mm_storeu_si128( destination+1, _mm_packs_epi32( _mm_srai_epi32( sums[2], shift ), _mm_srai_epi32( sums[3], shift ) ) );
+	}
+}
+
+void ImageConverterKernels::scaleRowSSSE3( const short* sourceRow, const unsigned int* firstIndices, const short* weights, unsigned int numTaps, unsigned char* destinationRow, unsigned int width )
+{
+	unsigned int numVectorSamples = width & ~7u;
+	for ( unsigned int x=0; x<numVectorSamples; x+=8 )
+	{
+		__m128i samples = _mm_packs_epi32( scaleRow4( sourceRow, firstIndices, weights, numTaps, x ), scaleRow4( sourceRow, firstIndices, weights, numTaps, x+4 ) );
+		_mm_storel_epi64( reinterpret_cast<__m128i*>(destinationRow + x), _mm_packus_epi16( samples, samples ) );
+	}
+	unsigned int x = numVectorSamples;
+	scaleRow( sourceRow, firstIndices + x, weights + x*numTaps, numTaps, destinationRow + x, width - x );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertRGBRowFunctionSSSE3( ImageFormat::Encoding sourceEncoding, ImageFormat::Encoding destinationEncoding )
+{
+	return selectRGBEncoding( RGBSourceSelector( destinationEncoding ), sourceEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertYUV422RowToRGBFunctionSSSE3( ImageFormat::Encoding yuv422Encoding, ImageFormat::Encoding rgbEncoding )
+{
+	return selectYUV422Encoding( YUV422SourceSelector( rgbEncoding ), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertNV12RowToRGBFunctionSSSE3( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( NV12RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertYUV420ColorRowFunction ImageConverterKernels::getConvertI420RowToRGBFunctionSSSE3( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( I420RowToRGBSelector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertRowFunction ImageConverterKernels::getConvertYUV422RowToGRAY8FunctionSSSE3( ImageFormat::Encoding yuv422Encoding )
+{
+	return selectYUV422Encoding( YUV422RowToGRAY8Selector(), yuv422Encoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToGRAY8FunctionSSSE3( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowToGRAY8Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowFunction ImageConverterKernels::getConvertRGBRowToYUV422FunctionSSSE3( ImageFormat::Encoding rgbEncoding, ImageFormat::Encoding yuv422Encoding )
+{
+	return selectRGBEncoding( RGBToYUV422SourceSelector( yuv422Encoding ), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToNV12FunctionSSSE3( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToNV12Selector(), rgbEncoding );
+}
+
+ImageConverterKernels::ConvertColorRowPairToYUV420Function ImageConverterKernels::getConvertRGBRowPairToI420FunctionSSSE3( ImageFormat::Encoding rgbEncoding )
+{
+	return selectRGBEncoding( RGBRowPairToI420Selector(), rgbEncoding );
+}
+
+}
+
+#endif
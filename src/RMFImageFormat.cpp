@@ -33,6 +33,18 @@ unsigned int ImageFormat::mEncodingBitsPerPixel[EncodingCount] =
 {
 	24,
 	24,
+	16,
+	12,
+	12,
+	12,
+	32,
+	32,
+	32,
+	32,
+	16,
+	16,
+	16,
+	8,
 	16
 };
 
@@ -40,21 +52,56 @@ const char* ImageFormat::mEncodingNames[EncodingCount] =
 {
 	"RGB24",
 	"BGR24",
-	"YUYV"	
+	"YUYV",
+	"NV12",
+	"I420",
+	"YV12",
+	"RGBA32",
+	"BGRA32",
+	"ARGB32",
+	"BGRX32",
+	"UYVY",
+	"YVYU",
+	"VYUY",
+	"GRAY8",
+	"GRAY16"
+};
+
+const char* ImageFormat::mColorMatrixNames[ColorMatrixCount] = 
+{
+	"BT.601",
+	"BT.709",
+	"BT.2020"
+};
+
+const char* ImageFormat::mColorRangeNames[ColorRangeCount] = 
+{
+	"limited range",
+	"full range"
 };
 	
 ImageFormat::ImageFormat()
 	: mWidth(0), 
 	  mHeight(0), 
-	  mEncoding(RGB24)
+	  mEncoding(RGB24),
+	  mColorMatrix(BT601),
+	  mColorRange(LimitedRange)
 {
 }
 
-ImageFormat::ImageFormat( unsigned int width, unsigned int height, Encoding encoding )
+ImageFormat::ImageFormat( unsigned int width, unsigned int height, Encoding encoding, ColorMatrix colorMatrix, ColorRange colorRange )
 	: mWidth(width), 
 	  mHeight(height), 
-	  mEncoding(encoding)
+	  mEncoding(encoding),
+	  mColorMatrix(colorMatrix),
+	  mColorRange(colorRange)
 {
+	// So that two RGB formats of the same encoding and size are equal
+	if ( isRGB() )
+	{
+		mColorMatrix = BT601;
+		mColorRange = LimitedRange;
+	}
 }
 
 unsigned int ImageFormat::getNumBitsPerPixel( Encoding encoding )
@@ -71,9 +118,102 @@ const char* ImageFormat::getEncodingName( Encoding encoding )
 	return mEncodingNames[encoding];
 }
 
+const char* ImageFormat::getColorMatrixName( ColorMatrix colorMatrix )
+{
+	if ( colorMatrix>=ColorMatrixCount )
+		return "Unknown";
+	return mColorMatrixNames[colorMatrix];
+}
+
+const char* ImageFormat::getColorRangeName( ColorRange colorRange )
+{
+	if ( colorRange>=ColorRangeCount )
+		return "Unknown";
+	return mColorRangeNames[colorRange];
+}
+
+unsigned int ImageFormat::getNumPlanes( Encoding encoding )
+{
+	switch ( encoding )
+	{
+		case NV12:
+			return 2;
+		case I420:
+		case YV12:
+			return 3;
+		default:
+			return 1;
+	}
+}
+
+bool ImageFormat::isRGB( Encoding encoding )
+{
+	switch ( encoding )
+	{
+		case RGB24:
+		case BGR24:
+		case RGBA32:
+		case BGRA32:
+		case ARGB32:
+		case BGRX32:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool ImageFormat::isPackedYUV422( Encoding encoding )
+{
+	switch ( encoding )
+	{
+		case YUYV:
+		case UYVY:
+		case YVYU:
+		case VYUY:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool ImageFormat::isGray( Encoding encoding )
+{
+	return encoding==GRAY8 || encoding==GRAY16;
+}
+
+unsigned int ImageFormat::getPlaneNumBytesPerLine( unsigned int plane ) const
+{
+	if ( plane>=getNumPlanes() )
+		return 0;
+	switch ( getEncoding() )
+	{
+		case NV12:
+			return plane==0 ? getWidth() : (getWidth()+1)/2 * 2;
+		case I420:
+		case YV12:
+			return plane==0 ? getWidth() : (getWidth()+1)/2;
+		case YUYV:
+		case UYVY:
+		case YVYU:
+		case VYUY:
+			return (getWidth()+1)/2 * 4;
+		default:
+			return getNumBitsPerPixel()*getWidth()/8;	// Note: rounded to the upper byte?
+	}
+}
+
+unsigned int ImageFormat::getPlaneHeight( unsigned int plane ) const
+{
+	if ( plane>=getNumPlanes() )
+		return 0;
+	return plane==0 ? getHeight() : (getHeight()+1)/2;
+}
+
 unsigned int ImageFormat::getDataSizeInBytes() const
 {
-	unsigned int size = getHeight() * getNumBytesPerLine();
+	unsigned int size = 0;
+	for ( unsigned int plane=0; plane<getNumPlanes(); ++plane )
+		size += getPlaneHeight(plane) * getPlaneNumBytesPerLine(plane);
 	return size;
 }
 
@@ -81,7 +221,9 @@ bool ImageFormat::operator==( const ImageFormat& other ) const
 {
 	return	mWidth == other.mWidth && 
 			mHeight == other.mHeight &&
-			mEncoding == other.mEncoding;
+			mEncoding == other.mEncoding &&
+			mColorMatrix == other.mColorMatrix &&
+			mColorRange == other.mColorRange;
 }
 
 bool ImageFormat::operator!=( const ImageFormat& other ) const
@@ -93,6 +235,8 @@ std::string ImageFormat::toString() const
 {
 	std::stringstream stream;
 	stream << getWidth() << "x" << getHeight() << " pixels, " << getEncodingName() << " encoding";
+	if ( getColorMatrix()!=BT601 || getColorRange()!=LimitedRange )
+		stream << ", " << getColorMatrixName( getColorMatrix() ) << " " << getColorRangeName( getColorRange() );
 	return stream.str();
 }
 
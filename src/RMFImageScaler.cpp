@@ -0,0 +1,466 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageScaler.h"
+
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <list>
+#include "RMFCriticalSection.h"
+#include "RMFCriticalSectionEnterer.h"
+
+namespace RMF
+{
+
+namespace
+{
+
+// sinc(x)*sinc(x/3), the 3-lobe Lanczos window
+double lanczos3( double x )
+{
+	const double pi = 3.14159265358979323846;
+	if ( fabs(x)>=3 )
+		return 0;
+	if ( fabs(x)<1e-9 )
+		return 1;
+	double piX = pi * x;
+	return 3 * sin(piX) * sin(piX/3) / (piX*piX);
+}
+
+}
+
+/*
+	ImageScaler::Coefficients
+*/
+ImageScaler::Coefficients::Coefficients( unsigned int sourceSize, unsigned int destinationSize, double scale, Filter filter, unsigned int tapAlignment )
+	: sourceSize(sourceSize),
+	  destinationSize(destinationSize),
+	  scale(scale),
+	  filter(filter),
+	  tapAlignment(tapAlignment),
+	  numTaps(0)
+{
+	assert( sourceSize>0 && tapAlignment>0 );
+
+	// The weights of each destination sample, from the first source sample it reads. 
+	// The scale is the number of source samples per destination sample
+	std::vector<unsigned int> firsts( destinationSize );
+	std::vector< std::vector<double> > sampleWeights( destinationSize );
+	int lastIndex = static_cast<int>(sourceSize) - 1;
+	unsigned int numFilterTaps = 0;
+	for ( unsigned int i=0; i<destinationSize; ++i )
+	{
+		std::vector<double>& samples = sampleWeights[i];
+		if ( filter==BoxFilter )
+		{
+			// The destination sample covers [start, end) in the source
+			double start = i * scale;
+			double end = (i+1) * scale;
+			int first = std::min( static_cast<int>( floor(start) ), lastIndex );
+			int last = std::max( std::min( static_cast<int>( ceil(end) ) - 1, lastIndex ), first );
+			firsts[i] = first;
+			for ( int j=first; j<=last; ++j )
+				samples.push_back( std::max( std::min( end, j+1.0 ) - std::max( start, static_cast<double>(j) ), 0.0 ) );
+		}
+		else if ( filter==NearestFilter )
+		{
+			firsts[i] = std::min( static_cast<int>( floor( (i+0.5) * scale ) ), lastIndex );
+			samples.push_back( 1.0 );
+		}
+		else if ( filter==LanczosFilter )
+		{
+			// Around the center of the destination sample, stretched when downscaling so it 
+			// covers all the source samples. The taps past the edges weigh on the edge samples
+			double stretch = std::max( scale, 1.0 );
+			double center = (i+0.5) * scale - 0.5;
+			int start = static_cast<int>( ceil( center - 3*stretch ) );
+			int end = static_cast<int>( floor( center + 3*stretch ) );
+			int first = std::min( std::max( start, 0 ), lastIndex );
+			int last = std::min( std::max( end, 0 ), lastIndex );
+			firsts[i] = first;
+			samples.assign( last - first + 1, 0.0 );
+			for ( int j=start; j<=end; ++j )
+				samples[ std::min( std::max( j, first ), last ) - first ] += lanczos3( (j-center) / stretch );
+		}
+		else
+		{
+			// The two source samples around the center of the destination sample
+			double center = (i+0.5) * scale - 0.5;
+			int first = static_cast<int>( floor(center) );
+			double fraction = center - first;
+			if ( first<0 )
+			{
+				firsts[i] = 0;
+				samples.push_back( 1.0 );
+			}
+			else if ( first>=lastIndex )
+			{
+				firsts[i] = lastIndex;
+				samples.push_back( 1.0 );
+			}
+			else
+			{
+				firsts[i] = first;
+				samples.push_back( 1.0-fraction );
+				samples.push_back( fraction );
+			}
+		}
+		numFilterTaps = std::max( numFilterTaps, static_cast<unsigned int>( samples.size() ) );
+	}
+	numTaps = (numFilterTaps + tapAlignment - 1) / tapAlignment * tapAlignment;
+
+	// Each destination sample gets numTaps fixed-point weights summing to 1<<weightBits. 
+	// The rounding error goes to the largest one. The samples near the end of the source 
+	// start earlier, with zero weights, so that the filter's taps don't read past it
+	const int one = 1 << weightBits;
+	firstIndices.resize( destinationSize );
+	weights.assign( destinationSize * numTaps, 0 );
+	for ( unsigned int i=0; i<destinationSize; ++i )
+	{
+		const std::vector<double>& samples = sampleWeights[i];
+		unsigned int shift = 0;
+		if ( firsts[i]+numFilterTaps>sourceSize )
+			shift = firsts[i] + numFilterTaps - sourceSize;
+		firstIndices[i] = firsts[i] - shift;
+
+		double sum = 0;
+		for ( std::size_t j=0; j<samples.size(); ++j )
+			sum += samples[j];
+		if ( sum<=0 )
+			sum = 1;
+
+		short* sampleFixedWeights = &weights[i*numTaps + shift];
+		int fixedSum = 0;
+		std::size_t largest = 0;
+		for ( std::size_t j=0; j<samples.size(); ++j )
+		{
+			sampleFixedWeights[j] = static_cast<short>( floor( samples[j] / sum * one + 0.5 ) );
+			fixedSum += sampleFixedWeights[j];
+			if ( samples[j]>samples[largest] )
+				largest = j;
+		}
+		sampleFixedWeights[largest] = static_cast<short>( sampleFixedWeights[largest] + one - fixedSum );
+	}
+}
+
+bool ImageScaler::Coefficients::matches( unsigned int otherSourceSize, unsigned int otherDestinationSize, double otherScale, Filter otherFilter, unsigned int otherTapAlignment ) const
+{
+	return sourceSize==otherSourceSize && destinationSize==otherDestinationSize && scale==otherScale && 
+		   filter==otherFilter && tapAlignment==otherTapAlignment;
+}
+
+/*
+	ImageScaler
+*/
+const char* ImageScaler::mFilterNames[FilterCount] = 
+{
+	"Box",
+	"Bilinear",
+	"Nearest",
+	"Lanczos"
+};
+
+ImageScaler::ImageScaler( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, Filter filter, ImageConverterKernels::InstructionSet instructionSet )
+	: mSourceFormat(sourceFormat),
+	  mDestinationFormat(destinationFormat),
+	  mFilter(filter),
+	  mScaleColumns( ImageConverterKernels::getScaleColumnsFunction( instructionSet ) ),
+	  mScaleRow( ImageConverterKernels::getScaleRowFunction( instructionSet ) )
+{
+	if ( !mScaleColumns || !mScaleRow )
+	{
+		mScaleColumns = ImageConverterKernels::scaleColumns;
+		mScaleRow = ImageConverterKernels::scaleRow;
+	}
+	if ( !canScale( sourceFormat, destinationFormat ) )
+		return;
+
+	// The subsampled components are scaled by the same factor as the others. The rows 
+	// are padded for the row kernels
+	double horizontalScale = static_cast<double>( sourceFormat.getWidth() ) / destinationFormat.getWidth();
+	double verticalScale = static_cast<double>( sourceFormat.getHeight() ) / destinationFormat.getHeight();
+	Component components[maxNumComponents];
+	unsigned int numComponents = getComponents( sourceFormat.getEncoding(), components );
+	for ( unsigned int i=0; i<numComponents; ++i )
+	{
+		const Component& component = components[i];
+		std::shared_ptr<const Coefficients>& horizontal = mHorizontalCoefficients[ component.isHorizontallySubsampled ? 1 : 0 ];
+		if ( !horizontal )
+			horizontal = getCoefficients( getComponentWidth( sourceFormat, component ), getComponentWidth( destinationFormat, component ), horizontalScale, filter, ImageConverterKernels::scaleRowTapAlignment );
+		std::shared_ptr<const Coefficients>& vertical = mVerticalCoefficients[ component.isVerticallySubsampled ? 1 : 0 ];
+		if ( !vertical )
+			vertical = getCoefficients( getComponentHeight( sourceFormat, component ), getComponentHeight( destinationFormat, component ), verticalScale, filter, 1 );
+	}
+}
+
+const char* ImageScaler::getFilterName( Filter filter )
+{
+	if ( filter>=FilterCount )
+		return "Unknown";
+	return mFilterNames[filter];
+}
+
+bool ImageScaler::canScale( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat )
+{
+	if ( sourceFormat.getEncoding()!=destinationFormat.getEncoding() )
+		return false;
+	if ( destinationFormat.getWidth()==0 || destinationFormat.getHeight()==0 )
+		return false;
+
+	// Each component of the source needs a sample
+	Component components[maxNumComponents];
+	unsigned int numComponents = getComponents( sourceFormat.getEncoding(), components );
+	for ( unsigned int i=0; i<numComponents; ++i )
+	{
+		if ( getComponentWidth( sourceFormat, components[i] )==0 || getComponentHeight( sourceFormat, components[i] )==0 )
+			return false;
+	}
+	return true;
+}
+
+void ImageScaler::scale( const ConstImageView& sourceImage, const ImageView& destinationImage, ThreadPool* threadPool, unsigned int minBandHeight ) const
+{
+	unsigned int numRowsPerStep = mSourceFormat.isPlanar() ? 2 : 1;
+	ThreadPool::BandTask scaleBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			scaleRows( sourceImage, destinationImage, firstRow, endRow );
+		};
+	ThreadPool::runBands( threadPool, scaleBand, mDestinationFormat.getHeight(), numRowsPerStep, minBandHeight );
+}
+
+void ImageScaler::scaleRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const
+{
+	assert( canScale( mSourceFormat, mDestinationFormat ) );
+	assert( sourceImage.getFormat().getEncoding()==mSourceFormat.getEncoding() && destinationImage.getFormat().getEncoding()==mDestinationFormat.getEncoding() );
+	assert( sourceImage.getFormat().getWidth()==mSourceFormat.getWidth() && sourceImage.getFormat().getHeight()==mSourceFormat.getHeight() );
+	assert( destinationImage.getFormat().getWidth()==mDestinationFormat.getWidth() && destinationImage.getFormat().getHeight()==mDestinationFormat.getHeight() );
+	assert( endRow<=mDestinationFormat.getHeight() );
+
+	if ( mSourceFormat.getEncoding()==ImageFormat::GRAY16 )
+	{
+		scaleGRAY16Rows( sourceImage, destinationImage, firstRow, endRow );
+		return;
+	}
+	for ( unsigned int plane=0; plane<mSourceFormat.getNumPlanes(); ++plane )
+		scaleBytePlaneRows( sourceImage, destinationImage, plane, firstRow, endRow );
+}
+
+bool ImageScaler::scaleImage( const ConstImageView& sourceImage, const ImageView& destinationImage, Filter filter, ThreadPool* threadPool )
+{
+	if ( !canScale( sourceImage.getFormat(), destinationImage.getFormat() ) )
+		return false;
+
+	ImageScaler scaler( sourceImage.getFormat(), destinationImage.getFormat(), filter );
+	scaler.scale( sourceImage, destinationImage, threadPool );
+	return true;
+}
+
+std::shared_ptr<const ImageScaler::Coefficients> ImageScaler::getCoefficients( unsigned int sourceSize, unsigned int destinationSize, double scale, Filter filter, unsigned int tapAlignment )
+{
+	// From the least to the most recently used. Never destroyed, like the default MemoryBufferPool, 
+	// so scalers can still be created during the static destructions
+	typedef std::list< std::shared_ptr<const Coefficients> > CoefficientsList;
+	static CriticalSection* criticalSection = new CriticalSection();
+	static CoefficientsList* cache = new CoefficientsList();
+
+	CriticalSectionEnterer criticalSectionRAII( *criticalSection );
+	for ( CoefficientsList::iterator itr=cache->begin(); itr!=cache->end(); ++itr )
+	{
+		if ( (*itr)->matches( sourceSize, destinationSize, scale, filter, tapAlignment ) )
+		{
+			cache->splice( cache->end(), *cache, itr );
+			return cache->back();
+		}
+	}
+	cache->push_back( std::make_shared<Coefficients>( sourceSize, destinationSize, scale, filter, tapAlignment ) );
+	if ( cache->size()>maxNumCachedCoefficients )
+		cache->pop_front();
+	return cache->back();
+}
+
+unsigned int ImageScaler::getComponents( ImageFormat::Encoding encoding, Component components[] )
+{
+	// plane, offset, step, horizontally subsampled, vertically subsampled
+	static const Component rgb24[] = { {0, 0, 3, false, false}, {0, 1, 3, false, false}, {0, 2, 3, false, false} };
+	static const Component rgb32[] = { {0, 0, 4, false, false}, {0, 1, 4, false, false}, {0, 2, 4, false, false}, {0, 3, 4, false, false} };
+	static const Component yuyv[] = { {0, 0, 2, false, false}, {0, 1, 4, true, false}, {0, 3, 4, true, false} };
+	static const Component uyvy[] = { {0, 1, 2, false, false}, {0, 0, 4, true, false}, {0, 2, 4, true, false} };
+	static const Component nv12[] = { {0, 0, 1, false, false}, {1, 0, 2, true, true}, {1, 1, 2, true, true} };
+	static const Component i420[] = { {0, 0, 1, false, false}, {1, 0, 1, true, true}, {2, 0, 1, true, true} };
+	static const Component gray[] = { {0, 0, 1, false, false} };
+
+	// YVYU and VYUY only swap the chroma bytes of YUYV and UYVY, which are scaled alike
+	const Component* encodingComponents = NULL;
+	unsigned int numComponents = 0;
+	switch ( encoding )
+	{
+		case ImageFormat::RGB24:	case ImageFormat::BGR24:	encodingComponents = rgb24; numComponents = 3; break;
+		case ImageFormat::RGBA32:	case ImageFormat::BGRA32:
+		case ImageFormat::ARGB32:	case ImageFormat::BGRX32:	encodingComponents = rgb32; numComponents = 4; break;
+		case ImageFormat::YUYV:		case ImageFormat::YVYU:		encodingComponents = yuyv; numComponents = 3; break;
+		case ImageFormat::UYVY:		case ImageFormat::VYUY:		encodingComponents = uyvy; numComponents = 3; break;
+		case ImageFormat::NV12:									encodingComponents = nv12; numComponents = 3; break;
+		case ImageFormat::I420:		case ImageFormat::YV12:		encodingComponents = i420; numComponents = 3; break;
+		case ImageFormat::GRAY8:	case ImageFormat::GRAY16:	encodingComponents = gray; numComponents = 1; break;
+		default: break;
+	}
+	assert( numComponents<=maxNumComponents );
+	std::copy( encodingComponents, encodingComponents+numComponents, components );
+	return numComponents;
+}
+
+unsigned int ImageScaler::getComponentWidth( const ImageFormat& imageFormat, const Component& component )
+{
+	// An odd last pixel has a chroma of its own
+	if ( !component.isHorizontallySubsampled )
+		return imageFormat.getWidth();
+	return (imageFormat.getWidth()+1) / 2;
+}
+
+unsigned int ImageScaler::getComponentHeight( const ImageFormat& imageFormat, const Component& component )
+{
+	if ( !component.isVerticallySubsampled )
+		return imageFormat.getHeight();
+	return (imageFormat.getHeight()+1) / 2;
+}
+
+void ImageScaler::scaleBytePlaneRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int plane, unsigned int firstRow, unsigned int endRow ) const
+{
+	Component components[maxNumComponents];
+	unsigned int numComponents = getComponents( mSourceFormat.getEncoding(), components );
+	bool isVerticallySubsampled = false;
+	unsigned int maxComponentWidth = 0;
+	for ( unsigned int i=0; i<numComponents; ++i )
+	{
+		if ( components[i].plane!=plane )
+			continue;
+		isVerticallySubsampled = components[i].isVerticallySubsampled;
+		maxComponentWidth = std::max( maxComponentWidth, std::max( getComponentWidth( mSourceFormat, components[i] ), getComponentWidth( mDestinationFormat, components[i] ) ) );
+	}
+	if ( isVerticallySubsampled )
+	{
+		firstRow /= 2;
+		endRow = (endRow+1) / 2;
+	}
+
+	// The rows of sums are padded with zeros for the taps the row kernel reads past them
+	const Coefficients& vertical = *mVerticalCoefficients[ isVerticallySubsampled ? 1 : 0 ];
+	unsigned int numSamples = mSourceFormat.getPlaneNumBytesPerLine( plane );
+	const unsigned int padding = ImageConverterKernels::scaleRowTapAlignment;
+	std::vector<short> sums( numSamples + padding );
+	std::vector<short> componentSums( maxComponentWidth + padding );
+	std::vector<unsigned char> componentRow( maxComponentWidth );
+	std::vector<const unsigned char*> sourceRows( vertical.numTaps );
+	std::vector<short> columnWeights( vertical.numTaps );
+	for ( unsigned int y=firstRow; y<endRow; ++y )
+	{
+		// Along the columns first, on whole rows whatever their components, skipping the zero weights
+		unsigned int numTaps = 0;
+		for ( unsigned int tap=0; tap<vertical.numTaps; ++tap )
+		{
+			short weight = vertical.weights[y*vertical.numTaps + tap];
+			if ( weight==0 )
+				continue;
+			sourceRows[numTaps] = sourceImage.getPlaneRow( plane, vertical.firstIndices[y] + tap );
+			columnWeights[numTaps] = weight;
+			numTaps++;
+		}
+		mScaleColumns( sourceRows.data(), columnWeights.data(), numTaps, sums.data(), numSamples );
+
+		// Then along the row, component by component. A component alone in its plane 
+		// is scaled in place, the interleaved ones go through a row of their own
+		unsigned char* destinationRow = destinationImage.getPlaneRow( plane, y );
+		for ( unsigned int i=0; i<numComponents; ++i )
+		{
+			const Component& component = components[i];
+			if ( component.plane!=plane )
+				continue;
+			const Coefficients& horizontal = *mHorizontalCoefficients[ component.isHorizontallySubsampled ? 1 : 0 ];
+			unsigned int width = getComponentWidth( mDestinationFormat, component );
+			if ( component.step==1 )
+			{
+				mScaleRow( sums.data(), horizontal.firstIndices.data(), horizontal.weights.data(), horizontal.numTaps, destinationRow, width );
+				continue;
+			}
+			const unsigned int step = component.step;
+			unsigned int sourceWidth = getComponentWidth( mSourceFormat, component );
+			for ( unsigned int x=0; x<sourceWidth; ++x )
+				componentSums[x] = sums[component.offset + x*step];
+			mScaleRow( componentSums.data(), horizontal.firstIndices.data(), horizontal.weights.data(), horizontal.numTaps, componentRow.data(), width );
+			unsigned char* destination = destinationRow + component.offset;
+			for ( unsigned int x=0; x<width; ++x )
+				destination[x*step] = componentRow[x];
+		}
+
+		// The padding luma of an odd last macroblock repeats the last one, like the conversions
+		if ( mDestinationFormat.isPackedYUV422() && mDestinationFormat.getWidth()%2!=0 )
+		{
+			unsigned int lastLumaOffset = components[0].offset + (mDestinationFormat.getWidth()-1)*components[0].step;
+			destinationRow[lastLumaOffset+components[0].step] = destinationRow[lastLumaOffset];
+		}
+	}
+}
+
+// The little-endian 16-bit samples fill 32-bit sums, with no extra precision
+void ImageScaler::scaleGRAY16Rows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const
+{
+	const Coefficients& vertical = *mVerticalCoefficients[0];
+	const Coefficients& horizontal = *mHorizontalCoefficients[0];
+	unsigned int numSamples = mSourceFormat.getWidth();
+	unsigned int width = mDestinationFormat.getWidth();
+	std::vector<int> sums( numSamples + ImageConverterKernels::scaleRowTapAlignment );
+	for ( unsigned int y=firstRow; y<endRow; ++y )
+	{
+		std::fill( sums.begin(), sums.begin() + numSamples, 0 );
+		for ( unsigned int tap=0; tap<vertical.numTaps; ++tap )
+		{
+			int weight = vertical.weights[y*vertical.numTaps + tap];
+			if ( weight==0 )
+				continue;
+			const unsigned char* sourceRow = sourceImage.getPlaneRow( 0, vertical.firstIndices[y] + tap );
+			for ( unsigned int x=0; x<numSamples; ++x )
+				sums[x] += weight * ( sourceRow[x*2] | (sourceRow[x*2+1] << 8) );
+		}
+		for ( unsigned int x=0; x<numSamples; ++x )
+			sums[x] = ( sums[x] + (1 << (weightBits-1)) ) >> weightBits;
+
+		// In locals, as the bytes written could alias the coefficients
+		unsigned char* destinationRow = destinationImage.getPlaneRow( 0, y );
+		const unsigned int numTaps = horizontal.numTaps;
+		const unsigned int* firstIndices = horizontal.firstIndices.data();
+		const short* weights = horizontal.weights.data();
+		for ( unsigned int x=0; x<width; ++x, weights+=numTaps )
+		{
+			const int* samples = &sums[ firstIndices[x] ];
+			int sum = 0;
+			for ( unsigned int tap=0; tap<numTaps; ++tap )
+				sum += weights[tap] * samples[tap];
+			int value = std::min( std::max( ( sum + (1 << (weightBits-1)) ) >> weightBits, 0 ), 65535 );
+			destinationRow[x*2] = static_cast<unsigned char>(value);
+			destinationRow[x*2+1] = static_cast<unsigned char>(value >> 8);
+		}
+	}
+}
+
+}
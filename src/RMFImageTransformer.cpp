@@ -0,0 +1,387 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageTransformer.h"
+
+#include <assert.h>
+#include <cstring>
+#include <algorithm>
+#include "RMFRGBKernels.h"
+
+namespace RMF
+{
+
+namespace
+{
+
+// Copies a sample of a plane
+template<unsigned int numSampleBytes>
+struct SampleCopier
+{
+	enum { numBytes = numSampleBytes };
+	void operator()( unsigned char* destination, const unsigned char* source ) const		{ memcpy( destination, source, numBytes ); }
+};
+
+// Copies a macroblock of a packed 4:2:2 encoding mirrored horizontally: its two lumas are swapped
+struct MirroredMacroblockCopier
+{
+	enum { numBytes = 4 };
+	MirroredMacroblockCopier( const YUV422Offsets& offsets )
+		: offsets(offsets)
+	{
+	}
+	void operator()( unsigned char* destination, const unsigned char* source ) const
+	{
+		destination[offsets.y0] = source[offsets.y1];
+		destination[offsets.y1] = source[offsets.y0];
+		destination[offsets.u] = source[offsets.u];
+		destination[offsets.v] = source[offsets.v];
+	}
+	YUV422Offsets offsets;
+};
+
+// Copies the destination rows [firstRow, endRow) of a plane, each sample from the source sample at 
+// origin + x*columnStep + y*rowStep. By square tiles when the source is read by columns
+template<class Copier>
+void copyMappedRows( const Copier& copier, const unsigned char* origin, std::ptrdiff_t columnStep, std::ptrdiff_t rowStep, 
+					 const ImageView& destinationImage, unsigned int plane, unsigned int width, unsigned int firstRow, unsigned int endRow )
+{
+	const unsigned int numBytes = Copier::numBytes;
+	bool readsColumns = columnStep!=static_cast<std::ptrdiff_t>(numBytes) && columnStep!=-static_cast<std::ptrdiff_t>(numBytes);
+	unsigned int tileWidth = readsColumns ? static_cast<unsigned int>(ImageTransformer::tileSize) : width;
+	unsigned int tileHeight = readsColumns ? static_cast<unsigned int>(ImageTransformer::tileSize) : 1u;
+	for ( unsigned int tileRow=firstRow; tileRow<endRow; tileRow+=tileHeight )
+	{
+		unsigned int tileEndRow = std::min( tileRow+tileHeight, endRow );
+		for ( unsigned int tileColumn=0; tileColumn<width; tileColumn+=tileWidth )
+		{
+			unsigned int tileEndColumn = std::min( tileColumn+tileWidth, width );
+			for ( unsigned int y=tileRow; y<tileEndRow; ++y )
+			{
+				const unsigned char* source = origin + static_cast<std::ptrdiff_t>(y)*rowStep + static_cast<std::ptrdiff_t>(tileColumn)*columnStep;
+				unsigned char* destination = destinationImage.getPlaneRow( plane, y ) + tileColumn*numBytes;
+				for ( unsigned int x=tileColumn; x<tileEndColumn; ++x, source+=columnStep, destination+=numBytes )
+					copier( destination, source );
+			}
+		}
+	}
+}
+
+// The samples i and width-1-i of the rows swapped, and copied with the copier
+template<class Copier>
+void swapMirroredSamples( const Copier& copier, unsigned char* row0, unsigned char* row1, unsigned int width )
+{
+	const unsigned int numBytes = Copier::numBytes;
+	for ( unsigned int i=0; i<width; ++i )
+	{
+		unsigned int j = width-1-i;
+		if ( row0==row1 && i>j )
+			break;
+		unsigned char sample0[numBytes];
+		unsigned char sample1[numBytes];
+		memcpy( sample0, row0 + i*numBytes, numBytes );
+		memcpy( sample1, row1 + j*numBytes, numBytes );
+		copier( row0 + i*numBytes, sample1 );
+		copier( row1 + j*numBytes, sample0 );
+	}
+}
+
+// Flips the rows and/or the columns of a plane in place
+template<class Copier>
+void flipPlane( const Copier& copier, const ImageView& image, unsigned int plane, unsigned int width, unsigned int height, bool flipsRows, bool flipsColumns )
+{
+	for ( unsigned int y=0; y<height; ++y )
+	{
+		unsigned int otherY = flipsRows ? height-1-y : y;
+		if ( otherY<y )
+			break;
+		unsigned char* row = image.getPlaneRow( plane, y );
+		unsigned char* otherRow = image.getPlaneRow( plane, otherY );
+		if ( flipsColumns )
+			swapMirroredSamples( copier, row, otherRow, width );
+		else if ( otherY!=y )
+			std::swap_ranges( row, row + width*Copier::numBytes, otherRow );
+	}
+}
+
+// The size of the planes in samples, and the size of the samples. The packed 4:2:2 encodings 
+// are handled by macroblocks
+struct PlaneLayout
+{
+	unsigned int	width;
+	unsigned int	height;
+	unsigned int	numBytes;
+};
+
+PlaneLayout getPlaneLayout( const ImageFormat& imageFormat, unsigned int plane )
+{
+	PlaneLayout layout;
+	layout.height = imageFormat.getPlaneHeight( plane );
+	if ( imageFormat.isPackedYUV422() )
+		layout.numBytes = 4;
+	else if ( imageFormat.isPlanar() )
+		layout.numBytes = ( plane>0 && imageFormat.getEncoding()==ImageFormat::NV12 ) ? 2 : 1;
+	else
+		layout.numBytes = imageFormat.getNumBitsPerPixel()/8;
+	layout.width = imageFormat.getPlaneNumBytesPerLine( plane ) / layout.numBytes;
+	return layout;
+}
+
+}
+
+const char* ImageTransformer::mTransformNames[TransformCount] = 
+{
+	"Identity",
+	"FlipHorizontally",
+	"FlipVertically",
+	"Rotate90",
+	"Rotate180",
+	"Rotate270",
+	"Transpose",
+	"Transverse"
+};
+
+const ImageTransformer::Mapping ImageTransformer::mMappings[TransformCount] = 
+{
+	// Origin, column step, row step
+	{ 0, 0,		 1,  0,		 0,  1 },		// Identity
+	{ 1, 0,		-1,  0,		 0,  1 },		// FlipHorizontally
+	{ 0, 1,		 1,  0,		 0, -1 },		// FlipVertically
+	{ 0, 1,		 0, -1,		 1,  0 },		// Rotate90
+	{ 1, 1,		-1,  0,		 0, -1 },		// Rotate180
+	{ 1, 0,		 0,  1,		-1,  0 },		// Rotate270
+	{ 0, 0,		 0,  1,		 1,  0 },		// Transpose
+	{ 1, 1,		 0, -1,		-1,  0 }		// Transverse
+};
+
+ImageTransformer::ImageTransformer( const ImageFormat& sourceFormat, Transform transform )
+	: mSourceFormat(sourceFormat),
+	  mDestinationFormat( getTransformedFormat(sourceFormat, transform) ),
+	  mTransform(transform)
+{
+}
+
+const char* ImageTransformer::getTransformName( Transform transform )
+{
+	if ( transform<0 || transform>=TransformCount )
+		return NULL;
+	return mTransformNames[transform];
+}
+
+bool ImageTransformer::swapsRowsAndColumns( Transform transform )
+{
+	return transform==Rotate90 || transform==Rotate270 || transform==Transpose || transform==Transverse;
+}
+
+ImageFormat ImageTransformer::getTransformedFormat( const ImageFormat& sourceFormat, Transform transform )
+{
+	if ( !swapsRowsAndColumns(transform) )
+		return sourceFormat;
+	return ImageFormat( sourceFormat.getHeight(), sourceFormat.getWidth(), sourceFormat.getEncoding(), sourceFormat.getColorMatrix(), sourceFormat.getColorRange() );
+}
+
+bool ImageTransformer::canTransform( const ImageFormat& sourceFormat, const ImageFormat& destinationFormat, Transform transform )
+{
+	if ( transform<0 || transform>=TransformCount )
+		return false;
+	if ( destinationFormat!=getTransformedFormat( sourceFormat, transform ) )
+		return false;
+
+	// The macroblocks of the packed 4:2:2 encodings are whole, in the source and the destination
+	if ( sourceFormat.isPackedYUV422() )
+		return sourceFormat.getWidth()%2==0 && destinationFormat.getWidth()%2==0;
+	return true;
+}
+
+bool ImageTransformer::canTransformInPlace( const ImageFormat& imageFormat, Transform transform )
+{
+	return !swapsRowsAndColumns( transform ) && canTransform( imageFormat, imageFormat, transform );
+}
+
+void ImageTransformer::transform( const ConstImageView& sourceImage, const ImageView& destinationImage, ThreadPool* threadPool, unsigned int minBandHeight ) const
+{
+	unsigned int numRowsPerStep = mSourceFormat.isPlanar() ? 2 : 1;
+	ThreadPool::BandTask transformBand = [&]( unsigned int firstRow, unsigned int endRow )
+		{
+			transformRows( sourceImage, destinationImage, firstRow, endRow );
+		};
+	ThreadPool::runBands( threadPool, transformBand, mDestinationFormat.getHeight(), numRowsPerStep, minBandHeight );
+}
+
+void ImageTransformer::transformRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const
+{
+	assert( canTransform( mSourceFormat, mDestinationFormat, mTransform ) );
+	assert( sourceImage.getFormat().getEncoding()==mSourceFormat.getEncoding() && destinationImage.getFormat().getEncoding()==mDestinationFormat.getEncoding() );
+	assert( sourceImage.getFormat().getWidth()==mSourceFormat.getWidth() && sourceImage.getFormat().getHeight()==mSourceFormat.getHeight() );
+	assert( destinationImage.getFormat().getWidth()==mDestinationFormat.getWidth() && destinationImage.getFormat().getHeight()==mDestinationFormat.getHeight() );
+	assert( endRow<=mDestinationFormat.getHeight() );
+
+	if ( mDestinationFormat.getWidth()==0 || firstRow>=endRow )
+		return;
+	if ( mSourceFormat.isPackedYUV422() && swapsRowsAndColumns(mTransform) )
+	{
+		transformYUV422Rows( sourceImage, destinationImage, firstRow, endRow );
+		return;
+	}
+	for ( unsigned int plane=0; plane<mSourceFormat.getNumPlanes(); ++plane )
+	{
+		// The chroma planes of the 4:2:0 encodings have a row for two rows of the image
+		if ( plane==0 )
+			transformPlaneRows( sourceImage, destinationImage, plane, firstRow, endRow );
+		else
+			transformPlaneRows( sourceImage, destinationImage, plane, firstRow/2, (endRow+1)/2 );
+	}
+}
+
+bool ImageTransformer::transformImage( const ConstImageView& sourceImage, const ImageView& destinationImage, Transform transform, ThreadPool* threadPool )
+{
+	if ( !canTransform( sourceImage.getFormat(), destinationImage.getFormat(), transform ) )
+		return false;
+
+	// The same pixels
+	if ( sourceImage.getRow(0)==destinationImage.getRow(0) && sourceImage.getFormat().getDataSizeInBytes()>0 )
+		return transformImageInPlace( destinationImage, transform );
+
+	ImageTransformer transformer( sourceImage.getFormat(), transform );
+	transformer.transform( sourceImage, destinationImage, threadPool );
+	return true;
+}
+
+bool ImageTransformer::transformImageInPlace( const ImageView& image, Transform transform )
+{
+	const ImageFormat& imageFormat = image.getFormat();
+	if ( !canTransformInPlace( imageFormat, transform ) )
+		return false;
+	
+	const Mapping& mapping = mMappings[transform];
+	bool flipsRows = mapping.rowStepY<0;
+	bool flipsColumns = mapping.columnStepX<0;
+	for ( unsigned int plane=0; plane<imageFormat.getNumPlanes(); ++plane )
+	{
+		PlaneLayout layout = getPlaneLayout( imageFormat, plane );
+		if ( imageFormat.isPackedYUV422() && flipsColumns )
+			flipPlane( MirroredMacroblockCopier( getYUV422Offsets(imageFormat.getEncoding()) ), image, plane, layout.width, layout.height, flipsRows, flipsColumns );
+		else if ( layout.numBytes==1 )
+			flipPlane( SampleCopier<1>(), image, plane, layout.width, layout.height, flipsRows, flipsColumns );
+		else if ( layout.numBytes==2 )
+			flipPlane( SampleCopier<2>(), image, plane, layout.width, layout.height, flipsRows, flipsColumns );
+		else if ( layout.numBytes==3 )
+			flipPlane( SampleCopier<3>(), image, plane, layout.width, layout.height, flipsRows, flipsColumns );
+		else
+			flipPlane( SampleCopier<4>(), image, plane, layout.width, layout.height, flipsRows, flipsColumns );
+	}
+	return true;
+}
+
+bool ImageTransformer::cropImage( const ConstImageView& sourceImage, unsigned int x, unsigned int y, const ImageView& destinationImage )
+{
+	ImageRegion region( x, y, destinationImage.getFormat().getWidth(), destinationImage.getFormat().getHeight() );
+	if ( !ImageView::isValidRegion( sourceImage.getFormat(), region ) )
+		return false;
+	return destinationImage.copyFrom( sourceImage.getRegion( region ) );
+}
+
+ImageTransformer::PlaneMapping ImageTransformer::getPlaneMapping( const ConstImageView& sourceImage, unsigned int plane, unsigned int width, unsigned int height, unsigned int numBytes ) const
+{
+	const Mapping& mapping = mMappings[mTransform];
+	std::ptrdiff_t sampleStep = static_cast<std::ptrdiff_t>(numBytes);
+	std::ptrdiff_t stride = sourceImage.getPlaneStride( plane );
+	PlaneMapping planeMapping;
+	planeMapping.origin = sourceImage.getPlaneRow( plane, mapping.originY ? height-1 : 0 ) + ( mapping.originX ? width-1 : 0 ) * sampleStep;
+	planeMapping.columnStep = mapping.columnStepX*sampleStep + mapping.columnStepY*stride;
+	planeMapping.rowStep = mapping.rowStepX*sampleStep + mapping.rowStepY*stride;
+	return planeMapping;
+}
+
+void ImageTransformer::transformPlaneRows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int plane, unsigned int firstRow, unsigned int endRow ) const
+{
+	PlaneLayout sourceLayout = getPlaneLayout( mSourceFormat, plane );
+	PlaneLayout destinationLayout = getPlaneLayout( mDestinationFormat, plane );
+	if ( sourceLayout.width==0 || sourceLayout.height==0 )
+		return;
+
+	PlaneMapping mapping = getPlaneMapping( sourceImage, plane, sourceLayout.width, sourceLayout.height, sourceLayout.numBytes );
+	unsigned int width = destinationLayout.width;
+
+	// The rows that aren't mirrored are copied as they are
+	if ( mapping.columnStep==static_cast<std::ptrdiff_t>(sourceLayout.numBytes) )
+	{
+		for ( unsigned int y=firstRow; y<endRow; ++y )
+			memcpy( destinationImage.getPlaneRow(plane, y), mapping.origin + static_cast<std::ptrdiff_t>(y)*mapping.rowStep, width*sourceLayout.numBytes );
+		return;
+	}
+
+	if ( mSourceFormat.isPackedYUV422() )
+	{
+		MirroredMacroblockCopier copier( getYUV422Offsets( mSourceFormat.getEncoding() ) );
+		copyMappedRows( copier, mapping.origin, mapping.columnStep, mapping.rowStep, destinationImage, plane, width, firstRow, endRow );
+	}
+	else if ( sourceLayout.numBytes==1 )
+		copyMappedRows( SampleCopier<1>(), mapping.origin, mapping.columnStep, mapping.rowStep, destinationImage, plane, width, firstRow, endRow );
+	else if ( sourceLayout.numBytes==2 )
+		copyMappedRows( SampleCopier<2>(), mapping.origin, mapping.columnStep, mapping.rowStep, destinationImage, plane, width, firstRow, endRow );
+	else if ( sourceLayout.numBytes==3 )
+		copyMappedRows( SampleCopier<3>(), mapping.origin, mapping.columnStep, mapping.rowStep, destinationImage, plane, width, firstRow, endRow );
+	else
+		copyMappedRows( SampleCopier<4>(), mapping.origin, mapping.columnStep, mapping.rowStep, destinationImage, plane, width, firstRow, endRow );
+}
+
+void ImageTransformer::transformYUV422Rows( const ConstImageView& sourceImage, const ImageView& destinationImage, unsigned int firstRow, unsigned int endRow ) const
+{
+	// The pixels of a destination row come from a column of the source, and each destination 
+	// macroblock from two source rows: the lumas are copied, the chroma is averaged
+	const Mapping& mapping = mMappings[mTransform];
+	YUV422Offsets offsets = getYUV422Offsets( mSourceFormat.getEncoding() );
+	unsigned int sourceWidth = mSourceFormat.getWidth();
+	unsigned int sourceHeight = mSourceFormat.getHeight();
+	const unsigned char* originRow = sourceImage.getRow( mapping.originY ? sourceHeight-1 : 0 );
+	std::ptrdiff_t pixelStep = mapping.columnStepY * static_cast<std::ptrdiff_t>( sourceImage.getStride() );
+	unsigned int numMacroblocks = mDestinationFormat.getWidth()/2;
+	const unsigned int tileNumMacroblocks = tileSize/2;
+	for ( unsigned int tileRow=firstRow; tileRow<endRow; tileRow+=tileSize )
+	{
+		unsigned int tileEndRow = std::min( tileRow+tileSize, endRow );
+		for ( unsigned int tileMacroblock=0; tileMacroblock<numMacroblocks; tileMacroblock+=tileNumMacroblocks )
+		{
+			unsigned int tileEndMacroblock = std::min( tileMacroblock+tileNumMacroblocks, numMacroblocks );
+			for ( unsigned int y=tileRow; y<tileEndRow; ++y )
+			{
+				unsigned int sourceX = mapping.originX ? sourceWidth-1-y : y;
+				const unsigned char* sourceMacroblock = originRow + (sourceX/2)*4 + static_cast<std::ptrdiff_t>(tileMacroblock*2)*pixelStep;
+				unsigned int luma = sourceX%2==0 ? offsets.y0 : offsets.y1;
+				unsigned char* destinationMacroblock = destinationImage.getRow( y ) + tileMacroblock*4;
+				for ( unsigned int i=tileMacroblock; i<tileEndMacroblock; ++i, sourceMacroblock+=2*pixelStep, destinationMacroblock+=4 )
+				{
+					const unsigned char* sourceMacroblock0 = sourceMacroblock;
+					const unsigned char* sourceMacroblock1 = sourceMacroblock + pixelStep;
+					destinationMacroblock[offsets.y0] = sourceMacroblock0[luma];
+					destinationMacroblock[offsets.y1] = sourceMacroblock1[luma];
+					destinationMacroblock[offsets.u] = static_cast<unsigned char>( ( sourceMacroblock0[offsets.u] + sourceMacroblock1[offsets.u] + 1 ) >> 1 );
+					destinationMacroblock[offsets.v] = static_cast<unsigned char>( ( sourceMacroblock0[offsets.v] + sourceMacroblock1[offsets.v] + 1 ) >> 1 );
+				}
+			}
+		}
+	}
+}
+
+}
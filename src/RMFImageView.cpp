@@ -0,0 +1,329 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFImageView.h"
+
+#include <assert.h>
+#include <cstring>
+#include <algorithm>
+#include "RMFImage.h"
+
+namespace RMF
+{
+
+namespace
+{
+
+// Locates the planes stored one after the other like in an Image, from the top row 
+// of the first plane. Works for both views
+template<class Byte>
+void locatePlanes( const ImageFormat& imageFormat, Byte* topRow, int stride, Byte* planeTopRows[], int planeStrides[] )
+{
+	if ( stride==0 )
+		stride = static_cast<int>( imageFormat.getNumBytesPerLine() );
+	
+	// Start of the buffer: the top row is the last one of the first plane when it's stored bottom-up
+	Byte* bytes = topRow;
+	if ( stride<0 && imageFormat.getHeight()>0 && topRow )
+		bytes = topRow + static_cast<std::ptrdiff_t>( imageFormat.getHeight()-1 ) * stride;
+
+	for ( unsigned int plane=0; plane<ImageFormat::maxNumPlanes; ++plane )
+	{
+		planeTopRows[plane] = NULL;
+		planeStrides[plane] = 0;
+		if ( plane>=imageFormat.getNumPlanes() || !bytes )
+			continue;
+
+		int planeStride = Image::getPlaneStride( imageFormat, stride, plane );
+		unsigned int planeHeight = imageFormat.getPlaneHeight( plane );
+		Byte* planeBytes = bytes + Image::getPlaneOffset( imageFormat, stride, plane );
+		if ( planeStride<0 && planeHeight>0 )
+			planeTopRows[plane] = planeBytes + static_cast<std::ptrdiff_t>( planeHeight-1 ) * (-planeStride);
+		else
+			planeTopRows[plane] = planeBytes;
+		planeStrides[plane] = planeStride;
+	}
+}
+
+// Copies the planes given separately, the unused ones being cleared
+template<class Byte>
+void copyPlanes( const ImageFormat& imageFormat, Byte* const sourcePlaneTopRows[], const int sourcePlaneStrides[], 
+				 Byte* planeTopRows[], int planeStrides[] )
+{
+	for ( unsigned int plane=0; plane<ImageFormat::maxNumPlanes; ++plane )
+	{
+		bool hasPlane = plane<imageFormat.getNumPlanes();
+		planeTopRows[plane] = hasPlane ? sourcePlaneTopRows[plane] : NULL;
+		planeStrides[plane] = hasPlane ? sourcePlaneStrides[plane] : 0;
+	}
+}
+
+// Takes the planes of an Image, or of a view
+template<class ImageType, class Byte>
+void getPlanes( ImageType& image, Byte* planeTopRows[], int planeStrides[] )
+{
+	const ImageFormat& imageFormat = image.getFormat();
+	for ( unsigned int plane=0; plane<ImageFormat::maxNumPlanes; ++plane )
+	{
+		planeTopRows[plane] = NULL;
+		planeStrides[plane] = 0;
+		if ( plane>=imageFormat.getNumPlanes() || imageFormat.getPlaneHeight(plane)==0 )
+			continue;
+		planeTopRows[plane] = image.getPlaneRow( plane, 0 );
+		planeStrides[plane] = image.getPlaneStride( plane );
+	}
+}
+
+// Locates the band of rows [firstRow, endRow) of a view. The chroma planes of the 4:2:0 
+// encodings have one row for two rows of the image
+template<class ViewType, class Byte>
+ImageFormat getBandPlanes( const ViewType& view, unsigned int firstRow, unsigned int endRow, Byte* planeTopRows[], int planeStrides[] )
+{
+	const ImageFormat& imageFormat = view.getFormat();
+	assert( firstRow<=endRow && endRow<=imageFormat.getHeight() );
+	assert( imageFormat.getNumPlanes()==1 || firstRow%2==0 );
+	for ( unsigned int plane=0; plane<ImageFormat::maxNumPlanes; ++plane )
+	{
+		planeTopRows[plane] = NULL;
+		planeStrides[plane] = 0;
+		if ( plane>=imageFormat.getNumPlanes() || view.isNull() )
+			continue;
+		planeTopRows[plane] = view.getPlaneRow( plane, plane==0 ? firstRow : firstRow/2 );
+		planeStrides[plane] = view.getPlaneStride( plane );
+	}
+	return ImageFormat( imageFormat.getWidth(), endRow-firstRow, imageFormat.getEncoding(), imageFormat.getColorMatrix(), imageFormat.getColorRange() );
+}
+
+// Locates the rectangle of a view starting at the pixel (x, y). The pixels of the packed encodings 
+// are whole bytes, the 4:2:2 ones two bytes on average. The luma plane of the 4:2:0 encodings has 
+// a byte per pixel, their chroma planes a sample, or a pair of them for NV12, per two pixels
+template<class ViewType, class Byte>
+ImageFormat getRegionPlanes( const ViewType& view, const ImageRegion& region, Byte* planeTopRows[], int planeStrides[] )
+{
+	const ImageFormat& imageFormat = view.getFormat();
+	assert( ImageView::isValidRegion( imageFormat, region ) );
+	unsigned int x = region.x;
+	unsigned int y = region.y;
+	for ( unsigned int plane=0; plane<ImageFormat::maxNumPlanes; ++plane )
+	{
+		planeTopRows[plane] = NULL;
+		planeStrides[plane] = 0;
+		if ( plane>=imageFormat.getNumPlanes() || view.isNull() )
+			continue;
+		if ( !imageFormat.isPlanar() )
+			planeTopRows[plane] = view.getPlaneRow( plane, y ) + imageFormat.getNumBitsPerPixel()/8*x;
+		else if ( plane==0 || imageFormat.getEncoding()==ImageFormat::NV12 )
+			planeTopRows[plane] = view.getPlaneRow( plane, plane==0 ? y : y/2 ) + x;
+		else
+			planeTopRows[plane] = view.getPlaneRow( plane, y/2 ) + x/2;
+		planeStrides[plane] = view.getPlaneStride( plane );
+	}
+	return ImageFormat( region.width, region.height, imageFormat.getEncoding(), imageFormat.getColorMatrix(), imageFormat.getColorRange() );
+}
+
+// Aligns the span [start, start+size) of pixels along one dimension, clipped to the limit. An even 
+// start moves it backward. An even size moves the end forward, or the start backward at the limit
+void alignSpan( unsigned int& start, unsigned int& size, unsigned int limit, bool hasEvenStart, bool hasEvenSize )
+{
+	start = std::min( start, limit );
+	unsigned int end = start + std::min( size, limit-start );
+	if ( hasEvenStart )
+		start -= start%2;
+	if ( hasEvenSize && (end-start)%2!=0 )
+	{
+		if ( end<limit )
+			++end;
+		else if ( !hasEvenStart && start>0 )
+			--start;
+	}
+	size = end-start;
+}
+
+bool hasPackedPlanes( const ImageFormat& imageFormat, const int planeStrides[] )
+{
+	for ( unsigned int plane=0; plane<imageFormat.getNumPlanes(); ++plane )
+	{
+		if ( planeStrides[plane]!=static_cast<int>( imageFormat.getPlaneNumBytesPerLine(plane) ) )
+			return false;
+	}
+	return true;
+}
+
+}
+
+/*
+	ImageView
+*/
+ImageView::ImageView()
+	: mFormat()
+{
+	locatePlanes<unsigned char>( mFormat, NULL, 0, mPlaneTopRows, mPlaneStrides );
+}
+
+ImageView::ImageView( const ImageFormat& imageFormat, unsigned char* topRow, int stride )
+	: mFormat(imageFormat)
+{
+	locatePlanes( mFormat, topRow, stride, mPlaneTopRows, mPlaneStrides );
+}
+
+ImageView::ImageView( const ImageFormat& imageFormat, unsigned char* const planeTopRows[], const int planeStrides[] )
+	: mFormat(imageFormat)
+{
+	copyPlanes( mFormat, planeTopRows, planeStrides, mPlaneTopRows, mPlaneStrides );
+}
+
+ImageView::ImageView( Image& image )
+	: mFormat( image.getFormat() )
+{
+	getPlanes( image, mPlaneTopRows, mPlaneStrides );
+}
+
+bool ImageView::hasPackedRows() const
+{
+	return hasPackedPlanes( mFormat, mPlaneStrides );
+}
+
+ImageView ImageView::getRows( unsigned int firstRow, unsigned int endRow ) const
+{
+	unsigned char* planeTopRows[ImageFormat::maxNumPlanes];
+	int planeStrides[ImageFormat::maxNumPlanes];
+	ImageFormat bandFormat = getBandPlanes( *this, firstRow, endRow, planeTopRows, planeStrides );
+	return ImageView( bandFormat, planeTopRows, planeStrides );
+}
+
+ImageView ImageView::getRegion( const ImageRegion& region ) const
+{
+	unsigned char* planeTopRows[ImageFormat::maxNumPlanes];
+	int planeStrides[ImageFormat::maxNumPlanes];
+	ImageFormat regionFormat = getRegionPlanes( *this, region, planeTopRows, planeStrides );
+	return ImageView( regionFormat, planeTopRows, planeStrides );
+}
+
+bool ImageView::isValidRegion( const ImageFormat& imageFormat, const ImageRegion& region )
+{
+	if ( region.x>imageFormat.getWidth() || region.width>imageFormat.getWidth()-region.x )
+		return false;
+	if ( region.y>imageFormat.getHeight() || region.height>imageFormat.getHeight()-region.y )
+		return false;
+	if ( imageFormat.isPlanar() )
+		return region.x%2==0 && region.y%2==0;
+	if ( imageFormat.isPackedYUV422() )
+		return region.x%2==0;
+	return true;
+}
+
+ImageRegion ImageView::alignRegion( const ImageFormat& imageFormat, const ImageRegion& region )
+{
+	return alignRegion( imageFormat, imageFormat.getEncoding(), region );
+}
+
+ImageRegion ImageView::alignRegion( const ImageFormat& imageFormat, ImageFormat::Encoding destinationEncoding, const ImageRegion& region )
+{
+	bool isPlanar = imageFormat.isPlanar();
+	bool isPackedYUV422 = imageFormat.isPackedYUV422();
+	bool isDestinationPlanar = ImageFormat::getNumPlanes( destinationEncoding )>1;
+	bool isDestinationPackedYUV422 = ImageFormat::isPackedYUV422( destinationEncoding );
+
+	ImageRegion alignedRegion = region;
+	alignSpan( alignedRegion.x, alignedRegion.width, imageFormat.getWidth(), isPlanar || isPackedYUV422, isPlanar || isPackedYUV422 || isDestinationPlanar || isDestinationPackedYUV422 );
+	alignSpan( alignedRegion.y, alignedRegion.height, imageFormat.getHeight(), isPlanar, isDestinationPlanar );
+	return alignedRegion;
+}
+
+bool ImageView::copyFrom( const ConstImageView& other ) const
+{
+	if ( other.getFormat()!=getFormat() )
+		return false;
+	if ( mFormat.getDataSizeInBytes()>0 && ( isNull() || other.isNull() ) )
+		return false;
+
+	for ( unsigned int plane=0; plane<mFormat.getNumPlanes(); ++plane )
+	{
+		unsigned int height = mFormat.getPlaneHeight( plane );
+		unsigned int numBytesPerLine = mFormat.getPlaneNumBytesPerLine( plane );
+		if ( getPlaneStride(plane)==static_cast<int>(numBytesPerLine) && other.getPlaneStride(plane)==static_cast<int>(numBytesPerLine) )
+		{
+			memcpy( getPlaneRow(plane, 0), other.getPlaneRow(plane, 0), numBytesPerLine * height );
+			continue;
+		}
+		for ( unsigned int y=0; y<height; ++y )
+			memcpy( getPlaneRow(plane, y), other.getPlaneRow(plane, y), numBytesPerLine );
+	}
+	return true;
+}
+
+/*
+	ConstImageView
+*/
+ConstImageView::ConstImageView()
+	: mFormat()
+{
+	locatePlanes<const unsigned char>( mFormat, NULL, 0, mPlaneTopRows, mPlaneStrides );
+}
+
+ConstImageView::ConstImageView( const ImageFormat& imageFormat, const unsigned char* topRow, int stride )
+	: mFormat(imageFormat)
+{
+	locatePlanes( mFormat, topRow, stride, mPlaneTopRows, mPlaneStrides );
+}
+
+ConstImageView::ConstImageView( const ImageFormat& imageFormat, const unsigned char* const planeTopRows[], const int planeStrides[] )
+	: mFormat(imageFormat)
+{
+	copyPlanes( mFormat, planeTopRows, planeStrides, mPlaneTopRows, mPlaneStrides );
+}
+
+ConstImageView::ConstImageView( const Image& image )
+	: mFormat( image.getFormat() )
+{
+	getPlanes( image, mPlaneTopRows, mPlaneStrides );
+}
+
+ConstImageView::ConstImageView( const ImageView& view )
+	: mFormat( view.getFormat() )
+{
+	getPlanes( view, mPlaneTopRows, mPlaneStrides );
+}
+
+bool ConstImageView::hasPackedRows() const
+{
+	return hasPackedPlanes( mFormat, mPlaneStrides );
+}
+
+ConstImageView ConstImageView::getRows( unsigned int firstRow, unsigned int endRow ) const
+{
+	const unsigned char* planeTopRows[ImageFormat::maxNumPlanes];
+	int planeStrides[ImageFormat::maxNumPlanes];
+	ImageFormat bandFormat = getBandPlanes( *this, firstRow, endRow, planeTopRows, planeStrides );
+	return ConstImageView( bandFormat, planeTopRows, planeStrides );
+}
+
+ConstImageView ConstImageView::getRegion( const ImageRegion& region ) const
+{
+	const unsigned char* planeTopRows[ImageFormat::maxNumPlanes];
+	int planeStrides[ImageFormat::maxNumPlanes];
+	ImageFormat regionFormat = getRegionPlanes( *this, region, planeTopRows, planeStrides );
+	return ConstImageView( regionFormat, planeTopRows, planeStrides );
+}
+
+}
\ No newline at end of file
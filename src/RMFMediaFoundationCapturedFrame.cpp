@@ -0,0 +1,116 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFMediaFoundationCapturedFrame.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+namespace RMF
+{
+
+MediaFoundationCapturedFrame* MediaFoundationCapturedFrame::create( const ImageFormat& imageFormat, const COMObjectSharedPtr<IMFMediaBuffer>& mediaBuffer, 
+																	LONG defaultStride, unsigned int sequenceNumber, LONGLONG timestamp )
+{
+	MediaFoundationCapturedFrame* frame = new MediaFoundationCapturedFrame( imageFormat, mediaBuffer );
+	if ( !frame->lock( defaultStride ) )
+	{
+		frame->release();
+		return NULL;
+	}
+	frame->setSequenceNumber( sequenceNumber );
+	frame->setTimestamp( timestamp );
+	return frame;
+}
+
+MediaFoundationCapturedFrame::MediaFoundationCapturedFrame( const ImageFormat& imageFormat, const COMObjectSharedPtr<IMFMediaBuffer>& mediaBuffer )
+	: CapturedFrame(imageFormat),
+	  mMediaBuffer(mediaBuffer),
+	  m2DBuffer(),
+	  mIsLocked(false)
+{
+}
+
+MediaFoundationCapturedFrame::~MediaFoundationCapturedFrame()
+{
+	if ( m2DBuffer.get() )
+	{
+		HRESULT hr = m2DBuffer->Unlock2D();
+		assert( SUCCEEDED(hr) );
+	}
+	else if ( mIsLocked )
+	{
+		HRESULT hr = mMediaBuffer->Unlock();
+		assert( SUCCEEDED(hr) );
+	}
+}
+
+bool MediaFoundationCapturedFrame::lock( LONG defaultStride )
+{
+	const ImageFormat& imageFormat = getImageFormat();
+	LONG numBytesPerLine = static_cast<LONG>( imageFormat.getNumBytesPerLine() );
+	
+	// Prefer the 2D buffer: its first scanline is always the top row, and the pitch 
+	// is negative when the image is bottom-up. The planes of the planar encodings 
+	// follow each other, the chroma planes starting right after the luma one
+	IMF2DBuffer* buffer2DRaw = NULL;
+	HRESULT hr = mMediaBuffer->QueryInterface( IID_PPV_ARGS(&buffer2DRaw) );
+	if ( SUCCEEDED(hr) )
+	{
+		COMObjectSharedPtr<IMF2DBuffer> buffer2DRes( buffer2DRaw );
+		BYTE* scanline0 = NULL;
+		LONG pitch = 0;
+		hr = buffer2DRes->Lock2D( &scanline0, &pitch );
+		if ( SUCCEEDED(hr) )
+		{
+			m2DBuffer = buffer2DRes;
+			if ( labs(pitch)<numBytesPerLine )
+				return false;
+			setRows( scanline0, pitch );
+			return true;
+		}
+	}
+
+	// Otherwise, lock the buffer as a contiguous block and locate the rows with the default stride
+	BYTE* bufferData = NULL;
+	DWORD maxLength = 0;
+	DWORD currentLength = 0;
+	hr = mMediaBuffer->Lock( &bufferData, &maxLength, &currentLength );
+	if ( FAILED(hr) )
+		return false;
+	mIsLocked = true;
+
+	LONG stride = defaultStride!=0 ? defaultStride : numBytesPerLine;
+	DWORD absoluteStride = static_cast<DWORD>( labs(stride) );
+	unsigned int height = imageFormat.getHeight();
+	if ( absoluteStride<static_cast<DWORD>(numBytesPerLine) || currentLength<Image::getBufferSizeInBytes( imageFormat, stride ) )
+		return false;
+	
+	if ( stride<0 && height>0 )
+		setRows( bufferData + absoluteStride*(height-1), stride );
+	else
+		setRows( bufferData, stride );
+	return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFMediaFoundationDeviceBackend.h"
+
+#include <assert.h>
+
+namespace RMF
+{
+
+MediaFoundationDeviceBackend::MediaFoundationDeviceBackend( const COMObjectSharedPtr<IMFActivate>& activate, const std::string& name )
+	: mInternals(NULL),
+	  mSupportedCaptureSettingsList(),
+	  mMediaTypeIndices()
+{
+	mInternals = new DeviceInternals( activate, name );
+
+	// Convert the supported VideoMediaTypes of the DeviceInternals into a CaptureSettingsList
+	// We only keep the types that our Image class can handle
+	const DeviceInternals::VideoMediaTypes&	mediaTypes = mInternals->getSupportedVideoMediaTypes();
+	for ( std::size_t index=0; index<mediaTypes.size(); ++index )
+	{
+		const DeviceInternals::VideoMediaType mediaType = mediaTypes[index];
+		
+		bool supported = true;
+		ImageFormat::Encoding encoding = ImageFormat::BGR24;
+		if ( mediaType.subType==MFVideoFormat_RGB24 )
+			encoding = ImageFormat::BGR24;
+		else if ( mediaType.subType==MFVideoFormat_YUY2 )
+			encoding = ImageFormat::YUYV;
+		else if ( mediaType.subType==MFVideoFormat_UYVY )
+			encoding = ImageFormat::UYVY;
+		else if ( mediaType.subType==MFVideoFormat_YVYU )
+			encoding = ImageFormat::YVYU;
+		else if ( mediaType.subType==MFVideoFormat_NV12 )
+			encoding = ImageFormat::NV12;
+		else if ( mediaType.subType==MFVideoFormat_I420 || mediaType.subType==MFVideoFormat_IYUV )
+			encoding = ImageFormat::I420;
+		else if ( mediaType.subType==MFVideoFormat_YV12 )
+			encoding = ImageFormat::YV12;
+		else if ( mediaType.subType==MFVideoFormat_RGB32 )
+			encoding = ImageFormat::BGRX32;
+		else if ( mediaType.subType==MFVideoFormat_ARGB32 )
+			encoding = ImageFormat::BGRA32;
+		else 
+			supported = false;
+
+		if ( supported )
+		{
+			// The RGB subtypes have no color matrix nor range: their attributes, when set, describe 
+			// the source of the frames. MFVideoTransferMatrix_BT2020_10 and _12 (4 and 5) are missing 
+			// from older SDKs
+			ImageFormat::ColorMatrix colorMatrix = ImageFormat::BT601;
+			ImageFormat::ColorRange colorRange = ImageFormat::LimitedRange;
+			if ( !ImageFormat::isRGB( encoding ) )
+			{
+				if ( mediaType.yuvMatrix==MFVideoTransferMatrix_BT709 )
+					colorMatrix = ImageFormat::BT709;
+				else if ( mediaType.yuvMatrix==4 || mediaType.yuvMatrix==5 )
+					colorMatrix = ImageFormat::BT2020;
+				if ( mediaType.nominalRange==MFNominalRange_0_255 )
+					colorRange = ImageFormat::FullRange;
+			}
+
+			ImageFormat imageFormat = ImageFormat( mediaType.width, mediaType.height, encoding, colorMatrix, colorRange );
+			CaptureSettings settings( imageFormat, static_cast<float>( mediaType.frameRate ) );
+			mSupportedCaptureSettingsList.push_back( settings );
+			mMediaTypeIndices.push_back(index);
+		}
+	}
+}
+
+MediaFoundationDeviceBackend::~MediaFoundationDeviceBackend()
+{
+	if ( isCapturing() )
+		stopCapture();
+	delete mInternals;
+	mInternals = NULL;
+}
+
+bool MediaFoundationDeviceBackend::startCapture( std::size_t captureSettingsIndex )
+{
+	if ( captureSettingsIndex>=mMediaTypeIndices.size() )
+		return false;
+
+	// Find the MediaType corresponding to the index of the CaptureSettings to use
+	DWORD mediaTypeIndex = static_cast<DWORD>( mMediaTypeIndices[captureSettingsIndex] );
+	return mInternals->startCapture( mediaTypeIndex, mSupportedCaptureSettingsList[captureSettingsIndex].getImageFormat() );
+}
+
+void MediaFoundationDeviceBackend::stopCapture()
+{
+	mInternals->stopCapture();
+}
+
+bool MediaFoundationDeviceBackend::isCapturing() const
+{
+	return mInternals->isCapturing();
+}
+
+unsigned int MediaFoundationDeviceBackend::getCapturedImageSequenceNumber() const
+{
+	return mInternals->getCapturedImageSequenceNumber();
+}
+
+bool MediaFoundationDeviceBackend::getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const
+{
+	LONGLONG internalsTimestamp = 0;
+	bool ret = mInternals->getCapturedImage( buffer, sequenceNumber, internalsTimestamp );
+	timestamp = internalsTimestamp;
+	return ret;
+}
+
+CapturedFrame* MediaFoundationDeviceBackend::acquireCapturedFrame( std::size_t /*captureSettingsIndex*/ ) const
+{
+	return mInternals->acquireCapturedFrame();
+}
+
+bool MediaFoundationDeviceBackend::setZeroCopyEnabled( bool enabled )
+{
+	return mInternals->setZeroCopyEnabled( enabled );
+}
+
+bool MediaFoundationDeviceBackend::setFrameQueueDepth( std::size_t depth )
+{
+	return mInternals->setFrameQueueDepth( depth );
+}
+
+std::size_t MediaFoundationDeviceBackend::getFrameQueueDepth() const
+{
+	return mInternals->getFrameQueueDepth();
+}
+
+CapturedFrame* MediaFoundationDeviceBackend::popCapturedFrame()
+{
+	return mInternals->popCapturedFrame();
+}
+
+unsigned int MediaFoundationDeviceBackend::getNumDroppedFrames() const
+{
+	return mInternals->getNumDroppedFrames();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFMediaFoundationDeviceManagerBackend.h"
+
+#include <ks.h>
+#include <Dbt.h>
+
+#include <assert.h>
+#include <algorithm>
+
+#include "RMFDeviceManager.h"
+#include "RMFMediaFoundationDeviceBackend.h"
+
+namespace RMF
+{
+
+// The list of all the MediaFoundationDeviceManagerBackend instances that exist in the application
+// This is needed because of the static nature of the WindowProc hook
+MediaFoundationDeviceManagerBackend::Instances MediaFoundationDeviceManagerBackend::mInstances;
+HHOOK MediaFoundationDeviceManagerBackend::mHookHandle = 0;
+
+MediaFoundationDeviceManagerBackend::MediaFoundationDeviceManagerBackend()
+	: mDeviceListChanged(true),
+	  mActivates()
+{
+	// Initialize the COM library 
+	// We dont check the result on purpose here. See documentation: 
+	// http://msdn.microsoft.com/en-us/library/windows/desktop/ms695279(v=vs.85).aspx
+	HRESULT hr = S_OK;
+	hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+	
+    // Initialize Media Foundation
+	// http://msdn.microsoft.com/en-us/library/windows/desktop/ms702238(v=vs.85).aspx
+    hr = MFStartup( MF_VERSION, MFSTARTUP_NOSOCKET );		// Note: in our case, we don't need the sockets library
+	assert( SUCCEEDED(hr) );	
+
+	// Add this instance to the static list
+	mInstances.push_back( this );
+	
+	// Register hook when this is the first instance created
+	// See this article for extra information
+	// http://www.codeproject.com/Articles/14500/Detecting-Hardware-Insertion-and-or-Removal
+	if ( mInstances.size()==1 )
+	{
+		DWORD threadID = GetCurrentThreadId();
+		HINSTANCE hInstance = GetModuleHandle(NULL) ;
+		mHookHandle = SetWindowsHookEx( WH_CALLWNDPROC, wndProcHook, hInstance, threadID );
+		assert( mHookHandle );
+	}
+}
+
+MediaFoundationDeviceManagerBackend::~MediaFoundationDeviceManagerBackend()
+{
+	mActivates.clear();
+
+	// Shutdown Media Foundation and COM 
+	HRESULT hr = MFShutdown();
+	assert( SUCCEEDED(hr) );
+	
+	CoUninitialize();
+
+	// Remove this instance from the static list
+	Instances::iterator itr = std::find( mInstances.begin(), mInstances.end(), this );
+	assert( itr!=mInstances.end() );
+	mInstances.erase(itr);
+
+	// If there's no more instances, remove the hook
+	if ( mInstances.empty() )
+	{
+		BOOL ret = UnhookWindowsHookEx( mHookHandle );
+		assert( ret );
+		mHookHandle = 0;
+	}
+}
+
+LRESULT CALLBACK MediaFoundationDeviceManagerBackend::wndProcHook( int nCode, WPARAM wParam, LPARAM lParam )
+{
+	// Note:
+	// We only process the message if it is sent by the current thread.
+	// By "current" I guess that they mean the same thread as the one called the hook
+	// registration function... but that's a guess :(
+	// See http://msdn.microsoft.com/en-us/library/windows/desktop/ms644975(v=vs.85).aspx
+	// My goal is to use this information to avoid having to handle concurrency with 
+	// a critical section or whatnot.
+	// Because if this hook is called by different thread, there's a micro chance that the
+	// array of instances I'm using changes while I'm using it
+	if ( wParam!=0 )
+	{
+		const CWPSTRUCT& params = *reinterpret_cast<CWPSTRUCT*>(lParam);
+		if ( params.message==WM_DEVICECHANGE )
+		{
+			for ( std::size_t i=0; i<mInstances.size(); ++i )
+				mInstances[i]->mDeviceListChanged = true;
+		}
+	}
+
+	// Process event
+	return CallNextHookEx( NULL, nCode, wParam, lParam );
+}
+
+void MediaFoundationDeviceManagerBackend::enumerateDevices( DeviceDescriptions& descriptions )
+{
+	descriptions.clear();
+	mDeviceListChanged = false;
+
+	enumerateActivates( mActivates );
+	for ( std::size_t i=0; i<mActivates.size(); ++i )
+	{
+		DeviceDescription description;
+		getName( mActivates[i].get(), description.name );
+		getSymbolicLink( mActivates[i].get(), description.symbolicLink );
+		descriptions.push_back( description );
+	}
+}
+
+DeviceBackend* MediaFoundationDeviceManagerBackend::createDeviceBackend( const DeviceDescription& description )
+{
+	std::string symbolicLink;
+	for ( std::size_t i=0; i<mActivates.size(); ++i )
+	{
+		getSymbolicLink( mActivates[i].get(), symbolicLink );
+		if ( symbolicLink==description.symbolicLink )
+			return new MediaFoundationDeviceBackend( mActivates[i], description.name );
+	}
+	return NULL;
+}
+
+void MediaFoundationDeviceManagerBackend::enumerateActivates( IMFActivates& activates )
+{
+	activates.clear();
+	HRESULT hr = S_OK;
+	
+	// Prepare attributes for enumerating the devices
+	IMFAttributes* attributesRaw = NULL;	
+	hr = MFCreateAttributes( &attributesRaw, 1 );
+	COMObjectSharedPtr<IMFAttributes> attributesRes( attributesRaw );
+	if ( FAILED(hr) )
+		return;
+	
+	// Specify we're only interested in video devices
+    hr = attributesRes->SetGUID( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE, MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_GUID );
+	if ( FAILED(hr) )
+		return;
+
+    // Enumerate the devices
+	IMFActivate** activatesList = NULL;
+	UINT32 numActivates = 0;
+    hr = MFEnumDeviceSources( attributesRes.get(), &activatesList, &numActivates );
+	if ( FAILED(hr ) )
+		return;
+
+	// Populate our list of Activates with the result
+	activates.resize( numActivates );
+	for ( UINT32 i=0; i<numActivates; ++i )
+	{
+		COMObjectSharedPtr<IMFActivate> activate = activatesList[i];
+		activates[i] = activate;
+	}
+
+	// Release list of enumerated devices
+	CoTaskMemFree( activatesList );
+}
+
+void MediaFoundationDeviceManagerBackend::wideCharStringToMultiByteString( const wchar_t* wideCharString, std::string& multiByteString )
+{
+	assert( wideCharString );
+	size_t size = wcslen(wideCharString)+1;
+	char* buffer = new char[size];
+	size_t numCharConverted = 0;
+	int ret = wcstombs_s( &numCharConverted, buffer, size, wideCharString, size );
+	if ( ret==0 )
+		multiByteString = buffer;
+	delete[] buffer;
+}
+
+void MediaFoundationDeviceManagerBackend::getName( const IMFActivate* activate, std::string& name )
+{
+	// See http://msdn.microsoft.com/de-de/library/bb970406(v=vs.85).aspx
+	WCHAR* theName = NULL;
+	HRESULT hr = const_cast<IMFActivate*>(activate)->GetAllocatedString( MF_DEVSOURCE_ATTRIBUTE_FRIENDLY_NAME, &theName, NULL );	
+	if ( SUCCEEDED(hr) )
+	{
+		wideCharStringToMultiByteString( theName, name );
+		CoTaskMemFree( theName );
+	}
+	else
+	{
+		name = "No name";
+	}
+}
+
+void MediaFoundationDeviceManagerBackend::getSymbolicLink( const IMFActivate* activate, std::string& symbolicLink )
+{
+	WCHAR* theSymbolicLink;
+	HRESULT hr = const_cast<IMFActivate*>(activate)->GetAllocatedString( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_SYMBOLIC_LINK, &theSymbolicLink, NULL );
+	if ( SUCCEEDED(hr) )
+	{	
+		wideCharStringToMultiByteString( theSymbolicLink, symbolicLink );
+		CoTaskMemFree( theSymbolicLink );
+	}
+	else
+	{
+		symbolicLink = "No symbolic link";
+	}
+}
+
+/*
+	DeviceManager default constructor
+	It lives here rather than in RMFDeviceManager.cpp so the Core library doesn't depend on Media Foundation
+*/
+DeviceManager::DeviceManager()
+	: DeviceManager( new MediaFoundationDeviceManagerBackend() )
+{
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFMemoryAllocator.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN 
+	#define NOMINMAX 
+	#include <windows.h>
+	#include <malloc.h>
+#else
+	#include <stdio.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+namespace RMF
+{
+
+MemoryAllocator::Allocation::Allocation()
+	: bytes(NULL),
+	  sizeInBytes(0),
+	  alignment(0),
+	  requestedPages(DefaultPages),
+	  pages(DefaultPages),
+	  mappedSizeInBytes(0)
+{
+}
+
+#ifdef __linux__
+// The default size of the hugetlb pages, the ones MAP_HUGETLB maps, else the size of the 
+// transparent huge pages. 2 MB on x86-64, but 512 MB on 64-bit ARM with 64K pages for example
+static std::size_t readHugePageSize()
+{
+	unsigned long sizeInKB = 0;
+	FILE* file = fopen( "/proc/meminfo", "r" );
+	if ( file )
+	{
+		char line[256];
+		while ( fgets( line, sizeof(line), file ) )
+		{
+			if ( sscanf( line, "Hugepagesize: %lu kB", &sizeInKB )==1 )
+				break;
+		}
+		fclose( file );
+	}
+	if ( sizeInKB>0 )
+		return static_cast<std::size_t>( sizeInKB ) * 1024;
+
+	unsigned long sizeInBytes = 0;
+	file = fopen( "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r" );
+	if ( file )
+	{
+		if ( fscanf( file, "%lu", &sizeInBytes )!=1 )
+			sizeInBytes = 0;
+		fclose( file );
+	}
+	return static_cast<std::size_t>( sizeInBytes );
+}
+#endif
+
+std::size_t MemoryAllocator::getHugePageSize()
+{
+#if defined(_WIN32)
+	return GetLargePageMinimum();
+#elif defined(__linux__)
+	static const std::size_t hugePageSize = readHugePageSize();		// Read once, it's asked for at each allocation
+	return hugePageSize;
+#else
+	return 0;
+#endif
+}
+
+bool MemoryAllocator::allocate( unsigned int sizeInBytes, unsigned int alignment, Pages pages, Allocation& allocation )
+{
+	assert( alignment>0 && (alignment & (alignment-1))==0 );
+	allocation = Allocation();
+	allocation.sizeInBytes = sizeInBytes;
+	allocation.alignment = alignment;
+	allocation.requestedPages = pages;
+
+	std::size_t hugePageSize = getHugePageSize();
+	bool largeEnough = hugePageSize>0 && sizeInBytes>=hugePageSize;
+	if ( pages==ExplicitHugePages && largeEnough && alignment<=hugePageSize )
+	{
+		if ( allocateExplicitHugePages( sizeInBytes, allocation ) )
+			return true;
+	}
+
+#ifdef __linux__
+	if ( pages!=DefaultPages && largeEnough )
+	{
+		// Aligning on a huge page lets the kernel map the whole block with huge pages
+		unsigned int hugePageAlignment = static_cast<unsigned int>( hugePageSize );
+		if ( allocateAligned( sizeInBytes, alignment>hugePageAlignment ? alignment : hugePageAlignment, allocation ) )
+		{
+			allocation.alignment = alignment;
+			if ( madvise( allocation.bytes, sizeInBytes, MADV_HUGEPAGE )==0 )
+				allocation.pages = TransparentHugePages;
+			return true;
+		}
+	}
+#endif
+
+	return allocateAligned( sizeInBytes, alignment, allocation );
+}
+
+void MemoryAllocator::deallocate( Allocation& allocation )
+{
+	if ( !allocation.bytes )
+		return;
+
+	if ( allocation.pages==ExplicitHugePages )
+	{
+#if defined(_WIN32)
+		VirtualFree( allocation.bytes, 0, MEM_RELEASE );
+#elif defined(__linux__)
+		munmap( allocation.bytes, allocation.mappedSizeInBytes );
+#endif
+	}
+	else
+	{
+#ifdef _WIN32
+		_aligned_free( allocation.bytes );
+#else
+		free( allocation.bytes );
+#endif
+	}
+	allocation = Allocation();
+}
+
+bool MemoryAllocator::allocateAligned( unsigned int sizeInBytes, unsigned int alignment, Allocation& allocation )
+{
+	// Allocate at least one byte, so every allocation has an address
+	std::size_t size = sizeInBytes>0 ? sizeInBytes : 1;
+	void* bytes = NULL;
+#ifdef _WIN32
+	bytes = _aligned_malloc( size, alignment );
+#else
+	if ( alignment<sizeof(void*) )
+		alignment = sizeof(void*);		// The minimum posix_memalign accepts
+	if ( posix_memalign( &bytes, alignment, size )!=0 )
+		bytes = NULL;
+#endif
+	if ( !bytes )
+		return false;
+	allocation.bytes = static_cast<unsigned char*>( bytes );
+	allocation.pages = DefaultPages;
+	allocation.mappedSizeInBytes = size;
+	return true;
+}
+
+bool MemoryAllocator::allocateExplicitHugePages( unsigned int sizeInBytes, Allocation& allocation )
+{
+	std::size_t hugePageSize = getHugePageSize();
+	std::size_t mappedSize = ( (sizeInBytes + hugePageSize - 1) / hugePageSize ) * hugePageSize;
+	void* bytes = NULL;
+#if defined(_WIN32)
+	bytes = VirtualAlloc( NULL, mappedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+#elif defined(__linux__) && defined(MAP_HUGETLB)
+	bytes = mmap( NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+	if ( bytes==MAP_FAILED )
+		bytes = NULL;
+#endif
+	if ( !bytes )
+		return false;
+	allocation.bytes = static_cast<unsigned char*>( bytes );
+	allocation.pages = ExplicitHugePages;
+	allocation.mappedSizeInBytes = mappedSize;
+	return true;
+}
+
+}
\ No newline at end of file
@@ -25,39 +25,81 @@
 
 #include <stddef.h>		// For NULL
 #include <memory.h>
+#include <new>
+#include "RMFMemoryBufferPool.h"
 
 namespace RMF
 {
 
+MemoryBuffer::Options::Options()
+	: zeroFill(true),
+	  pool(NULL),
+	  alignment(MemoryAllocator::defaultAlignment),
+	  pages(MemoryAllocator::DefaultPages)
+{
+}
+
 MemoryBuffer::MemoryBuffer()
 	: mBytes(NULL),
-	  mSizeInBytes(0)
+	  mSizeInBytes(0),
+	  mPool(NULL),
+	  mAllocation()
 {
 }
 
 MemoryBuffer::MemoryBuffer( unsigned int sizeInBytes )
 	: mBytes(NULL),
-	  mSizeInBytes(sizeInBytes)
+	  mSizeInBytes(sizeInBytes),
+	  mPool(NULL),
+	  mAllocation()
 {
-	mBytes = new unsigned char[mSizeInBytes];
+	allocate( MemoryAllocator::defaultAlignment, MemoryAllocator::DefaultPages );
 	fill(0);
 }
 
+MemoryBuffer::MemoryBuffer( unsigned int sizeInBytes, const Options& options )
+	: mBytes(NULL),
+	  mSizeInBytes(sizeInBytes),
+	  mPool(options.pool),
+	  mAllocation()
+{
+	allocate( options.alignment, options.pages );
+	if ( options.zeroFill )
+		fill(0);
+}
+
 MemoryBuffer::MemoryBuffer( const MemoryBuffer& other )
 	: mBytes(NULL),
-	  mSizeInBytes( other.getSizeInBytes() )
+	  mSizeInBytes( other.getSizeInBytes() ),
+	  mPool( other.mPool ),
+	  mAllocation()
 {
-	mBytes = new unsigned char[mSizeInBytes];
+	allocate( other.mAllocation.alignment>0 ? other.mAllocation.alignment : MemoryAllocator::defaultAlignment, other.mAllocation.requestedPages );
 	memcpy( mBytes, other.getBytes(), other.getSizeInBytes() );
 }
 
 MemoryBuffer::~MemoryBuffer()
 {
-	delete[] mBytes;
+	if ( mPool )
+		mPool->release( mAllocation );
+	else
+		MemoryAllocator::deallocate( mAllocation );
 	mBytes = NULL;
 	mSizeInBytes = 0;
 }
 
+void MemoryBuffer::allocate( unsigned int alignment, MemoryAllocator::Pages pages )
+{
+	bool ret = false;
+	if ( mPool )
+		ret = mPool->allocate( mSizeInBytes, alignment, pages, mAllocation );
+	else
+		ret = MemoryAllocator::allocate( mSizeInBytes, alignment, pages, mAllocation );
+	if ( !ret )
+		throw std::bad_alloc();		// Like the new[] this replaces
+	mBytes = mAllocation.bytes;
+}
+
 void MemoryBuffer::fill( char value )
 {
 	memset( mBytes, value, getSizeInBytes() );
@@ -0,0 +1,142 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFMemoryBufferPool.h"
+
+#include <assert.h>
+#include "RMFCriticalSectionEnterer.h"
+
+namespace RMF
+{
+
+MemoryBufferPool::MemoryBufferPool( std::size_t maxNumBytes )
+	: mCriticalSection(),
+	  mBlocks(),
+	  mNumBytes(0),
+	  mMaxNumBytes(maxNumBytes),
+	  mNumAllocations(0),
+	  mNumReusedAllocations(0)
+{
+}
+
+MemoryBufferPool::~MemoryBufferPool()
+{
+	clear();
+}
+
+MemoryBufferPool& MemoryBufferPool::getDefault()
+{
+	// Never destroyed, so buffers released during the static destructions can still return to it
+	static MemoryBufferPool* pool = new MemoryBufferPool();
+	return *pool;
+}
+
+bool MemoryBufferPool::allocate( unsigned int sizeInBytes, unsigned int alignment, MemoryAllocator::Pages pages, MemoryAllocator::Allocation& allocation )
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	mNumAllocations++;
+
+	// Take the most recently released block that matches, its memory is the most likely to be in the caches.
+	// The blocks are matched on the pages requested, not obtained, so a failed huge page request isn't retried 
+	for ( Blocks::reverse_iterator itr=mBlocks.rbegin(); itr!=mBlocks.rend(); ++itr )
+	{
+		if ( itr->sizeInBytes==sizeInBytes && itr->alignment==alignment && itr->requestedPages==pages )
+		{
+			allocation = *itr;
+			mNumBytes -= sizeInBytes;
+			mBlocks.erase( --(itr.base()) );
+			mNumReusedAllocations++;
+			return true;
+		}
+	}
+	return MemoryAllocator::allocate( sizeInBytes, alignment, pages, allocation );
+}
+
+void MemoryBufferPool::release( MemoryAllocator::Allocation& allocation )
+{
+	if ( !allocation.bytes )
+		return;
+
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( allocation.sizeInBytes>mMaxNumBytes )
+	{
+		MemoryAllocator::deallocate( allocation );
+		return;
+	}
+	trim( mMaxNumBytes - allocation.sizeInBytes );
+	mBlocks.push_back( allocation );
+	mNumBytes += allocation.sizeInBytes;
+	allocation = MemoryAllocator::Allocation();
+}
+
+std::size_t MemoryBufferPool::getMaxNumBytes() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mMaxNumBytes;
+}
+
+void MemoryBufferPool::setMaxNumBytes( std::size_t maxNumBytes )
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	mMaxNumBytes = maxNumBytes;
+	trim( mMaxNumBytes );
+}
+
+std::size_t MemoryBufferPool::getNumBytes() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mNumBytes;
+}
+
+void MemoryBufferPool::clear()
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	trim( 0 );
+}
+
+unsigned int MemoryBufferPool::getNumAllocations() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mNumAllocations;
+}
+
+unsigned int MemoryBufferPool::getNumReusedAllocations() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mNumReusedAllocations;
+}
+
+// Free the least recently released blocks until the retained memory fits 
+void MemoryBufferPool::trim( std::size_t maxNumBytes )
+{
+	while ( mNumBytes>maxNumBytes )
+	{
+		assert( !mBlocks.empty() );
+		MemoryAllocator::Allocation& block = mBlocks.front();
+		mNumBytes -= block.sizeInBytes;
+		MemoryAllocator::deallocate( block );
+		mBlocks.pop_front();
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,535 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFReplayDeviceBackend.h"
+
+#include <assert.h>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+#include "RMFCriticalSectionEnterer.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN 
+	#define NOMINMAX 
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+namespace RMF
+{
+
+static const long long numTimeUnitsPerSecond = 10000000;		// 100-nanosecond units
+
+static bool isDirectory( const std::string& path )
+{
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA( path.c_str() );
+	return attributes!=INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	struct stat status;
+	if ( stat( path.c_str(), &status )!=0 )
+		return false;
+	return S_ISDIR( status.st_mode );
+#endif
+}
+
+// List the names of the files in a directory (not the sub-directories), in alphabetical order
+static void listFiles( const std::string& directoryPath, std::vector<std::string>& fileNames )
+{
+	fileNames.clear();
+#ifdef _WIN32
+	WIN32_FIND_DATAA findData;
+	HANDLE handle = FindFirstFileA( (directoryPath + "\\*").c_str(), &findData );
+	if ( handle==INVALID_HANDLE_VALUE )
+		return;
+	do
+	{
+		if ( !(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) )
+			fileNames.push_back( findData.cFileName );
+	}
+	while ( FindNextFileA( handle, &findData ) );
+	FindClose( handle );
+#else
+	DIR* directory = opendir( directoryPath.c_str() );
+	if ( !directory )
+		return;
+	while ( dirent* entry = readdir( directory ) )
+	{
+		std::string fileName = entry->d_name;
+		if ( !isDirectory( directoryPath + "/" + fileName ) )
+			fileNames.push_back( fileName );
+	}
+	closedir( directory );
+#endif
+	std::sort( fileNames.begin(), fileNames.end() );
+}
+
+static long long getFileSize( const std::string& filePath )
+{
+	std::ifstream stream( filePath.c_str(), std::ios::binary|std::ios::in );
+	if ( !stream.is_open() )
+		return -1;
+	stream.seekg( 0, std::ios::end );
+	return static_cast<long long>( stream.tellg() );
+}
+
+static bool endsWith( const std::string& text, const std::string& suffix )
+{
+	if ( suffix.size()>text.size() )
+		return false;
+	return text.compare( text.size()-suffix.size(), suffix.size(), suffix )==0;
+}
+
+static std::string toUpper( const std::string& text )
+{
+	std::string ret = text;
+	for ( std::size_t i=0; i<ret.size(); ++i )
+		ret[i] = static_cast<char>( toupper( static_cast<unsigned char>(ret[i]) ) );
+	return ret;
+}
+
+/*
+	ReplayDeviceBackend::Options
+*/
+ReplayDeviceBackend::Options::Options()
+	: pacing(RealTimePacing),
+	  loop(true),
+	  preload(false),
+	  frameRate(30.f),
+	  imageFormat()
+{
+}
+
+/*
+	ReplayDeviceBackend
+*/
+ReplayDeviceBackend::ReplayDeviceBackend( const std::string& path, const Options& options )
+	: mOptions(options),
+	  mRecordings(),
+	  mSupportedCaptureSettingsList(),
+	  mCriticalSection(),
+	  mRecording(NULL),
+	  mCaptureStartTime(),
+	  mRetrievedImageNumber(0),
+	  mPreloadedImageBuffers(),
+	  mFileStream(),
+	  mFileStreamPath(),
+	  mPlanarBuffer()
+{
+	// Trailing separators would get in the way of naming the timestamps file
+	std::string cleanPath = path;
+	while ( cleanPath.size()>1 && ( cleanPath[cleanPath.size()-1]=='/' || cleanPath[cleanPath.size()-1]=='\\' ) )
+		cleanPath.erase( cleanPath.size()-1 );
+
+	bool hasImageFormat = mOptions.imageFormat.getDataSizeInBytes()>0;
+	if ( isDirectory( cleanPath ) )
+	{
+		std::vector<std::string> fileNames;
+		listFiles( cleanPath, fileNames );
+		for ( std::size_t i=0; i<fileNames.size(); ++i )
+		{
+			ImageFormat imageFormat = mOptions.imageFormat;
+			if ( hasImageFormat || parseImageFormat( fileNames[i], imageFormat ) )
+				addRawFile( cleanPath + "/" + fileNames[i], imageFormat );
+		}
+	}
+	else if ( endsWith( toUpper(cleanPath), ".Y4M" ) )
+	{
+		addY4MFile( cleanPath );
+	}
+	else
+	{
+		ImageFormat imageFormat = mOptions.imageFormat;
+		if ( hasImageFormat || parseImageFormat( cleanPath, imageFormat ) )
+			addRawFile( cleanPath, imageFormat );
+	}
+
+	setTimestamps( cleanPath + ".timestamps" );
+
+	for ( std::size_t i=0; i<mRecordings.size(); ++i )
+		mSupportedCaptureSettingsList.push_back( CaptureSettings( mRecordings[i].imageFormat, mRecordings[i].frameRate ) );
+}
+
+ReplayDeviceBackend::~ReplayDeviceBackend()
+{
+	if ( isCapturing() )
+		stopCapture();
+}
+
+bool ReplayDeviceBackend::parseImageFormat( const std::string& fileName, ImageFormat& imageFormat )
+{
+	// The expected form is <anything>_<width>x<height>.<encoding name>
+	std::size_t dotPosition = fileName.rfind('.');
+	if ( dotPosition==std::string::npos )
+		return false;
+	std::string encodingName = toUpper( fileName.substr( dotPosition+1 ) );
+	int encoding = 0;
+	while ( encoding<ImageFormat::EncodingCount && encodingName!=ImageFormat::getEncodingName( static_cast<ImageFormat::Encoding>(encoding) ) )
+		++encoding;
+	if ( encoding==ImageFormat::EncodingCount )
+		return false;
+
+	std::size_t underscorePosition = fileName.rfind( '_', dotPosition );
+	if ( underscorePosition==std::string::npos )
+		return false;
+	std::string size = fileName.substr( underscorePosition+1, dotPosition-underscorePosition-1 );
+	unsigned int width = 0;
+	unsigned int height = 0;
+	char separator = 0;
+	std::istringstream stream( size );
+	stream >> width >> separator >> height;
+	if ( stream.fail() || !stream.eof() || separator!='x' || width==0 || height==0 )
+		return false;
+
+	imageFormat = ImageFormat( width, height, static_cast<ImageFormat::Encoding>(encoding) );
+	return true;
+}
+
+ReplayDeviceBackend::Recording& ReplayDeviceBackend::getRecording( const ImageFormat& imageFormat, Layout layout )
+{
+	for ( std::size_t i=0; i<mRecordings.size(); ++i )
+	{
+		if ( mRecordings[i].imageFormat==imageFormat && mRecordings[i].layout==layout )
+			return mRecordings[i];
+	}
+	Recording recording;
+	recording.imageFormat = imageFormat;
+	recording.layout = layout;
+	recording.frameRate = mOptions.frameRate;
+	recording.duration = 0;
+	mRecordings.push_back( recording );
+	return mRecordings.back();
+}
+
+bool ReplayDeviceBackend::addRawFile( const std::string& filePath, const ImageFormat& imageFormat )
+{
+	long long fileSize = getFileSize( filePath );
+	long long imageSize = imageFormat.getDataSizeInBytes();
+	if ( fileSize<=0 || imageSize==0 || fileSize % imageSize!=0 )
+		return false;
+
+	Recording& recording = getRecording( imageFormat, RawLayout );
+	for ( long long offset=0; offset<fileSize; offset+=imageSize )
+	{
+		Frame frame;
+		frame.filePath = filePath;
+		frame.offset = offset;
+		frame.timestamp = 0;
+		recording.frames.push_back( frame );
+	}
+	return true;
+}
+
+bool ReplayDeviceBackend::addY4MFile( const std::string& filePath )
+{
+	// See http://wiki.multimedia.cx/index.php?title=YUV4MPEG2
+	std::ifstream stream( filePath.c_str(), std::ios::binary|std::ios::in );
+	if ( !stream.is_open() )
+		return false;
+	
+	std::string header;
+	if ( !std::getline( stream, header ) )
+		return false;
+	std::istringstream headerStream( header );
+	std::string token;
+	headerStream >> token;
+	if ( token!="YUV4MPEG2" )
+		return false;
+	
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int frameRateNumerator = 0;
+	unsigned int frameRateDenominator = 0;
+	std::string colorSpace = "420jpeg";		// The default
+	while ( headerStream >> token )
+	{
+		std::string value = token.substr(1);
+		switch ( token[0] )
+		{
+			case 'W': width = static_cast<unsigned int>( atoi( value.c_str() ) ); break;
+			case 'H': height = static_cast<unsigned int>( atoi( value.c_str() ) ); break;
+			case 'C': colorSpace = value; break;
+			case 'F': 
+				{
+					char separator = 0;
+					std::istringstream rateStream( value );
+					rateStream >> frameRateNumerator >> separator >> frameRateDenominator;
+				}
+				break;
+			default: break;
+		}
+	}
+	if ( colorSpace!="422" || width==0 || height==0 || width % 2!=0 )
+		return false;
+
+	ImageFormat imageFormat( width, height, ImageFormat::YUYV );
+	long long imageSize = imageFormat.getDataSizeInBytes();
+	
+	Recording& recording = getRecording( imageFormat, Y4M422Layout );
+	if ( frameRateNumerator>0 && frameRateDenominator>0 )
+		recording.frameRate = static_cast<float>( frameRateNumerator ) / static_cast<float>( frameRateDenominator );
+	
+	// Index the images, each one being preceded by a FRAME line
+	long long fileSize = getFileSize( filePath );
+	std::string frameHeader;
+	while ( std::getline( stream, frameHeader ) && frameHeader.compare( 0, 5, "FRAME" )==0 )
+	{
+		Frame frame;
+		frame.filePath = filePath;
+		frame.offset = static_cast<long long>( stream.tellg() );
+		frame.timestamp = 0;
+		if ( frame.offset+imageSize>fileSize )
+			break;		// Truncated image
+		recording.frames.push_back( frame );
+		stream.seekg( imageSize, std::ios::cur );
+	}
+	return true;
+}
+
+void ReplayDeviceBackend::setTimestamps( const std::string& timestampsFilePath )
+{
+	std::vector<long long> timestamps;
+	std::ifstream stream( timestampsFilePath.c_str() );
+	double timestampInSec = 0;
+	while ( stream >> timestampInSec )
+		timestamps.push_back( static_cast<long long>( timestampInSec * numTimeUnitsPerSecond + 0.5 ) );
+
+	for ( std::size_t i=0; i<mRecordings.size(); ++i )
+	{
+		Recording& recording = mRecordings[i];
+		Frames& frames = recording.frames;
+		std::size_t numFrames = frames.size();
+		if ( numFrames==0 )
+			continue;
+		
+		long long framePeriod = 0;
+		if ( recording.frameRate>0.f )
+			framePeriod = static_cast<long long>( numTimeUnitsPerSecond / recording.frameRate );
+		
+		if ( timestamps.size()>=numFrames )
+		{
+			// Recorded timestamps, made relative to the first image
+			for ( std::size_t j=0; j<numFrames; ++j )
+				frames[j].timestamp = timestamps[j] - timestamps[0];
+			if ( numFrames>1 )
+			{
+				framePeriod = frames[numFrames-1].timestamp / static_cast<long long>(numFrames-1);
+				if ( framePeriod>0 )
+					recording.frameRate = static_cast<float>( numTimeUnitsPerSecond ) / static_cast<float>( framePeriod );
+			}
+		}
+		else
+		{
+			// Deduced from the frame rate
+			for ( std::size_t j=0; j<numFrames; ++j )
+				frames[j].timestamp = static_cast<long long>(j) * framePeriod;
+		}
+		recording.duration = frames[numFrames-1].timestamp + framePeriod;
+	}
+}
+
+bool ReplayDeviceBackend::startCapture( std::size_t captureSettingsIndex )
+{
+	if ( isCapturing() )
+		return false;
+	if ( captureSettingsIndex>=mRecordings.size() )
+		return false;
+
+	const Recording& recording = mRecordings[captureSettingsIndex];
+	if ( recording.frames.empty() )
+		return false;
+	
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	mRecording = &recording;
+	if ( mOptions.preload )
+	{
+		// The buffers are filled from the files right away, no need to zero them
+		MemoryBuffer::Options bufferOptions;
+		bufferOptions.zeroFill = false;
+		for ( std::size_t i=0; i<recording.frames.size(); ++i )
+		{
+			MemoryBuffer* buffer = new MemoryBuffer( recording.imageFormat.getDataSizeInBytes(), bufferOptions );
+			mPreloadedImageBuffers.push_back( buffer );
+			if ( !readFrame( i, *buffer ) )
+			{
+				stopCapture();
+				return false;
+			}
+		}
+	}
+	mRetrievedImageNumber = 0;
+	mCaptureStartTime = std::chrono::steady_clock::now();
+	return true;
+}
+
+void ReplayDeviceBackend::stopCapture()
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( !mRecording )
+		return;
+	mRecording = NULL;
+	mRetrievedImageNumber = 0;
+	for ( std::size_t i=0; i<mPreloadedImageBuffers.size(); ++i )
+		delete mPreloadedImageBuffers[i];
+	mPreloadedImageBuffers.clear();
+	mFileStream.close();
+	mFileStream.clear();
+	mFileStreamPath.clear();
+}
+
+bool ReplayDeviceBackend::isCapturing() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mRecording!=NULL;
+}
+
+std::size_t ReplayDeviceBackend::getFrameIndex( unsigned int sequenceNumber ) const
+{
+	assert( mRecording && sequenceNumber>0 );
+	return (sequenceNumber-1) % mRecording->frames.size();
+}
+
+long long ReplayDeviceBackend::getTimestamp( unsigned int sequenceNumber ) const
+{
+	assert( mRecording && sequenceNumber>0 );
+	long long loopIndex = (sequenceNumber-1) / mRecording->frames.size();
+	return loopIndex * mRecording->duration + mRecording->frames[ getFrameIndex(sequenceNumber) ].timestamp;
+}
+
+unsigned int ReplayDeviceBackend::getCapturedImageSequenceNumber() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( !mRecording )
+		return 0;
+
+	unsigned int numFrames = static_cast<unsigned int>( mRecording->frames.size() );
+	unsigned int sequenceNumber = 0;
+	if ( mOptions.pacing==AsFastAsPossiblePacing )
+	{
+		sequenceNumber = mRetrievedImageNumber + 1;
+	}
+	else
+	{
+		// Find the last image which timestamp is due
+		long long elapsedTime = std::chrono::duration_cast< std::chrono::duration<long long, std::ratio<1, 10000000> > >( std::chrono::steady_clock::now() - mCaptureStartTime ).count();
+		unsigned int loopIndex = 0;
+		if ( mRecording->duration>0 )
+		{
+			loopIndex = static_cast<unsigned int>( elapsedTime / mRecording->duration );
+			elapsedTime %= mRecording->duration;
+		}
+		unsigned int frameIndex = 0;
+		while ( frameIndex+1<numFrames && mRecording->frames[frameIndex+1].timestamp<=elapsedTime )
+			++frameIndex;
+		sequenceNumber = loopIndex * numFrames + frameIndex + 1;
+	}
+
+	if ( !mOptions.loop && sequenceNumber>numFrames )
+		sequenceNumber = numFrames;
+	return sequenceNumber;
+}
+
+bool ReplayDeviceBackend::getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	
+	// Initialize output parameters
+	sequenceNumber = 0;
+	timestamp = 0;
+
+	if ( !mRecording )
+		return false;
+	if ( buffer.getSizeInBytes()!=mRecording->imageFormat.getDataSizeInBytes() )
+		return false;
+
+	unsigned int latestSequenceNumber = getCapturedImageSequenceNumber();
+	std::size_t frameIndex = getFrameIndex( latestSequenceNumber );
+	bool ret = false;
+	if ( mPreloadedImageBuffers.empty() )
+		ret = readFrame( frameIndex, buffer );
+	else
+		ret = buffer.copyFrom( *mPreloadedImageBuffers[frameIndex] );
+	if ( !ret )
+		return false;
+	
+	mRetrievedImageNumber = latestSequenceNumber;
+	sequenceNumber = latestSequenceNumber;
+	timestamp = getTimestamp( latestSequenceNumber );
+	return true;
+}
+
+bool ReplayDeviceBackend::readFrame( std::size_t frameIndex, MemoryBuffer& buffer ) const
+{
+	assert( mRecording );
+	const Frame& frame = mRecording->frames[frameIndex];
+
+	// Keep the current file open, the images are usually read from the same one
+	if ( mFileStreamPath!=frame.filePath )
+	{
+		mFileStream.close();
+		mFileStream.clear();
+		mFileStream.open( frame.filePath.c_str(), std::ios::binary|std::ios::in );
+		mFileStreamPath = frame.filePath;
+	}
+	if ( !mFileStream.is_open() )
+		return false;
+	mFileStream.clear();
+	mFileStream.seekg( frame.offset );
+
+	unsigned int imageSize = mRecording->imageFormat.getDataSizeInBytes();
+	if ( mRecording->layout==RawLayout )
+	{
+		mFileStream.read( reinterpret_cast<char*>( buffer.getBytes() ), imageSize );
+		return !mFileStream.fail();
+	}
+	
+	// Interleave the planar 4:2:2 Y, U and V planes into YUYV
+	assert( mRecording->layout==Y4M422Layout );
+	mPlanarBuffer.resize( imageSize );
+	mFileStream.read( reinterpret_cast<char*>( &mPlanarBuffer[0] ), imageSize );
+	if ( mFileStream.fail() )
+		return false;
+
+	unsigned int numPixels = mRecording->imageFormat.getWidth() * mRecording->imageFormat.getHeight();
+	const unsigned char* yBytes = &mPlanarBuffer[0];
+	const unsigned char* uBytes = yBytes + numPixels;
+	const unsigned char* vBytes = uBytes + numPixels/2;
+	unsigned char* destBytes = buffer.getBytes();
+	for ( unsigned int i=0; i<numPixels/2; ++i )
+	{
+		destBytes[0] = yBytes[0];
+		destBytes[1] = uBytes[i];
+		destBytes[2] = yBytes[1];
+		destBytes[3] = vBytes[i];
+		destBytes += 4;
+		yBytes += 2;
+	}
+	return true;
+}
+
+}
\ No newline at end of file
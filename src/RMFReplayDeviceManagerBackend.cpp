@@ -0,0 +1,100 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFReplayDeviceManagerBackend.h"
+
+namespace RMF
+{
+
+ReplayDeviceManagerBackend::ReplayDeviceManagerBackend()
+	: mDeviceListChanged(true),
+	  mDevices()
+{
+}
+
+ReplayDeviceManagerBackend::~ReplayDeviceManagerBackend()
+{
+}
+
+std::string ReplayDeviceManagerBackend::getSymbolicLink( const std::string& name )
+{
+	return "replay://" + name;
+}
+
+bool ReplayDeviceManagerBackend::addDevice( const std::string& name, const std::string& path, const ReplayDeviceBackend::Options& options )
+{
+	std::string symbolicLink = getSymbolicLink( name );
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+	{
+		if ( mDevices[i].description.symbolicLink==symbolicLink )
+			return false;
+	}
+
+	// Check there's something to replay there
+	ReplayDeviceBackend backend( path, options );
+	if ( backend.getSupportedCaptureSettingsList().empty() )
+		return false;
+
+	ReplayDevice device;
+	device.description = DeviceDescription( name, symbolicLink );
+	device.path = path;
+	device.options = options;
+	mDevices.push_back( device );
+	mDeviceListChanged = true;
+	return true;
+}
+
+bool ReplayDeviceManagerBackend::removeDevice( const std::string& name )
+{
+	std::string symbolicLink = getSymbolicLink( name );
+	for ( ReplayDevices::iterator itr=mDevices.begin(); itr!=mDevices.end(); ++itr )
+	{
+		if ( itr->description.symbolicLink==symbolicLink )
+		{
+			mDevices.erase( itr );
+			mDeviceListChanged = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ReplayDeviceManagerBackend::enumerateDevices( DeviceDescriptions& descriptions )
+{
+	descriptions.clear();
+	mDeviceListChanged = false;
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+		descriptions.push_back( mDevices[i].description );
+}
+
+DeviceBackend* ReplayDeviceManagerBackend::createDeviceBackend( const DeviceDescription& description )
+{
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+	{
+		if ( mDevices[i].description.symbolicLink==description.symbolicLink )
+			return new ReplayDeviceBackend( mDevices[i].path, mDevices[i].options );
+	}
+	return NULL;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,519 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFSyntheticDeviceBackend.h"
+
+#include <assert.h>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "RMFCriticalSectionEnterer.h"
+#include "RMFImageConverterKernels.h"
+#include "RMFRGBKernels.h"
+
+namespace RMF
+{
+
+static const unsigned int numSequenceNumberBits = 32;
+
+SyntheticDeviceBackend::SyntheticDeviceBackend( const CaptureSettingsList& supportedCaptureSettingsList, bool bottomUp )
+	: mSupportedCaptureSettingsList(),
+	  mBottomUp(bottomUp),
+	  mCaptureSettings(),
+	  mCaptureBottomUp(false),
+	  mCriticalSection(),
+	  mIsCapturing(false),
+	  mCapturedFrame(NULL),
+	  mFrames(),
+	  mFrameQueue(),
+	  mCaptureThread(NULL),
+	  mCaptureThreadMutex(),
+	  mCaptureThreadCondition(),
+	  mCaptureThreadStopRequested(false)
+{
+	// We only keep the settings we know how to generate
+	for ( std::size_t i=0; i<supportedCaptureSettingsList.size(); ++i )
+	{
+		if ( isEncodingSupported( supportedCaptureSettingsList[i].getImageFormat().getEncoding() ) )
+			mSupportedCaptureSettingsList.push_back( supportedCaptureSettingsList[i] );
+	}
+}
+
+SyntheticDeviceBackend::~SyntheticDeviceBackend()
+{
+	if ( isCapturing() )
+		stopCapture();
+}
+
+bool SyntheticDeviceBackend::startCapture( std::size_t captureSettingsIndex )
+{
+	if ( isCapturing() )
+		return false;
+
+	if ( captureSettingsIndex>=mSupportedCaptureSettingsList.size() )
+		return false;
+
+	mCaptureSettings = mSupportedCaptureSettingsList[captureSettingsIndex];
+	mCaptureBottomUp = isBottomUp( captureSettingsIndex );
+
+	{
+		CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+		mIsCapturing = true;
+		assert( !mCapturedFrame );
+		assert( mFrames.empty() );
+	}
+	mFrameQueue.clear();
+
+	assert( !mCaptureThread );
+	mCaptureThreadStopRequested = false;
+	mCaptureThread = new std::thread( &SyntheticDeviceBackend::captureThreadFunction, this );
+	return true;
+}
+
+void SyntheticDeviceBackend::stopCapture()
+{
+	if ( !isCapturing() )
+		return;
+
+	// Wake the capture thread up and wait for it to finish
+	{
+		std::lock_guard<std::mutex> lock( mCaptureThreadMutex );
+		mCaptureThreadStopRequested = true;
+	}
+	mCaptureThreadCondition.notify_all();
+	mCaptureThread->join();
+	delete mCaptureThread;
+	mCaptureThread = NULL;
+
+	// Release the frames. Those still referenced by consumers are deleted when they release them.
+	// The frame queue is emptied but its counters are kept until the next start
+	mFrameQueue.releaseFrames();
+
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	mIsCapturing = false;
+	mCapturedFrame = NULL;
+	for ( std::size_t i=0; i<mFrames.size(); ++i )
+		mFrames[i]->release();
+	mFrames.clear();
+}
+
+bool SyntheticDeviceBackend::isCapturing() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mIsCapturing;
+}
+
+unsigned int SyntheticDeviceBackend::getCapturedImageSequenceNumber() const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	return mCapturedFrame ? mCapturedFrame->getSequenceNumber() : 0;
+}
+
+bool SyntheticDeviceBackend::getCapturedImage( MemoryBuffer& buffer, unsigned int& sequenceNumber, long long& timestamp ) const
+{
+	// Initialize output parameters
+	sequenceNumber = 0;
+	timestamp = 0;
+
+	// Check that we're currently capturing and that a first image was already generated.
+	// The copy is done outside of the critical section, so the capture thread doesn't wait for it
+	// The frames are all BufferCapturedFrames, whose buffer is copied as it is stored, bottom-up or not
+	BufferCapturedFrame* frame = static_cast<BufferCapturedFrame*>( acquireCapturedFrame( 0 ) );
+	if ( !frame )
+		return false;
+
+	const MemoryBuffer& frameBuffer = frame->getBuffer();
+	bool ret = buffer.getSizeInBytes()==frameBuffer.getSizeInBytes();
+	if ( ret )
+		memcpy( buffer.getBytes(), frameBuffer.getBytes(), frameBuffer.getSizeInBytes() );
+	if ( ret )
+	{
+		sequenceNumber = frame->getSequenceNumber();
+		timestamp = frame->getTimestamp();
+	}
+	frame->release();
+	return ret;
+}
+
+bool SyntheticDeviceBackend::getCapturedImage( const ImageView& image, unsigned int& sequenceNumber, long long& timestamp ) const
+{
+	// Same as above, the rows of the buffer being copied in the order they are stored
+	sequenceNumber = 0;
+	timestamp = 0;
+
+	BufferCapturedFrame* frame = static_cast<BufferCapturedFrame*>( acquireCapturedFrame( 0 ) );
+	if ( !frame )
+		return false;
+
+	ConstImageView storedImage( frame->getImageFormat(), frame->getBuffer().getBytes() );
+	bool ret = image.copyFrom( storedImage );
+	if ( ret )
+	{
+		sequenceNumber = frame->getSequenceNumber();
+		timestamp = frame->getTimestamp();
+	}
+	frame->release();
+	return ret;
+}
+
+bool SyntheticDeviceBackend::isBottomUp( std::size_t captureSettingsIndex ) const
+{
+	if ( captureSettingsIndex>=mSupportedCaptureSettingsList.size() )
+		return false;
+	return mBottomUp && !mSupportedCaptureSettingsList[captureSettingsIndex].getImageFormat().isPlanar();
+}
+
+CapturedFrame* SyntheticDeviceBackend::acquireCapturedFrame( std::size_t /*captureSettingsIndex*/ ) const
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	if ( !mCapturedFrame )
+		return NULL;
+	mCapturedFrame->addReference();
+	return mCapturedFrame;
+}
+
+bool SyntheticDeviceBackend::setFrameQueueDepth( std::size_t depth )
+{
+	if ( isCapturing() )
+		return false;
+	return mFrameQueue.setDepth( depth );
+}
+
+// Find a frame only the backend references, so the capture thread can generate into it.
+// Only the latest frame can be acquired by consumers, and only the capture thread pushes frames 
+// into the queue, so once it isn't the latest anymore, a frame with a single reference stays unreferenced
+BufferCapturedFrame* SyntheticDeviceBackend::getFreeFrame()
+{
+	CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+	for ( std::size_t i=0; i<mFrames.size(); ++i )
+	{
+		if ( mFrames[i]!=mCapturedFrame && mFrames[i]->getReferenceCount()==1 )
+			return mFrames[i];
+	}
+	BufferCapturedFrame* frame = new BufferCapturedFrame( mCaptureSettings.getImageFormat(), mCaptureBottomUp );
+	mFrames.push_back( frame );
+	return frame;
+}
+
+void SyntheticDeviceBackend::captureThreadFunction()
+{
+	typedef std::chrono::steady_clock Clock;
+	
+	const ImageFormat& imageFormat = mCaptureSettings.getImageFormat();
+	float frameRate = mCaptureSettings.getFrameRate();
+	Clock::duration framePeriod = Clock::duration::zero();
+	if ( frameRate>0.f )
+		framePeriod = std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1.0 / frameRate ) );
+
+	Clock::time_point startTime = Clock::now();
+	unsigned int sequenceNumber = 0;
+	for ( ;; )
+	{
+		// Wait until the image is due, or until we're asked to stop
+		++sequenceNumber;
+		Clock::time_point dueTime = startTime + framePeriod * (sequenceNumber-1);
+		{
+			std::unique_lock<std::mutex> lock( mCaptureThreadMutex );
+			while ( !mCaptureThreadStopRequested && Clock::now()<dueTime )
+				mCaptureThreadCondition.wait_until( lock, dueTime );
+			if ( mCaptureThreadStopRequested )
+				break;
+		}
+
+		// Generate the image outside of the critical section, the capture thread is the
+		// only one touching a free frame
+		BufferCapturedFrame* frame = getFreeFrame();
+		generateImage( imageFormat, sequenceNumber, frame->getBuffer() );
+		if ( mCaptureBottomUp )
+			flipRows( imageFormat, frame->getBuffer() );
+		long long timestamp = std::chrono::duration_cast< std::chrono::duration<long long, std::ratio<1, 10000000> > >( Clock::now() - startTime ).count();
+		frame->setSequenceNumber( sequenceNumber );
+		frame->setTimestamp( timestamp );
+
+		// Queue it
+		if ( mFrameQueue.getDepth()>0 )
+		{
+			frame->addReference();
+			mFrameQueue.push( frame );
+		}
+
+		// Publish it
+		CriticalSectionEnterer criticalSectionRAII( mCriticalSection );
+		mCapturedFrame = frame;
+	}
+}
+
+bool SyntheticDeviceBackend::isEncodingSupported( ImageFormat::Encoding encoding )
+{
+	return	encoding==ImageFormat::RGB24 ||
+			encoding==ImageFormat::BGR24 ||
+			encoding==ImageFormat::NV12 ||
+			encoding==ImageFormat::I420 ||
+			encoding==ImageFormat::YV12 ||
+			ImageFormat::isRGB( encoding ) ||
+			ImageFormat::isPackedYUV422( encoding ) ||
+			ImageFormat::isGray( encoding );
+}
+
+// The images are generated top row first, the bottom-up ones are then turned upside down in place
+void SyntheticDeviceBackend::flipRows( const ImageFormat& imageFormat, MemoryBuffer& buffer )
+{
+	std::size_t numBytesPerLine = imageFormat.getNumBytesPerLine();
+	unsigned int height = imageFormat.getHeight();
+	unsigned char* bytes = buffer.getBytes();
+	for ( unsigned int y=0; y<height/2; ++y )
+	{
+		unsigned char* row = bytes + y*numBytesPerLine;
+		std::swap_ranges( row, row + numBytesPerLine, bytes + (height-1-y)*numBytesPerLine );
+	}
+}
+
+bool SyntheticDeviceBackend::generateImage( const ImageFormat& imageFormat, unsigned int sequenceNumber, MemoryBuffer& buffer )
+{
+	if ( !isEncodingSupported( imageFormat.getEncoding() ) )
+		return false;
+	if ( buffer.getSizeInBytes()!=imageFormat.getDataSizeInBytes() )
+		return false;
+
+	unsigned int width = imageFormat.getWidth();
+	unsigned int height = imageFormat.getHeight();
+	unsigned char* bytes = buffer.getBytes();
+	
+	// Each component follows its own gradient, scrolling at its own speed
+	unsigned int t = sequenceNumber;
+	switch ( imageFormat.getEncoding() )
+	{
+		case ImageFormat::RGB24:
+		case ImageFormat::BGR24:
+		case ImageFormat::RGBA32:
+		case ImageFormat::BGRA32:
+		case ImageFormat::ARGB32:
+		case ImageFormat::BGRX32:
+		{
+			// Each row is generated in RGB24, then converted to the encoding if needed
+			ImageView image( imageFormat, bytes );
+			std::vector<unsigned char> rgb24Row( width*3 );
+			ImageConverterKernels::ConvertRowFunction convertRow = ImageConverterKernels::getConvertRGBRowFunction( ImageFormat::RGB24, imageFormat.getEncoding(), ImageConverterKernels::ScalarInstructionSet );
+			for ( unsigned int y=0; y<height; ++y )
+			{
+				unsigned char* rgb24Bytes = convertRow ? &rgb24Row[0] : image.getRow(y);
+				for ( unsigned int x=0; x<width; ++x )
+				{
+					rgb24Bytes[x*3] = static_cast<unsigned char>( x + 2*t );
+					rgb24Bytes[x*3+1] = static_cast<unsigned char>( y + t );
+					rgb24Bytes[x*3+2] = static_cast<unsigned char>( (x + y)/2 + 3*t );
+				}
+				if ( convertRow )
+					convertRow( rgb24Bytes, image.getRow(y), width );
+			}
+		}
+		break;
+
+		case ImageFormat::YUYV:
+		case ImageFormat::UYVY:
+		case ImageFormat::YVYU:
+		case ImageFormat::VYUY:
+		{
+			YUV422Offsets offsets = getYUV422Offsets( imageFormat.getEncoding() );
+			for ( unsigned int y=0; y<height; ++y )
+			{
+				for ( unsigned int x=0; x+1<width; x+=2 )
+				{
+					bytes[offsets.y0] = static_cast<unsigned char>( x + y + 2*t );
+					bytes[offsets.u] = static_cast<unsigned char>( x/2 + t );
+					bytes[offsets.y1] = static_cast<unsigned char>( x + 1 + y + 2*t );
+					bytes[offsets.v] = static_cast<unsigned char>( y + 3*t );
+					bytes += 4;
+				}
+			}
+		}
+		break;
+
+		case ImageFormat::NV12:
+		case ImageFormat::I420:
+		case ImageFormat::YV12:
+		{
+			// Same gradients as the packed 4:2:2 encodings, the chroma being shared by 2x2 blocks of pixels
+			ImageView image( imageFormat, bytes );
+			for ( unsigned int y=0; y<height; ++y )
+			{
+				unsigned char* yRow = image.getRow(y);
+				for ( unsigned int x=0; x<width; ++x )
+					yRow[x] = static_cast<unsigned char>( x + y + 2*t );
+			}
+
+			bool isNV12 = imageFormat.getEncoding()==ImageFormat::NV12;
+			unsigned int uPlane = imageFormat.getEncoding()==ImageFormat::YV12 ? 2 : 1;
+			unsigned int vPlane = 3 - uPlane;
+			for ( unsigned int y=0; y<imageFormat.getPlaneHeight(1); ++y )
+			{
+				for ( unsigned int x=0; x<(width+1)/2; ++x )
+				{
+					unsigned char u = static_cast<unsigned char>( x + t );
+					unsigned char v = static_cast<unsigned char>( 2*y + 3*t );
+					if ( isNV12 )
+					{
+						image.getPlaneRow( 1, y )[2*x] = u;
+						image.getPlaneRow( 1, y )[2*x+1] = v;
+					}
+					else
+					{
+						image.getPlaneRow( uPlane, y )[x] = u;
+						image.getPlaneRow( vPlane, y )[x] = v;
+					}
+				}
+			}
+		}
+		break;
+
+		case ImageFormat::GRAY8:
+		case ImageFormat::GRAY16:
+		{
+			// Same gradient as the luma of the YUV encodings, scaled to 16 bits for GRAY16
+			ImageView image( imageFormat, bytes );
+			bool isGRAY16 = imageFormat.getEncoding()==ImageFormat::GRAY16;
+			for ( unsigned int y=0; y<height; ++y )
+			{
+				unsigned char* row = image.getRow(y);
+				for ( unsigned int x=0; x<width; ++x )
+				{
+					unsigned char luma = static_cast<unsigned char>( x + y + 2*t );
+					if ( isGRAY16 )
+					{
+						row[x*2] = luma;		// Little-endian luma*257
+						row[x*2+1] = luma;
+					}
+					else
+					{
+						row[x] = luma;
+					}
+				}
+			}
+		}
+		break;
+
+		default:
+			return false;
+	}
+	
+	burnSequenceNumber( imageFormat, sequenceNumber, buffer );
+	return true;
+}
+
+// The blocks are an even number of pixels wide so they're made of whole 4:2:2 macroblocks
+unsigned int SyntheticDeviceBackend::getSequenceNumberBlockWidth( const ImageFormat& imageFormat )
+{
+	return ( imageFormat.getWidth() / numSequenceNumberBits ) & ~1u;
+}
+
+unsigned int SyntheticDeviceBackend::getSequenceNumberBlockHeight( const ImageFormat& imageFormat )
+{
+	return imageFormat.getHeight()<8 ? imageFormat.getHeight() : 8;
+}
+
+// The number of bytes of a pixel in the first plane: the luma plane of the planar encodings
+unsigned int SyntheticDeviceBackend::getNumBytesPerBlockPixel( const ImageFormat& imageFormat )
+{
+	if ( imageFormat.isPlanar() )
+		return 1;
+	return imageFormat.getNumBitsPerPixel() / 8;
+}
+
+void SyntheticDeviceBackend::burnSequenceNumber( const ImageFormat& imageFormat, unsigned int sequenceNumber, MemoryBuffer& buffer )
+{
+	unsigned int blockWidth = getSequenceNumberBlockWidth( imageFormat );
+	unsigned int blockHeight = getSequenceNumberBlockHeight( imageFormat );
+	if ( blockWidth==0 )
+		return;		// The image is too small
+
+	ImageView image( imageFormat, buffer.getBytes() );
+	unsigned int numBytesPerBlockLine = blockWidth * getNumBytesPerBlockPixel( imageFormat );
+	for ( unsigned int bitIndex=0; bitIndex<numSequenceNumberBits; ++bitIndex )
+	{
+		bool bit = ( sequenceNumber >> (numSequenceNumberBits-1-bitIndex) ) & 1;
+		for ( unsigned int y=0; y<blockHeight; ++y )
+		{
+			unsigned char* blockBytes = image.getRow(y) + bitIndex * numBytesPerBlockLine;
+			if ( imageFormat.isPackedYUV422() )
+			{
+				YUV422Offsets offsets = getYUV422Offsets( imageFormat.getEncoding() );
+				for ( unsigned int i=0; i<numBytesPerBlockLine; i+=4 )
+				{
+					blockBytes[i+offsets.y0] = bit ? 235 : 16;		// Luma: studio swing white or black
+					blockBytes[i+offsets.y1] = bit ? 235 : 16;
+					blockBytes[i+offsets.u] = 128;					// Chroma: neutral
+					blockBytes[i+offsets.v] = 128;
+				}
+			}
+			else if ( imageFormat.isPlanar() || imageFormat.getEncoding()==ImageFormat::GRAY8 )
+			{
+				memset( blockBytes, bit ? 235 : 16, numBytesPerBlockLine );
+			}
+			else
+			{
+				memset( blockBytes, bit ? 255 : 0, numBytesPerBlockLine );
+			}
+		}
+	}
+
+	// The chroma of the planar encodings lives in the other planes: make it neutral under the blocks
+	unsigned int numBlockPixels = numSequenceNumberBits * blockWidth;
+	unsigned int numChromaBytesPerLine = imageFormat.getEncoding()==ImageFormat::NV12 ? numBlockPixels : numBlockPixels/2;
+	for ( unsigned int plane=1; plane<imageFormat.getNumPlanes(); ++plane )
+	{
+		for ( unsigned int y=0; y<(blockHeight+1)/2; ++y )
+			memset( image.getPlaneRow( plane, y ), 128, numChromaBytesPerLine );
+	}
+}
+
+bool SyntheticDeviceBackend::readSequenceNumber( const ConstImageView& image, unsigned int& sequenceNumber )
+{
+	sequenceNumber = 0;
+	const ImageFormat& imageFormat = image.getFormat();
+	if ( !isEncodingSupported( imageFormat.getEncoding() ) )
+		return false;
+
+	unsigned int blockWidth = getSequenceNumberBlockWidth( imageFormat );
+	unsigned int blockHeight = getSequenceNumberBlockHeight( imageFormat );
+	if ( blockWidth==0 )
+		return false;
+
+	// Sample the first byte of the center pixel of each block: luma for the YUV encodings 
+	// and a color component or the alpha for the RGB encodings (they're all equal in the blocks anyway).
+	// The luma of a packed 4:2:2 macroblock isn't always its first byte
+	unsigned int lumaOffset = imageFormat.isPackedYUV422() ? getYUV422Offsets( imageFormat.getEncoding() ).y0 : 0;
+	unsigned int numBytesPerPixelPair = 2 * getNumBytesPerBlockPixel( imageFormat );
+	unsigned int numBytesPerBlockLine = blockWidth * getNumBytesPerBlockPixel( imageFormat );
+	const unsigned char* centerLineBytes = image.getRow( blockHeight/2 );
+	for ( unsigned int bitIndex=0; bitIndex<numSequenceNumberBits; ++bitIndex )
+	{
+		const unsigned char* pixelBytes = centerLineBytes + bitIndex * numBytesPerBlockLine + (blockWidth/2/2) * numBytesPerPixelPair;
+		sequenceNumber <<= 1;
+		if ( pixelBytes[lumaOffset]>=128 )
+			sequenceNumber |= 1;
+	}
+	return true;
+}
+
+}
\ No newline at end of file
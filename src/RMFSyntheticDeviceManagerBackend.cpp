@@ -0,0 +1,97 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFSyntheticDeviceManagerBackend.h"
+
+#include "RMFSyntheticDeviceBackend.h"
+
+namespace RMF
+{
+
+SyntheticDeviceManagerBackend::SyntheticDeviceManagerBackend()
+	: mDeviceListChanged(true),
+	  mDevices()
+{
+}
+
+SyntheticDeviceManagerBackend::~SyntheticDeviceManagerBackend()
+{
+}
+
+std::string SyntheticDeviceManagerBackend::getSymbolicLink( const std::string& name )
+{
+	return "synthetic://" + name;
+}
+
+bool SyntheticDeviceManagerBackend::addDevice( const std::string& name, const CaptureSettingsList& supportedCaptureSettingsList, bool bottomUp )
+{
+	std::string symbolicLink = getSymbolicLink( name );
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+	{
+		if ( mDevices[i].description.symbolicLink==symbolicLink )
+			return false;
+	}
+
+	SyntheticDevice device;
+	device.description = DeviceDescription( name, symbolicLink );
+	device.supportedCaptureSettingsList = supportedCaptureSettingsList;
+	device.bottomUp = bottomUp;
+	mDevices.push_back( device );
+	mDeviceListChanged = true;
+	return true;
+}
+
+bool SyntheticDeviceManagerBackend::removeDevice( const std::string& name )
+{
+	std::string symbolicLink = getSymbolicLink( name );
+	for ( SyntheticDevices::iterator itr=mDevices.begin(); itr!=mDevices.end(); ++itr )
+	{
+		if ( itr->description.symbolicLink==symbolicLink )
+		{
+			mDevices.erase( itr );
+			mDeviceListChanged = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void SyntheticDeviceManagerBackend::enumerateDevices( DeviceDescriptions& descriptions )
+{
+	descriptions.clear();
+	mDeviceListChanged = false;
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+		descriptions.push_back( mDevices[i].description );
+}
+
+DeviceBackend* SyntheticDeviceManagerBackend::createDeviceBackend( const DeviceDescription& description )
+{
+	for ( std::size_t i=0; i<mDevices.size(); ++i )
+	{
+		if ( mDevices[i].description.symbolicLink==description.symbolicLink )
+			return new SyntheticDeviceBackend( mDevices[i].supportedCaptureSettingsList, mDevices[i].bottomUp );
+	}
+	return NULL;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFThreadPool.h"
+
+#include <algorithm>
+
+namespace RMF
+{
+
+ThreadPool::ThreadPool( unsigned int numThreads )
+	: mTask(NULL),
+	  mNumTasks(0),
+	  mNextTaskIndex(0),
+	  mNumCompletedTasks(0),
+	  mGeneration(0),
+	  mStopRequested(false)
+{
+	if ( numThreads==0 )
+	{
+		unsigned int numCores = std::thread::hardware_concurrency();
+		numThreads = numCores>1 ? numCores-1 : 0;
+	}
+	for ( unsigned int i=0; i<numThreads; ++i )
+		mThreads.push_back( std::thread( &ThreadPool::threadFunction, this ) );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStopRequested = true;
+	}
+	mWorkCondition.notify_all();
+	for ( std::size_t i=0; i<mThreads.size(); ++i )
+		mThreads[i].join();
+}
+
+void ThreadPool::run( const Task& task, unsigned int numTasks )
+{
+	if ( numTasks==0 )
+		return;
+
+	if ( mThreads.empty() || numTasks==1 )
+	{
+		for ( unsigned int i=0; i<numTasks; ++i )
+			task( i );
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock( mRunMutex );
+	std::unique_lock<std::mutex> lock( mMutex );
+	mTask = &task;
+	mNumTasks = numTasks;
+	mNextTaskIndex = 0;
+	mNumCompletedTasks = 0;
+	mGeneration++;
+	mWorkCondition.notify_all();
+
+	runTasks( lock );
+	while ( mNumCompletedTasks<mNumTasks )
+		mDoneCondition.wait( lock );
+	mTask = NULL;
+}
+
+void ThreadPool::runBands( ThreadPool* threadPool, const BandTask& task, unsigned int numRows, unsigned int numRowsPerStep, unsigned int minBandHeight )
+{
+	unsigned int numBands = 1;
+	if ( threadPool )
+	{
+		unsigned int maxNumBands = numRows / std::max( minBandHeight, numRowsPerStep );
+		numBands = std::min( threadPool->getNumThreads()+1, maxNumBands );
+	}
+	if ( numBands<=1 )
+	{
+		task( 0, numRows );
+		return;
+	}
+
+	Task bandTask = [&]( unsigned int bandIndex )
+		{
+			unsigned int firstRow = numRows * bandIndex / numBands / numRowsPerStep * numRowsPerStep;
+			unsigned int endRow = numRows;
+			if ( bandIndex+1<numBands )
+				endRow = numRows * (bandIndex+1) / numBands / numRowsPerStep * numRowsPerStep;
+			task( firstRow, endRow );
+		};
+	threadPool->run( bandTask, numBands );
+}
+
+void ThreadPool::threadFunction()
+{
+	unsigned int generation = 0;
+	std::unique_lock<std::mutex> lock( mMutex );
+	for ( ;; )
+	{
+		while ( !mStopRequested && mGeneration==generation )
+			mWorkCondition.wait( lock );
+		if ( mStopRequested )
+			return;
+		generation = mGeneration;
+		runTasks( lock );
+	}
+}
+
+// Takes the tasks one by one until there are none left. The lock is held 
+// except while a task executes
+void ThreadPool::runTasks( std::unique_lock<std::mutex>& lock )
+{
+	while ( mNextTaskIndex<mNumTasks )
+	{
+		unsigned int taskIndex = mNextTaskIndex++;
+		const Task& task = *mTask;
+		lock.unlock();
+		task( taskIndex );
+		lock.lock();
+		mNumCompletedTasks++;
+		if ( mNumCompletedTasks==mNumTasks )
+			mDoneCondition.notify_all();
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+   The MIT License (MIT) (http://opensource.org/licenses/MIT)
+   
+   Copyright (c) 2015 Jacques Menuet
+   
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+   
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+#include "RMFYUVCoefficients.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace RMF
+{
+
+// Computed from the Kr and Kb constants of each matrix (0.299 and 0.114 for BT.601, 0.2126 and 0.0722 
+// for BT.709, 0.2627 and 0.0593 for BT.2020). The limited range scales the luma by 219/255 and 
+// the chroma by 224/255
+const YUVCoefficients YUVCoefficients::mCoefficients[ImageFormat::ColorMatrixCount][ImageFormat::ColorRangeCount] = 
+{
+	{
+		{ 16, 298, 409, -100, -208, 516,	66, 129, 25,	-38, -74, 112,	112, -94, -18 },		// BT.601, limited range
+		{ 0, 256, 359, -88, -183, 454,		77, 150, 29,	-43, -85, 128,	128, -107, -21 },		// BT.601, full range
+	},
+	{
+		{ 16, 298, 459, -55, -136, 541,		47, 157, 16,	-26, -86, 112,	112, -102, -10 },		// BT.709, limited range
+		{ 0, 256, 403, -48, -120, 475,		54, 183, 19,	-29, -99, 128,	128, -116, -12 },		// BT.709, full range
+	},
+	{
+		{ 16, 298, 430, -48, -167, 548,		58, 149, 13,	-31, -81, 112,	112, -103, -9 },		// BT.2020, limited range
+		{ 0, 256, 377, -42, -146, 482,		67, 174, 15,	-36, -92, 128,	128, -118, -10 },		// BT.2020, full range
+	}
+};
+
+// Falls back to BT.601 limited range for the out of range values
+const YUVCoefficients& YUVCoefficients::get( ImageFormat::ColorMatrix colorMatrix, ImageFormat::ColorRange colorRange )
+{
+	if ( colorMatrix>=ImageFormat::ColorMatrixCount || colorRange>=ImageFormat::ColorRangeCount )
+		return mCoefficients[ImageFormat::BT601][ImageFormat::LimitedRange];
+	return mCoefficients[colorMatrix][colorRange];
+}
+
+YUVToRGBTables::YUVToRGBTables( const YUVCoefficients& coefficients )
+{
+	for ( int i=0; i<256; ++i )
+	{
+		yTable[i] = coefficients.yFactor * ( i - coefficients.yOffset ) + 128;
+		vToRedTable[i] = coefficients.vToRed * ( i - 128 );
+		uToGreenTable[i] = coefficients.uToGreen * ( i - 128 );
+		vToGreenTable[i] = coefficients.vToGreen * ( i - 128 );
+		uToBlueTable[i] = coefficients.uToBlue * ( i - 128 );
+	}
+
+	// The extreme sums of each component must fit in the clip table. This assumes a positive 
+	// yFactor, vToRed and uToBlue, and negative green coefficients, like the standard ones
+	assert( ( ( yTable[0] + std::min( std::min( vToRedTable[0], uToBlueTable[0] ), uToGreenTable[255] + vToGreenTable[255] ) ) >> 8 ) >= -clipTableOffset );
+	assert( ( ( yTable[255] + std::max( std::max( vToRedTable[255], uToBlueTable[255] ), uToGreenTable[0] + vToGreenTable[0] ) ) >> 8 ) < clipTableSize-clipTableOffset );
+
+	for ( int i=0; i<clipTableSize; ++i )
+	{
+		int value = i - clipTableOffset;
+		mClipTable[i] = static_cast<unsigned char>( value<0 ? 0 : ( value>255 ? 255 : value ) );
+	}
+}
+
+namespace
+{
+
+struct StandardYUVToRGBTables
+{
+	StandardYUVToRGBTables()
+	{
+		for ( int i=0; i<ImageFormat::ColorMatrixCount; ++i )
+		{
+			for ( int j=0; j<ImageFormat::ColorRangeCount; ++j )
+			{
+				ImageFormat::ColorMatrix colorMatrix = static_cast<ImageFormat::ColorMatrix>(i);
+				ImageFormat::ColorRange colorRange = static_cast<ImageFormat::ColorRange>(j);
+				tables[i][j] = new YUVToRGBTables( YUVCoefficients::get( colorMatrix, colorRange ) );
+			}
+		}
+	}
+
+	~StandardYUVToRGBTables()
+	{
+		for ( int i=0; i<ImageFormat::ColorMatrixCount; ++i )
+			for ( int j=0; j<ImageFormat::ColorRangeCount; ++j )
+				delete tables[i][j];
+	}
+
+	YUVToRGBTables*		tables[ImageFormat::ColorMatrixCount][ImageFormat::ColorRangeCount];
+};
+
+}
+
+// Falls back to BT.601 limited range for the out of range values, like YUVCoefficients::get()
+const YUVToRGBTables& YUVToRGBTables::get( ImageFormat::ColorMatrix colorMatrix, ImageFormat::ColorRange colorRange )
+{
+	static StandardYUVToRGBTables standardTables;
+	if ( colorMatrix>=ImageFormat::ColorMatrixCount || colorRange>=ImageFormat::ColorRangeCount )
+		return *standardTables.tables[ImageFormat::BT601][ImageFormat::LimitedRange];
+	return *standardTables.tables[colorMatrix][colorRange];
+}
+
+}